@@ -25,3 +25,12 @@ def onFinish():
 	可以在此做一些游戏资源清理工作
 	"""
 	pass
+
+def onCreateBotScenario(bot):
+	"""
+	KBEngine method.
+	机器人的玩家进入世界后引擎调用这个接口， 返回的对象每隔bots/scenario/tickInterval秒
+	被调用一次onTick(bot)， 机器人销毁或断线时调用onDestroy(bot)(可选)
+	返回None则这个机器人不运行场景
+	"""
+	return None
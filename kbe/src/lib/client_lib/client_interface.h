@@ -248,6 +248,11 @@ NETWORK_INTERFACE_DECLARE_BEGIN(ClientInterface)
 	// ׼ 
 	CLIENT_MESSAGE_DECLARE_STREAM(acrossServerReady,					 NETWORK_VARIABLE_MESSAGE)
 
+	// ¼ŶУǰŶλúԤƵȴ
+	CLIENT_MESSAGE_DECLARE_ARGS2(onLoginQueuePosition,						NETWORK_FIXED_MESSAGE,
+									uint32,									position,
+									uint32,									waitSeconds)
+
 	NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
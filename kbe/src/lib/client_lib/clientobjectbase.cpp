@@ -64,6 +64,7 @@ appID_(0),
 pServerChannel_(NULL),
 pEntities_(new Entities<client::Entity>()),
 pEntityIDAliasIDList_(),
+entityAliasAllocator_(),
 pyCallbackMgr_(),
 entityID_(0),
 spaceID_(0),
@@ -137,6 +138,7 @@ void ClientObjectBase::reset(void)
 {
 	pEntities_->finalise();
 	pEntityIDAliasIDList_.clear();
+	entityAliasAllocator_.clear();
 	pyCallbackMgr_.finalise();
 
 	entityID_ = 0;
@@ -387,6 +389,14 @@ client::Entity* ClientObjectBase::createEntity(const char* entityType, PyObject*
 //-------------------------------------------------------------------------------------
 ENTITY_ID ClientObjectBase::getViewEntityID(ENTITY_ID id)
 {
+	if(EntityDef::entityAliasIDSlots())
+	{
+		if(id >= 0 && id < EntityAliasAllocator::MAX_ALIASES)
+			return entityAliasAllocator_.entityID((uint16)id);
+
+		return id;
+	}
+
 	if(id <= 255 && EntityDef::entityAliasID() && pEntityIDAliasIDList_.size() <= 255)
 	{
 		return pEntityIDAliasIDList_[id];
@@ -406,6 +416,10 @@ ENTITY_ID ClientObjectBase::getViewEntityIDFromStream(MemoryStream& s)
 		return id;
 	}
 
+	// λĿɷǰ дʱһ
+	if (EntityDef::entityAliasIDSlots())
+		return entityAliasAllocator_.entityID(entityAliasAllocator_.readFromStream(s));
+
 	if(pEntityIDAliasIDList_.size() > 255)
 	{
 		s >> id;
@@ -850,7 +864,10 @@ void ClientObjectBase::onEntityEnterWorld(Network::Channel * pChannel, MemoryStr
 		s >> isOnGround;
 
 	if(eid != entityID_ && entityID_ > 0)
+	{
 		pEntityIDAliasIDList_.push_back(eid);
+		entityAliasAllocator_.alloc(eid);
+	}
 
 	client::Entity* entity = pEntities_->find(eid);
 	if(entity == NULL)
@@ -914,6 +931,7 @@ void ClientObjectBase::onEntityEnterWorld(Network::Channel * pChannel, MemoryStr
 			// ʹgiveClientToлȨ
 			// ֮ǰʵѾ磬 лʵҲ磬 ܻ֮ǰǸʵϢ
 			pEntityIDAliasIDList_.clear();
+			entityAliasAllocator_.clear();
 			std::vector<ENTITY_ID> excludes;
 			excludes.push_back(entityID_);
 			pEntities_->clear(true, excludes);
@@ -985,6 +1003,7 @@ void ClientObjectBase::onEntityLeaveWorld(Network::Channel * pChannel, ENTITY_ID
 		controlledEntities_.remove(entity);
 		destroyEntity(eid, false);
 		pEntityIDAliasIDList_.erase(std::remove(pEntityIDAliasIDList_.begin(), pEntityIDAliasIDList_.end(), eid), pEntityIDAliasIDList_.end());
+		entityAliasAllocator_.reclaim(eid);
 	}
 	else
 	{
@@ -1162,6 +1181,13 @@ void ClientObjectBase::acrossServerReady(Network::Channel * pChannel, MemoryStre
 	ERROR_MSG("ClientObjectBase::acrossServerReady: .\n");
 }
 
+//-------------------------------------------------------------------------------------	
+void ClientObjectBase::onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds)
+{
+	INFO_MSG(fmt::format("ClientObjectBase::onLoginQueuePosition: {} position={}, waitSeconds={}!\n", 
+		name_, position, waitSeconds));
+}
+
 //-------------------------------------------------------------------------------------
 client::Entity* ClientObjectBase::pPlayer()
 {
@@ -2326,6 +2352,7 @@ void ClientObjectBase::clearSpace(bool isAll)
 	}
 
 	pEntityIDAliasIDList_.clear();
+	entityAliasAllocator_.clear();
 	spacedatas_.clear();
 	bufferedCreateEntityMessage_.clear();
 
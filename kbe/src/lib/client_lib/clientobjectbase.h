@@ -31,6 +31,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "pyscript/scriptobject.h"
 #include "entitydef/entities.h"
 #include "entitydef/common.h"
+#include "entitydef/entity_alias_allocator.h"
 #include "server/callbackmgr.h"
 #include "server/server_errors.h"
 #include "math/math.h"
@@ -409,6 +410,13 @@ public:
 	*/
 	virtual void acrossServerReady(Network::Channel* pChannel, MemoryStream& s);
 
+	/** ӿ
+		¼Ŷ
+		@position: ǰŶλ(1ʼ)
+		@waitSeconds: ԤƵȴ
+	*/
+	virtual void onLoginQueuePosition(Network::Channel* pChannel, uint32 position, uint32 waitSeconds);
+
 	/** 
 		playerʵ
 	*/
@@ -484,6 +492,9 @@ protected:
 	Entities<client::Entity>*								pEntities_;	
 	std::vector<ENTITY_ID>									pEntityIDAliasIDList_;
 
+	// aliasEntityIDSlotsģʽWitnessһµıID
+	EntityAliasAllocator									entityAliasAllocator_;
+
 	PY_CALLBACKMGR											pyCallbackMgr_;
 
 	ENTITY_ID												entityID_;
@@ -356,6 +356,11 @@ bool Config::loadConfig(std::string fileName)
 		EntityDef::entitydefAliasID((xml->getValStr(rootNode) == "true"));
 	}
 
+	rootNode = xml->getRootNode("aliasEntityIDSlots");
+	if(rootNode != NULL){
+		EntityDef::entityAliasIDSlots((xml->getValStr(rootNode) == "true"));
+	}
+
 	rootNode = xml->getRootNode("isOnInitCallPropertysSetMethods");
 	if (rootNode != NULL)
 		isOnInitCallPropertysSetMethods_ = (xml->getValStr(rootNode) == "true");
@@ -42,6 +42,9 @@ namespace client
 {
 
 //-------------------------------------------------------------------------------------
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Entity");
+
 CLIENT_ENTITY_METHOD_DECLARE_BEGIN(ClientApp, Entity)
 SCRIPT_METHOD_DECLARE("moveToPoint",				pyMoveToPoint,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("cancelController",			pyCancelController,				METH_VARARGS,				0)
@@ -84,7 +87,7 @@ inited_(false),
 isControlled_(false)
 {
 	ENTITY_INIT_PROPERTYS(Entity);
-	script::PyGC::incTracing("Entity");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -97,7 +100,7 @@ Entity::~Entity()
 	S_RELEASE(cellEntityCall_);
 	S_RELEASE(baseEntityCall_);
 
-	script::PyGC::decTracing("Entity");
+	script::PyGC::decTracing(g_tracingSlot);
 	
 	if(pClientApp_->pEntities())
 		pClientApp_->pEntities()->pGetbages()->erase(id());
@@ -101,6 +101,28 @@ public:
 		return query(cmd.c_str(), (uint32)cmd.size(), printlog, result);
 	}
 
+	/**
+		ķʽִһ䣬һԶڴ棬ͨfetchStreamֿȡ
+		endStream֮ǰӲִѯֵ֧Ľӿڷfalse
+	*/
+	virtual bool queryStream(const char* cmd, uint32 size) { return false; }
+
+	/**
+		ӵǰȡmaxRows(ݳmaxBytes)дresultʽRAW_DB_FIELD_TYPE
+		ȡʱfinishedΪtrue
+	*/
+	virtual bool fetchStream(MemoryStream* result, uint32 maxRows, uint32 maxBytes, bool& finished) { return false; }
+
+	/**
+		ǰͷʣ
+	*/
+	virtual void endStream() {}
+
+	/**
+		ǰȡʣúӲʹãҪdetach
+	*/
+	virtual void abortStream() { endStream(); }
+
 	/**
 		ӿڵ
 	*/
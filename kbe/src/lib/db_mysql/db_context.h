@@ -60,14 +60,45 @@ public:
 	*/
 	struct DB_ITEM_DATA
 	{
+		/**
+			дֵͣдʱԤĲ󶨣
+			޷ʹԤʱתΪsqlı
+		*/
+		enum BIND_TYPE
+		{
+			BIND_NONE = 0,
+			BIND_INT64 = 1,
+			BIND_UINT64 = 2,
+			BIND_DOUBLE = 3,
+			BIND_STRING = 4,
+			BIND_BLOB = 5
+		};
+
 		DB_ITEM_DATA()
 		{
 			sqlkey = NULL;
+			bindType = BIND_NONE;
+			bindVal.i = 0;
 		}
 
+		void setInt(int64 v) { bindType = BIND_INT64; bindVal.i = v; }
+		void setUInt(uint64 v) { bindType = BIND_UINT64; bindVal.u = v; }
+		void setDouble(double v) { bindType = BIND_DOUBLE; bindVal.d = v; }
+		void setString(const std::string& v) { bindType = BIND_STRING; bindData = v; }
+		void setBlob(const std::string& v) { bindType = BIND_BLOB; bindData = v; }
+
 		char sqlval[MAX_BUF];
 		const char* sqlkey;
 		std::string extraDatas;
+
+		uint8 bindType;
+		union
+		{
+			int64 i;
+			uint64 u;
+			double d;
+		} bindVal;
+		std::string bindData;							// ַݵԭʼ(δת)
 	};
 
 	typedef std::vector< std::pair< std::string/*tableName*/, KBEShared_ptr< DBContext > > > DB_RW_CONTEXTS;
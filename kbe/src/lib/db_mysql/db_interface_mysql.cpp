@@ -23,8 +23,10 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "entity_table_mysql.h"
 #include "kbe_table_mysql.h"
 #include "db_exception.h"
+#include "db_stmt.h"
 #include "thread/threadguard.h"
 #include "helper/watcher.h"
+#include "server/common.h"
 #include "server/serverconfig.h"
 
 namespace KBEngine { 
@@ -123,6 +125,16 @@ static uint32 watcher_grant(const std::string&)
 	return watcher_query("GRANT");
 }
 
+static uint32 watcher_stmt_prepare(const std::string&)
+{
+	return watcher_query("STMT_PREPARE");
+}
+
+static uint32 watcher_stmt_execute(const std::string&)
+{
+	return watcher_query("STMT_EXECUTE");
+}
+
 static void initializeWatcher()
 {
 	if(_g_installedWatcher)
@@ -140,6 +152,8 @@ static void initializeWatcher()
 	WATCH_OBJECT("db_querys/show", &KBEngine::watcher_show);
 	WATCH_OBJECT("db_querys/alter", &KBEngine::watcher_alter);
 	WATCH_OBJECT("db_querys/grant", &KBEngine::watcher_grant);
+	WATCH_OBJECT("db_querys/stmt_prepare", &KBEngine::watcher_stmt_prepare);
+	WATCH_OBJECT("db_querys/stmt_execute", &KBEngine::watcher_stmt_execute);
 }
 
 size_t DBInterfaceMysql::sql_max_allowed_packet_ = 0;
@@ -149,11 +163,17 @@ DBInterface(name),
 pMysql_(NULL),
 hasLostConnection_(false),
 inTransaction_(false),
+multiStatements_(false),
 lock_(NULL, false),
 characterSet_(characterSet),
 collation_(collation),
 autoIncrementOffset_(autoIncrementOffset),
-autoIncrementIncrement_(autoIncrementIncrement)
+autoIncrementIncrement_(autoIncrementIncrement),
+stmts_(),
+usePreparedStatements_(true),
+pStreamResult_(NULL),
+streamFieldTypes_(),
+streamHeaderSent_(false)
 {
 	lock_.pdbi(this);
 }
@@ -161,6 +181,8 @@ autoIncrementIncrement_(autoIncrementIncrement)
 //-------------------------------------------------------------------------------------
 DBInterfaceMysql::~DBInterfaceMysql()
 {
+	endStream();
+	clearStmts();
 }
 
 //-------------------------------------------------------------------------------------
@@ -190,6 +212,11 @@ bool DBInterfaceMysql::attach(const char* databaseName)
 		kbe_snprintf(db_name_, MAX_BUF, "%s", databaseName);
 
 	hasLostConnection_ = false;
+	multiStatements_ = false;
+
+	DBInterfaceInfo* pDBInfo = g_kbeSrvConfig.dbInterface(name());
+	if (pDBInfo)
+		usePreparedStatements_ = pDBInfo->db_preparedStatements;
 
 	try
 	{
@@ -206,7 +233,7 @@ bool DBInterfaceMysql::attach(const char* databaseName)
 
 __RECONNECT:
 		if(mysql_real_connect(mysql(), db_ip_, db_username_, 
-    		db_password_, db_name_, db_port_, NULL, 0)) // CLIENT_MULTI_STATEMENTS  
+    		db_password_, db_name_, db_port_, NULL, CLIENT_MULTI_STATEMENTS))
 		{
 			if(mysql_select_db(mysql(), db_name_) != 0)
 			{
@@ -235,7 +262,7 @@ __RECONNECT:
 				}
 
 				if (mysql_real_connect(mysql(), db_ip_, db_username_,
-					db_password_, NULL, db_port_, NULL, 0)) // CLIENT_MULTI_STATEMENTS  
+					db_password_, NULL, db_port_, NULL, CLIENT_MULTI_STATEMENTS))
 				{
 					this->createDatabaseIfNotExist();
 					if (mysql_select_db(mysql(), db_name_) != 0)
@@ -264,6 +291,11 @@ __RECONNECT:
 			return false;
 		}
 
+		// ȡʵʱͬһӱѯϲΪһ䷢
+		// ʱͿ䣬ÿζȡʵ嶼Ҫлѡ
+		// ѯĶdrainResults
+		multiStatements_ = true;
+
 		// ҪرԶύײSTART TRANSACTION֮COMMIT
 		// mysql_autocommit(mysql(), 0);
 
@@ -434,6 +466,10 @@ bool DBInterfaceMysql::reattach()
 //-------------------------------------------------------------------------------------
 bool DBInterfaceMysql::detach()
 {
+	// ʽӣӹرպȫʧЧ
+	endStream();
+	clearStmts();
+
 	if(mysql())
 	{
 		::mysql_close(mysql());
@@ -492,6 +528,9 @@ bool DBInterfaceMysql::query(const char* cmd, uint32 size, bool printlog, Memory
 
 	querystatistics(cmd, size);
 
+	// һ(ô洢)Ľ
+	drainResults();
+
 	lastquery_.assign(cmd, size);
 
 	if(_g_debug)
@@ -509,6 +548,8 @@ bool DBInterfaceMysql::query(const char* cmd, uint32 size, bool printlog, Memory
 				mysql_errno(pMysql_), mysql_error(pMysql_), lastquery_)); 
 		}
 
+		// ׳쳣֮ǰĽͬ
+		drainResults();
 		this->throwError(NULL);
 		
 		if(result)
@@ -597,6 +638,387 @@ bool DBInterfaceMysql::write_query_result(MemoryStream * result)
 		(*result) << lastInsertID;
 	}
 
+	// 洢̵Ȼ᷵ضֻصһĽҪԱͬ
+	if(!drainResults())
+	{
+		this->throwError(NULL);
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceMysql::abortStream()
+{
+	if(pStreamResult_ == NULL)
+	{
+		endStream();
+		return;
+	}
+
+	// mysql_free_resultmysql_use_resultʣУܴʱܾ
+	// ÷ֹѯfreeֻҪѾ;ݺжϵĴ
+	// ֹʧʱfreeȻȷֻҪʣ
+	killQuery();
+
+	mysql_free_result(pStreamResult_);
+	pStreamResult_ = NULL;
+
+	endStream();
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::killQuery()
+{
+	if(pMysql_ == NULL)
+		return false;
+
+	unsigned long threadID = mysql_thread_id(pMysql_);
+
+	MYSQL* pKiller = mysql_init(0);
+	if(pKiller == NULL)
+	{
+		ERROR_MSG("DBInterfaceMysql::killQuery: mysql_init error!\n");
+		return false;
+	}
+
+	if(!mysql_real_connect(pKiller, db_ip_, db_username_, db_password_, NULL, db_port_, NULL, 0))
+	{
+		ERROR_MSG(fmt::format("DBInterfaceMysql::killQuery: connect error({}:{})!\n", 
+			mysql_errno(pKiller), mysql_error(pKiller)));
+
+		::mysql_close(pKiller);
+		return false;
+	}
+
+	char sql[MAX_BUF];
+	kbe_snprintf(sql, MAX_BUF, "KILL QUERY %lu", threadID);
+
+	bool ret = mysql_real_query(pKiller, sql, (unsigned long)strlen(sql)) == 0;
+	if(!ret)
+	{
+		ERROR_MSG(fmt::format("DBInterfaceMysql::killQuery: error({}:{})!\nsql:({})\n", 
+			mysql_errno(pKiller), mysql_error(pKiller), sql));
+	}
+
+	::mysql_close(pKiller);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::drainResults()
+{
+	if(pMysql_ == NULL)
+		return true;
+
+	// mysql_more_resultsֻ״̬ıϵĴϢ
+	while(mysql_more_results(pMysql_))
+	{
+		int status = mysql_next_result(pMysql_);
+
+		if(status > 0)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceMysql::drainResults: error({}:{})!\nsql:({})\n", 
+				mysql_errno(pMysql_), mysql_error(pMysql_), lastquery_));
+
+			return false;
+		}
+
+		if(status < 0)
+			break;
+
+		MYSQL_RES* pResult = mysql_store_result(pMysql_);
+		if(pResult)
+			mysql_free_result(pResult);
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static uint8 mysqlFieldType2RawDBType(const MYSQL_FIELD& field)
+{
+	switch(field.type)
+	{
+	case MYSQL_TYPE_TINY:
+	case MYSQL_TYPE_SHORT:
+	case MYSQL_TYPE_INT24:
+	case MYSQL_TYPE_LONG:
+	case MYSQL_TYPE_LONGLONG:
+	case MYSQL_TYPE_YEAR:
+		return (field.flags & UNSIGNED_FLAG) ? RAW_DB_FIELD_TYPE_UINT : RAW_DB_FIELD_TYPE_INT;
+	case MYSQL_TYPE_FLOAT:
+	case MYSQL_TYPE_DOUBLE:
+		return RAW_DB_FIELD_TYPE_DOUBLE;
+	case MYSQL_TYPE_TINY_BLOB:
+	case MYSQL_TYPE_MEDIUM_BLOB:
+	case MYSQL_TYPE_LONG_BLOB:
+	case MYSQL_TYPE_BLOB:
+	case MYSQL_TYPE_VAR_STRING:
+	case MYSQL_TYPE_STRING:
+	case MYSQL_TYPE_BIT:
+	case MYSQL_TYPE_GEOMETRY:
+		// ַΪbinary(63)Ķ
+		return (field.charsetnr == 63) ? RAW_DB_FIELD_TYPE_BLOB : RAW_DB_FIELD_TYPE_STRING;
+	default:
+		// decimalʱıʽű⾫ȶʧ
+		return RAW_DB_FIELD_TYPE_STRING;
+	};
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::queryStream(const char* cmd, uint32 size)
+{
+	endStream();
+
+	if(pMysql_ == NULL)
+	{
+		ERROR_MSG(fmt::format("DBInterfaceMysql::queryStream: has no attach(db)!\nsql:({})\n", lastquery_));
+		return false;
+	}
+
+	querystatistics(cmd, size);
+	lastquery_.assign(cmd, size);
+
+	if(mysql_real_query(pMysql_, cmd, size) != 0)
+	{
+		ERROR_MSG(fmt::format("DBInterfaceMysql::queryStream: error({}:{})!\nsql:({})\n", 
+			mysql_errno(pMysql_), mysql_error(pMysql_), lastquery_)); 
+
+		this->throwError(NULL);
+		return false;
+	}
+
+	// ڷ˰ȡᱻһԶڴ
+	pStreamResult_ = mysql_use_result(pMysql_);
+	streamHeaderSent_ = false;
+	streamFieldTypes_.clear();
+
+	if(pStreamResult_ == NULL && mysql_field_count(pMysql_) > 0)
+	{
+		ERROR_MSG(fmt::format("DBInterfaceMysql::queryStream: use_result error({}:{})!\nsql:({})\n", 
+			mysql_errno(pMysql_), mysql_error(pMysql_), lastquery_)); 
+
+		this->throwError(NULL);
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::fetchStream(MemoryStream* result, uint32 maxRows, uint32 maxBytes, bool& finished)
+{
+	finished = false;
+
+	if(pMysql_ == NULL)
+		return false;
+
+	size_t startpos = result->wpos();
+	uint8 flags = 0;
+	(*result) << flags;
+
+	if(!streamHeaderSent_)
+	{
+		flags |= RAW_DB_STREAM_HEADER;
+		streamHeaderSent_ = true;
+
+		uint32 nfields = pStreamResult_ ? (uint32)mysql_num_fields(pStreamResult_) : 0;
+		(*result) << nfields;
+
+		if(nfields > 0)
+		{
+			MYSQL_FIELD* fields = mysql_fetch_fields(pStreamResult_);
+			streamFieldTypes_.resize(nfields);
+
+			for(uint32 i = 0; i < nfields; ++i)
+			{
+				streamFieldTypes_[i] = mysqlFieldType2RawDBType(fields[i]);
+				(*result) << std::string(fields[i].name, fields[i].name_length) << streamFieldTypes_[i];
+			}
+		}
+	}
+
+	size_t nrowspos = result->wpos();
+	uint32 nrows = 0;
+	(*result) << nrows;
+
+	if(pStreamResult_)
+	{
+		uint32 nfields = (uint32)streamFieldTypes_.size();
+		std::vector<uint8> nullbits((nfields + 7) / 8);
+
+		while(nrows < maxRows && result->wpos() - startpos < maxBytes)
+		{
+			MYSQL_ROW arow = mysql_fetch_row(pStreamResult_);
+			if(arow == NULL)
+			{
+				if(mysql_errno(pMysql_) != 0)
+				{
+					result->wpos(startpos);
+					ERROR_MSG(fmt::format("DBInterfaceMysql::fetchStream: error({}:{})!\nsql:({})\n", 
+						mysql_errno(pMysql_), mysql_error(pMysql_), lastquery_)); 
+
+					endStream();
+					this->throwError(NULL);
+					return false;
+				}
+
+				finished = true;
+				break;
+			}
+
+			unsigned long *lengths = mysql_fetch_lengths(pStreamResult_);
+
+			std::fill(nullbits.begin(), nullbits.end(), 0);
+			for(uint32 i = 0; i < nfields; ++i)
+			{
+				if(arow[i] == NULL)
+					nullbits[i / 8] |= (uint8)(1 << (i % 8));
+			}
+
+			if(nullbits.size() > 0)
+				result->append(&nullbits[0], nullbits.size());
+
+			for(uint32 i = 0; i < nfields; ++i)
+			{
+				if(arow[i] == NULL)
+					continue;
+
+				switch(streamFieldTypes_[i])
+				{
+				case RAW_DB_FIELD_TYPE_INT:
+					(*result) << (int64)strtoll(arow[i], NULL, 10);
+					break;
+				case RAW_DB_FIELD_TYPE_UINT:
+					(*result) << (uint64)strtoull(arow[i], NULL, 10);
+					break;
+				case RAW_DB_FIELD_TYPE_DOUBLE:
+					(*result) << strtod(arow[i], NULL);
+					break;
+				default:
+					result->appendBlob(arow[i], lengths[i]);
+					break;
+				};
+			}
+
+			++nrows;
+		}
+	}
+	else
+	{
+		finished = true;
+	}
+
+	result->put(nrowspos, nrows);
+
+	if(finished)
+	{
+		flags |= RAW_DB_STREAM_FINISHED;
+
+		uint64 affectedRows = pStreamResult_ ? 0 : (uint64)mysql_affected_rows(pMysql_);
+		uint64 lastInsertID = pStreamResult_ ? 0 : (uint64)mysql_insert_id(pMysql_);
+		(*result) << affectedRows << lastInsertID;
+
+		endStream();
+	}
+
+	result->put(startpos, flags);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceMysql::endStream()
+{
+	if(pStreamResult_)
+	{
+		// mysql_use_resultҪִһ֮ǰеУfreeᶪʣ
+		mysql_free_result(pStreamResult_);
+		pStreamResult_ = NULL;
+	}
+
+	streamFieldTypes_.clear();
+	streamHeaderSent_ = false;
+
+	drainResults();
+}
+
+//-------------------------------------------------------------------------------------
+mysql::DBStmt* DBInterfaceMysql::getStmt(const std::string& key, const std::string& sql)
+{
+	if(!usePreparedStatements_ || pMysql_ == NULL)
+		return NULL;
+
+	STMTS::iterator iter = stmts_.find(key);
+	if(iter != stmts_.end())
+		return iter->second->isPrepared() ? iter->second : NULL;
+
+	mysql::DBStmt* pStmt = new mysql::DBStmt(this, sql);
+	stmts_[key] = pStmt;
+
+	querystatistics("STMT_PREPARE", strlen("STMT_PREPARE"));
+
+	// ʧ֮ܵͬǰظ
+	if(!pStmt->prepare())
+	{
+		WARNING_MSG(fmt::format("DBInterfaceMysql::getStmt: prepare({}) failed, fallback to text protocol!\n", key));
+		return NULL;
+	}
+
+	return pStmt;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceMysql::clearStmts()
+{
+	STMTS::iterator iter = stmts_.begin();
+	for(; iter != stmts_.end(); ++iter)
+		delete iter->second;
+
+	stmts_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::executeStmt(mysql::DBStmt* pStmt, bool printlog)
+{
+	KBE_ASSERT(pStmt != NULL);
+
+	querystatistics(pStmt->sql().c_str(), (uint32)pStmt->sql().size());
+	querystatistics("STMT_EXECUTE", strlen("STMT_EXECUTE"));
+
+	lastquery_ = pStmt->sql();
+
+	if(_g_debug)
+	{
+		DEBUG_MSG(fmt::format("DBInterfaceMysql::executeStmt({:p}): {}\n", (void*)this, lastquery_));
+	}
+
+	if(!pStmt->execute())
+	{
+		if(printlog)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceMysql::executeStmt: error({}:{})!\nsql:({})\n", 
+				pStmt->getLastErrorNum(), pStmt->getLastError(), lastquery_)); 
+		}
+
+		mysql::DBException e(NULL);
+		e.setError(pStmt->getLastError(), pStmt->getLastErrorNum());
+
+		if (e.isLostConnection())
+		{
+			this->hasLostConnection(true);
+		}
+
+		throwError(&e);
+		return false;
+	}
+
+	if(printlog)
+	{
+		INFO_MSG("DBInterfaceMysql::executeStmt: successfully!\n"); 
+	}
+
 	return true;
 }
 
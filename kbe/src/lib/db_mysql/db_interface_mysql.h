@@ -66,6 +66,7 @@ struct MYSQL_TABLE_FIELD
 namespace mysql
 {
 	class DBException;
+	class DBStmt;
 }
 
 /*
@@ -99,6 +100,16 @@ public:
 	bool hasLostConnection() const		{ return hasLostConnection_; }
 	void hasLostConnection( bool v )	{ hasLostConnection_ = v; }
 
+	/**
+		Ƿ˶(ʱCLIENT_MULTI_STATEMENTSںϲȡʵӱ)
+	*/
+	bool multiStatements() const		{ return pMysql_ != NULL && multiStatements_; }
+
+	/**
+		ǰ仹δȡĺ(洢)ʹӱͬʱfalse
+	*/
+	bool drainResults();
+
 	/**
 		黷
 	*/
@@ -114,6 +125,28 @@ public:
 
 	bool write_query_result(MemoryStream * result);
 
+	virtual bool queryStream(const char* cmd, uint32 size);
+	virtual bool fetchStream(MemoryStream* result, uint32 maxRows, uint32 maxBytes, bool& finished);
+	virtual void endStream();
+	virtual void abortStream();
+
+	/**
+		ͨһִKILL QUERYֹǰִе䣬ӱȻ
+	*/
+	bool killQuery();
+
+	/**
+		ȡһڵǰϵԤ䣬keyͨΪ":"
+		δԤprepareʧ򷵻NULLҪ˵ıʽѯ
+	*/
+	mysql::DBStmt* getStmt(const std::string& key, const std::string& sql);
+	void clearStmts();
+
+	/**
+		ִһԤ䣬ʧʱqueryһ׳쳣
+	*/
+	bool executeStmt(mysql::DBStmt* pStmt, bool printlog = true);
+
 	/**
 		ȡݿеı
 	*/
@@ -206,6 +239,8 @@ protected:
 
 	bool inTransaction_;
 
+	bool multiStatements_;
+
 	mysql::DBTransaction lock_;
 
 	std::string characterSet_;
@@ -214,6 +249,16 @@ protected:
 	std::string autoIncrementOffset_;
 	std::string autoIncrementIncrement_;
 
+	// ǰѾprepare
+	typedef KBEUnordered_map<std::string, mysql::DBStmt*> STMTS;
+	STMTS stmts_;
+	bool usePreparedStatements_;
+
+	// ǰʽȡĽ
+	MYSQL_RES* pStreamResult_;
+	std::vector<uint8> streamFieldTypes_;
+	bool streamHeaderSent_;
+
 	static size_t sql_max_allowed_packet_;
 };
 
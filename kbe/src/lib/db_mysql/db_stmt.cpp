@@ -0,0 +1,447 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "db_stmt.h"
+#include "db_interface_mysql.h"
+#include "helper/debug_helper.h"
+
+namespace KBEngine { 
+namespace mysql {
+
+//-------------------------------------------------------------------------------------
+DBStmt::DBStmt(DBInterfaceMysql* pdbi, const std::string& sql):
+	pdbi_(pdbi),
+	pStmt_(NULL),
+	pMeta_(NULL),
+	sql_(sql),
+	params_(),
+	paramBinds_(),
+	columns_(),
+	resultBinds_(),
+	hasResult_(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt::~DBStmt()
+{
+	freeResult();
+
+	if(pMeta_)
+	{
+		mysql_free_result(pMeta_);
+		pMeta_ = NULL;
+	}
+
+	if(pStmt_)
+	{
+		mysql_stmt_close(pStmt_);
+		pStmt_ = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool DBStmt::prepare()
+{
+	if(pStmt_)
+		return true;
+
+	if(pdbi_->mysql() == NULL)
+		return false;
+
+	pStmt_ = mysql_stmt_init(pdbi_->mysql());
+	if(pStmt_ == NULL)
+		return false;
+
+	if(mysql_stmt_prepare(pStmt_, sql_.c_str(), (unsigned long)sql_.size()) != 0)
+	{
+		WARNING_MSG(fmt::format("DBStmt::prepare: error({}:{})!\nsql:({})\n", 
+			mysql_stmt_errno(pStmt_), mysql_stmt_error(pStmt_), sql_));
+
+		mysql_stmt_close(pStmt_);
+		pStmt_ = NULL;
+		return false;
+	}
+
+	// store_resultÿһе󳤶ȣԱһηл
+	stmt_bool updateMaxLength = 1;
+	mysql_stmt_attr_set(pStmt_, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+
+	pMeta_ = mysql_stmt_result_metadata(pStmt_);
+
+	if(pMeta_)
+	{
+		uint32 nfields = (uint32)mysql_num_fields(pMeta_);
+		columns_.resize(nfields);
+		resultBinds_.resize(nfields);
+	}
+
+	params_.reserve(mysql_stmt_param_count(pStmt_));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void DBStmt::clearParams()
+{
+	params_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt::PARAM& DBStmt::addParam(enum_field_types type, bool isUnsigned)
+{
+	params_.push_back(PARAM());
+
+	PARAM& param = params_.back();
+	param.type = type;
+	param.isUnsigned = isUnsigned;
+	param.isNull = false;
+	param.val.i = 0;
+	param.length = 0;
+	return param;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(int32 v)
+{
+	addParam(MYSQL_TYPE_LONG, false).val.i32 = v;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(uint32 v)
+{
+	addParam(MYSQL_TYPE_LONG, true).val.i32 = (int32)v;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(int64 v)
+{
+	addParam(MYSQL_TYPE_LONGLONG, false).val.i = v;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(uint64 v)
+{
+	addParam(MYSQL_TYPE_LONGLONG, true).val.i = (int64)v;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(double v)
+{
+	addParam(MYSQL_TYPE_DOUBLE, false).val.d = v;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bind(const std::string& v)
+{
+	PARAM& param = addParam(MYSQL_TYPE_STRING, false);
+	param.str = v;
+	param.length = (unsigned long)v.size();
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bindBlob(const char* data, size_t size)
+{
+	PARAM& param = addParam(MYSQL_TYPE_BLOB, false);
+	param.str.assign(data, size);
+	param.length = (unsigned long)size;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+DBStmt& DBStmt::bindNull()
+{
+	addParam(MYSQL_TYPE_NULL, false).isNull = true;
+	return *this;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBStmt::execute()
+{
+	KBE_ASSERT(pStmt_ != NULL);
+
+	freeResult();
+
+	if(params_.size() != mysql_stmt_param_count(pStmt_))
+	{
+		ERROR_MSG(fmt::format("DBStmt::execute: param count mismatch({} != {})!\nsql:({})\n", 
+			params_.size(), mysql_stmt_param_count(pStmt_), sql_));
+
+		return false;
+	}
+
+	if(params_.size() > 0)
+	{
+		// ȫָ֮룬vectorݵָʧЧ
+		paramBinds_.resize(params_.size());
+		memset(&paramBinds_[0], 0, sizeof(MYSQL_BIND) * paramBinds_.size());
+
+		for(size_t i = 0; i < params_.size(); ++i)
+		{
+			PARAM& param = params_[i];
+			MYSQL_BIND& b = paramBinds_[i];
+
+			b.buffer_type = param.type;
+			b.is_unsigned = param.isUnsigned;
+
+			if(param.type == MYSQL_TYPE_STRING || param.type == MYSQL_TYPE_BLOB)
+			{
+				b.buffer = (void*)param.str.data();
+				b.buffer_length = param.length;
+				b.length = &param.length;
+			}
+			else if(param.type != MYSQL_TYPE_NULL)
+			{
+				b.buffer = (void*)&param.val;
+			}
+		}
+
+		if(mysql_stmt_bind_param(pStmt_, &paramBinds_[0]) != 0)
+			return false;
+	}
+
+	if(mysql_stmt_execute(pStmt_) != 0)
+		return false;
+
+	if(pMeta_ == NULL)
+		return true;
+
+	if(mysql_stmt_store_result(pStmt_) != 0)
+		return false;
+
+	hasResult_ = true;
+	return bindResult();
+}
+
+//-------------------------------------------------------------------------------------
+bool DBStmt::bindResult()
+{
+	if(columns_.size() == 0)
+		return true;
+
+	MYSQL_FIELD* fields = mysql_fetch_fields(pMeta_);
+	memset(&resultBinds_[0], 0, sizeof(MYSQL_BIND) * resultBinds_.size());
+
+	for(size_t i = 0; i < columns_.size(); ++i)
+	{
+		COLUMN& col = columns_[i];
+		MYSQL_BIND& b = resultBinds_[i];
+		MYSQL_FIELD& field = fields[i];
+
+		col.fieldType = field.type;
+		col.isUnsigned = (field.flags & UNSIGNED_FLAG) > 0;
+		col.val.i = 0;
+		col.length = 0;
+		col.isNull = 0;
+		col.error = 0;
+
+		switch(field.type)
+		{
+		case MYSQL_TYPE_TINY:
+		case MYSQL_TYPE_SHORT:
+		case MYSQL_TYPE_INT24:
+		case MYSQL_TYPE_LONG:
+		case MYSQL_TYPE_LONGLONG:
+		case MYSQL_TYPE_YEAR:
+			// ͳһɷתΪ64λ
+			col.type = MYSQL_TYPE_LONGLONG;
+			b.buffer = (void*)&col.val;
+			break;
+		case MYSQL_TYPE_FLOAT:
+		case MYSQL_TYPE_DOUBLE:
+			col.type = MYSQL_TYPE_DOUBLE;
+			b.buffer = (void*)&col.val;
+			break;
+		default:
+			{
+				col.type = MYSQL_TYPE_BLOB;
+
+				size_t size = (size_t)field.max_length;
+				if(size == 0)
+					size = 1;
+
+				if(col.buffer.size() < size)
+					col.buffer.resize(size);
+
+				b.buffer = (void*)&col.buffer[0];
+				b.buffer_length = (unsigned long)col.buffer.size();
+			}
+			break;
+		};
+
+		b.buffer_type = col.type;
+		b.is_unsigned = col.isUnsigned;
+		b.length = &col.length;
+		b.is_null = &col.isNull;
+		b.error = &col.error;
+	}
+
+	return mysql_stmt_bind_result(pStmt_, &resultBinds_[0]) == 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBStmt::fetch()
+{
+	if(!hasResult_)
+		return false;
+
+	int ret = mysql_stmt_fetch(pStmt_);
+	return ret == 0 || ret == MYSQL_DATA_TRUNCATED;
+}
+
+//-------------------------------------------------------------------------------------
+void DBStmt::freeResult()
+{
+	if(!hasResult_)
+		return;
+
+	hasResult_ = false;
+	mysql_stmt_free_result(pStmt_);
+}
+
+//-------------------------------------------------------------------------------------
+bool DBStmt::isNull(uint32 idx) const
+{
+	KBE_ASSERT(idx < columns_.size());
+	return columns_[idx].isNull != 0;
+}
+
+//-------------------------------------------------------------------------------------
+int64 DBStmt::getInt64(uint32 idx) const
+{
+	KBE_ASSERT(idx < columns_.size());
+
+	const COLUMN& col = columns_[idx];
+	if(col.isNull)
+		return 0;
+
+	if(col.type == MYSQL_TYPE_LONGLONG)
+		return col.val.i;
+	else if(col.type == MYSQL_TYPE_DOUBLE)
+		return (int64)col.val.d;
+
+	int64 v = 0;
+	std::string s(col.buffer.data(), col.length);
+	StringConv::str2value(v, s.c_str());
+	return v;
+}
+
+//-------------------------------------------------------------------------------------
+uint64 DBStmt::getUInt64(uint32 idx) const
+{
+	KBE_ASSERT(idx < columns_.size());
+
+	const COLUMN& col = columns_[idx];
+	if(col.isNull)
+		return 0;
+
+	if(col.type == MYSQL_TYPE_LONGLONG)
+		return (uint64)col.val.i;
+	else if(col.type == MYSQL_TYPE_DOUBLE)
+		return (uint64)col.val.d;
+
+	uint64 v = 0;
+	std::string s(col.buffer.data(), col.length);
+	StringConv::str2value(v, s.c_str());
+	return v;
+}
+
+//-------------------------------------------------------------------------------------
+double DBStmt::getDouble(uint32 idx) const
+{
+	KBE_ASSERT(idx < columns_.size());
+
+	const COLUMN& col = columns_[idx];
+	if(col.isNull)
+		return 0.0;
+
+	if(col.type == MYSQL_TYPE_DOUBLE)
+		return col.val.d;
+	else if(col.type == MYSQL_TYPE_LONGLONG)
+		return col.isUnsigned ? (double)(uint64)col.val.i : (double)col.val.i;
+
+	double v = 0.0;
+	std::string s(col.buffer.data(), col.length);
+	StringConv::str2value(v, s.c_str());
+	return v;
+}
+
+//-------------------------------------------------------------------------------------
+void DBStmt::getString(uint32 idx, std::string& out) const
+{
+	KBE_ASSERT(idx < columns_.size());
+
+	const COLUMN& col = columns_[idx];
+	if(col.isNull)
+	{
+		out = "";
+		return;
+	}
+
+	if(col.type == MYSQL_TYPE_LONGLONG)
+		out = col.isUnsigned ? StringConv::val2str((uint64)col.val.i) : StringConv::val2str(col.val.i);
+	else if(col.type == MYSQL_TYPE_DOUBLE)
+	{
+		// 㹻Чλı֮ԭֵͬ
+		char buf[64];
+
+		if(col.fieldType == MYSQL_TYPE_FLOAT)
+			kbe_snprintf(buf, sizeof(buf), "%.9g", (double)(float)col.val.d);
+		else
+			kbe_snprintf(buf, sizeof(buf), "%.17g", col.val.d);
+
+		out = buf;
+	}
+	else
+		out.assign(col.buffer.data(), col.length);
+}
+
+//-------------------------------------------------------------------------------------
+uint64 DBStmt::affectedRows()
+{
+	return pStmt_ ? (uint64)mysql_stmt_affected_rows(pStmt_) : 0;
+}
+
+//-------------------------------------------------------------------------------------
+uint64 DBStmt::insertID()
+{
+	return pStmt_ ? (uint64)mysql_stmt_insert_id(pStmt_) : 0;
+}
+
+//-------------------------------------------------------------------------------------
+unsigned int DBStmt::getLastErrorNum()
+{
+	return pStmt_ ? mysql_stmt_errno(pStmt_) : 0;
+}
+
+//-------------------------------------------------------------------------------------
+const char* DBStmt::getLastError()
+{
+	return pStmt_ ? mysql_stmt_error(pStmt_) : "pStmt is NULL";
+}
+
+//-------------------------------------------------------------------------------------
+}
+}
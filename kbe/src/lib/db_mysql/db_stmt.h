@@ -0,0 +1,150 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_MYSQL_STMT_H
+#define KBE_MYSQL_STMT_H
+
+#include "common/common.h"
+#include "mysql/mysql.h"
+
+namespace KBEngine { 
+
+class DBInterfaceMysql;
+
+namespace mysql {
+
+// mysql8.0ʼͻ˿ⲻṩmy_bool
+#if defined(LIBMYSQL_VERSION_ID) && LIBMYSQL_VERSION_ID >= 80000 && !defined(MARIADB_BASE_VERSION)
+typedef bool stmt_bool;
+#else
+typedef my_bool stmt_bool;
+#endif
+
+/*
+	Ԥ
+	ֻڵһʹʱһΣ֮ԶЭ鴫䣬
+	ÿƴSQLתַԼеִı½
+	ÿDBInterfaceMysql(ÿ)һݣӶϿҪprepare
+*/
+class DBStmt
+{
+public:
+	struct PARAM
+	{
+		enum_field_types type;
+		bool isUnsigned;
+		bool isNull;
+		union
+		{
+			int32 i32;
+			int64 i;
+			double d;
+		} val;
+		std::string str;
+		unsigned long length;
+	};
+
+	struct COLUMN
+	{
+		enum_field_types type;
+		enum_field_types fieldType;
+		bool isUnsigned;
+		union
+		{
+			int64 i;
+			double d;
+		} val;
+		std::vector<char> buffer;
+		unsigned long length;
+		stmt_bool isNull;
+		stmt_bool error;
+	};
+
+	DBStmt(DBInterfaceMysql* pdbi, const std::string& sql);
+	~DBStmt();
+
+	bool prepare();
+	bool isPrepared() const { return pStmt_ != NULL; }
+
+	const std::string& sql() const { return sql_; }
+
+	/**
+		ռλ˳󶨲
+	*/
+	void clearParams();
+
+	DBStmt& bind(int32 v);
+	DBStmt& bind(uint32 v);
+	DBStmt& bind(int64 v);
+	DBStmt& bind(uint64 v);
+	DBStmt& bind(double v);
+	DBStmt& bind(const std::string& v);
+	DBStmt& bindBlob(const char* data, size_t size);
+	DBStmt& bindNull();
+
+	/**
+		ִ䣬ڽ򽫽浽ͻ˲󶨵л
+	*/
+	bool execute();
+
+	/**
+		ȡһ
+	*/
+	bool fetch();
+	void freeResult();
+
+	uint32 numColumns() const { return (uint32)columns_.size(); }
+
+	bool isNull(uint32 idx) const;
+	int64 getInt64(uint32 idx) const;
+	uint64 getUInt64(uint32 idx) const;
+	double getDouble(uint32 idx) const;
+	void getString(uint32 idx, std::string& out) const;
+
+	uint64 affectedRows();
+	uint64 insertID();
+
+	unsigned int getLastErrorNum();
+	const char* getLastError();
+
+protected:
+	PARAM& addParam(enum_field_types type, bool isUnsigned);
+	bool bindResult();
+
+protected:
+	DBInterfaceMysql* pdbi_;
+	MYSQL_STMT* pStmt_;
+	MYSQL_RES* pMeta_;
+
+	std::string sql_;
+
+	std::vector<PARAM> params_;
+	std::vector<MYSQL_BIND> paramBinds_;
+
+	std::vector<COLUMN> columns_;
+	std::vector<MYSQL_BIND> resultBinds_;
+
+	bool hasResult_;
+};
+
+}
+}
+
+#endif // KBE_MYSQL_STMT_H
@@ -990,9 +990,9 @@ void EntityTableItemMysql_VECTOR2::getWriteSqlItem(DBInterface* pdbi, MemoryStre
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->setDouble(v);
 #endif
 		
 		context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
@@ -1073,9 +1073,9 @@ void EntityTableItemMysql_VECTOR3::getWriteSqlItem(DBInterface* pdbi, MemoryStre
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->setDouble(v);
 #endif
 
 		context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
@@ -1156,9 +1156,9 @@ void EntityTableItemMysql_VECTOR4::getWriteSqlItem(DBInterface* pdbi, MemoryStre
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->setDouble(v);
 #endif
 
 		context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
@@ -1610,61 +1610,61 @@ void EntityTableItemMysql_DIGIT::getWriteSqlItem(DBInterface* pdbi, MemoryStream
 	{
 		int8 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 	}
 	else if(dataSType_ == "INT16")
 	{
 		int16 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 	}
 	else if(dataSType_ == "INT32")
 	{
 		int32 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->setInt(v);
 	}
 	else if(dataSType_ == "INT64")
 	{
 		int64 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%" PRI64, v);
+		pSotvs->setInt(v);
 	}
 	else if(dataSType_ == "UINT8")
 	{
 		uint8 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
+		pSotvs->setUInt(v);
 	}
 	else if(dataSType_ == "UINT16")
 	{
 		uint16 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
+		pSotvs->setUInt(v);
 	}
 	else if(dataSType_ == "UINT32")
 	{
 		uint32 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
+		pSotvs->setUInt(v);
 	}
 	else if(dataSType_ == "UINT64")
 	{
 		uint64 v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%" PRIu64, v);
+		pSotvs->setUInt(v);
 	}
 	else if(dataSType_ == "FLOAT")
 	{
 		float v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->setDouble(v);
 	}
 	else if(dataSType_ == "DOUBLE")
 	{
 		double v;
 		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%lf", v);
+		pSotvs->setDouble(v);
 	}
 
 	pSotvs->sqlkey = db_item_name();
@@ -1724,21 +1724,8 @@ void EntityTableItemMysql_STRING::getWriteSqlItem(DBInterface* pdbi,
 
 	std::string val;
 	(*s) >> val;
+	pSotvs->setString(val);
 
-	pSotvs->extraDatas = "\"";
-
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(pdbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs->sqlval, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
 }
@@ -1796,19 +1783,8 @@ void EntityTableItemMysql_UNICODE::getWriteSqlItem(DBInterface* pdbi, MemoryStre
 
 	std::string val;
 	s->readBlob(val);
+	pSotvs->setString(val);
 
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(pdbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-	
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs->sqlval, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
 }
@@ -1848,19 +1824,8 @@ void EntityTableItemMysql_BLOB::getWriteSqlItem(DBInterface* pdbi, MemoryStream*
 
 	std::string val;
 	s->readBlob(val);
+	pSotvs->setBlob(val);
 
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(pdbi)->mysql(), 
-		tbuf, val.data(), val.size());
-
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs->sqlval, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
 }
@@ -1900,19 +1865,8 @@ void EntityTableItemMysql_PYTHON::getWriteSqlItem(DBInterface* pdbi, MemoryStrea
 
 	std::string val;
 	s->readBlob(val);
+	pSotvs->setBlob(val);
 
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(pdbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs->sqlval, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	context.items.push_back(KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA>(pSotvs));
 }
@@ -22,6 +22,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "kbe_table_mysql.h"
 #include "db_exception.h"
 #include "db_interface_mysql.h"
+#include "db_stmt.h"
 #include "db_interface/db_interface.h"
 #include "db_interface/entity_table.h"
 #include "entitydef/entitydef.h"
@@ -162,6 +163,35 @@ bool KBEEntityLogTableMysql::syncToDB(DBInterface* pdbi)
 bool KBEEntityLogTableMysql::logEntity(DBInterface * pdbi, const char* ip, uint32 port, DBID dbid,
 					COMPONENT_ID componentID, ENTITY_ID entityID, ENTITY_SCRIPT_UID entityType)
 {
+	mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi)->getStmt(KBE_TABLE_PERFIX "_entitylog:insert", 
+		"insert into " KBE_TABLE_PERFIX "_entitylog (entityDBID, entityType, entityID, ip, port, componentID, serverGroupID) values(?,?,?,?,?,?,?)");
+
+	if (pStmt)
+	{
+		pStmt->clearParams();
+		pStmt->bind((uint64)dbid).bind((uint32)entityType).bind((int32)entityID).bind(std::string(ip))
+			.bind(port).bind((uint64)componentID).bind((uint64)getUserUID());
+
+		try
+		{
+			if (!static_cast<DBInterfaceMysql*>(pdbi)->executeStmt(pStmt, false))
+				return false;
+		}
+		catch (std::exception & e)
+		{
+			mysql::DBException& dbe = static_cast<mysql::DBException&>(e);
+			if (dbe.isLostConnection())
+			{
+				if (pdbi->processException(e))
+					return true;
+			}
+
+			return false;
+		}
+
+		return true;
+	}
+
 	std::string sqlstr = "insert into " KBE_TABLE_PERFIX "_entitylog (entityDBID, entityType, entityID, ip, port, componentID, serverGroupID) values(";
 
 	char* tbuf = new char[MAX_BUF * 3];
@@ -224,6 +254,40 @@ bool KBEEntityLogTableMysql::logEntity(DBInterface * pdbi, const char* ip, uint3
 //-------------------------------------------------------------------------------------
 bool KBEEntityLogTableMysql::queryEntity(DBInterface * pdbi, DBID dbid, EntityLog& entitylog, ENTITY_SCRIPT_UID entityType)
 {
+	entitylog.dbid = dbid;
+	entitylog.componentID = 0;
+	entitylog.serverGroupID = 0;
+	entitylog.entityID = 0;
+	entitylog.ip[0] = '\0';
+	entitylog.port = 0;
+
+	mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi)->getStmt(KBE_TABLE_PERFIX "_entitylog:query", 
+		"select entityID, ip, port, componentID, serverGroupID from " KBE_TABLE_PERFIX "_entitylog where entityDBID=? and entityType=? LIMIT 1");
+
+	if (pStmt)
+	{
+		pStmt->clearParams();
+		pStmt->bind((uint64)dbid).bind((uint32)entityType);
+
+		if (!static_cast<DBInterfaceMysql*>(pdbi)->executeStmt(pStmt, false))
+			return true;
+
+		if (pStmt->fetch())
+		{
+			std::string ipstr;
+			pStmt->getString(1, ipstr);
+
+			entitylog.entityID = (ENTITY_ID)pStmt->getInt64(0);
+			kbe_snprintf(entitylog.ip, MAX_IP, "%s", ipstr.c_str());
+			entitylog.port = (uint32)pStmt->getUInt64(2);
+			entitylog.componentID = pStmt->getUInt64(3);
+			entitylog.serverGroupID = pStmt->getUInt64(4);
+		}
+
+		pStmt->freeResult();
+		return entitylog.componentID > 0;
+	}
+
 	std::string sqlstr = "select entityID, ip, port, componentID, serverGroupID from " KBE_TABLE_PERFIX "_entitylog where entityDBID=";
 
 	char tbuf[MAX_BUF];
@@ -239,13 +303,6 @@ bool KBEEntityLogTableMysql::queryEntity(DBInterface * pdbi, DBID dbid, EntityLo
 	{
 		return true;
 	}
-	
-	entitylog.dbid = dbid;
-	entitylog.componentID = 0;
-	entitylog.serverGroupID = 0;
-	entitylog.entityID = 0;
-	entitylog.ip[0] = '\0';
-	entitylog.port = 0;
 
 	MYSQL_RES * pResult = mysql_store_result(static_cast<DBInterfaceMysql*>(pdbi)->mysql());
 	if(pResult)
@@ -269,6 +326,16 @@ bool KBEEntityLogTableMysql::queryEntity(DBInterface * pdbi, DBID dbid, EntityLo
 //-------------------------------------------------------------------------------------
 bool KBEEntityLogTableMysql::eraseEntityLog(DBInterface * pdbi, DBID dbid, ENTITY_SCRIPT_UID entityType)
 {
+	mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi)->getStmt(KBE_TABLE_PERFIX "_entitylog:erase", 
+		"delete from " KBE_TABLE_PERFIX "_entitylog where entityDBID=? and entityType=?");
+
+	if (pStmt)
+	{
+		pStmt->clearParams();
+		pStmt->bind((uint64)dbid).bind((uint32)entityType);
+		return static_cast<DBInterfaceMysql*>(pdbi)->executeStmt(pStmt, false);
+	}
+
 	std::string sqlstr = "delete from " KBE_TABLE_PERFIX "_entitylog where entityDBID=";
 
 	char tbuf[MAX_BUF];
@@ -646,6 +713,34 @@ bool KBEAccountTableMysql::setFlagsDeadline(DBInterface * pdbi, const std::strin
 //-------------------------------------------------------------------------------------
 bool KBEAccountTableMysql::queryAccount(DBInterface * pdbi, const std::string& name, ACCOUNT_INFOS& info)
 {
+	mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi)->getStmt(KBE_TABLE_PERFIX "_accountinfos:query", 
+		"select entityDBID, password, flags, deadline, bindata from " KBE_TABLE_PERFIX "_accountinfos where accountName=? or email=? LIMIT 1");
+
+	if (pStmt)
+	{
+		pStmt->clearParams();
+		pStmt->bind(name).bind(name);
+
+		// ѯʧ򷵻شڣ ܲĴ
+		if (!static_cast<DBInterfaceMysql*>(pdbi)->executeStmt(pStmt, false))
+			return true;
+
+		info.dbid = 0;
+
+		if (pStmt->fetch())
+		{
+			info.dbid = pStmt->getUInt64(0);
+			info.name = name;
+			pStmt->getString(1, info.password);
+			info.flags = (uint32)pStmt->getUInt64(2);
+			info.deadline = pStmt->getUInt64(3);
+			pStmt->getString(4, info.datas);
+		}
+
+		pStmt->freeResult();
+		return info.dbid > 0;
+	}
+
 	std::string sqlstr = "select entityDBID, password, flags, deadline, bindata from " KBE_TABLE_PERFIX "_accountinfos where accountName=\"";
 
 	char* tbuf = new char[name.size() * 2 + 1];
@@ -732,6 +827,16 @@ bool KBEAccountTableMysql::queryAccountAllInfos(DBInterface * pdbi, const std::s
 //-------------------------------------------------------------------------------------
 bool KBEAccountTableMysql::updateCount(DBInterface * pdbi, const std::string& name, DBID dbid)
 {
+	mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi)->getStmt(KBE_TABLE_PERFIX "_accountinfos:updateCount", 
+		"update " KBE_TABLE_PERFIX "_accountinfos set lasttime=?, numlogin=numlogin+1 where entityDBID=?");
+
+	if (pStmt)
+	{
+		pStmt->clearParams();
+		pStmt->bind((int64)time(NULL)).bind((uint64)dbid);
+		return static_cast<DBInterfaceMysql*>(pdbi)->executeStmt(pStmt, false);
+	}
+
 	// ѯʧ򷵻شڣ ܲĴ
 	if(!pdbi->query(fmt::format("update " KBE_TABLE_PERFIX "_accountinfos set lasttime={}, numlogin=numlogin+1 where entityDBID={}",
 		time(NULL), dbid), false))
@@ -39,6 +39,77 @@ namespace KBEngine{
 class ReadEntityHelper
 {
 public:
+	/**
+		ͬһҪѯӱԼÿӱӦĸdbids
+	*/
+	typedef std::vector< std::pair< mysql::DBContext*, std::vector<DBID> > > CHILD_QUERYS;
+
+	/**
+		ıЭĽ
+	*/
+	class ResultRows
+	{
+	public:
+		ResultRows(MYSQL_RES * pResult):
+		pResult_(pResult),
+		arow_(NULL),
+		lengths_(NULL)
+		{
+		}
+
+		bool next()
+		{
+			arow_ = mysql_fetch_row(pResult_);
+			if(arow_ == NULL)
+				return false;
+
+			lengths_ = mysql_fetch_lengths(pResult_);
+			return true;
+		}
+
+		uint32 numFields() const { return (uint32)mysql_num_fields(pResult_); }
+
+		DBID getDBID(uint32 idx) const
+		{
+			std::stringstream sval;
+			sval << arow_[idx];
+
+			DBID dbid = 0;
+			sval >> dbid;
+			return dbid;
+		}
+
+		void getData(uint32 idx, std::string& data) const
+		{
+			data.assign(arow_[idx], lengths_[idx]);
+		}
+
+	protected:
+		MYSQL_RES * pResult_;
+		MYSQL_ROW arow_;
+		unsigned long * lengths_;
+	};
+
+	/**
+		ԤĽԶƷأתΪıЭַͬ
+	*/
+	class StmtRows
+	{
+	public:
+		StmtRows(mysql::DBStmt* pStmt):
+		pStmt_(pStmt)
+		{
+		}
+
+		bool next() { return pStmt_->fetch(); }
+		uint32 numFields() const { return pStmt_->numColumns(); }
+		DBID getDBID(uint32 idx) const { return (DBID)pStmt_->getUInt64(idx); }
+		void getData(uint32 idx, std::string& data) const { pStmt_->getString(idx, data); }
+
+	protected:
+		mysql::DBStmt* pStmt_;
+	};
+
 	ReadEntityHelper()
 	{
 	}
@@ -49,227 +120,371 @@ public:
 
 	/**
 		ӱвѯ
+		ֱõӱͬһвѯ(ЩӱparentIDʵdbid)
+		֮ͬһǶϵӱٺϲΪһֻݶǶйأ
+		ӱԼԪص޹ء
 	*/
 	static bool queryDB(DBInterface* pdbi, mysql::DBContext& context)
 	{
-		// ĳdbidһűϵ
-		SqlStatement* pSqlcmd = new SqlStatementQuery(pdbi, context.tableName, 
-			context.dbids[context.dbid], 
-			context.dbid, context.items);
+		DBInterfaceMysql* pdbiMysql = static_cast<DBInterfaceMysql*>(pdbi);
 
-		bool ret = pSqlcmd->query();
-		context.dbid = pSqlcmd->dbid();
-		delete pSqlcmd;
-		
-		if(!ret)
-			return ret;
+		// Ѿ˶䣬ӱʱϲΪһ
+		bool multiStatements = context.optable.size() > 0 && pdbiMysql->multiStatements();
 
-		// ѯĽд
-		MYSQL_RES * pResult = mysql_store_result(static_cast<DBInterfaceMysql*>(pdbi)->mysql());
+		bool ret = false;
 
-		if(pResult)
+		try
 		{
-			MYSQL_ROW arow;
+			ret = queryDB_(pdbi, context, multiStatements);
+		}
+		catch (...)
+		{
+			// ʱ(׳쳣)δȡĽӻصк󱣳ͬ
+			pdbiMysql->drainResults();
+			throw;
+		}
 
-			while((arow = mysql_fetch_row(pResult)) != NULL)
-			{
-				uint32 nfields = (uint32)mysql_num_fields(pResult);
-				if(nfields <= 0)
-					continue;
+		if(!ret)
+			pdbiMysql->drainResults();
 
-				unsigned long *lengths = mysql_fetch_lengths(pResult);
+		return ret;
+	}
 
-				// ѯ֤˲ѯÿ¼dbid
-				std::stringstream sval;
-				sval << arow[0];
+protected:
+	static bool queryDB_(DBInterface* pdbi, mysql::DBContext& context, bool multiStatements)
+	{
+		DBInterfaceMysql* pdbiMysql = static_cast<DBInterfaceMysql*>(pdbi);
 
-				DBID item_dbid;
-				sval >> item_dbid;
+		// ĳdbidһűϵ
+		SqlStatementQuery sqlcmd(pdbi, context.tableName, 
+			context.dbids[context.dbid], 
+			context.dbid, context.items);
 
-				// dbid¼бУǰӱȥӱÿһdbidصļ¼
-				std::vector<DBID>& itemDBIDs = context.dbids[context.dbid];
-				int fidx = -100;
+		context.dbid = sqlcmd.dbid();
 
-				// ǰitemdbidСڸñһ¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
-				if (itemDBIDs.size() > 0 && itemDBIDs[itemDBIDs.size() - 1] > item_dbid)
-				{
-					for (fidx = itemDBIDs.size() - 1; fidx > 0; --fidx)
-					{
-						if (itemDBIDs[fidx] < item_dbid)
-							break;
-					}
+		CHILD_QUERYS childs;
+		mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
+		for(; iter1 != context.optable.end(); ++iter1)
+		{
+			childs.push_back(std::make_pair(iter1->second.get(), std::vector<DBID>(1, context.dbid)));
+		}
 
-					itemDBIDs.insert(itemDBIDs.begin() + fidx, item_dbid);
-				}
-				else
-				{
-					itemDBIDs.push_back(item_dbid);
-				}
+		// ûӱϲΪһʱԤѯ
+		mysql::DBStmt* pStmt = multiStatements ? NULL : sqlcmd.getStmt(pdbi);
 
-				// ¼dbid⻹ݣ䵽
-				if(nfields > 1)
-				{
-					std::vector<std::string>& itemResults = context.results[item_dbid].second;
-					context.results[item_dbid].first = 0;
+		if(pStmt)
+		{
+			if(!pdbiMysql->executeStmt(pStmt, false))
+				return false;
 
-					KBE_ASSERT(nfields == context.items.size() + 1);
+			StmtRows rows(pStmt);
+			readResult(context, rows);
+			pStmt->freeResult();
+		}
+		else
+		{
+			std::string sqlstr = sqlcmd.sql();
+			if(multiStatements)
+				appendChildQuerys(pdbi, childs, sqlstr);
 
-					for (uint32 i = 1; i < nfields; ++i)
-					{
-						KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = context.items[i - 1];
-						std::string data;
-						data.assign(arow[i], lengths[i]);
-
-						// dbidʱǲ뷽ʽôҲҪ뵽Ӧλ
-						if (fidx != -100)
-							itemResults.insert(itemResults.begin() + fidx++, data);
-						else
-							itemResults.push_back(data);
-					}
-				}
+			if(!pdbiMysql->query(sqlstr.c_str(), sqlstr.size(), false))
+			{
+				ERROR_MSG(fmt::format("ReadEntityHelper::queryDB: {}\n\tsql:{}\n", 
+					pdbi->getstrerror(), sqlstr));
+
+				return false;
 			}
 
-			mysql_free_result(pResult);
+			// ѯĽд
+			MYSQL_RES * pResult = mysql_store_result(pdbiMysql->mysql());
+
+			if(pResult)
+			{
+				ResultRows rows(pResult);
+				readResult(context, rows);
+				mysql_free_result(pResult);
+			}
 		}
-		
+
 		std::vector<DBID>& dbids = context.dbids[context.dbid];
 
 		// ûѯ
 		if(dbids.size() == 0)
+		{
+			// Ѿһ͵ӱѯ꣬ӻᴦڲͬ״̬
+			if(multiStatements)
+				return pdbiMysql->drainResults();
+
 			return true;
+		}
 
 		// ǰӱҪѯӱ
 		// ÿһdbidҪӱϵ
 		// ӱһβѯеdbidsȻ䵽
-
-		mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
-		for(; iter1 != context.optable.end(); ++iter1)
-		{
-			mysql::DBContext& wbox = *iter1->second.get();
-			if(!queryChildDB(pdbi, wbox, dbids))
-				return false;
-		}
-
-		return ret;
+		return queryChildDB(pdbi, childs, multiStatements, multiStatements);
 	}
 
-
+public:
 	/**
 		ӱвѯ
+		УÿһӱϲΪһ
+		resultsPendingΪtrueʾһĽѾ游Ĳѯһ𷵻أֻҪζȡ
 	*/
-	static bool queryChildDB(DBInterface* pdbi, mysql::DBContext& context, std::vector<DBID>& parentTableDBIDs)
+	static bool queryChildDB(DBInterface* pdbi, CHILD_QUERYS& childs, bool resultsPending, bool multiStatements)
 	{
-		// ĳdbidһűϵ
-		SqlStatement* pSqlcmd = new SqlStatementQuery(pdbi, context.tableName, 
-			parentTableDBIDs, 
-			context.dbid, context.items);
+		DBInterfaceMysql* pdbiMysql = static_cast<DBInterfaceMysql*>(pdbi);
 
-		bool ret = pSqlcmd->query();
-		context.dbid = pSqlcmd->dbid();
-		delete pSqlcmd;
-		
-		if(!ret)
-			return ret;
-
-		std::vector<DBID> t_parentTableDBIDs;
-
-		// ѯĽд
-		MYSQL_RES * pResult = mysql_store_result(static_cast<DBInterfaceMysql*>(pdbi)->mysql());
-
-		if(pResult)
+		while(childs.size() > 0)
 		{
-			MYSQL_ROW arow;
+			// ǰ֮ǰǷ(Ľ)Ҫ
+			bool advanceFirst = resultsPending;
 
-			while((arow = mysql_fetch_row(pResult)) != NULL)
+			if(!resultsPending && multiStatements)
 			{
-				uint32 nfields = (uint32)mysql_num_fields(pResult);
-				if(nfields <= 0)
-					continue;
+				std::string sqlstr;
+				appendChildQuerys(pdbi, childs, sqlstr);
 
-				unsigned long *lengths = mysql_fetch_lengths(pResult);
-
-				// ѯ֤˲ѯÿ¼dbid
-				std::stringstream sval;
-				sval << arow[0];
+				if(!pdbiMysql->query(sqlstr.c_str(), sqlstr.size(), false))
+				{
+					ERROR_MSG(fmt::format("ReadEntityHelper::queryChildDB: {}\n\tsql:{}\n", 
+						pdbi->getstrerror(), sqlstr));
 
-				DBID item_dbid;
-				sval >> item_dbid;
+					return false;
+				}
+			}
 
-				sval.clear();
-				sval << arow[1];
+			CHILD_QUERYS nextChilds;
 
-				DBID parentID;
-				sval >> parentID;
+			for(size_t i = 0; i < childs.size(); ++i)
+			{
+				mysql::DBContext& context = *childs[i].first;
 
-				// dbid¼бУǰӱȥӱÿһdbidصļ¼
-				std::vector<DBID>& itemDBIDs = context.dbids[parentID];
-				int fidx = -100;
+				std::vector<DBID> t_parentTableDBIDs;
+				bool readFromStmt = false;
 
-				// ǰitemdbidСڸñһ¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
-				if (itemDBIDs.size() > 0 && itemDBIDs[itemDBIDs.size() - 1] > item_dbid)
+				if(multiStatements)
 				{
-					for (fidx = itemDBIDs.size() - 1; fidx > 0; --fidx)
-					{
-						if (itemDBIDs[fidx] < item_dbid)
-							break;
-					}
-
-					itemDBIDs.insert(itemDBIDs.begin() + fidx, item_dbid);
-					t_parentTableDBIDs.insert(t_parentTableDBIDs.begin() + t_parentTableDBIDs.size() - (itemDBIDs.size() - fidx - 1), item_dbid);
+					if((i > 0 || advanceFirst) && !nextResult(pdbi))
+						return false;
 				}
 				else
 				{
-					itemDBIDs.push_back(item_dbid);
-					t_parentTableDBIDs.push_back(item_dbid);
-				}
+					SqlStatementQuery childcmd(pdbi, context.tableName, 
+						childs[i].second, context.dbid, context.items);
 
-				// ¼dbid⻹ݣ䵽
-				const uint32 const_fields = 2; // id, parentID
-				if(nfields > const_fields)
-				{
-					std::vector<std::string>& itemResults = context.results[item_dbid].second;
-					context.results[item_dbid].first = 0;
+					// ֻһdbidʱʹԤ
+					mysql::DBStmt* pStmt = childcmd.getStmt(pdbi);
 
-					KBE_ASSERT(nfields == context.items.size() + const_fields);
+					if(pStmt)
+					{
+						if(!pdbiMysql->executeStmt(pStmt, false))
+							return false;
 
-					for (uint32 i = const_fields; i < nfields; ++i)
+						StmtRows rows(pStmt);
+						readChildResult(context, rows, t_parentTableDBIDs);
+						pStmt->freeResult();
+						readFromStmt = true;
+					}
+					else if(!childcmd.query())
 					{
-						KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = context.items[i - const_fields];
-						std::string data;
-						data.assign(arow[i], lengths[i]);
-
-						// ǰitemdbidڸñм¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
-						if (fidx != -100)
-							itemResults.insert(itemResults.begin() + fidx++, data);
-						else
-							itemResults.push_back(data);
+						return false;
 					}
 				}
+
+				// ѯĽд
+				MYSQL_RES * pResult = readFromStmt ? NULL : mysql_store_result(pdbiMysql->mysql());
+
+				if(pResult)
+				{
+					ResultRows rows(pResult);
+					readChildResult(context, rows, t_parentTableDBIDs);
+					mysql_free_result(pResult);
+				}
+
+				// ûӱѯ
+				if(t_parentTableDBIDs.size() == 0)
+					continue;
+
+				// ǰӱҪһѯӱ
+				mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
+				for(; iter1 != context.optable.end(); ++iter1)
+				{
+					nextChilds.push_back(std::make_pair(iter1->second.get(), t_parentTableDBIDs));
+				}
 			}
 
-			mysql_free_result(pResult);
+			childs.swap(nextChilds);
+			resultsPending = false;
 		}
 
-		// ûѯ
-		if(t_parentTableDBIDs.size() == 0)
+		return true;
+	}
+
+protected:
+	/**
+		һӱĲѯƴΪһѯ
+	*/
+	static void appendChildQuerys(DBInterface* pdbi, CHILD_QUERYS& childs, std::string& sqlstr)
+	{
+		CHILD_QUERYS::iterator citer = childs.begin();
+		for(; citer != childs.end(); ++citer)
+		{
+			SqlStatementQuery childcmd(pdbi, citer->first->tableName, 
+				citer->second, citer->first->dbid, citer->first->items);
+
+			if(sqlstr.size() > 0)
+				sqlstr += ";";
+
+			sqlstr += childcmd.sql();
+		}
+	}
+
+	/**
+		лѯһ
+	*/
+	static bool nextResult(DBInterface* pdbi)
+	{
+		DBInterfaceMysql* pdbiMysql = static_cast<DBInterfaceMysql*>(pdbi);
+
+		int status = mysql_next_result(pdbiMysql->mysql());
+		if(status == 0)
 			return true;
 
-		// ǰӱҪѯӱ
-		// ÿһdbidҪӱϵ
-		// ӱһβѯеdbidsȻ䵽
-		mysql::DBContext::DB_RW_CONTEXTS::iterator iter1 = context.optable.begin();
-		for(; iter1 != context.optable.end(); ++iter1)
+		if(status > 0)
 		{
-			mysql::DBContext& wbox = *iter1->second.get();
+			ERROR_MSG(fmt::format("ReadEntityHelper::nextResult: {}\n\tsql:{}\n", 
+				pdbi->getstrerror(), pdbiMysql->lastquery()));
 
-			if(!queryChildDB(pdbi, wbox, t_parentTableDBIDs))
-				return false;
+			pdbiMysql->throwError(NULL);
+		}
+		else
+		{
+			ERROR_MSG(fmt::format("ReadEntityHelper::nextResult: missing result!\n\tsql:{}\n", 
+				pdbiMysql->lastquery()));
 		}
 
-		return ret;
+		return false;
 	}
 
-protected:
+	/**
+		Ĳѯд
+	*/
+	template<class ROWS>
+	static void readResult(mysql::DBContext& context, ROWS& rows)
+	{
+		while(rows.next())
+		{
+			uint32 nfields = rows.numFields();
+			if(nfields <= 0)
+				continue;
+
+			// ѯ֤˲ѯÿ¼dbid
+			DBID item_dbid = rows.getDBID(0);
+
+			// dbid¼бУǰӱȥӱÿһdbidصļ¼
+			std::vector<DBID>& itemDBIDs = context.dbids[context.dbid];
+			int fidx = -100;
+
+			// ǰitemdbidСڸñһ¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
+			if (itemDBIDs.size() > 0 && itemDBIDs[itemDBIDs.size() - 1] > item_dbid)
+			{
+				for (fidx = itemDBIDs.size() - 1; fidx > 0; --fidx)
+				{
+					if (itemDBIDs[fidx] < item_dbid)
+						break;
+				}
+
+				itemDBIDs.insert(itemDBIDs.begin() + fidx, item_dbid);
+			}
+			else
+			{
+				itemDBIDs.push_back(item_dbid);
+			}
+
+			// ¼dbid⻹ݣ䵽
+			if(nfields > 1)
+			{
+				std::vector<std::string>& itemResults = context.results[item_dbid].second;
+				context.results[item_dbid].first = 0;
+
+				KBE_ASSERT(nfields == context.items.size() + 1);
+
+				for (uint32 i = 1; i < nfields; ++i)
+				{
+					std::string data;
+					rows.getData(i, data);
+
+					// dbidʱǲ뷽ʽôҲҪ뵽Ӧλ
+					if (fidx != -100)
+						itemResults.insert(itemResults.begin() + fidx++, data);
+					else
+						itemResults.push_back(data);
+				}
+			}
+		}
+	}
+
+	/**
+		ӱĲѯдģt_parentTableDBIDsΪһӱҪĸdbids
+	*/
+	template<class ROWS>
+	static void readChildResult(mysql::DBContext& context, ROWS& rows, std::vector<DBID>& t_parentTableDBIDs)
+	{
+		while(rows.next())
+		{
+			uint32 nfields = rows.numFields();
+			if(nfields <= 0)
+				continue;
+
+			// ѯ֤˲ѯÿ¼dbid
+			DBID item_dbid = rows.getDBID(0);
+			DBID parentID = rows.getDBID(1);
+
+			// dbid¼бУǰӱȥӱÿһdbidصļ¼
+			std::vector<DBID>& itemDBIDs = context.dbids[parentID];
+			int fidx = -100;
+
+			// ǰitemdbidСڸñһ¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
+			if (itemDBIDs.size() > 0 && itemDBIDs[itemDBIDs.size() - 1] > item_dbid)
+			{
+				for (fidx = itemDBIDs.size() - 1; fidx > 0; --fidx)
+				{
+					if (itemDBIDs[fidx] < item_dbid)
+						break;
+				}
+
+				itemDBIDs.insert(itemDBIDs.begin() + fidx, item_dbid);
+				t_parentTableDBIDs.insert(t_parentTableDBIDs.begin() + t_parentTableDBIDs.size() - (itemDBIDs.size() - fidx - 1), item_dbid);
+			}
+			else
+			{
+				itemDBIDs.push_back(item_dbid);
+				t_parentTableDBIDs.push_back(item_dbid);
+			}
+
+			// ¼dbid⻹ݣ䵽
+			const uint32 const_fields = 2; // id, parentID
+			if(nfields > const_fields)
+			{
+				std::vector<std::string>& itemResults = context.results[item_dbid].second;
+				context.results[item_dbid].first = 0;
+
+				KBE_ASSERT(nfields == context.items.size() + const_fields);
+
+				for (uint32 i = const_fields; i < nfields; ++i)
+				{
+					std::string data;
+					rows.getData(i, data);
+
+					// ǰitemdbidڸñм¼dbidСôҪitemDBIDsָλòdbidԱ֤С˳
+					if (fidx != -100)
+						itemResults.insert(itemResults.begin() + fidx++, data);
+					else
+						itemResults.push_back(data);
+				}
+			}
+		}
+	}
 };
 
 }
@@ -31,6 +31,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "db_interface/db_interface.h"
 #include "db_interface/entity_table.h"
 #include "db_interface_mysql.h"
+#include "db_stmt.h"
 
 namespace KBEngine{ 
 
@@ -84,59 +85,167 @@ protected:
 	DBInterface* pdbi_; 
 };
 
-class SqlStatementInsert : public SqlStatement
+/**
+	д
+	sqlstr_ΪռλʽsqlͬʱΪԤϻkey(ͬһűʽǹ̶)
+	ֵԶЭ󶨣ҪתҲҪָʽΪı
+	Ӳֻ֧ԤʧʱΪƴת֮sqlı
+*/
+class SqlStatementWrite : public SqlStatement
 {
 public:
-	SqlStatementInsert(DBInterface* pdbi, std::string tableName, DBID parentDBID, 
+	SqlStatementWrite(DBInterface* pdbi, std::string tableName, DBID parentDBID, 
 		DBID dbid, mysql::DBContext::DB_ITEM_DATAS& tableItemDatas) :
-	  SqlStatement(pdbi, tableName, parentDBID, dbid, tableItemDatas)
+	  SqlStatement(pdbi, tableName, parentDBID, dbid, tableItemDatas),
+	  insertID_(0)
 	{
-		// insert into tbl_Account (sm_accountName) values("fdsafsad\0\fdsfasfsa\0fdsafsda");
-		sqlstr_ = "insert into " ENTITY_TABLE_PERFIX "_";
-		sqlstr_ += tableName;
-		sqlstr_ += " (";
-		sqlstr1_ = ")  values(";
-		
-		if(parentDBID > 0)
+	}
+
+	virtual ~SqlStatementWrite()
+	{
+	}
+
+	virtual bool query(DBInterface* pdbi = NULL)
+	{
+		// ûݸ
+		if(sqlstr_ == "")
+			return true;
+
+		DBInterfaceMysql* pdbiMysql = static_cast<DBInterfaceMysql*>(pdbi != NULL ? pdbi : pdbi_);
+
+		mysql::DBStmt* pStmt = pdbiMysql->getStmt(sqlstr_, sqlstr_);
+		if(pStmt)
 		{
-			sqlstr_ += TABLE_PARENTID_CONST_STR;
-			sqlstr_ += ",";
-			
-			char strdbid[MAX_BUF];
-			kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, parentDBID);
-			sqlstr1_ += strdbid;
-			sqlstr1_ += ",";
+			pStmt->clearParams();
+			bindParams(pStmt);
+
+			if(!pdbiMysql->executeStmt(pStmt, false))
+			{
+				ERROR_MSG(fmt::format("SqlStatementWrite::query: {}\n\tsql:{}\n", 
+					pStmt->getLastError(), sqlstr_));
+
+				return false;
+			}
+
+			insertID_ = (DBID)pStmt->insertID();
+			return true;
 		}
 
-		mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas.begin();
-		for(; tableValIter != tableItemDatas.end(); ++tableValIter)
+		std::string sqlstr;
+		buildSql(pdbiMysql, sqlstr, false);
+
+		if(!pdbiMysql->query(sqlstr.c_str(), sqlstr.size(), false))
 		{
-			KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = (*tableValIter);
+			ERROR_MSG(fmt::format("SqlStatementWrite::query: {}\n\tsql:{}\n", 
+				pdbiMysql->getstrerror(), sqlstr));
+
+			return false;
+		}
 
-			if(dbid > 0)
+		insertID_ = (DBID)pdbiMysql->insertID();
+		return true;
+	}
+
+protected:
+	/**
+		sqlplaceholdersΪtrueʱֵ?
+	*/
+	virtual void buildSql(DBInterfaceMysql* pdbi, std::string& sqlstr, bool placeholders) = 0;
+
+	/**
+		buildSqlռλ˳󶨲
+	*/
+	virtual void bindParams(mysql::DBStmt* pStmt) = 0;
+
+	static void appendValue(DBInterfaceMysql* pdbi, std::string& sqlstr, 
+		mysql::DBContext::DB_ITEM_DATA& item, bool placeholders)
+	{
+		if(placeholders)
+		{
+			sqlstr += "?";
+			return;
+		}
+
+		switch(item.bindType)
+		{
+		case mysql::DBContext::DB_ITEM_DATA::BIND_INT64:
+			sqlstr += fmt::format("{}", item.bindVal.i);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_UINT64:
+			sqlstr += fmt::format("{}", item.bindVal.u);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_DOUBLE:
 			{
+				// 㹻Чλ⾫ȶʧ
+				char strval[MAX_BUF];
+				kbe_snprintf(strval, MAX_BUF, "%.17g", item.bindVal.d);
+				sqlstr += strval;
 			}
-			else
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_STRING:
+		case mysql::DBContext::DB_ITEM_DATA::BIND_BLOB:
 			{
-				sqlstr_ += pSotvs->sqlkey;
-				if(pSotvs->extraDatas.size() > 0)
-					sqlstr1_ += pSotvs->extraDatas;
-				else
-					sqlstr1_ += pSotvs->sqlval;
-
-				sqlstr_ += ",";
-				sqlstr1_ += ",";
+				char* tbuf = new char[item.bindData.size() * 2 + 1];
+
+				mysql_real_escape_string(pdbi->mysql(), 
+					tbuf, item.bindData.data(), (unsigned long)item.bindData.size());
+
+				sqlstr += "\"";
+				sqlstr += tbuf;
+				sqlstr += "\"";
+				SAFE_RELEASE_ARRAY(tbuf);
 			}
-		}
-		
-		if(parentDBID > 0 || sqlstr_.at(sqlstr_.size() - 1) == ',')
-			sqlstr_.erase(sqlstr_.size() - 1);
+			break;
+		default:
+			if(item.extraDatas.size() > 0)
+				sqlstr += item.extraDatas;
+			else
+				sqlstr += item.sqlval;
+			break;
+		};
+	}
 
-		if(parentDBID > 0 || sqlstr1_.at(sqlstr1_.size() - 1) == ',')
-			sqlstr1_.erase(sqlstr1_.size() - 1);
+	static void bindValue(mysql::DBStmt* pStmt, mysql::DBContext::DB_ITEM_DATA& item)
+	{
+		switch(item.bindType)
+		{
+		case mysql::DBContext::DB_ITEM_DATA::BIND_INT64:
+			pStmt->bind(item.bindVal.i);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_UINT64:
+			pStmt->bind(item.bindVal.u);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_DOUBLE:
+			pStmt->bind(item.bindVal.d);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_STRING:
+			pStmt->bind(item.bindData);
+			break;
+		case mysql::DBContext::DB_ITEM_DATA::BIND_BLOB:
+			pStmt->bindBlob(item.bindData.data(), item.bindData.size());
+			break;
+		default:
+			// ûϢֵı룬ɷת
+			if(item.extraDatas.size() > 0)
+				pStmt->bind(item.extraDatas);
+			else
+				pStmt->bind(std::string(item.sqlval));
+			break;
+		};
+	}
 
-		sqlstr1_ += ")";
-		sqlstr_ += sqlstr1_;
+protected:
+	DBID insertID_;
+};
+
+class SqlStatementInsert : public SqlStatementWrite
+{
+public:
+	SqlStatementInsert(DBInterface* pdbi, std::string tableName, DBID parentDBID, 
+		DBID dbid, mysql::DBContext::DB_ITEM_DATAS& tableItemDatas) :
+	  SqlStatementWrite(pdbi, tableName, parentDBID, dbid, tableItemDatas)
+	{
+		buildSql(static_cast<DBInterfaceMysql*>(pdbi), sqlstr_, true);
 	}
 
 	virtual ~SqlStatementInsert()
@@ -149,7 +258,7 @@ public:
 		if(sqlstr_ == "")
 			return true;
 
-		bool ret = SqlStatement::query(pdbi);
+		bool ret = SqlStatementWrite::query(pdbi);
 		if(!ret)
 		{
 			ERROR_MSG(fmt::format("SqlStatementInsert::query: {}\n\tsql:{}\n",
@@ -158,20 +267,84 @@ public:
 			return false;
 		}
 
-		dbid_ = static_cast<DBInterfaceMysql*>(pdbi != NULL ? pdbi : pdbi_)->insertID();
+		dbid_ = insertID_;
 		return ret;
 	}
 
 protected:
-	std::string sqlstr1_;
+	virtual void buildSql(DBInterfaceMysql* pdbi, std::string& sqlstr, bool placeholders)
+	{
+		// insert into tbl_Account (sm_accountName) values("fdsafsad\0\fdsfasfsa\0fdsafsda");
+		sqlstr = "insert into " ENTITY_TABLE_PERFIX "_";
+		sqlstr += tableName_;
+		sqlstr += " (";
+
+		std::string sqlstr1 = ")  values(";
+		
+		if(parentDBID_ > 0)
+		{
+			sqlstr += TABLE_PARENTID_CONST_STR;
+			sqlstr += ",";
+			
+			if(placeholders)
+			{
+				sqlstr1 += "?";
+			}
+			else
+			{
+				char strdbid[MAX_BUF];
+				kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, parentDBID_);
+				sqlstr1 += strdbid;
+			}
+
+			sqlstr1 += ",";
+		}
+
+		if(dbid_ <= 0)
+		{
+			mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas_.begin();
+			for(; tableValIter != tableItemDatas_.end(); ++tableValIter)
+			{
+				KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = (*tableValIter);
+
+				sqlstr += pSotvs->sqlkey;
+				appendValue(pdbi, sqlstr1, *pSotvs, placeholders);
+
+				sqlstr += ",";
+				sqlstr1 += ",";
+			}
+		}
+		
+		if(parentDBID_ > 0 || sqlstr.at(sqlstr.size() - 1) == ',')
+			sqlstr.erase(sqlstr.size() - 1);
+
+		if(parentDBID_ > 0 || sqlstr1.at(sqlstr1.size() - 1) == ',')
+			sqlstr1.erase(sqlstr1.size() - 1);
+
+		sqlstr1 += ")";
+		sqlstr += sqlstr1;
+	}
+
+	virtual void bindParams(mysql::DBStmt* pStmt)
+	{
+		if(parentDBID_ > 0)
+			pStmt->bind((uint64)parentDBID_);
+
+		if(dbid_ > 0)
+			return;
+
+		mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas_.begin();
+		for(; tableValIter != tableItemDatas_.end(); ++tableValIter)
+			bindValue(pStmt, *(*tableValIter));
+	}
 };
 
-class SqlStatementUpdate : public SqlStatement
+class SqlStatementUpdate : public SqlStatementWrite
 {
 public:
 	SqlStatementUpdate(DBInterface* pdbi, std::string tableName, DBID parentDBID, 
 		DBID dbid, mysql::DBContext::DB_ITEM_DATAS& tableItemDatas) :
-	  SqlStatement(pdbi, tableName, parentDBID, dbid, tableItemDatas)
+	  SqlStatementWrite(pdbi, tableName, parentDBID, dbid, tableItemDatas)
 	{
 		if(tableItemDatas.size() == 0)
 		{
@@ -179,42 +352,57 @@ public:
 			return;
 		}
 
+		buildSql(static_cast<DBInterfaceMysql*>(pdbi), sqlstr_, true);
+	}
+
+	virtual ~SqlStatementUpdate()
+	{
+	}
+
+protected:
+	virtual void buildSql(DBInterfaceMysql* pdbi, std::string& sqlstr, bool placeholders)
+	{
 		// update tbl_Account set sm_accountName="fdsafsad" where id=123;
-		sqlstr_ = "update " ENTITY_TABLE_PERFIX "_";
-		sqlstr_ += tableName;
-		sqlstr_ += " set ";
+		sqlstr = "update " ENTITY_TABLE_PERFIX "_";
+		sqlstr += tableName_;
+		sqlstr += " set ";
 
-		mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas.begin();
-		for(; tableValIter != tableItemDatas.end(); ++tableValIter)
+		mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas_.begin();
+		for(; tableValIter != tableItemDatas_.end(); ++tableValIter)
 		{
 			KBEShared_ptr<mysql::DBContext::DB_ITEM_DATA> pSotvs = (*tableValIter);
 			
-			sqlstr_ += pSotvs->sqlkey;
-			sqlstr_ += "=";
-				
-			if(pSotvs->extraDatas.size() > 0)
-				sqlstr_ += pSotvs->extraDatas;
-			else
-				sqlstr_ += pSotvs->sqlval;
-
-			sqlstr_ += ",";
+			sqlstr += pSotvs->sqlkey;
+			sqlstr += "=";
+			appendValue(pdbi, sqlstr, *pSotvs, placeholders);
+			sqlstr += ",";
 		}
 
-		if(sqlstr_.at(sqlstr_.size() - 1) == ',')
-			sqlstr_.erase(sqlstr_.size() - 1);
+		if(sqlstr.at(sqlstr.size() - 1) == ',')
+			sqlstr.erase(sqlstr.size() - 1);
 
-		sqlstr_ += " where id=";
+		sqlstr += " where id=";
 		
-		char strdbid[MAX_BUF];
-		kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, dbid);
-		sqlstr_ += strdbid;
+		if(placeholders)
+		{
+			sqlstr += "?";
+		}
+		else
+		{
+			char strdbid[MAX_BUF];
+			kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, dbid_);
+			sqlstr += strdbid;
+		}
 	}
 
-	virtual ~SqlStatementUpdate()
+	virtual void bindParams(mysql::DBStmt* pStmt)
 	{
-	}
+		mysql::DBContext::DB_ITEM_DATAS::iterator tableValIter = tableItemDatas_.begin();
+		for(; tableValIter != tableItemDatas_.end(); ++tableValIter)
+			bindValue(pStmt, *(*tableValIter));
 
-protected:
+		pStmt->bind((uint64)dbid_);
+	}
 };
 
 class SqlStatementQuery : public SqlStatement
@@ -223,7 +411,9 @@ public:
 	SqlStatementQuery(DBInterface* pdbi, std::string tableName, const std::vector<DBID>& parentTableDBIDs, 
 		DBID dbid, mysql::DBContext::DB_ITEM_DATAS& tableItemDatas) :
 	  SqlStatement(pdbi, tableName, 0, dbid, tableItemDatas),
-	  sqlstr1_()
+	  sqlstr1_(),
+	  stmtsqlstr_(),
+	  stmtDBID_(0)
 	{
 
 		// select id,xxx from tbl_SpawnPoint where id=123;
@@ -234,8 +424,14 @@ public:
 		
 		char strdbid[MAX_BUF];
 
+		// ֻһֵʱͬʱռλʽ䣬ʹԤѯ
+		std::string stmtwhere;
+
 		if(parentTableDBIDs.size() == 0)
 		{
+			stmtwhere = " where id=?";
+			stmtDBID_ = dbid;
+
 			sqlstr1_ += " where id=";
 			kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, dbid);
 			sqlstr1_ += strdbid;
@@ -259,6 +455,9 @@ public:
 			}
 			else
 			{
+				stmtwhere = " where " TABLE_PARENTID_CONST_STR "=?";
+				stmtDBID_ = parentTableDBIDs[0];
+
 				sqlstr1_ += " where " TABLE_PARENTID_CONST_STR "=";
 				kbe_snprintf(strdbid, MAX_BUF, "%" PRDBID, parentTableDBIDs[0]);
 				sqlstr1_ += strdbid;
@@ -277,6 +476,14 @@ public:
 		if(sqlstr_.at(sqlstr_.size() - 1) == ',')
 			sqlstr_.erase(sqlstr_.size() - 1);
 
+		if(stmtwhere.size() > 0)
+		{
+			stmtsqlstr_ = sqlstr_;
+			stmtsqlstr_ += " from " ENTITY_TABLE_PERFIX "_";
+			stmtsqlstr_ += tableName;
+			stmtsqlstr_ += stmtwhere;
+		}
+
 		sqlstr_ += sqlstr1_;
 	}
 
@@ -284,8 +491,27 @@ public:
 	{
 	}
 
+	/**
+		ѰԤ䣬ʹԤʱNULLʱʹsql()ıѯ
+	*/
+	mysql::DBStmt* getStmt(DBInterface* pdbi = NULL)
+	{
+		if(stmtsqlstr_.size() == 0)
+			return NULL;
+
+		mysql::DBStmt* pStmt = static_cast<DBInterfaceMysql*>(pdbi != NULL ? pdbi : pdbi_)->getStmt(stmtsqlstr_, stmtsqlstr_);
+		if(pStmt == NULL)
+			return NULL;
+
+		pStmt->clearParams();
+		pStmt->bind((uint64)stmtDBID_);
+		return pStmt;
+	}
+
 protected:
 	std::string sqlstr1_;
+	std::string stmtsqlstr_;
+	DBID stmtDBID_;
 };
 
 }
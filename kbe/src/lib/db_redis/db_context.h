@@ -45,6 +45,7 @@ namespace redis {
 	optableӱṹ
 
 	resultsʱѯ, ݵжӦitemsеstrkeydbids
+	nullsresultsһһӦݿвֶʱΪtrue(ʵ浵֮)
 	readresultIdxΪresultsеdbids * itemsԵĳЩݹʱݻreadresultIdxλá
 
 	parentTableDBIDdbid
@@ -90,6 +91,7 @@ public:
 	
 	std::map<DBID, std::vector<DBID> > dbids;
 	std::vector< std::string >results;
+	std::vector< bool >nulls;
 	std::vector< std::string >::size_type readresultIdx;
 
 private:
@@ -417,6 +417,97 @@ bool DBInterfaceRedis::getQueryReply(redisReply **pRedisReply)
 	return redisGetReply(pRedisContext_, (void**)pRedisReply) == REDIS_OK;
 }
 
+//-------------------------------------------------------------------------------------
+bool DBInterfaceRedis::queryAppend(const std::vector<std::string>& args, bool printlog)
+{
+	KBE_ASSERT(pRedisContext_ && args.size() > 0);
+
+	std::vector<const char*> argv(args.size());
+	std::vector<size_t> argvlen(args.size());
+
+	for(size_t i = 0; i < args.size(); ++i)
+	{
+		argv[i] = args[i].data();
+		argvlen[i] = args[i].size();
+	}
+
+	int ret = redisAppendCommandArgv(pRedisContext_, (int)args.size(), &argv[0], &argvlen[0]);
+
+	// ֵǶݣֻ¼key
+	std::string cmd = args[0];
+	if(args.size() > 1)
+	{
+		cmd += " ";
+		cmd += args[1];
+	}
+
+	if(lastquery_.size() > 0 && lastquery_[lastquery_.size() - 1] != ';')
+		lastquery_ = "";
+
+	lastquery_ += cmd;
+	lastquery_ += ";";
+	RedisWatcher::querystatistics(cmd.c_str(), (uint32)cmd.size());
+
+	if (ret == REDIS_ERR) 
+	{	
+		if(printlog)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::queryAppend: cmd={}, errno={}, error={}\n",
+				lastquery_, pRedisContext_->err, pRedisContext_->errstr));
+		}
+
+		this->throwError(NULL);
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceRedis::getQueryReplies(size_t count, std::vector<redisReply*>& replies)
+{
+	KBE_ASSERT(pRedisContext_);
+
+	bool ret = true;
+
+	for(size_t i = 0; i < count; ++i)
+	{
+		redisReply* pRedisReply = NULL;
+
+		if(redisGetReply(pRedisContext_, (void**)&pRedisReply) != REDIS_OK || pRedisReply == NULL)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::getQueryReplies: cmd={}, errno={}, error={}\n",
+				lastquery_, pRedisContext_->err, pRedisContext_->errstr));
+
+			freeReplies(replies);
+			this->throwError(NULL);
+			return false;
+		}
+
+		if(pRedisReply->type == REDIS_REPLY_ERROR)
+		{
+			ERROR_MSG(fmt::format("DBInterfaceRedis::getQueryReplies: cmd={}, error={}\n",
+				lastquery_, pRedisReply->str));
+
+			ret = false;
+		}
+
+		replies.push_back(pRedisReply);
+	}
+
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceRedis::freeReplies(std::vector<redisReply*>& replies)
+{
+	std::vector<redisReply*>::iterator iter = replies.begin();
+	for(; iter != replies.end(); ++iter)
+		freeReplyObject((*iter));
+
+	replies.clear();
+}
+
 //-------------------------------------------------------------------------------------
 void DBInterfaceRedis::write_query_result(redisReply* pRedisReply, MemoryStream * result)
 {
@@ -114,6 +114,17 @@ public:
 	bool query(bool printlog, const char* format, ...);
 	bool queryAppend(bool printlog, const char* format, ...);
 	bool getQueryReply(redisReply **pRedisReply);
+
+	/**
+		Բķʽ׷һܵУǶ
+	*/
+	bool queryAppend(const std::vector<std::string>& args, bool printlog = true);
+
+	/**
+		һȡعܵcountĽҪfreeRepliesͷ
+	*/
+	bool getQueryReplies(size_t count, std::vector<redisReply*>& replies);
+	static void freeReplies(std::vector<redisReply*>& replies);
 	
 	void write_query_result(redisReply* pRedisReply, MemoryStream * result);
 	void write_query_result_element(redisReply* pRedisReply, MemoryStream * result);
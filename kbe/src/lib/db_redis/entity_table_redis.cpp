@@ -20,8 +20,11 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "entity_table_redis.h"
 #include "kbe_table_redis.h"
+#include "db_interface_redis.h"
+#include "redis_helper.h"
 #include "entitydef/scriptdef_module.h"
 #include "entitydef/property.h"
+#include "entitydef/datatype.h"
 #include "db_interface/db_interface.h"
 #include "db_interface/entity_table.h"
 #include "network/fixed_messages.h"
@@ -119,22 +122,26 @@ bool EntityTableRedis::initialize(ScriptDefModule* sm, std::string name)
 //-------------------------------------------------------------------------------------
 void EntityTableRedis::init_db_item_name()
 {
+	// redisfixedDictһֶУҪmysqlչֶ
 	EntityTable::TABLEITEM_MAP::iterator iter = tableItems_.begin();
 	for(; iter != tableItems_.end(); ++iter)
 	{
-		// fixedDictֶƵ
-		std::string exstrFlag = "";
-		if(iter->second->type() == TABLE_ITEM_TYPE_FIXEDDICT)
-		{
-			exstrFlag = iter->second->itemName();
-			if(exstrFlag.size() > 0)
-				exstrFlag += "_";
-		}
-
-		static_cast<EntityTableItemRedisBase*>(iter->second.get())->init_db_item_name(exstrFlag.c_str());
+		static_cast<EntityTableItemRedisBase*>(iter->second.get())->init_db_item_name();
 	}
 }
 
+//-------------------------------------------------------------------------------------
+std::string EntityTableRedis::entityKey(DBID dbid)
+{
+	return fmt::format(ENTITY_TABLE_PERFIX "_{}:{}", tableName(), dbid);
+}
+
+//-------------------------------------------------------------------------------------
+std::string EntityTableRedis::autoLoadKey()
+{
+	return fmt::format(ENTITY_TABLE_PERFIX "_{}_" TABLE_AUTOLOAD_CONST_STR, tableName());
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTableRedis::syncIndexToDB(DBInterface* pdbi)
 {
@@ -147,62 +154,8 @@ bool EntityTableRedis::syncToDB(DBInterface* pdbi)
 	if (hasSync())
 		return true;
 
-	// DEBUG_MSG(fmt::format("EntityTableRedis::syncToDB(): {}.\n", tableName()));
-
 	// redisҪһʼдʱŲݣﲻҪ
-	// ȡǰitemsÿitemǷ뵱ǰƥ䣬ͬΪǰ
-
-	//DBInterfaceRedis::TABLE_FIELDS outs;
-	//static_cast<DBInterfaceRedis*>(pdbi)->getFields(outs, this->tableName());
-
-	//sync_item_to_db(pdbi, "tinyint not null DEFAULT 0", this->tableName(), TABLE_ITEM_PERFIX"_" TABLE_AUTOLOAD_CONST_STR, 0,
-	//	FIELD_TYPE_TINY, NOT_NULL_FLAG, (void*)&outs, &sync_autoload_item_index);
-
-	EntityTable::TABLEITEM_MAP::iterator iter = tableItems_.begin();
-	for (; iter != tableItems_.end(); ++iter)
-	{
-	//	if (!iter->second->syncToDB(pdbi, (void*)&outs))
-	//		return false;
-	}
-
-	std::vector<std::string> dbTableItemNames;
-
-	std::string ttablename = ENTITY_TABLE_PERFIX"_";
-	ttablename += tableName();
-
-	pdbi->getTableItemNames(ttablename.c_str(), dbTableItemNames);
-
-	// ǷҪɾıֶ
-	std::vector<std::string>::iterator iter0 = dbTableItemNames.begin();
-	for (; iter0 != dbTableItemNames.end(); ++iter0)
-	{
-		std::string tname = (*iter0);
-
-		if (tname == TABLE_ID_CONST_STR ||
-			tname == TABLE_ITEM_PERFIX"_" TABLE_AUTOLOAD_CONST_STR ||
-			tname == TABLE_PARENTID_CONST_STR)
-		{
-			continue;
-		}
-
-		EntityTable::TABLEITEM_MAP::iterator iter = tableItems_.begin();
-		bool found = false;
-
-		for (; iter != tableItems_.end(); ++iter)
-		{
-			if (iter->second->isSameKey(tname))
-			{
-				found = true;
-				break;
-			}
-		}
-
-		if (!found)
-		{
-			if (!pdbi->dropEntityTableItemFromDB(ttablename.c_str(), tname.c_str()))
-				return false;
-		}
-	}
+	// ʵѾɾڶȡʱᱻԣ´дʱٲֶ
 
 	// ͬ
 	if (!syncIndexToDB(pdbi))
@@ -216,6 +169,30 @@ bool EntityTableRedis::syncToDB(DBInterface* pdbi)
 void EntityTableRedis::queryAutoLoadEntities(DBInterface* pdbi, ScriptDefModule* pModule, 
 		ENTITY_ID start, ENTITY_ID end, std::vector<DBID>& outs)
 {
+	if(end <= start)
+		return;
+
+	redisReply* pRedisReply = NULL;
+
+	if(!static_cast<DBInterfaceRedis*>(pdbi)->query(fmt::format("ZRANGE {} {} {}", 
+		autoLoadKey(), start, end - 1), &pRedisReply, false))
+		return;
+
+	if(pRedisReply)
+	{
+		if(pRedisReply->type == REDIS_REPLY_ARRAY)
+		{
+			for(size_t i = 0; i < pRedisReply->elements; ++i)
+			{
+				DBID dbid = 0;
+				StringConv::str2value(dbid, pRedisReply->element[i]->str);
+				if(dbid > 0)
+					outs.push_back(dbid);
+			}
+		}
+
+		freeReplyObject(pRedisReply);
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -333,368 +310,698 @@ EntityTableItem* EntityTableRedis::createItem(std::string type, std::string defa
 	return new EntityTableItemRedis_STRING("", 0, 0);
 }
 
+//-------------------------------------------------------------------------------------
+void EntityTableRedis::appendAutoLoad(DBInterfaceRedis* pdbi, DBID dbid, bool shouldAutoLoad, size_t& nreplies)
+{
+	std::vector<std::string> args;
+	args.push_back(shouldAutoLoad ? "ZADD" : "ZREM");
+	args.push_back(autoLoadKey());
+
+	if(shouldAutoLoad)
+		args.push_back(fmt::format("{}", dbid));
+
+	args.push_back(fmt::format("{}", dbid));
+	pdbi->queryAppend(args, false);
+	++nreplies;
+}
+
 //-------------------------------------------------------------------------------------
 void EntityTableRedis::entityShouldAutoLoad(DBInterface* pdbi, DBID dbid, bool shouldAutoLoad)
 {
 	if(dbid == 0)
 		return;
 
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+	size_t nreplies = 0;
+
+	std::vector<std::string> args;
+	args.push_back("HSET");
+	args.push_back(entityKey(dbid));
+	args.push_back(TABLE_ITEM_PERFIX "_" TABLE_AUTOLOAD_CONST_STR);
+	args.push_back(shouldAutoLoad ? "1" : "0");
+	pdbiRedis->queryAppend(args, false);
+	++nreplies;
+
+	appendAutoLoad(pdbiRedis, dbid, shouldAutoLoad, nreplies);
+
+	std::vector<redisReply*> replies;
+	pdbiRedis->getQueryReplies(nreplies, replies);
+	DBInterfaceRedis::freeReplies(replies);
 }
 
 //-------------------------------------------------------------------------------------
 DBID EntityTableRedis::writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule)
 {
-	return 0;
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+
+	redis::DBContext context;
+	context.parentTableName = "";
+	context.parentTableDBID = 0;
+	context.dbid = dbid;
+	context.tableName = pModule->getName();
+	context.isEmpty = false;
+	context.readresultIdx = 0;
+
+	while(s->length() > 0)
+	{
+		ENTITY_PROPERTY_UID pid;
+		(*s) >> pid;
+		
+		EntityTableItem* pTableItem = this->findItem(pid);
+		if(pTableItem == NULL)
+		{
+			ERROR_MSG(fmt::format("EntityTableRedis::writeTable: not found item[{}].\n", pid));
+			return dbid;
+		}
+		
+		static_cast<EntityTableItemRedisBase*>(pTableItem)->getWriteSqlItem(pdbi, s, context);
+	};
+
+	// ʵȷһdbidдʱΨһҪȴ
+	bool isInsert = (dbid == 0);
+	if(isInsert)
+	{
+		redisReply* pRedisReply = NULL;
+
+		if(!pdbiRedis->query(fmt::format("INCR " ENTITY_TABLE_PERFIX "_{}_Auto_increment", tableName()), 
+			&pRedisReply, false))
+			return 0;
+
+		if(pRedisReply)
+		{
+			if(pRedisReply->type == REDIS_REPLY_INTEGER)
+				dbid = (DBID)pRedisReply->integer;
+
+			freeReplyObject(pRedisReply);
+		}
+
+		if(dbid <= 0)
+			return 0;
+
+		// ʵһдԶرǣѯʱжʵǷ
+		if(shouldAutoLoad < 0)
+			shouldAutoLoad = 0;
+	}
+
+	// һͨܵһηֻȴһ
+	size_t nreplies = 0;
+	std::vector<std::string> args;
+
+	args.push_back("MULTI");
+	pdbiRedis->queryAppend(args, false);
+	++nreplies;
+
+	args.clear();
+	args.push_back("HMSET");
+	args.push_back(entityKey(dbid));
+
+	if(shouldAutoLoad > -1)
+	{
+		args.push_back(TABLE_ITEM_PERFIX "_" TABLE_AUTOLOAD_CONST_STR);
+		args.push_back(shouldAutoLoad > 0 ? "1" : "0");
+	}
+
+	redis::DBContext::DB_ITEM_DATAS::iterator iter = context.items.begin();
+	for(; iter != context.items.end(); ++iter)
+	{
+		args.push_back((*iter)->sqlkey);
+		args.push_back((*iter)->extraDatas);
+	}
+
+	if(args.size() > 2)
+	{
+		pdbiRedis->queryAppend(args, false);
+		++nreplies;
+	}
+
+	// 滻Ӧlists
+	redis::DBContext::DB_RW_CONTEXTS::iterator optiter = context.optable.begin();
+	for(; optiter != context.optable.end(); ++optiter)
+	{
+		std::string listKey = fmt::format("{}:{}", optiter->first, dbid);
+
+		args.clear();
+		args.push_back("DEL");
+		args.push_back(listKey);
+		pdbiRedis->queryAppend(args, false);
+		++nreplies;
+
+		redis::DBContext& arrayContext = *optiter->second.get();
+		if(arrayContext.results.size() == 0)
+			continue;
+
+		args.clear();
+		args.push_back("RPUSH");
+		args.push_back(listKey);
+		args.insert(args.end(), arrayContext.results.begin(), arrayContext.results.end());
+		pdbiRedis->queryAppend(args, false);
+		++nreplies;
+	}
+
+	if(shouldAutoLoad > -1)
+		appendAutoLoad(pdbiRedis, dbid, shouldAutoLoad > 0, nreplies);
+
+	args.clear();
+	args.push_back("EXEC");
+	pdbiRedis->queryAppend(args, false);
+	++nreplies;
+
+	std::vector<redisReply*> replies;
+	bool ret = pdbiRedis->getQueryReplies(nreplies, replies);
+
+	// κһʧEXEC᷵
+	if(!ret || replies.size() != nreplies || replies[nreplies - 1]->type != REDIS_REPLY_ARRAY)
+	{
+		ERROR_MSG(fmt::format("EntityTableRedis::writeTable: write {} failed! dbid={}\n", 
+			entityKey(dbid), dbid));
+
+		DBInterfaceRedis::freeReplies(replies);
+		return 0;
+	}
+
+	DBInterfaceRedis::freeReplies(replies);
+	return dbid;
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableRedis::removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule)
 {
-	return true;
+	KBE_ASSERT(pModule && dbid > 0);
+
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
+	size_t nreplies = 0;
+
+	std::vector<std::string> args;
+	args.push_back("DEL");
+	args.push_back(entityKey(dbid));
+
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		if((*iter)->type() != TABLE_ITEM_TYPE_FIXEDARRAY)
+			continue;
+
+		args.push_back(fmt::format("{}:{}", 
+			static_cast<EntityTableItemRedis_ARRAY*>((*iter))->listName(), dbid));
+	}
+
+	pdbiRedis->queryAppend(args, false);
+	++nreplies;
+
+	appendAutoLoad(pdbiRedis, dbid, false, nreplies);
+
+	std::vector<redisReply*> replies;
+	bool ret = pdbiRedis->getQueryReplies(nreplies, replies);
+	DBInterfaceRedis::freeReplies(replies);
+	return ret;
 }
 
 //-------------------------------------------------------------------------------------
 bool EntityTableRedis::queryTable(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule)
 {
-	return true;
-}
+	KBE_ASSERT(pModule && s && dbid > 0);
 
-//-------------------------------------------------------------------------------------
-void EntityTableRedis::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
-{
-}
+	DBInterfaceRedis* pdbiRedis = static_cast<DBInterfaceRedis*>(pdbi);
 
-//-------------------------------------------------------------------------------------
-void EntityTableRedis::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
-{
-}
+	redis::DBContext context;
+	context.parentTableName = "";
+	context.parentTableDBID = 0;
+	context.dbid = dbid;
+	context.tableName = pModule->getName();
+	context.isEmpty = false;
+	context.readresultIdx = 0;
 
-//-------------------------------------------------------------------------------------
-void EntityTableRedis::getReadSqlItem(redis::DBContext& context)
-{
-}
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->getReadSqlItem(context);
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedisBase::init_db_item_name(const char* exstrFlag)
-{
-}
+	// һȡʵhashesԼlists
+	size_t nreplies = 0;
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR2::isSameKey(std::string key)
-{
-	return true;
-}
+	std::vector<std::string> args;
+	args.push_back("HMGET");
+	args.push_back(entityKey(dbid));
+	args.push_back(TABLE_ITEM_PERFIX "_" TABLE_AUTOLOAD_CONST_STR);
+	args.insert(args.end(), context.results.begin(), context.results.end());
+	pdbiRedis->queryAppend(args, false);
+	++nreplies;
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR2::syncToDB(DBInterface* pdbi, void* pData)
-{
-	return true;
-}
+	redis::DBContext::DB_RW_CONTEXTS::iterator optiter = context.optable.begin();
+	for(; optiter != context.optable.end(); ++optiter)
+	{
+		args.clear();
+		args.push_back("LRANGE");
+		args.push_back(fmt::format("{}:{}", optiter->first, dbid));
+		args.push_back("0");
+		args.push_back("-1");
+		pdbiRedis->queryAppend(args, false);
+		++nreplies;
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
-{
-}
+	std::vector<redisReply*> replies;
+	if(!pdbiRedis->getQueryReplies(nreplies, replies) || replies.size() != nreplies)
+	{
+		DBInterfaceRedis::freeReplies(replies);
+		return false;
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
-{
-	if(s == NULL)
-		return;
-}
+	redisReply* pRedisReply = replies[0];
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR2::getReadSqlItem(redis::DBContext& context)
-{
-}
+	// Զرʵ崴ʱһд룬˵ûʵ
+	if(pRedisReply->type != REDIS_REPLY_ARRAY || pRedisReply->elements != context.results.size() + 1 ||
+		pRedisReply->element[0]->type == REDIS_REPLY_NIL)
+	{
+		DBInterfaceRedis::freeReplies(replies);
+		return false;
+	}
+
+	context.results.clear();
+	context.nulls.clear();
+
+	for(size_t i = 1; i < pRedisReply->elements; ++i)
+	{
+		redisReply* pElement = pRedisReply->element[i];
+		bool isNull = (pElement->type != REDIS_REPLY_STRING);
+
+		context.nulls.push_back(isNull);
+		context.results.push_back(isNull ? std::string() : std::string(pElement->str, pElement->len));
+	}
+
+	size_t idx = 1;
+	optiter = context.optable.begin();
+	for(; optiter != context.optable.end(); ++optiter, ++idx)
+	{
+		redis::DBContext& arrayContext = *optiter->second.get();
+		pRedisReply = replies[idx];
+
+		if(pRedisReply->type != REDIS_REPLY_ARRAY)
+			continue;
+
+		for(size_t i = 0; i < pRedisReply->elements; ++i)
+		{
+			redisReply* pElement = pRedisReply->element[i];
+			arrayContext.results.push_back(std::string(pElement->str, pElement->len));
+		}
+	}
+
+	DBInterfaceRedis::freeReplies(replies);
+
+	iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>((*iter))->addToStream(s, context, dbid);
+	}
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR3::isSameKey(std::string key)
-{
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR3::syncToDB(DBInterface* pdbi, void* pData)
+bool EntityTableItemRedisBase::initialize(const PropertyDescription* pPropertyDescription, 
+										  const DataType* pDataType, std::string name)
 {
+	itemName(name);
+
+	pDataType_ = pDataType;
+	pPropertyDescription_ = pPropertyDescription;
+	indexType_ = pPropertyDescription->indexType();
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedisBase::init_db_item_name(const char* exstrFlag)
 {
+	kbe_snprintf(db_item_name_, MAX_BUF, TABLE_ITEM_PERFIX"_%s%s", exstrFlag, itemName());
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedisBase::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
 {
 	if(s == NULL)
 		return;
-}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR3::getReadSqlItem(redis::DBContext& context)
-{
-}
+	// еĶԭţȡʱֱӷŻ
+	size_t rpos = s->rpos();
+	readStreamValue(s);
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR4::isSameKey(std::string key)
-{
-	return true;
+	redis::DBContext::DB_ITEM_DATA* pSotvs = new redis::DBContext::DB_ITEM_DATA();
+	pSotvs->sqlkey = db_item_name_;
+	pSotvs->sqlval[0] = '\0';
+	pSotvs->extraDatas.assign((const char*)(s->data() + rpos), s->rpos() - rpos);
+	context.items.push_back(KBEShared_ptr<redis::DBContext::DB_ITEM_DATA>(pSotvs));
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_VECTOR4::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedisBase::getReadSqlItem(redis::DBContext& context)
 {
-	return true;
+	context.results.push_back(db_item_name_);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedisBase::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
-}
+	std::vector< std::string >::size_type idx = context.readresultIdx++;
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
-{
-	if(s == NULL)
+	if(idx >= context.results.size() || context.nulls[idx])
+	{
+		addDefaultToStream(s);
 		return;
-}
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_VECTOR4::getReadSqlItem(redis::DBContext& context)
-{
+	const std::string& datas = context.results[idx];
+	s->append(datas.data(), datas.size());
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_ENTITYCALL::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedis_DIGIT::readStreamValue(MemoryStream* s)
 {
-	return true;
+	if(dataSType_ == "INT8" || dataSType_ == "UINT8")
+		s->read_skip<uint8>();
+	else if(dataSType_ == "INT16" || dataSType_ == "UINT16")
+		s->read_skip<uint16>();
+	else if(dataSType_ == "INT32" || dataSType_ == "UINT32" || dataSType_ == "FLOAT")
+		s->read_skip<uint32>();
+	else if(dataSType_ == "INT64" || dataSType_ == "UINT64" || dataSType_ == "DOUBLE")
+		s->read_skip<uint64>();
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ENTITYCALL::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_DIGIT::addDefaultToStream(MemoryStream* s)
 {
+	if(dataSType_ == "INT8" || dataSType_ == "UINT8")
+		(*s) << (uint8)0;
+	else if(dataSType_ == "INT16" || dataSType_ == "UINT16")
+		(*s) << (uint16)0;
+	else if(dataSType_ == "INT32" || dataSType_ == "UINT32")
+		(*s) << (uint32)0;
+	else if(dataSType_ == "INT64" || dataSType_ == "UINT64")
+		(*s) << (uint64)0;
+	else if(dataSType_ == "FLOAT")
+		(*s) << (float)0.f;
+	else if(dataSType_ == "DOUBLE")
+		(*s) << (double)0.0;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ENTITYCALL::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedis_STRING::readStreamValue(MemoryStream* s)
 {
+	std::string val;
+	(*s) >> val;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ENTITYCALL::getReadSqlItem(redis::DBContext& context)
+void EntityTableItemRedis_STRING::addDefaultToStream(MemoryStream* s)
 {
+	(*s) << "";
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_ARRAY::isSameKey(std::string key)
+void EntityTableItemRedis_UNICODE::readStreamValue(MemoryStream* s)
 {
-	return false;
+	std::string val;
+	s->readBlob(val);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_ARRAY::initialize(const PropertyDescription* pPropertyDescription, 
-											const DataType* pDataType, std::string name)
+void EntityTableItemRedis_UNICODE::addDefaultToStream(MemoryStream* s)
 {
-	return true;
+	s->appendBlob("");
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_ARRAY::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedis_PYTHON::readStreamValue(MemoryStream* s)
 {
-	return true;
+	std::string val;
+	s->readBlob(val);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ARRAY::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_PYTHON::addDefaultToStream(MemoryStream* s)
 {
+	s->appendBlob("");
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ARRAY::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedis_BLOB::readStreamValue(MemoryStream* s)
 {
+	std::string val;
+	s->readBlob(val);
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ARRAY::getReadSqlItem(redis::DBContext& context)
+void EntityTableItemRedis_BLOB::addDefaultToStream(MemoryStream* s)
 {
+	s->appendBlob("");
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_ARRAY::init_db_item_name(const char* exstrFlag)
-{
-}
+#ifdef CLIENT_NO_FLOAT
+#define VECTOR_ITEM_VALUE_TYPE int32
+#else
+#define VECTOR_ITEM_VALUE_TYPE float
+#endif
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_FIXED_DICT::isSameKey(std::string key)
+void EntityTableItemRedis_VECTOR2::readStreamValue(MemoryStream* s)
 {
-	return true;
+	for(ArraySize i=0; i<2; ++i)
+		s->read_skip<VECTOR_ITEM_VALUE_TYPE>();
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_FIXED_DICT::initialize(const PropertyDescription* pPropertyDescription, 
-												 const DataType* pDataType, std::string name)
+void EntityTableItemRedis_VECTOR2::addDefaultToStream(MemoryStream* s)
 {
-	return true;
+	for(ArraySize i=0; i<2; ++i)
+		(*s) << (VECTOR_ITEM_VALUE_TYPE)0;
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_FIXED_DICT::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedis_VECTOR3::readStreamValue(MemoryStream* s)
 {
-
-	return true;
+	for(ArraySize i=0; i<3; ++i)
+		s->read_skip<VECTOR_ITEM_VALUE_TYPE>();
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_FIXED_DICT::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_VECTOR3::addDefaultToStream(MemoryStream* s)
 {
+	for(ArraySize i=0; i<3; ++i)
+		(*s) << (VECTOR_ITEM_VALUE_TYPE)0;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_FIXED_DICT::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedis_VECTOR4::readStreamValue(MemoryStream* s)
 {
+	for(ArraySize i=0; i<4; ++i)
+		s->read_skip<VECTOR_ITEM_VALUE_TYPE>();
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_FIXED_DICT::getReadSqlItem(redis::DBContext& context)
+void EntityTableItemRedis_VECTOR4::addDefaultToStream(MemoryStream* s)
 {
+	for(ArraySize i=0; i<4; ++i)
+		(*s) << (VECTOR_ITEM_VALUE_TYPE)0;
 }
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_FIXED_DICT::init_db_item_name(const char* exstrFlag)
-{
-}
+#undef VECTOR_ITEM_VALUE_TYPE
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedisBase::initialize(const PropertyDescription* pPropertyDescription, 
-										  const DataType* pDataType, std::string name)
+bool EntityTableItemRedis_ARRAY::initialize(const PropertyDescription* pPropertyDescription, 
+											const DataType* pDataType, std::string name)
 {
-	itemName(name);
+	bool ret = EntityTableItemRedisBase::initialize(pPropertyDescription, pDataType, name);
+	if(!ret)
+		return false;
 
-	pDataType_ = pDataType;
-	pPropertyDescription_ = pPropertyDescription;
-	indexType_ = pPropertyDescription->indexType();
-	return true;
-}
+	const DataType* pElementDataType = static_cast<FixedArrayType*>(const_cast<DataType*>(pDataType))->getDataType();
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_DIGIT::syncToDB(DBInterface* pdbi, void* pData)
-{
+	EntityTableItem* pArrayTableItem = pParentTable_->createItem(pElementDataType->getName(), 
+		pPropertyDescription->getDefaultValStr());
+
+	pArrayTableItem->utype(-pPropertyDescription->getUType());
+	pArrayTableItem->pParentTable(this->pParentTable());
+	pArrayTableItem->pParentTableItem(this);
+	pArrayTableItem->tableName(this->tableName());
+
+	ret = pArrayTableItem->initialize(pPropertyDescription, pElementDataType, "");
+	if(!ret)
+	{
+		delete pArrayTableItem;
+		return false;
+	}
+
+	pElementItem_.reset(pArrayTableItem);
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_DIGIT::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_ARRAY::init_db_item_name(const char* exstrFlag)
 {
+	EntityTableItemRedisBase::init_db_item_name(exstrFlag);
+	listName_ = fmt::format(ENTITY_TABLE_PERFIX "_{}_{}{}", tableName(), exstrFlag, itemName());
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_DIGIT::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedis_ARRAY::readStreamValue(MemoryStream* s)
 {
-	if(s == NULL)
-		return;
-}
+	ArraySize size = 0;
+	(*s) >> size;
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_DIGIT::getReadSqlItem(redis::DBContext& context)
-{
+	for(ArraySize i=0; i<size; ++i)
+		static_cast<EntityTableItemRedisBase*>(pElementItem_.get())->readStreamValue(s);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_STRING::syncToDB(DBInterface* pdbi, void* pData)
+void EntityTableItemRedis_ARRAY::addDefaultToStream(MemoryStream* s)
 {
-	return true;
+	ArraySize size = 0;
+	(*s) << size;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_STRING::addToStream(MemoryStream* s, 
-											  redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_ARRAY::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
 {
-}
+	// ǶfixedDictе游ֶһ
+	if(pParentTableItem() != NULL)
+	{
+		EntityTableItemRedisBase::getWriteSqlItem(pdbi, s, context);
+		return;
+	}
+
+	redis::DBContext* pArrayContext = new redis::DBContext();
+	pArrayContext->parentTableName = tableName();
+	pArrayContext->tableName = listName_;
+	pArrayContext->parentTableDBID = context.dbid;
+	pArrayContext->dbid = 0;
+	pArrayContext->isEmpty = (s == NULL);
+	pArrayContext->readresultIdx = 0;
+
+	context.optable.push_back(std::pair<std::string/*tableName*/, KBEShared_ptr< redis::DBContext > >
+		(listName_, KBEShared_ptr< redis::DBContext >(pArrayContext)));
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_STRING::getWriteSqlItem(DBInterface* pdbi, 
-												  MemoryStream* s, redis::DBContext& context)
-{
 	if(s == NULL)
 		return;
-}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_STRING::getReadSqlItem(redis::DBContext& context)
-{
-}
+	ArraySize size = 0;
+	(*s) >> size;
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_UNICODE::syncToDB(DBInterface* pdbi, void* pData)
-{
-	return true;
+	// ÿԪصĶΪlistsеһ
+	for(ArraySize i=0; i<size; ++i)
+	{
+		size_t rpos = s->rpos();
+		static_cast<EntityTableItemRedisBase*>(pElementItem_.get())->readStreamValue(s);
+		pArrayContext->results.push_back(std::string((const char*)(s->data() + rpos), s->rpos() - rpos));
+	}
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_UNICODE::addToStream(MemoryStream* s, 
-											   redis::DBContext& context, DBID resultDBID)
+void EntityTableItemRedis_ARRAY::getReadSqlItem(redis::DBContext& context)
 {
+	if(pParentTableItem() != NULL)
+	{
+		EntityTableItemRedisBase::getReadSqlItem(context);
+		return;
+	}
+
+	redis::DBContext* pArrayContext = new redis::DBContext();
+	pArrayContext->parentTableName = tableName();
+	pArrayContext->tableName = listName_;
+	pArrayContext->parentTableDBID = context.dbid;
+	pArrayContext->dbid = 0;
+	pArrayContext->isEmpty = true;
+	pArrayContext->readresultIdx = 0;
+
+	context.optable.push_back(std::pair<std::string/*tableName*/, KBEShared_ptr< redis::DBContext > >
+		(listName_, KBEShared_ptr< redis::DBContext >(pArrayContext)));
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_UNICODE::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, 
-												   redis::DBContext& context)
+void EntityTableItemRedis_ARRAY::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
 {
-	if(s == NULL)
+	if(pParentTableItem() != NULL)
+	{
+		EntityTableItemRedisBase::addToStream(s, context, resultDBID);
 		return;
-}
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_UNICODE::getReadSqlItem(redis::DBContext& context)
-{
-}
+	redis::DBContext::DB_RW_CONTEXTS::iterator iter = context.optable.begin();
+	for(; iter != context.optable.end(); ++iter)
+	{
+		if(listName_ != iter->first)
+			continue;
 
-//-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_BLOB::syncToDB(DBInterface* pdbi, void* pData)
-{
-	return true;
-}
+		std::vector< std::string >& results = iter->second->results;
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_BLOB::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
-{
-}
+		ArraySize size = (ArraySize)results.size();
+		(*s) << size;
+
+		for(ArraySize i=0; i<size; ++i)
+			s->append(results[i].data(), results[i].size());
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_BLOB::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
-{
-	if(s == NULL)
 		return;
-}
+	}
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_BLOB::getReadSqlItem(redis::DBContext& context)
-{
+	addDefaultToStream(s);
 }
 
 //-------------------------------------------------------------------------------------
-bool EntityTableItemRedis_PYTHON::syncToDB(DBInterface* pdbi, void* pData)
+bool EntityTableItemRedis_FIXED_DICT::initialize(const PropertyDescription* pPropertyDescription, 
+												 const DataType* pDataType, std::string name)
 {
-	return true;
-}
+	bool ret = EntityTableItemRedisBase::initialize(pPropertyDescription, pDataType, name);
+	if(!ret)
+		return false;
 
-//-------------------------------------------------------------------------------------
-void EntityTableItemRedis_PYTHON::addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID)
-{
+	KBEngine::FixedDictType* fdatatype = static_cast<KBEngine::FixedDictType*>(const_cast<DataType*>(pDataType));
+
+	FixedDictType::FIXEDDICT_KEYTYPE_MAP& keyTypes = fdatatype->getKeyTypes();
+	FixedDictType::FIXEDDICT_KEYTYPE_MAP::iterator iter = keyTypes.begin();
+
+	for(; iter != keyTypes.end(); ++iter)
+	{
+		if(!iter->second->persistent)
+			continue;
+
+		EntityTableItem* tableItem = pParentTable_->createItem(iter->second->dataType->getName(), pPropertyDescription->getDefaultValStr());
+
+		tableItem->pParentTable(this->pParentTable());
+		tableItem->pParentTableItem(this);
+		tableItem->utype(-pPropertyDescription->getUType());
+		tableItem->tableName(this->tableName());
+		if(!tableItem->initialize(pPropertyDescription, iter->second->dataType, iter->first))
+		{
+			delete tableItem;
+			return false;
+		}
+
+		std::pair< std::string, KBEShared_ptr<EntityTableItem> > itemVal;
+		itemVal.first = iter->first;
+		itemVal.second.reset(tableItem);
+
+		keyTypes_.push_back(itemVal);
+	}
+
+	return true;
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_PYTHON::getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context)
+void EntityTableItemRedis_FIXED_DICT::readStreamValue(MemoryStream* s)
 {
-	if(s == NULL)
-		return;
+	EntityTableItemRedis_FIXED_DICT::FIXEDDICT_KEYTYPES::iterator iter = keyTypes_.begin();
+	for(; iter != keyTypes_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>(iter->second.get())->readStreamValue(s);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-void EntityTableItemRedis_PYTHON::getReadSqlItem(redis::DBContext& context)
+void EntityTableItemRedis_FIXED_DICT::addDefaultToStream(MemoryStream* s)
 {
+	EntityTableItemRedis_FIXED_DICT::FIXEDDICT_KEYTYPES::iterator iter = keyTypes_.begin();
+	for(; iter != keyTypes_.end(); ++iter)
+	{
+		static_cast<EntityTableItemRedisBase*>(iter->second.get())->addDefaultToStream(s);
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -33,7 +33,16 @@ class ScriptDefModule;
 class EntityTableRedis;
 
 /*
-	άentityݿеһֶ
+	άentityݿеһֶ
+
+	redisÿʵһhashesÿ洢еһֶΣֵΪеĶ:
+	tbl_Account:1 = hashes(sm_autoLoad, sm_name, sm_level, ...)
+
+	ʵϵԵΪһlistsÿԪԪеĶ:
+	tbl_Account_items:1 = lists(val, val, ...)
+
+	Զصʵ¼һzset:
+	tbl_Account_autoLoad = zset(dbid, ...)
 */
 class EntityTableItemRedisBase : public EntityTableItem
 {
@@ -58,8 +67,9 @@ public:
 
 	/**
 		ͬentityݿ
+		redisеûнṹдʱŲֶΣԲҪͬ
 	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL) = 0;
+	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL){ return true; }
 
 	/**
 		
@@ -71,16 +81,26 @@ public:
 	*/
 	virtual bool queryTable(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule){ return true; }
 
+	/**
+		жһֵȡֵĶ
+	*/
+	virtual void readStreamValue(MemoryStream* s) = 0;
+
+	/**
+		ݿûֶʱдĬֵ
+	*/
+	virtual void addDefaultToStream(MemoryStream* s) = 0;
+
 	/**
 		ȡĳеݷŵ
 	*/
-	virtual void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID){};
+	virtual void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
 
 	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
+		ȡҪ洢ֶͶֵ
 	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context) = 0;
-	virtual void getReadSqlItem(redis::DBContext& context) = 0;
+	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
+	virtual void getReadSqlItem(redis::DBContext& context);
 
 	virtual void init_db_item_name(const char* exstrFlag = "");
 	const char* db_item_name(){ return db_item_name_; }
@@ -104,21 +124,9 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_DIGIT; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
 protected:
 	std::string dataSType_;
 };
@@ -136,21 +144,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_STRING; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_UNICODE : public EntityTableItemRedisBase
@@ -166,21 +161,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_UNICODE; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_PYTHON : public EntityTableItemRedisBase
@@ -196,21 +178,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_PYTHON; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_BLOB : public EntityTableItemRedisBase
@@ -226,21 +195,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_BLOB; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_VECTOR2 : public EntityTableItemRedisBase
@@ -255,33 +211,9 @@ public:
 	virtual ~EntityTableItemRedis_VECTOR2(){};
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_VECTOR2; }
-	
-	virtual bool isSameKey(std::string key);
-
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
 
-	virtual void init_db_item_name(const char* exstrFlag = "")
-	{
-		for(int i=0; i<2; ++i)
-			kbe_snprintf(db_item_names_[i], MAX_BUF, TABLE_ITEM_PERFIX"_%d_%s%s", i, exstrFlag, itemName());
-	}
-
-protected:
-	char db_item_names_[2][MAX_BUF];
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_VECTOR3 : public EntityTableItemRedisBase
@@ -297,32 +229,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_VECTOR3; }
 
-	virtual bool isSameKey(std::string key);
-
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
-
-	virtual void init_db_item_name(const char* exstrFlag = "")
-	{
-		for(int i=0; i<3; ++i)
-			kbe_snprintf(db_item_names_[i], MAX_BUF, TABLE_ITEM_PERFIX"_%d_%s%s", i, exstrFlag, itemName());
-	}
-
-protected:
-	char db_item_names_[3][MAX_BUF];
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_VECTOR4 : public EntityTableItemRedisBase
@@ -338,32 +246,8 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_VECTOR4; }
 
-	virtual bool isSameKey(std::string key);
-
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
-
-	virtual void init_db_item_name(const char* exstrFlag = "")
-	{
-		for(int i=0; i<4; ++i)
-			kbe_snprintf(db_item_names_[i], MAX_BUF, TABLE_ITEM_PERFIX"_%d_%s%s", i, exstrFlag, itemName());
-	}
-
-protected:
-	char db_item_names_[4][MAX_BUF];
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 };
 
 class EntityTableItemRedis_ENTITYCALL : public EntityTableItemRedisBase
@@ -380,20 +264,13 @@ public:
 	uint8 type() const{ return TABLE_ITEM_TYPE_ENTITYCALL; }
 
 	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
+		mysqlͬentityCall浵
 	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
+	virtual void readStreamValue(MemoryStream* s){}
+	virtual void addDefaultToStream(MemoryStream* s){}
+	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context){}
+	virtual void getReadSqlItem(redis::DBContext& context){}
+	virtual void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID){}
 };
 
 class EntityTableItemRedis_ARRAY : public EntityTableItemRedisBase
@@ -402,14 +279,12 @@ public:
 	EntityTableItemRedis_ARRAY(std::string itemDBType, 
 		uint32 datalength, uint32 flags):
 	  EntityTableItemRedisBase(itemDBType, datalength, flags),
-	  pChildTable_(NULL)
+	  pElementItem_()
 	  {
 	  }
 
 	virtual ~EntityTableItemRedis_ARRAY(){};
 
-	virtual bool isSameKey(std::string key);
-
 	/**
 		ʼ
 	*/
@@ -418,26 +293,26 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_FIXEDARRAY; }
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 
 	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
+		ʵϵԴڵlistsУǶеֱӴڸֶε
 	*/
+	virtual void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
 	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
 	virtual void getReadSqlItem(redis::DBContext& context);
 
 	virtual void init_db_item_name(const char* exstrFlag = "");
 
+	/**
+		Ԫصlists(dbid)
+	*/
+	const std::string& listName() const{ return listName_; }
+
 protected:
-	EntityTable* pChildTable_;
+	KBEShared_ptr<EntityTableItem> pElementItem_;
+	std::string listName_;
 };
 
 class EntityTableItemRedis_FIXED_DICT : public EntityTableItemRedisBase
@@ -455,31 +330,14 @@ public:
 
 	uint8 type() const{ return TABLE_ITEM_TYPE_FIXEDDICT; }
 
-	virtual bool isSameKey(std::string key);
-
 	/**
 		ʼ
 	*/
 	virtual bool initialize(const PropertyDescription* pPropertyDescription, 
 		const DataType* pDataType, std::string name);
 
-	/**
-		ͬentityݿ
-	*/
-	virtual bool syncToDB(DBInterface* pdbi, void* pData = NULL);
-
-	/**
-		ȡĳеݷŵ
-	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
-
-	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
-	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
-
-	virtual void init_db_item_name(const char* exstrFlag = "");
+	virtual void readStreamValue(MemoryStream* s);
+	virtual void addDefaultToStream(MemoryStream* s);
 
 protected:
 	EntityTableItemRedis_FIXED_DICT::FIXEDDICT_KEYTYPES			keyTypes_;		// ̶ֵĸkey
@@ -515,6 +373,9 @@ public:
 	*/
 	virtual EntityTableItem* createItem(std::string type, std::string defaultVal);
 
+	/**
+		дʵ壬еһܵһη
+	*/
 	DBID writeTable(DBInterface* pdbi, DBID dbid, int8 shouldAutoLoad, MemoryStream* s, ScriptDefModule* pModule);
 
 	/**
@@ -523,7 +384,7 @@ public:
 	bool removeEntity(DBInterface* pdbi, DBID dbid, ScriptDefModule* pModule);
 
 	/**
-		ȡеݷŵ
+		ȡеݷŵУhasheslistsһܵһȡ
 	*/
 	virtual bool queryTable(DBInterface* pdbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule);
 
@@ -538,21 +399,20 @@ public:
 	virtual void queryAutoLoadEntities(DBInterface* pdbi, ScriptDefModule* pModule, 
 		ENTITY_ID start, ENTITY_ID end, std::vector<DBID>& outs);
 
+	void init_db_item_name();
+
 	/**
-		ȡĳеݷŵ
+		ʵhasheskey
 	*/
-	void addToStream(MemoryStream* s, redis::DBContext& context, DBID resultDBID);
+	std::string entityKey(DBID dbid);
 
 	/**
-		ȡҪ洢ı ֶתΪsql洢ʱֵַ
+		Զʵzsetkey
 	*/
-	virtual void getWriteSqlItem(DBInterface* pdbi, MemoryStream* s, redis::DBContext& context);
-	virtual void getReadSqlItem(redis::DBContext& context);
-
-	void init_db_item_name();
+	std::string autoLoadKey();
 
 protected:
-	
+	void appendAutoLoad(DBInterfaceRedis* pdbi, DBID dbid, bool shouldAutoLoad, size_t& nreplies);
 };
 
 
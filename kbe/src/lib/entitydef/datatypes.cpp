@@ -20,6 +20,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "datatypes.h"
+#include "entitydef_cache.h"
 #include "resmgr/resmgr.h"
 
 namespace KBEngine{
@@ -111,7 +112,10 @@ std::vector< std::string > DataTypes::getBaseTypeNames()
 //-------------------------------------------------------------------------------------
 bool DataTypes::loadTypes(std::string& file)
 {
-	auto xml = KBE_MAKE_SHARED<XML>(Resmgr::getSingleton().matchRes(file).c_str());
+	auto xml = KBE_MAKE_SHARED<XML>();
+	if (!EntityDefCache::openSection(xml.get(), Resmgr::getSingleton().matchRes(file)))
+		return false;
+
 	return loadTypes(xml);
 }
 
@@ -0,0 +1,179 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_ENTITY_ALIAS_ALLOCATOR_H
+#define KBE_ENTITY_ALIAS_ALLOCATOR_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+
+#include <set>
+#include <map>
+
+namespace KBEngine{
+
+/*
+	Ϊͬͻ˵ViewʵID(λ)
+	(Witness)Ϳͻ˰ͬϢ˳allocreclaim ˵õıIDȫһ£
+	˱IDҪЭд䡣 յĲλȸСĿвλ ĩβĲλʱ֮
+	ʵ뿪ViewʱҪؽӳ
+
+	IDıɵǰ 256ʱʹ1ֽڣ ʹ2ֽڡ
+*/
+class EntityAliasAllocator
+{
+public:
+	// ɷı ʵֻʹentityID
+	enum { MAX_ALIASES = 65535 };
+
+	EntityAliasAllocator():
+	slots_(),
+	freeSlots_(),
+	aliases_()
+	{
+	}
+
+	~EntityAliasAllocator()
+	{
+	}
+
+	/** 
+		ΪʵһID ʧܷ-1 
+	*/
+	int alloc(ENTITY_ID id)
+	{
+		std::map<ENTITY_ID, uint16>::iterator iter = aliases_.find(id);
+		if(iter != aliases_.end())
+			return iter->second;
+
+		uint16 aliasID = 0;
+
+		if(freeSlots_.size() > 0)
+		{
+			aliasID = *freeSlots_.begin();
+			freeSlots_.erase(freeSlots_.begin());
+			slots_[aliasID] = id;
+		}
+		else
+		{
+			if(slots_.size() >= MAX_ALIASES)
+				return -1;
+
+			aliasID = (uint16)slots_.size();
+			slots_.push_back(id);
+		}
+
+		aliases_[id] = aliasID;
+		return aliasID;
+	}
+
+	/** 
+		ʵıID 
+	*/
+	bool reclaim(ENTITY_ID id)
+	{
+		std::map<ENTITY_ID, uint16>::iterator iter = aliases_.find(id);
+		if(iter == aliases_.end())
+			return false;
+
+		uint16 aliasID = iter->second;
+		aliases_.erase(iter);
+
+		slots_[aliasID] = 0;
+		freeSlots_.insert(aliasID);
+
+		// ĩβĲλʱ ʹȾܻ䵽1ֽ
+		while(slots_.size() > 0 && slots_.back() == 0)
+		{
+			freeSlots_.erase((uint16)(slots_.size() - 1));
+			slots_.pop_back();
+		}
+
+		return true;
+	}
+
+	void clear()
+	{
+		slots_.clear();
+		freeSlots_.clear();
+		aliases_.clear();
+	}
+
+	ENTITY_ID entityID(uint16 aliasID) const
+	{
+		if(aliasID >= slots_.size())
+			return 0;
+
+		return slots_[aliasID];
+	}
+
+	int aliasID(ENTITY_ID id) const
+	{
+		std::map<ENTITY_ID, uint16>::const_iterator iter = aliases_.find(id);
+		if(iter == aliases_.end())
+			return -1;
+
+		return iter->second;
+	}
+
+	size_t size() const { return aliases_.size(); }
+	size_t capacity() const { return slots_.size(); }
+
+	/** 
+		ǰIDõֽ 
+	*/
+	uint8 aliasIDSize() const { return slots_.size() <= 256 ? sizeof(uint8) : sizeof(uint16); }
+
+	template<typename STREAM>
+	void addToStream(STREAM& s, uint16 aliasID) const
+	{
+		if(aliasIDSize() == sizeof(uint8))
+			s << (uint8)aliasID;
+		else
+			s << aliasID;
+	}
+
+	uint16 readFromStream(MemoryStream& s) const
+	{
+		if(aliasIDSize() == sizeof(uint8))
+		{
+			uint8 aliasID = 0;
+			s >> aliasID;
+			return aliasID;
+		}
+
+		uint16 aliasID = 0;
+		s >> aliasID;
+		return aliasID;
+	}
+
+private:
+	// λӦentityID 0ʾ
+	std::vector<ENTITY_ID> slots_;
+
+	// еĲλ ԱǸСĲλ
+	std::set<uint16> freeSlots_;
+
+	std::map<ENTITY_ID, uint16> aliases_;
+};
+
+}
+
+#endif // KBE_ENTITY_ALIAS_ALLOCATOR_H
@@ -38,6 +38,9 @@ EntityCall::FindChannelFunc EntityCall::__findChannelFunc;
 EntityCall::EntityCallCallHookFunc*	EntityCall::__hookCallFuncPtr = NULL;
 EntityCall::ENTITYCALLS EntityCall::entityCalls;
 
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("EntityCall");
+
 SCRIPT_METHOD_DECLARE_BEGIN(EntityCall)
 SCRIPT_METHOD_DECLARE_END()
 
@@ -70,7 +73,7 @@ EntityCall::EntityCall(PyTypeObject * scriptType, ScriptDefModule * pScriptModul
 	atIdx_ = EntityCall::entityCalls.size();
 	EntityCall::entityCalls.push_back(this);
 
-	script::PyGC::incTracing("EntityCall");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -90,7 +93,7 @@ EntityCall::~EntityCall()
 	atIdx_ = ENTITYCALLS::size_type(-1);
 	EntityCall::entityCalls.pop_back();
 
-	script::PyGC::decTracing("EntityCall");
+	script::PyGC::decTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -20,6 +20,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include "entitydef.h"
+#include "entitydef_cache.h"
 #include "scriptdef_module.h"
 #include "datatypes.h"
 #include "common.h"
@@ -51,6 +52,7 @@ bool g_isReload = false;
 
 bool EntityDef::__entityAliasID = false;
 bool EntityDef::__entitydefAliasID = false;
+bool EntityDef::__entityAliasIDSlots = false;
 
 uint16 EntityDef::__maxClientModuleUType = 0;
 
@@ -167,6 +169,10 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 	std::string entitiesFile = __entitiesPath + "entities.xml";
 	std::string defFilePath = __entitiesPath + "entity_defs/";
 	ENTITY_SCRIPT_UID utype = 1;
+	uint64 startTime = timestamp();
+
+	// ԤĻ棬ûб仯defļֱӴӻлԭڵ
+	EntityDefCache::initialize(defFilePath + ENTITYDEF_CACHE_FILE, __entitiesPath);
 	
 	// ʼ
 	// assets/scripts/entity_defs/types.xml
@@ -175,13 +181,16 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 
 	// entities.xmlļ
 	auto xml = KBE_MAKE_UNIQUE<XML>();
-	if(!xml->openSection(entitiesFile.c_str()))
+	if(!EntityDefCache::openSection(xml.get(), entitiesFile))
 		return false;
 	
 	// entities.xmlڵ, ûжһentityôֱӷtrue
 	TiXmlNode* node = xml->getRootNode();
 	if(node == NULL)
+	{
+		EntityDefCache::finalise(true);
 		return true;
+	}
 
 	// ʼеentityڵ
 	XML_FOR_BEGIN(node)
@@ -194,7 +203,7 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 		std::string deffile = defFilePath + moduleName + ".def";
 
 		auto defxml = KBE_MAKE_SHARED<XML>();
-		if(!defxml->openSection(deffile.c_str()))
+		if(!EntityDefCache::openSection(defxml.get(), deffile))
 			return false;
 
 		TiXmlNode* defNode = defxml->getRootNode();
@@ -237,6 +246,12 @@ bool EntityDef::initialize(std::vector<PyTypeObject*>& scriptBaseTypes,
 
 	EntityDef::md5().final();
 
+	INFO_MSG(fmt::format("EntityDef::initialize: loaded {} entity defs in {:.2f}ms, cache(hits={}, misses={}).\n", 
+		__scriptModules.size(), (timestamp() - startTime) * 1000.0 / stampsPerSecondD(), 
+		EntityDefCache::numHits(), EntityDefCache::numMisses()));
+
+	EntityDefCache::finalise(true);
+
 	if(loadComponentType == DBMGR_TYPE)
 		return true;
 
@@ -485,7 +500,7 @@ bool EntityDef::loadInterfaces(const std::string& defFilePath,
 		std::string interfacefile = defFilePath + "interfaces/" + interfaceName + ".def";
 
 		auto interfaceXml = KBE_MAKE_SHARED<XML>();
-		if(!interfaceXml->openSection(interfacefile.c_str()))
+		if(!EntityDefCache::openSection(interfaceXml.get(), interfacefile))
 			return false;
 
 		TiXmlNode* interfaceRootNode = interfaceXml->getRootNode();
@@ -542,7 +557,7 @@ bool EntityDef::loadParentClass(const std::string& defFilePath,
 	std::string parentClassfile = defFilePath + parentClassName + ".def";
 	
 	auto parentClassXml = KBE_MAKE_SHARED<XML>();
-	if(!parentClassXml->openSection(parentClassfile.c_str()))
+	if(!EntityDefCache::openSection(parentClassXml.get(), parentClassfile))
 		return false;
 	
 	TiXmlNode* parentClassdefNode = parentClassXml->getRootNode();
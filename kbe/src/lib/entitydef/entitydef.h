@@ -182,6 +182,16 @@ public:
 		return __entityAliasID; 
 	}
 
+	static void entityAliasIDSlots(bool v)
+	{ 
+		__entityAliasIDSlots = v; 
+	}
+
+	static bool entityAliasIDSlots()
+	{ 
+		return __entityAliasID && __entityAliasIDSlots; 
+	}
+
 	static bool scriptModuleAliasID()
 	{ 
 		return __entitydefAliasID && __maxClientModuleUType <= 255;
@@ -206,6 +216,7 @@ private:
 
 	static bool __entityAliasID;												// ŻEntityIDviewΧС255EntityID, 䵽clientʱʹ1ֽαID 
 	static bool __entitydefAliasID;												// ŻentityԺͷ㲥ʱռõĴentityͻԻ߿ͻ˲255ʱ uiduid䵽clientʱʹ1ֽڱID
+	static bool __entityAliasIDSlots;											// ViewʵIDʹȶĲλ(вλ) 256ʱʹ2ֽڱID ͻҪָ֧ģʽ
 	
 	static uint16 __maxClientModuleUType;										// clientĽűģutypeǶ
 };
@@ -0,0 +1,371 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "entitydef_cache.h"
+#include "common/md5.h"
+
+namespace KBEngine{
+
+// ļͷʽ仯ʱҪ޸İ汾
+static const uint32 ENTITYDEF_CACHE_MAGIC = 0x4445424B; // "KBED"
+static const uint16 ENTITYDEF_CACHE_VERSION = 1;
+
+// ڵֻͣdefʱõĽڵ
+enum ENTITYDEF_CACHE_NODE_TYPE
+{
+	ENTITYDEF_CACHE_NODE_ELEMENT = 0,
+	ENTITYDEF_CACHE_NODE_TEXT = 1,
+	ENTITYDEF_CACHE_NODE_COMMENT = 2,
+};
+
+bool EntityDefCache::isInit_ = false;
+bool EntityDefCache::recording_ = false;
+std::string EntityDefCache::cacheFile_;
+std::string EntityDefCache::basePath_;
+EntityDefCache::CACHE_ITEMS EntityDefCache::items_;
+MemoryStream EntityDefCache::stream_;
+uint32 EntityDefCache::numHits_ = 0;
+uint32 EntityDefCache::numMisses_ = 0;
+
+//-------------------------------------------------------------------------------------
+bool EntityDefCache::initialize(const std::string& cacheFile, const std::string& basePath)
+{
+	finalise(false);
+
+	cacheFile_ = cacheFile;
+	basePath_ = basePath;
+	numHits_ = 0;
+	numMisses_ = 0;
+	isInit_ = true;
+
+	// ¼ģʽ
+	if (recording_)
+		return true;
+
+	std::string datas;
+	if (!readFile(cacheFile_, datas))
+	{
+		isInit_ = false;
+		return false;
+	}
+
+	stream_.append(datas.data(), datas.size());
+
+	uint32 magic = 0;
+	uint16 version = 0;
+	uint32 count = 0;
+
+	if (stream_.length() < sizeof(magic) + sizeof(version) + sizeof(count))
+	{
+		WARNING_MSG(fmt::format("EntityDefCache::initialize: {} is invalid, ignored!\n", cacheFile_));
+		finalise(false);
+		return false;
+	}
+
+	stream_ >> magic >> version >> count;
+
+	if (magic != ENTITYDEF_CACHE_MAGIC || version != ENTITYDEF_CACHE_VERSION)
+	{
+		WARNING_MSG(fmt::format("EntityDefCache::initialize: {} version mismatch, ignored!\n", cacheFile_));
+		finalise(false);
+		return false;
+	}
+
+	// ֻڵõʱŻԭ
+	try
+	{
+		for (uint32 i = 0; i < count; ++i)
+		{
+			std::string key;
+			CACHE_ITEM item;
+			uint32 size = 0;
+
+			stream_ >> key >> item.md5 >> size;
+			item.pos = stream_.rpos();
+			item.size = size;
+
+			if (size > stream_.length())
+				throw MemoryStreamException(false, item.pos, size, stream_.size());
+
+			stream_.read_skip(size);
+			items_[key] = item;
+		}
+	}
+	catch (MemoryStreamException &)
+	{
+		WARNING_MSG(fmt::format("EntityDefCache::initialize: {} is corrupted, ignored!\n", cacheFile_));
+		finalise(false);
+		return false;
+	}
+
+	DEBUG_MSG(fmt::format("EntityDefCache::initialize: {} loaded, {} files.\n", cacheFile_, items_.size()));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityDefCache::finalise(bool success)
+{
+	if (isInit_ && recording_ && success)
+		save();
+
+	items_.clear();
+	stream_.clear(true);
+	isInit_ = false;
+}
+
+//-------------------------------------------------------------------------------------
+std::string EntityDefCache::cacheKey(const std::string& xmlFile)
+{
+	if (basePath_.size() > 0 && xmlFile.compare(0, basePath_.size(), basePath_) == 0)
+		return xmlFile.substr(basePath_.size());
+
+	return xmlFile;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefCache::readFile(const std::string& file, std::string& datas)
+{
+	FILE* f = fopen(file.c_str(), "rb");
+	if (f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	if (size < 0)
+	{
+		fclose(f);
+		return false;
+	}
+
+	datas.resize(size);
+	bool ret = size == 0 || fread(&datas[0], 1, size, f) == (size_t)size;
+	fclose(f);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefCache::openSection(XML* xml, const std::string& xmlFile)
+{
+	if (!isInit_)
+		return xml->openSection(xmlFile.c_str());
+
+	std::string datas;
+	bool hasDatas = readFile(xmlFile, datas);
+	std::string md5 = hasDatas ? KBE_MD5::getDigest(datas.data(), (int)datas.size()) : "";
+
+	if (!recording_ && hasDatas)
+	{
+		CACHE_ITEMS::iterator iter = items_.find(cacheKey(xmlFile));
+		if (iter != items_.end() && iter->second.md5 == md5)
+		{
+			TiXmlDocument* txdoc = new TiXmlDocument(xmlFile.c_str());
+
+			bool ret = false;
+			stream_.rpos(iter->second.pos);
+
+			try
+			{
+				ret = readNode(stream_, txdoc);
+			}
+			catch (MemoryStreamException &)
+			{
+				ret = false;
+			}
+
+			if (ret && xml->openDocument(txdoc))
+			{
+				++numHits_;
+				return true;
+			}
+
+			if (!ret)
+				delete txdoc;
+
+			WARNING_MSG(fmt::format("EntityDefCache::openSection: {} is corrupted in cache, parse xml.\n", xmlFile));
+		}
+	}
+
+	++numMisses_;
+
+	if (!xml->openSection(xmlFile.c_str()))
+		return false;
+
+	if (recording_ && hasDatas)
+	{
+		CACHE_ITEM item;
+		item.md5 = md5;
+		item.pos = stream_.wpos();
+
+		writeNode(stream_, xml->getTxdoc());
+		item.size = stream_.wpos() - item.pos;
+		items_[cacheKey(xmlFile)] = item;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityDefCache::writeNode(MemoryStream& s, const TiXmlNode* pNode)
+{
+	const TiXmlNode* pChildNode = NULL;
+	uint32 numChilds = 0;
+
+	for (pChildNode = pNode->FirstChild(); pChildNode; pChildNode = pChildNode->NextSibling())
+	{
+		int type = pChildNode->Type();
+		if (type == TiXmlNode::TINYXML_ELEMENT || type == TiXmlNode::TINYXML_TEXT || type == TiXmlNode::TINYXML_COMMENT)
+			++numChilds;
+	}
+
+	s << numChilds;
+
+	for (pChildNode = pNode->FirstChild(); pChildNode; pChildNode = pChildNode->NextSibling())
+	{
+		switch (pChildNode->Type())
+		{
+		case TiXmlNode::TINYXML_ELEMENT:
+		{
+			s << (uint8)ENTITYDEF_CACHE_NODE_ELEMENT << pChildNode->Value();
+
+			const TiXmlAttribute* pAttribute = pChildNode->ToElement()->FirstAttribute();
+			uint16 numAttributes = 0;
+			for (; pAttribute; pAttribute = pAttribute->Next())
+				++numAttributes;
+
+			s << numAttributes;
+
+			pAttribute = pChildNode->ToElement()->FirstAttribute();
+			for (; pAttribute; pAttribute = pAttribute->Next())
+				s << pAttribute->Name() << pAttribute->Value();
+
+			writeNode(s, pChildNode);
+			break;
+		}
+		case TiXmlNode::TINYXML_TEXT:
+			s << (uint8)ENTITYDEF_CACHE_NODE_TEXT << pChildNode->Value() << (uint8)pChildNode->ToText()->CDATA();
+			break;
+		case TiXmlNode::TINYXML_COMMENT:
+			s << (uint8)ENTITYDEF_CACHE_NODE_COMMENT << pChildNode->Value();
+			break;
+		default:
+			break;
+		};
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefCache::readNode(MemoryStream& s, TiXmlNode* pParentNode)
+{
+	uint32 numChilds = 0;
+	s >> numChilds;
+
+	for (uint32 i = 0; i < numChilds; ++i)
+	{
+		uint8 type = 0;
+		std::string value;
+		s >> type >> value;
+
+		switch (type)
+		{
+		case ENTITYDEF_CACHE_NODE_ELEMENT:
+		{
+			TiXmlElement* pElement = new TiXmlElement(value.c_str());
+			pParentNode->LinkEndChild(pElement);
+
+			uint16 numAttributes = 0;
+			s >> numAttributes;
+
+			for (uint16 j = 0; j < numAttributes; ++j)
+			{
+				std::string name, attrValue;
+				s >> name >> attrValue;
+				pElement->SetAttribute(name.c_str(), attrValue.c_str());
+			}
+
+			if (!readNode(s, pElement))
+				return false;
+
+			break;
+		}
+		case ENTITYDEF_CACHE_NODE_TEXT:
+		{
+			uint8 cdata = 0;
+			s >> cdata;
+
+			TiXmlText* pText = new TiXmlText(value.c_str());
+			pText->SetCDATA(cdata > 0);
+			pParentNode->LinkEndChild(pText);
+			break;
+		}
+		case ENTITYDEF_CACHE_NODE_COMMENT:
+		{
+			TiXmlComment* pComment = new TiXmlComment();
+			pComment->SetValue(value.c_str());
+			pParentNode->LinkEndChild(pComment);
+			break;
+		}
+		default:
+			return false;
+		};
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityDefCache::save()
+{
+	MemoryStream s;
+	s << ENTITYDEF_CACHE_MAGIC << ENTITYDEF_CACHE_VERSION << (uint32)items_.size();
+
+	CACHE_ITEMS::iterator iter = items_.begin();
+	for (; iter != items_.end(); ++iter)
+	{
+		s << iter->first << iter->second.md5 << (uint32)iter->second.size;
+		s.append(stream_.data() + iter->second.pos, iter->second.size);
+	}
+
+	FILE* f = fopen(cacheFile_.c_str(), "wb");
+	if (f == NULL)
+	{
+		ERROR_MSG(fmt::format("EntityDefCache::save: open {} error!\n", cacheFile_));
+		return false;
+	}
+
+	bool ret = fwrite(s.data(), 1, s.wpos(), f) == s.wpos();
+	fclose(f);
+
+	if (!ret)
+	{
+		ERROR_MSG(fmt::format("EntityDefCache::save: write {} error!\n", cacheFile_));
+		return false;
+	}
+
+	INFO_MSG(fmt::format("EntityDefCache::save: {} saved, {} files, size={}.\n", 
+		cacheFile_, items_.size(), s.wpos()));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,108 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef KBE_ENTITYDEF_CACHE_H
+#define KBE_ENTITYDEF_CACHE_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "helper/debug_helper.h"
+#include "xml/xml.h"
+
+namespace KBEngine{
+
+// ļentity_defsĿ¼
+#define ENTITYDEF_CACHE_FILE "entitydefs.cache"
+
+/*
+	Ԥentitydef
+
+	бentities.xmltypes.xmlԼdefļĽڵ()
+	ÿļݵmd5ΪУ飬ļûб仯ʱֱӴӻ滹ԭڵٽxml
+	ļб仯߻ûļʱ˵xml
+
+	ļkbcmd --entitydefcacheɡ
+*/
+class EntityDefCache
+{
+public:
+	struct CACHE_ITEM
+	{
+		std::string md5;
+		size_t pos;
+		size_t size;
+	};
+
+	typedef std::map<std::string, CACHE_ITEM> CACHE_ITEMS;
+
+	/**
+		ػļļڻЧʱļxml
+		basePathΪkeyĸĿ¼ʹԴڵľ·޹
+	*/
+	static bool initialize(const std::string& cacheFile, const std::string& basePath);
+
+	/**
+		ͷŻ棬¼ģʽsuccessΪtrueʱ¼д뻺ļ
+	*/
+	static void finalise(bool success);
+
+	/**
+		һdefصxmlļȴӻлԭ
+	*/
+	static bool openSection(XML* xml, const std::string& xmlFile);
+
+	/**
+		¼ģʽд򿪵ļᱻд뻺棬kbcmdʹ
+	*/
+	static void recording(bool v){ recording_ = v; }
+	static bool recording(){ return recording_; }
+
+	static uint32 numHits(){ return numHits_; }
+	static uint32 numMisses(){ return numMisses_; }
+
+protected:
+	static std::string cacheKey(const std::string& xmlFile);
+	static bool readFile(const std::string& file, std::string& datas);
+
+	static void writeNode(MemoryStream& s, const TiXmlNode* pNode);
+	static bool readNode(MemoryStream& s, TiXmlNode* pParentNode);
+
+	static bool save();
+
+protected:
+	static bool isInit_;
+	static bool recording_;
+
+	static std::string cacheFile_;
+	static std::string basePath_;
+
+	static CACHE_ITEMS items_;
+
+	// ļݣitems_м¼ÿļĽڵеλ
+	static MemoryStream stream_;
+
+	static uint32 numHits_;
+	static uint32 numMisses_;
+};
+
+}
+
+#endif // KBE_ENTITYDEF_CACHE_H
@@ -24,6 +24,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine{ 
 
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("FixedArray");
+
 SCRIPT_METHOD_DECLARE_BEGIN(FixedArray)
 SCRIPT_METHOD_DECLARE("__reduce_ex__",				reduce_ex__,			METH_VARARGS, 0)
 SCRIPT_METHOD_DECLARE("append",						append,					METH_VARARGS, 0)
@@ -51,7 +54,7 @@ Sequence(getScriptType(), false)
 	_dataType = static_cast<FixedArrayType*>(dataType);
 	_dataType->incRef();
 
-	script::PyGC::incTracing("FixedArray");
+	script::PyGC::incTracing(g_tracingSlot);
 
 //	DEBUG_MSG(fmt::format("FixedArray::FixedArray(): {:p}\n", (void*)this));
 }
@@ -61,7 +64,7 @@ FixedArray::~FixedArray()
 {
 	_dataType->decRef();
 
-	script::PyGC::decTracing("FixedArray");
+	script::PyGC::decTracing(g_tracingSlot);
 
 //	DEBUG_MSG(fmt::format("FixedArray::~FixedArray(): {:p}\n", (void*)this));
 }
@@ -48,6 +48,9 @@ PySequenceMethods FixedDict::mappingSequenceMethods =
     0,											/* sq_inplace_repeat */
 };
 
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("FixedDict");
+
 SCRIPT_METHOD_DECLARE_BEGIN(FixedDict)
 SCRIPT_METHOD_DECLARE("__reduce_ex__",				reduce_ex__,			METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE("has_key",					has_key,				METH_VARARGS,		0)
@@ -71,7 +74,7 @@ Map(getScriptType(), false)
 	_dataType = static_cast<FixedDictType*>(dataType);
 	_dataType->incRef();
 
-	script::PyGC::incTracing("FixedDict");
+	script::PyGC::incTracing(g_tracingSlot);
 
 	//	DEBUG_MSG(fmt::format("FixedDict::FixedDict(1): {:p}---{}\n", (void*)this,
 	//		PyUnicode_AsUTF8AndSize(PyObject_Str(getDictObject()), NULL)));
@@ -84,7 +87,7 @@ Map(getScriptType(), false)
 	_dataType = static_cast<FixedDictType*>(dataType);
 	_dataType->incRef();
 	
-	script::PyGC::incTracing("FixedDict");
+	script::PyGC::incTracing(g_tracingSlot);
 
 	//	DEBUG_MSG(fmt::format("FixedDict::FixedDict(2): {:p}---{}\n", (void*)this,
 	//		PyUnicode_AsUTF8AndSize(PyObject_Str(getDictObject()), NULL)));
@@ -95,7 +98,7 @@ Map(getScriptType(), false)
 FixedDict::~FixedDict()
 {
 	_dataType->decRef();
-	script::PyGC::decTracing("FixedDict");
+	script::PyGC::decTracing(g_tracingSlot);
 
 //	DEBUG_MSG(fmt::format("FixedDict::~FixedDict(): {:p}\n", (void*)this));
 }
@@ -30,8 +30,18 @@ namespace KBEngine
 {
 
 ProfileGroup* g_pDefaultGroup = NULL;
+
 TimeStamp ProfileVal::warningPeriod_;
 
+//-------------------------------------------------------------------------------------
+// дgroup ʱʱʹ
+// ģȫProfileValھ̬ʼڼͻᴴgroup ˲ʹȫֱ
+static std::vector<ProfileGroup*>& profileGroups()
+{
+	static std::vector<ProfileGroup*> groups;
+	return groups;
+}
+
 //-------------------------------------------------------------------------------------
 uint64 runningTime()
 {
@@ -40,17 +50,28 @@ uint64 runningTime()
 
 //-------------------------------------------------------------------------------------
 ProfileGroup::ProfileGroup(std::string name):
-name_(name)
+name_(name),
+traceEvents_(),
+traceIndex_(0),
+traceNames_(),
+traceNameIDs_()
 {
 	stampsPerSecond();
 
 	ProfileVal * pRunningTime = new ProfileVal("RunningTime", this);
 	pRunningTime->start();
+
+	profileGroups().push_back(this);
 }
 
 //-------------------------------------------------------------------------------------
 ProfileGroup::~ProfileGroup()
 {
+	std::vector<ProfileGroup*>& groups = profileGroups();
+	std::vector<ProfileGroup*>::iterator iter = std::find(groups.begin(), groups.end(), this);
+	if (iter != groups.end())
+		groups.erase(iter);
+
 	delete this->pRunningTime();
 }
 
@@ -72,6 +93,19 @@ void ProfileGroup::add( ProfileVal * pVal )
 	profiles_.push_back( pVal );
 }
 
+//-------------------------------------------------------------------------------------
+uint32 ProfileGroup::traceNameID(const std::string& name)
+{
+	std::map<std::string, uint32>::iterator iter = traceNameIDs_.find(name);
+	if (iter != traceNameIDs_.end())
+		return iter->second;
+
+	uint32 id = (uint32)traceNames_.size();
+	traceNames_.push_back(name);
+	traceNameIDs_[name] = id;
+	return id;
+}
+
 //-------------------------------------------------------------------------------------
 ProfileGroup & ProfileGroup::defaultGroup()
 {
@@ -86,25 +120,120 @@ bool ProfileGroup::initializeWatcher()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+static std::string jsonEscape(const std::string& s)
+{
+	std::string ret;
+	ret.reserve(s.size());
+
+	for (size_t i = 0; i < s.size(); ++i)
+	{
+		unsigned char c = (unsigned char)s[i];
+
+		switch (c)
+		{
+		case '"': ret += "\\\""; break;
+		case '\\': ret += "\\\\"; break;
+		case '\n': ret += "\\n"; break;
+		case '\r': ret += "\\r"; break;
+		case '\t': ret += "\\t"; break;
+		default:
+			if (c < 0x20)
+				ret += fmt::format("\\u{:04x}", (uint32)c);
+			else
+				ret += (char)c;
+			break;
+		};
+	}
+
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+std::string ProfileGroup::dumpChromeTrace(float seconds, uint32& eventCount)
+{
+	eventCount = 0;
+
+	uint64 now = timestamp();
+	uint64 since = now - KBE_MIN(now, uint64(seconds * stampsPerSecondD()));
+
+	std::string datas = "{\"traceEvents\":[";
+
+	std::vector<ProfileGroup*>& groups = profileGroups();
+	for (uint32 i = 0; i < (uint32)groups.size(); ++i)
+		groups[i]->appendChromeTrace(datas, since, i, eventCount);
+
+	datas += "]}";
+	return datas;
+}
+
+//-------------------------------------------------------------------------------------
+void ProfileGroup::appendChromeTrace(std::string& datas, uint64 since, uint32 tid, uint32& eventCount) const
+{
+	int32 pid = getProcessPID();
+	std::string groupName = jsonEscape(name_);
+
+	// ߳Ԫݣ ʱʾgroupƣ ¼
+	if (datas[datas.size() - 1] != '[')
+		datas += ",";
+
+	datas += fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+		pid, tid, groupName);
+
+	if (traceEvents_.empty())
+		return;
+
+	double stampsPerMicrosecond = stampsPerSecondD() / 1000000.0;
+
+	// δдʱ0ʼ ɵ¼ʼ
+	uint32 count = KBE_MIN(traceIndex_, (uint32)TRACE_BUFFER_SIZE);
+	uint32 start = traceIndex_ - count;
+
+	for (uint32 i = 0; i < count; ++i)
+	{
+		const TraceEvent& event = traceEvents_[(start + i) & (TRACE_BUFFER_SIZE - 1)];
+		if (event.end < since)
+			continue;
+
+		datas += ",";
+		++eventCount;
+
+		datas += fmt::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":{},\"tid\":{}",
+			jsonEscape(traceNames_[event.nameID]), groupName, double(event.begin) / stampsPerMicrosecond, 
+			double(event.end - event.begin) / stampsPerMicrosecond, pid, tid);
+
+		if (event.quantity > 0)
+			datas += fmt::format(",\"args\":{{\"quantity\":{}}}", event.quantity);
+
+		datas += "}";
+	}
+}
+
 //-------------------------------------------------------------------------------------
 ProfileVal::ProfileVal(std::string name, ProfileGroup * pGroup):
 	name_(name),
 	pProfileGroup_(pGroup),
+	traceNameID_(0),
 	lastTime_(0),
 	sumTime_(0),
 	lastIntTime_(0),
 	sumIntTime_(0),
+	maxTime_(0),
 	lastQuantity_(0),
 	sumQuantity_(0),
 	count_(0),
 	inProgress_(0),
 	initWatcher_(false)
 {
+	memset(histogram_, 0, sizeof(histogram_));
+
 	if (pProfileGroup_ == NULL)
 	{
 		pProfileGroup_ = &ProfileGroup::defaultGroup();
 	}
 
+	traceNameID_ = pProfileGroup_->traceNameID(name_);
+
 	if (!name_.empty())
 	{
 		pProfileGroup_->add( this );
@@ -153,9 +282,44 @@ bool ProfileVal::initializeWatcher()
 	kbe_snprintf(buf, MAX_BUF, "cprofiles/%s/%s/inProgress", pProfileGroup_->name(), name_.c_str());
 	WATCH_OBJECT(buf, inProgress_);
 
+	kbe_snprintf(buf, MAX_BUF, "cprofiles/%s/%s/maxTime", pProfileGroup_->name(), name_.c_str());
+	WATCH_OBJECT(buf, &maxTime_, &TimeStamp::stamp);
+
+	kbe_snprintf(buf, MAX_BUF, "cprofiles/%s/%s/p50", pProfileGroup_->name(), name_.c_str());
+	WATCH_OBJECT(buf, this, &ProfileVal::p50);
+
+	kbe_snprintf(buf, MAX_BUF, "cprofiles/%s/%s/p99", pProfileGroup_->name(), name_.c_str());
+	WATCH_OBJECT(buf, this, &ProfileVal::p99);
+
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+uint64 ProfileVal::percentile(float p) const
+{
+	uint64 total = 0;
+	for (int i = 0; i < HISTOGRAM_SIZE; ++i)
+		total += histogram_[i];
+
+	if (total == 0)
+		return 0;
+
+	uint64 target = uint64(double(total) * p);
+	uint64 sum = 0;
+	int i = 0;
+
+	for (; i < HISTOGRAM_SIZE - 1; ++i)
+	{
+		sum += histogram_[i];
+		if (sum > target)
+			break;
+	}
+
+	// ظͰ
+	double stamps = double(uint64(1) << (i + 1 < HISTOGRAM_SIZE ? i + 1 : i));
+	return uint64(stamps * 1000000.0 / stampsPerSecondD());
+}
+
 //-------------------------------------------------------------------------------------
 } 
 
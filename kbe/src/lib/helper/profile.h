@@ -42,6 +42,19 @@ public:
 	typedef std::vector<ProfileVal*> PROFILEVALS;
 	typedef PROFILEVALS::iterator iterator;
 
+	// profile¼ ڵʱ
+	// ֻ¼id ProfileValڵ֮ǰͱ
+	struct TraceEvent
+	{
+		uint64 begin;
+		uint64 end;
+		uint32 nameID;
+		uint32 quantity;
+	};
+
+	// λС 2
+	enum { TRACE_BUFFER_SIZE = 1 << 16 };
+
 	static ProfileGroup & defaultGroup();
 
 	PROFILEVALS & stack() { return stack_; }
@@ -62,10 +75,45 @@ public:
 
 	INLINE const ProfileGroup::PROFILEVALS& profiles() const;
 
+	/**
+		¼һprofileֹʱ䣬 д뻷λ ɵ¼
+		stack_һ һgroupֻӦһ߳ʹã 
+	*/
+	void addTraceEvent(uint32 nameID, uint64 begin, uint64 end, uint32 quantity)
+	{
+		if(traceEvents_.empty())
+			traceEvents_.resize(TRACE_BUFFER_SIZE);
+
+		TraceEvent& event = traceEvents_[traceIndex_++ & (TRACE_BUFFER_SIZE - 1)];
+		event.begin = begin;
+		event.end = end;
+		event.nameID = nameID;
+		event.quantity = quantity;
+	}
+
+	/**
+		ʱеid ͬprofileһid groupǰһֱ
+	*/
+	uint32 traceNameID(const std::string& name);
+
+	/**
+		groupsecondsڵ¼ΪChrome trace(chrome://tracing)ʽjson
+		ÿgroupΪһ߳(tid)ʾ
+	*/
+	static std::string dumpChromeTrace(float seconds, uint32& eventCount);
+
 private:
 	PROFILEVALS profiles_;
 	PROFILEVALS stack_;
 	std::string name_;
+
+	void appendChromeTrace(std::string& datas, uint64 since, uint32 tid, uint32& eventCount) const;
+
+	std::vector<TraceEvent> traceEvents_;
+	uint32 traceIndex_;
+
+	std::vector<std::string> traceNames_;
+	std::map<std::string, uint32> traceNameIDs_;
 };
 
 class ProfileVal
@@ -112,8 +160,15 @@ public:
 		// Ϊ0ԼǵջĲ
 		// ڴǿԵõܹķѵʱ
 		if (--inProgress_ == 0){
+			TimeStamp begin = lastTime_;
 			lastTime_ = now - lastTime_;
 			sumTime_ += lastTime_;
+
+			if (lastTime_ > maxTime_)
+				maxTime_ = lastTime_;
+
+			++histogram_[histogramIndex(lastTime_)];
+			pProfileGroup_->addTraceEvent(traceNameID_, begin, now, qty);
 		}
 
 		lastQuantity_ = qty;
@@ -159,6 +214,27 @@ public:
 
 	INLINE bool isTooLong() const;
 
+	/**
+		ʱֲ ʱlog2Ͱͳƣ ذٷλӦĺʱ(΢)
+	*/
+	uint64 percentile(float p) const;
+	uint64 p50() const { return percentile(0.5f); }
+	uint64 p99() const { return percentile(0.99f); }
+
+	static int histogramIndex(uint64 stamps)
+	{
+		int index = 0;
+		if (stamps >= (uint64(1) << 32)) { stamps >>= 32; index += 32; }
+		if (stamps >= (uint64(1) << 16)) { stamps >>= 16; index += 16; }
+		if (stamps >= (uint64(1) << 8)) { stamps >>= 8; index += 8; }
+		if (stamps >= (uint64(1) << 4)) { stamps >>= 4; index += 4; }
+		if (stamps >= (uint64(1) << 2)) { stamps >>= 2; index += 2; }
+		if (stamps >= (uint64(1) << 1)) { index += 1; }
+		return index;
+	}
+
+	enum { HISTOGRAM_SIZE = 64 };
+
 	static void setWarningPeriod(TimeStamp warningPeriod) { warningPeriod_ = warningPeriod; }
 
 	// 
@@ -167,6 +243,9 @@ public:
 	// ProfileGroupָ
 	ProfileGroup * pProfileGroup_;
 
+	// groupʱеid
+	uint32			traceNameID_;
+
 	// startdʱ.
 	TimeStamp		lastTime_;
 
@@ -179,6 +258,12 @@ public:
 	// count_ڲʱ
 	TimeStamp		sumIntTime_;
 
+	// ʱ
+	TimeStamp		maxTime_;
+
+	// ʱֲ ±Ϊʱ(stamps)log2
+	uint32			histogram_[HISTOGRAM_SIZE];
+
 	uint32			lastQuantity_;	///< The last value passed into stop.
 	uint32			sumQuantity_;	///< The total of all values passed into stop.
 	uint32			count_;			///< The number of times stop has been called.
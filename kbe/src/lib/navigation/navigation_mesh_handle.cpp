@@ -24,8 +24,15 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "thread/threadguard.h"
 #include "math/math.h"
 
+#include <sys/stat.h>
+#if KBE_PLATFORM != PLATFORM_WIN32
+#include <sys/mman.h>
+#endif
+
 namespace KBEngine{	
 
+static void unmapNavmeshFile(void* pData, size_t size);
+
 // Returns a random number [0..1)
 static float frand()
 {
@@ -57,6 +64,7 @@ NavMeshHandle::~NavMeshHandle()
 	{
 		dtFreeNavMesh(iter->second.pNavmesh);
 		dtFreeNavMeshQuery(iter->second.pNavmeshQuery);
+		unmapNavmeshFile(iter->second.pMappedData, iter->second.mappedSize);
 	}
 	
 	DEBUG_MSG(fmt::format("NavMeshHandle::~NavMeshHandle(): ({}) is destroyed!\n", resPath));
@@ -972,7 +980,8 @@ NavigationHandle* NavMeshHandle::create(std::string resPath, const std::map< int
 
 //-------------------------------------------------------------------------------------
 template<typename NAVMESH_SET_HEADER>
-dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res, bool showlog)
+bool readNavmeshTiles(const uint8* data, size_t readsize, const std::string& res, bool showlog,
+	dtNavMeshParams& params, std::vector<NavMeshMappedTileHeader>& tiles)
 {
 	if (readsize < sizeof(NAVMESH_SET_HEADER))
 	{
@@ -982,12 +991,11 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 				Resmgr::getSingleton().matchRes(res)));
 		}
 
-		return NULL;
+		return false;
 	}
 	
-	int pos = 0;
-	int size = 0;
-	bool safeStorage = true;
+	size_t pos = 0;
+	size_t size = 0;
 	
 	NAVMESH_SET_HEADER header;
 	size = sizeof(NAVMESH_SET_HEADER);
@@ -1002,9 +1010,51 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 				header.version, ((int)NavMeshHandle::RCN_NAVMESH_VERSION)));
 		}
 		
-		return NULL;
+		return false;
+	}
+
+	memcpy(&params, &header.params, sizeof(dtNavMeshParams));
+	pos += size;
+
+	for (int i = 0; i < header.tileCount; ++i)
+	{
+		NavMeshTileHeader tileHeader;
+		size = sizeof(NavMeshTileHeader);
+
+		if (pos + size > readsize)
+			return false;
+
+		memcpy(&tileHeader, &data[pos], size);
+		pos += size;
+
+		if (!tileHeader.tileRef || tileHeader.dataSize <= 0 || pos + tileHeader.dataSize > readsize)
+		{
+			if(showlog)
+			{
+				ERROR_MSG(fmt::format("NavMeshHandle::tryReadNavmesh: open({}), tile({}) error!\n", 
+					Resmgr::getSingleton().matchRes(res), i));
+			}
+
+			return false;
+		}
+
+		NavMeshMappedTileHeader tile;
+		memset(&tile, 0, sizeof(tile));
+		tile.tileRef = tileHeader.tileRef;
+		tile.dataOffset = pos;
+		tile.dataSize = tileHeader.dataSize;
+		tiles.push_back(tile);
+
+		pos += tileHeader.dataSize;
 	}
 
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static dtNavMesh* createNavmeshFromTiles(const dtNavMeshParams& params, uint8* data, 
+	const std::vector<NavMeshMappedTileHeader>& tiles, bool copyData, bool showlog)
+{
 	dtNavMesh* mesh = dtAllocNavMesh();
 	if (!mesh)
 	{
@@ -1016,7 +1066,7 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 		return NULL;
 	}
 
-	dtStatus status = mesh->init(&header.params);
+	dtStatus status = mesh->init(&params);
 	if (dtStatusFailed(status))
 	{
 		if(showlog)
@@ -1030,44 +1080,39 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 
 	// Read tiles.
 	bool success = true;
-	pos += size;
 
-	for (int i = 0; i < header.tileCount; ++i)
+	std::vector<NavMeshMappedTileHeader>::const_iterator iter = tiles.begin();
+	for (; iter != tiles.end(); ++iter)
 	{
-		NavMeshTileHeader tileHeader;
-		size = sizeof(NavMeshTileHeader);
-
-		memcpy(&tileHeader, &data[pos], size);
-		pos += size;
+		int size = (*iter).dataSize;
+		unsigned char* tileData = data + (*iter).dataOffset;
 
-		size = tileHeader.dataSize;
-		if (!tileHeader.tileRef || !tileHeader.dataSize)
+		// ӳֱӽDetour ͷNavMeshHandle
+		if (copyData)
 		{
-			success = false;
-			status = DT_FAILURE + DT_INVALID_PARAM;
-			break;
-		}
-		
-		unsigned char* tileData = 
-			(unsigned char*)dtAlloc(size, DT_ALLOC_PERM);
+			tileData = (unsigned char*)dtAlloc(size, DT_ALLOC_PERM);
 
-		if (!tileData)
-		{
-			success = false;
-			status = DT_FAILURE + DT_OUT_OF_MEMORY;
-			break;
+			if (!tileData)
+			{
+				success = false;
+				status = DT_FAILURE + DT_OUT_OF_MEMORY;
+				break;
+			}
+
+			memcpy(tileData, data + (*iter).dataOffset, size);
 		}
-		memcpy(tileData, &data[pos], size);
-		pos += size;
 
 		status = mesh->addTile(tileData
 			, size
-			, (safeStorage ? DT_TILE_FREE_DATA : 0)
-			, tileHeader.tileRef
+			, (copyData ? DT_TILE_FREE_DATA : 0)
+			, (*iter).tileRef
 			, 0);
 
 		if (dtStatusFailed(status))
 		{
+			if (copyData)
+				dtFree(tileData);
+
 			success = false;
 			break;
 		}
@@ -1087,23 +1132,33 @@ dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res,
 	return mesh;
 }
 
-bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::string& res, NavMeshHandle* pNavMeshHandle)
+//-------------------------------------------------------------------------------------
+template<typename NAVMESH_SET_HEADER>
+dtNavMesh* tryReadNavmesh(uint8* data, size_t readsize, const std::string& res, bool showlog)
+{
+	dtNavMeshParams params;
+	std::vector<NavMeshMappedTileHeader> tiles;
+
+	if (!readNavmeshTiles<NAVMESH_SET_HEADER>(data, readsize, res, showlog, params, tiles))
+		return NULL;
+
+	return createNavmeshFromTiles(params, data, tiles, true, showlog);
+}
+
+//-------------------------------------------------------------------------------------
+static uint8* readNavmeshFile(const std::string& res, size_t& flen)
 {
-	KBE_ASSERT(pNavMeshHandle);
 	FILE* fp = fopen(res.c_str(), "rb");
 	if (!fp)
 	{
 		ERROR_MSG(fmt::format("NavMeshHandle::create: open({}) error!\n", 
 			Resmgr::getSingleton().matchRes(res)));
 
-		return false;
+		return NULL;
 	}
-	
-	DEBUG_MSG(fmt::format("NavMeshHandle::create: ({}), layer={}\n", 
-		res, layer));
 
 	fseek(fp, 0, SEEK_END); 
-	size_t flen = ftell(fp); 
+	flen = ftell(fp); 
 	fseek(fp, 0, SEEK_SET); 
 
 	uint8* data = new uint8[flen];
@@ -1114,7 +1169,7 @@ bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::st
 
 		fclose(fp);
 		SAFE_RELEASE_ARRAY(data);
-		return false;
+		return NULL;
 	}
 
 	size_t readsize = fread(data, 1, flen, fp);
@@ -1125,32 +1180,307 @@ bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::st
 
 		fclose(fp);
 		SAFE_RELEASE_ARRAY(data);
-		return false;
+		return NULL;
+	}
+
+	fclose(fp);
+	return data;
+}
+
+//-------------------------------------------------------------------------------------
+static void* mapNavmeshFile(const std::string& res, size_t& size)
+{
+#if KBE_PLATFORM == PLATFORM_WIN32
+	HANDLE hFile = CreateFileA(res.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, 
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	size = (size_t)GetFileSize(hFile, NULL);
+
+	// дʱƣ DetourдҳΪ˽У ҳ̹
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(hFile);
+
+	if (hMapping == NULL)
+		return NULL;
+
+	void* pData = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(hMapping);
+	return pData;
+#else
+	int fd = open(res.c_str(), O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat s;
+	if (fstat(fd, &s) != 0 || s.st_size <= 0)
+	{
+		close(fd);
+		return NULL;
 	}
 
-	dtNavMesh* mesh = tryReadNavmesh<NavMeshSetHeader>(data, readsize, res, false);
+	size = (size_t)s.st_size;
+
+	// дʱƣ DetourдҳΪ˽У ҳ̹
+	void* pData = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (pData == MAP_FAILED)
+		return NULL;
+
+	return pData;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+static void unmapNavmeshFile(void* pData, size_t size)
+{
+	if (pData == NULL)
+		return;
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+	UnmapViewOfFile(pData);
+#else
+	munmap(pData, size);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+static dtNavMesh* tryLoadMappedNavmesh(const std::string& res, void*& pMappedData, size_t& mappedSize)
+{
+	std::string mappedRes = res + ".mapped";
+
+	struct stat mappedStat;
+	if (stat(mappedRes.c_str(), &mappedStat) != 0)
+		return NULL;
+
+	struct stat sourceStat;
+	if (stat(res.c_str(), &sourceStat) != 0)
+		return NULL;
+
+	size_t size = 0;
+	uint8* data = (uint8*)mapNavmeshFile(mappedRes, size);
+	if (data == NULL)
+	{
+		WARNING_MSG(fmt::format("NavMeshHandle::create: map({}) error!\n", mappedRes));
+		return NULL;
+	}
+
+	NavMeshMappedHeader header;
+	if (size < sizeof(header))
+	{
+		unmapNavmeshFile(data, size);
+		return NULL;
+	}
+
+	memcpy(&header, data, sizeof(header));
+
+	if (header.magic != NAVMESH_MAPPED_MAGIC || header.version != NAVMESH_MAPPED_VERSION || header.tileCount < 0)
+	{
+		WARNING_MSG(fmt::format("NavMeshHandle::create: {} is not a valid mapped navmesh!\n", mappedRes));
+		unmapNavmeshFile(data, size);
+		return NULL;
+	}
+
+	if (header.sourceSize != (uint64)sourceStat.st_size || header.sourceMTime != (uint64)sourceStat.st_mtime)
+	{
+		WARNING_MSG(fmt::format("NavMeshHandle::create: {} is out of date, please run kbcmd --navmeshmapped again!\n", 
+			mappedRes));
+
+		unmapNavmeshFile(data, size);
+		return NULL;
+	}
+
+	size_t pos = sizeof(header);
+	std::vector<NavMeshMappedTileHeader> tiles;
+
+	for (int i = 0; i < header.tileCount; ++i)
+	{
+		NavMeshMappedTileHeader tile;
+		if (pos + sizeof(tile) > size)
+			break;
+
+		memcpy(&tile, data + pos, sizeof(tile));
+		pos += sizeof(tile);
+
+		if (!tile.tileRef || tile.dataSize <= 0 || (tile.dataOffset % NAVMESH_MAPPED_ALIGN) != 0 || 
+			tile.dataOffset + tile.dataSize > size)
+			break;
+
+		tiles.push_back(tile);
+	}
+
+	dtNavMesh* mesh = NULL;
+	if ((int)tiles.size() == header.tileCount)
+		mesh = createNavmeshFromTiles(header.params, data, tiles, false, true);
+
+	if (!mesh)
+	{
+		WARNING_MSG(fmt::format("NavMeshHandle::create: {} is corrupted!\n", mappedRes));
+		unmapNavmeshFile(data, size);
+		return NULL;
+	}
+
+	pMappedData = data;
+	mappedSize = size;
+	return mesh;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshHandle::writeMappedNavmesh(const std::string& res)
+{
+	size_t flen = 0;
+	uint8* data = readNavmeshFile(res, flen);
+	if (!data)
+		return false;
+
+	dtNavMeshParams params;
+	std::vector<NavMeshMappedTileHeader> tiles;
+
+	bool ret = readNavmeshTiles<NavMeshSetHeader>(data, flen, res, false, params, tiles);
 	
 	// ʧԼչʽ
-	if(!mesh)
-		mesh = tryReadNavmesh<NavMeshSetHeaderEx>(data, readsize, res, true);
+	if (!ret)
+	{
+		tiles.clear();
+		ret = readNavmeshTiles<NavMeshSetHeaderEx>(data, flen, res, true, params, tiles);
+	}
 
-	if (!mesh)
+	struct stat sourceStat;
+	if (!ret || stat(res.c_str(), &sourceStat) != 0)
 	{
-		ERROR_MSG("NavMeshHandle::create: dtAllocNavMesh is failed!\n");
-		fclose(fp);
+		ERROR_MSG(fmt::format("NavMeshHandle::writeMappedNavmesh: read({}) error!\n", res));
 		SAFE_RELEASE_ARRAY(data);
 		return false;
 	}
 
+	NavMeshMappedHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = NAVMESH_MAPPED_MAGIC;
+	header.version = NAVMESH_MAPPED_VERSION;
+	header.tileCount = (int)tiles.size();
+	header.align = NAVMESH_MAPPED_ALIGN;
+	header.sourceSize = (uint64)sourceStat.st_size;
+	header.sourceMTime = (uint64)sourceStat.st_mtime;
+	memcpy(&header.params, &params, sizeof(dtNavMeshParams));
+
+	// tileļжλ
+	std::vector<NavMeshMappedTileHeader> mappedTiles = tiles;
+	uint64 offset = sizeof(header) + sizeof(NavMeshMappedTileHeader) * mappedTiles.size();
+
+	std::vector<NavMeshMappedTileHeader>::iterator iter = mappedTiles.begin();
+	for (; iter != mappedTiles.end(); ++iter)
+	{
+		offset = (offset + NAVMESH_MAPPED_ALIGN - 1) & ~((uint64)NAVMESH_MAPPED_ALIGN - 1);
+		(*iter).dataOffset = offset;
+		offset += (*iter).dataSize;
+	}
+
+	// дʱļ滻 ӳ䵽дһļ
+	std::string mappedRes = res + ".mapped";
+	std::string tmpRes = mappedRes + ".tmp";
+
+	FILE* fp = fopen(tmpRes.c_str(), "wb");
+	if (!fp)
+	{
+		ERROR_MSG(fmt::format("NavMeshHandle::writeMappedNavmesh: open({}) error!\n", tmpRes));
+		SAFE_RELEASE_ARRAY(data);
+		return false;
+	}
+
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+	if (success && mappedTiles.size() > 0)
+		success = fwrite(&mappedTiles[0], sizeof(NavMeshMappedTileHeader), mappedTiles.size(), fp) == mappedTiles.size();
+
+	uint64 pos = sizeof(header) + sizeof(NavMeshMappedTileHeader) * mappedTiles.size();
+	static const char padding[NAVMESH_MAPPED_ALIGN] = {0};
+
+	for (size_t i = 0; success && i < mappedTiles.size(); ++i)
+	{
+		if (mappedTiles[i].dataOffset > pos)
+		{
+			size_t padsize = (size_t)(mappedTiles[i].dataOffset - pos);
+			success = fwrite(padding, 1, padsize, fp) == padsize;
+			pos += padsize;
+		}
+
+		if (success)
+		{
+			success = fwrite(data + tiles[i].dataOffset, 1, tiles[i].dataSize, fp) == (size_t)tiles[i].dataSize;
+			pos += tiles[i].dataSize;
+		}
+	}
+
 	fclose(fp);
 	SAFE_RELEASE_ARRAY(data);
 
+	if (success)
+	{
+		remove(mappedRes.c_str());
+		success = rename(tmpRes.c_str(), mappedRes.c_str()) == 0;
+	}
+
+	if (!success)
+	{
+		ERROR_MSG(fmt::format("NavMeshHandle::writeMappedNavmesh: write({}) error!\n", mappedRes));
+		remove(tmpRes.c_str());
+		return false;
+	}
+
+	INFO_MSG(fmt::format("NavMeshHandle::writeMappedNavmesh: {}, tiles={}, size={}\n", 
+		mappedRes, mappedTiles.size(), pos));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::string& res, NavMeshHandle* pNavMeshHandle)
+{
+	KBE_ASSERT(pNavMeshHandle);
+
+	DEBUG_MSG(fmt::format("NavMeshHandle::create: ({}), layer={}\n", 
+		res, layer));
+
+	uint64 startTime = timestamp();
+
+	// ʹÿڽ̼乲ӳʽ
+	void* pMappedData = NULL;
+	size_t mappedSize = 0;
+	dtNavMesh* mesh = tryLoadMappedNavmesh(res, pMappedData, mappedSize);
+
+	if (!mesh)
+	{
+		size_t readsize = 0;
+		uint8* data = readNavmeshFile(res, readsize);
+		if (!data)
+			return false;
+
+		mesh = tryReadNavmesh<NavMeshSetHeader>(data, readsize, res, false);
+		
+		// ʧԼչʽ
+		if(!mesh)
+			mesh = tryReadNavmesh<NavMeshSetHeaderEx>(data, readsize, res, true);
+
+		SAFE_RELEASE_ARRAY(data);
+
+		if (!mesh)
+		{
+			ERROR_MSG("NavMeshHandle::create: dtAllocNavMesh is failed!\n");
+			return false;
+		}
+	}
+
 	dtNavMeshQuery* pMavmeshQuery = new dtNavMeshQuery();
 
 	pMavmeshQuery->init(mesh, 1024);
 	pNavMeshHandle->resPath = resPath;
 	pNavMeshHandle->navmeshLayer[layer].pNavmeshQuery = pMavmeshQuery;
 	pNavMeshHandle->navmeshLayer[layer].pNavmesh = mesh;
+	pNavMeshHandle->navmeshLayer[layer].pMappedData = pMappedData;
+	pNavMeshHandle->navmeshLayer[layer].mappedSize = mappedSize;
 	
 	uint32 tileCount = 0;
 	uint32 nodeCount = 0;
@@ -1183,6 +1513,8 @@ bool NavMeshHandle::_create(int layer, const std::string& resPath, const std::st
 	DEBUG_MSG(fmt::format("\t==> {} polygons ({} vertices)\n", polyCount, vertCount));
 	DEBUG_MSG(fmt::format("\t==> {} triangles ({} vertices)\n", triCount, triVertCount));
 	DEBUG_MSG(fmt::format("\t==> {:.2f} MB of data (not including pointers)\n", (((float)dataSize / sizeof(unsigned char)) / 1048576)));
+	DEBUG_MSG(fmt::format("\t==> {} ({:.2f} MB), loaded in {:.2f} ms\n", (pMappedData ? "mapped" : "copied"), 
+		((float)mappedSize / 1048576), (double(timestamp() - startTime) * 1000.0 / stampsPerSecondD())));
 	
 	return true;
 }
@@ -61,6 +61,38 @@ struct NavMeshTileHeader
 	int dataSize;
 };
 
+/**
+	ֱӳ䵽ڴnavmeshʽ(xxx.navmesh.mapped) kbcmd --navmeshmappedɡ
+	tileļаNAVMESH_MAPPED_ALIGNţ ʱдʱƵķʽӳļ
+	tileֱӽDetour(DT_TILE_FREE_DATA) ͬһ̨ϵĶcellappҳ棬
+	ֻDetouraddTileʱдpolyslinksڵҳΪ˽
+*/
+#define NAVMESH_MAPPED_MAGIC		('K'<<24 | 'N'<<16 | 'M'<<8 | 'M')
+#define NAVMESH_MAPPED_VERSION		1
+#define NAVMESH_MAPPED_ALIGN		16
+
+struct NavMeshMappedHeader
+{
+	int magic;
+	int version;
+	int tileCount;
+	int align;
+
+	// ʱԴļĴС޸ʱ䣬 һʱ˵ԴļѸ£ ˵ȡԴļ
+	uint64 sourceSize;
+	uint64 sourceMTime;
+
+	dtNavMeshParams params;
+};
+
+struct NavMeshMappedTileHeader
+{
+	dtTileRef tileRef;
+	uint64 dataOffset;
+	int dataSize;
+	int reserved;
+};
+
 class NavMeshHandle : public NavigationHandle
 {
 public:
@@ -74,6 +106,10 @@ public:
 	{
 		dtNavMesh* pNavmesh;
 		dtNavMeshQuery* pNavmeshQuery;
+
+		// xxx.navmesh.mappedʱӳڴ棬 tileݲDetourͷ
+		void* pMappedData;
+		size_t mappedSize;
 	};
 
 public:
@@ -93,6 +129,11 @@ public:
 
 	static NavigationHandle* create(std::string resPath, const std::map< int, std::string >& params);
 	static bool _create(int layer, const std::string& resPath, const std::string& res, NavMeshHandle* pNavMeshHandle);
+
+	/**
+		resתΪֱӳĸʽ дres + ".mapped"
+	*/
+	static bool writeMappedNavmesh(const std::string& res);
 	
 	std::map<int, NavmeshLayer> navmeshLayer;
 private:
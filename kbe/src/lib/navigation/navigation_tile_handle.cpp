@@ -24,15 +24,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "thread/threadguard.h"
 #include "math/math.h"
 
-namespace KBEngine{	
-NavTileHandle* NavTileHandle::pCurrNavTileHandle = NULL;
-int NavTileHandle::currentLayer = 0;
-NavTileHandle::MapSearchNode NavTileHandle::nodeGoal;
-NavTileHandle::MapSearchNode NavTileHandle::nodeStart;
-AStarSearch<NavTileHandle::MapSearchNode> NavTileHandle::astarsearch;
+#include <queue>
 
-#define DEBUG_LISTS 0
-#define DEBUG_LIST_LENGTHS_ONLY 0
+namespace KBEngine{	
 
 // Returns a random number [0..1)
 static float frand()
@@ -41,12 +35,77 @@ static float frand()
 	return (float)rand()/(float)RAND_MAX;
 }
 
+#define SQRT2 1.41421356f
+
+/*
+	tileѰ·ѯȫ״̬ ڵߵջϴ ѯ
+	пͨtileͬʱʹ(JPS, 8 ǽ)
+	TileLayerGrid۵A*
+*/
+class TilePathSearch
+{
+public:
+	struct Node
+	{
+		Node(): g(0.f), parent(-1), closed(false) {}
+
+		float g;
+		int parent;
+		bool closed;
+	};
+
+	struct OpenNode
+	{
+		OpenNode(float pf, float pg, int pidx): f(pf), g(pg), idx(pidx) {}
+
+		// priority_queueǴ󶥶ѣ ȽfСڶѶ
+		bool operator<(const OpenNode& other) const { return f > other.f; }
+
+		float f;
+		float g;
+		int idx;
+	};
+
+	TilePathSearch(const NavTileHandle::TileLayerGrid& grid, bool direction8, int sx, int sy, int gx, int gy);
+
+	bool search();
+
+	/**
+		õ· 㣬 յ
+	*/
+	void solution(std::vector<NavTileHandle::MapSearchNode>& results) const;
+
+	size_t numVisited() const { return nodes_.size(); }
+
+private:
+	int index(int x, int y) const { return y * grid_.width + x; }
+
+	float heuristic(int x, int y) const;
+	void push(int idx, int parentIdx, float g);
+
+	void expandJPS(int idx);
+	void expandAStar(int idx);
+
+	int jump(int x, int y, int dx, int dy) const;
+	int jumpStraight(int x, int y, int dx, int dy) const;
+
+	const NavTileHandle::TileLayerGrid& grid_;
+	bool direction8_;
+	bool useJPS_;
+	int sx_, sy_, gx_, gy_;
+	int goalIdx_;
+
+	KBEUnordered_map<int, Node> nodes_;
+	std::priority_queue<OpenNode> open_;
+};
+
 
 //-------------------------------------------------------------------------------------
 NavTileHandle::NavTileHandle(bool dir):
 NavigationHandle(),
 pTilemap(0),
-direction8_(dir)
+direction8_(dir),
+layerGrids_()
 {
 }
 
@@ -54,7 +113,8 @@ direction8_(dir)
 NavTileHandle::NavTileHandle(const KBEngine::NavTileHandle & navTileHandle):
 NavigationHandle(),
 pTilemap(0),
-direction8_(navTileHandle.direction8_)
+direction8_(navTileHandle.direction8_),
+layerGrids_(navTileHandle.layerGrids_)
 {
 	pTilemap = new Tmx::Map(*navTileHandle.pTilemap);
 }
@@ -71,112 +131,43 @@ NavTileHandle::~NavTileHandle()
 //-------------------------------------------------------------------------------------
 int NavTileHandle::findStraightPath(int layer, uint16 flags, const Position3D& start, const Position3D& end, std::vector<Position3D>& paths)
 {
-	setMapLayer(layer);
-	pCurrNavTileHandle = this;
-
-	if(pCurrNavTileHandle->pTilemap->GetNumLayers() < layer + 1)
+	const TileLayerGrid* pGrid = layerGrid(layer);
+	if(pGrid == NULL)
 	{
 		ERROR_MSG(fmt::format("NavTileHandle::findStraightPath: not found layer({})\n", layer));
 		return NAV_ERROR;
 	}
 
 	// Create a start state
-	nodeStart.x = int(start.x / pTilemap->GetTileWidth());
-	nodeStart.y = int(start.z / pTilemap->GetTileHeight()); 
+	int sx = int(start.x / pTilemap->GetTileWidth());
+	int sy = int(start.z / pTilemap->GetTileHeight()); 
 
 	// Define the goal state
-	nodeGoal.x = int(end.x / pTilemap->GetTileWidth());				
-	nodeGoal.y = int(end.z / pTilemap->GetTileHeight()); 
+	int gx = int(end.x / pTilemap->GetTileWidth());				
+	int gy = int(end.z / pTilemap->GetTileHeight()); 
 
 	//DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: start({}, {}), end({}, {})\n", 
-	//	nodeStart.x, nodeStart.y, nodeGoal.x, nodeGoal.y));
-
-	// Set Start and goal states
-	astarsearch.SetStartAndGoalStates(nodeStart, nodeGoal);
+	//	sx, sy, gx, gy));
 
-	unsigned int SearchState;
-	unsigned int SearchSteps = 0;
+	TilePathSearch search(*pGrid, direction8_, sx, sy, gx, gy);
 
-	do
+	if(!search.search())
 	{
-		SearchState = astarsearch.SearchStep();
-
-		SearchSteps++;
-
-#if DEBUG_LISTS
-
-		DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: Steps: {}\n", SearchSteps));
-
-		int len = 0;
-
-		DEBUG_MSG("NavTileHandle::findStraightPath: Open:\n");
-		MapSearchNode *p = astarsearch.GetOpenListStart();
-		while( p )
-		{
-			len++;
-#if !DEBUG_LIST_LENGTHS_ONLY			
-			((MapSearchNode *)p)->printNodeInfo();
-#endif
-			p = astarsearch.GetOpenListNext();
-			
-		}
-		
-		DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: Open list has {} nodes\n", len));
-
-		len = 0;
-
-		DEBUG_MSG("NavTileHandle::findStraightPath: Closed:\n");
-		p = astarsearch.GetClosedListStart();
-		while( p )
-		{
-			len++;
-#if !DEBUG_LIST_LENGTHS_ONLY			
-			p->printNodeInfo();
-#endif			
-			p = astarsearch.GetClosedListNext();
-		}
-
-		DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: Closed list has {} nodes\n", len));
-#endif
-
+		ERROR_MSG("NavTileHandle::findStraightPath: Search terminated. Did not find goal state\n");
+		return 0;
 	}
-	while( SearchState == AStarSearch<MapSearchNode>::SEARCH_STATE_SEARCHING );
-
-	if( SearchState == AStarSearch<MapSearchNode>::SEARCH_STATE_SUCCEEDED )
-	{
-		//DEBUG_MSG("NavTileHandle::findStraightPath: Search found goal state\n");
-		MapSearchNode *node = astarsearch.GetSolutionStart();
 
-		int steps = 0;
+	std::vector<MapSearchNode> nodes;
+	search.solution(nodes);
 
-		//node->PrintNodeInfo();
-		for( ;; )
-		{
-			node = astarsearch.GetSolutionNext();
-
-			if( !node )
-			{
-				break;
-			}
-
-			//node->PrintNodeInfo();
-			steps ++;
-			paths.push_back(Position3D((float)node->x * pTilemap->GetTileWidth(), 0, (float)node->y * pTilemap->GetTileWidth()));
-		};
-
-		// DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: Solution steps {}\n", steps));
-		// Once you're done with the solution you can free the nodes up
-		astarsearch.FreeSolutionNodes();
-	}
-	else if( SearchState == AStarSearch<MapSearchNode>::SEARCH_STATE_FAILED ) 
+	std::vector<MapSearchNode>::iterator iter = nodes.begin();
+	for(; iter != nodes.end(); ++iter)
 	{
-		ERROR_MSG("NavTileHandle::findStraightPath: Search terminated. Did not find goal state\n");
+		paths.push_back(Position3D((float)(*iter).x * pTilemap->GetTileWidth(), 0, (float)(*iter).y * pTilemap->GetTileWidth()));
 	}
 
-	// Display the number of loops the search went through
-	// DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: SearchSteps: {}\n", SearchSteps));
-	astarsearch.EnsureMemoryFreed();
-
+	// DEBUG_MSG(fmt::format("NavTileHandle::findStraightPath: Solution steps {}, visited {}\n", 
+	//	nodes.size(), search.numVisited()));
 	return 0;
 }
 
@@ -238,10 +229,7 @@ void NavTileHandle::bresenhamLine(int x0, int y0, int x1, int y1, std::vector<Ma
 //-------------------------------------------------------------------------------------
 int NavTileHandle::raycast(int layer, uint16 flags, const Position3D& start, const Position3D& end, std::vector<Position3D>& hitPointVec)
 {
-	setMapLayer(layer);
-	pCurrNavTileHandle = this;
-
-	if(pCurrNavTileHandle->pTilemap->GetNumLayers() < layer + 1)
+	if(layerGrid(layer) == NULL)
 	{
 		ERROR_MSG(fmt::format("NavTileHandle::raycast: not found layer({})\n",  layer));
 		return NAV_ERROR;
@@ -268,7 +256,7 @@ int NavTileHandle::raycast(int layer, uint16 flags, const Position3D& start, con
 	std::vector<MapSearchNode>::iterator iter = vec.begin();
 	for(; iter != vec.end(); iter++)
 	{
-		if(getMap((*iter).x, (*iter).y) == TILE_STATE_CLOSED)
+		if(getMap(layer, (*iter).x, (*iter).y) == TILE_STATE_CLOSED)
 			break;
 
 		hitPointVec.push_back(Position3D(float((*iter).x * pTilemap->GetTileWidth()), start.y, float((*iter).y * pTilemap->GetTileWidth())));
@@ -287,10 +275,7 @@ int NavTileHandle::collideVertical(int layer, uint16 flags, const Position3D& po
 int NavTileHandle::findRandomPointAroundCircle(int layer, uint16 flags, const Position3D& centerPos,
 	std::vector<Position3D>& points, uint32 max_points, float maxRadius)
 {
-	setMapLayer(layer);
-	pCurrNavTileHandle = this;
-
-	if(pCurrNavTileHandle->pTilemap->GetNumLayers() < layer + 1)
+	if(layerGrid(layer) == NULL)
 	{
 		ERROR_MSG(fmt::format("NavTileHandle::findRandomPointAroundCircle: not found layer({})\n", layer));
 		return NAV_ERROR;
@@ -406,6 +391,7 @@ NavTileHandle* NavTileHandle::_create(const std::string& res)
 	
 	NavTileHandle* pNavTileHandle = new NavTileHandle(mapdir);
 	pNavTileHandle->pTilemap = map;
+	pNavTileHandle->compileLayers();
 	return pNavTileHandle;
 }
 
@@ -425,195 +411,388 @@ bool NavTileHandle::validTile(int x, int y) const
 }
 
 //-------------------------------------------------------------------------------------
-int NavTileHandle::getMap(int x, int y)
+int NavTileHandle::getMap(int layer, int x, int y) const
 {
-	if(!validTile(x, y))
+	const TileLayerGrid* pGrid = layerGrid(layer);
+	if(pGrid == NULL)
 		return TILE_STATE_CLOSED;	 
 
-	Tmx::MapTile& mapTile = pTilemap->GetLayer(currentLayer)->GetTile(x, y);
-	
-	return (int)mapTile.id;
+	return pGrid->get(x, y);
 }
 
 //-------------------------------------------------------------------------------------
-bool NavTileHandle::MapSearchNode::IsSameState(MapSearchNode &rhs)
+void NavTileHandle::compileLayers()
 {
-	// same state in a maze search is simply when (x,y) are the same
-	if( (x == rhs.x) &&
-		(y == rhs.y) )
-	{
-		return true;
-	}
-	else
+	layerGrids_.clear();
+
+	for(int i = 0; i < pTilemap->GetNumLayers(); ++i)
 	{
-		return false;
+		Tmx::Layer* pLayer = pTilemap->GetLayer(i);
+
+		TileLayerGridPtr pGrid(new TileLayerGrid());
+		pGrid->width = pLayer->GetWidth();
+		pGrid->height = pLayer->GetHeight();
+		pGrid->costs.resize(pGrid->width * pGrid->height, TILE_STATE_CLOSED);
+
+		int uniform = -1;
+
+		for(int y = 0; y < pGrid->height; ++y)
+		{
+			for(int x = 0; x < pGrid->width; ++x)
+			{
+				unsigned id = pLayer->GetTileId(x, y);
+				if(id >= TILE_STATE_CLOSED)
+					continue;
+
+				pGrid->costs[y * pGrid->width + x] = (uint8)id;
+
+				if(uniform == -1)
+				{
+					uniform = (int)id;
+					pGrid->minCost = (int)id;
+				}
+				else if(uniform != (int)id)
+				{
+					pGrid->uniformCost = false;
+				}
+
+				if((int)id < pGrid->minCost)
+					pGrid->minCost = (int)id;
+			}
+		}
+
+		DEBUG_MSG(fmt::format("\t==> layer {:02d} : {}x{}, uniformCost={}, minCost={}\n", 
+			i, pGrid->width, pGrid->height, pGrid->uniformCost, pGrid->minCost));
+
+		layerGrids_.push_back(pGrid);
 	}
 }
 
 //-------------------------------------------------------------------------------------
-void NavTileHandle::MapSearchNode::PrintNodeInfo()
+const NavTileHandle::TileLayerGrid* NavTileHandle::layerGrid(int layer) const
 {
-	char str[100];
-	sprintf( str, "NavTileHandle::MapSearchNode::printNodeInfo(): Node position : (%d,%d)\n", 
-		x, y);
-	
-	DEBUG_MSG(str);
+	if(layer < 0 || layer >= (int)layerGrids_.size())
+		return NULL;
+
+	return layerGrids_[layer].get();
 }
 
 //-------------------------------------------------------------------------------------
-// Here's the heuristic function that estimates the distance from a Node
-// to the Goal. 
-
-float NavTileHandle::MapSearchNode::GoalDistanceEstimate(MapSearchNode &nodeGoal)
+TilePathSearch::TilePathSearch(const NavTileHandle::TileLayerGrid& grid, bool direction8, 
+	int sx, int sy, int gx, int gy):
+grid_(grid),
+direction8_(direction8),
+useJPS_(direction8 && grid.uniformCost),
+sx_(sx),
+sy_(sy),
+gx_(gx),
+gy_(gy),
+goalIdx_(-1),
+nodes_(),
+open_()
 {
-	float xd = float(((float)x - (float)nodeGoal.x));
-	float yd = float(((float)y - (float)nodeGoal.y));
-
-	return xd + yd;
 }
 
 //-------------------------------------------------------------------------------------
-bool NavTileHandle::MapSearchNode::IsGoal(MapSearchNode &nodeGoal)
+bool TilePathSearch::search()
 {
+	// յ㲻ɴʱŵͼ
+	if(!grid_.passable(gx_, gy_))
+		return false;
+
+	if(sx_ < 0 || sx_ >= grid_.width || sy_ < 0 || sy_ >= grid_.height)
+		return false;
+
+	goalIdx_ = index(gx_, gy_);
+	push(index(sx_, sy_), -1, 0.f);
 
-	if( (x == nodeGoal.x) &&
-		(y == nodeGoal.y) )
+	while(!open_.empty())
 	{
-		return true;
+		OpenNode curr = open_.top();
+		open_.pop();
+
+		Node& node = nodes_[curr.idx];
+
+		// Ѿи̵·ڵ㣬 Ƕڵļ¼
+		if(node.closed || curr.g > node.g)
+			continue;
+
+		node.closed = true;
+
+		if(curr.idx == goalIdx_)
+			return true;
+
+		if(useJPS_)
+			expandJPS(curr.idx);
+		else
+			expandAStar(curr.idx);
 	}
 
 	return false;
 }
 
 //-------------------------------------------------------------------------------------
-// This generates the successors to the given Node. It uses a helper function called
-// AddSuccessor to give the successors to the AStar class. The A* specific initialisation
-// is done for each node internally, so here you just set the state information that
-// is specific to the application
-bool NavTileHandle::MapSearchNode::GetSuccessors(AStarSearch<MapSearchNode> *astarsearch, MapSearchNode *parent_node)
+float TilePathSearch::heuristic(int x, int y) const
 {
-	int parent_x = -1; 
-	int parent_y = -1; 
+	int dx = abs(x - gx_);
+	int dy = abs(y - gy_);
 
-	if( parent_node )
-	{
-		parent_x = parent_node->x;
-		parent_y = parent_node->y;
-	}
-	
-	MapSearchNode NewNode;
+	if(useJPS_)
+		return (float)std::max(dx, dy) + (SQRT2 - 1.f) * (float)std::min(dx, dy);
 
-	// push each possible move except allowing the search to go backwards
+	// ÿһĴΪminCost ۲ᳬʵʴ
+	if(direction8_)
+		return (float)(grid_.minCost * std::max(dx, dy));
 
-	if( (NavTileHandle::pCurrNavTileHandle->getMap( x-1, y ) < TILE_STATE_CLOSED) 
-		&& !((parent_x == x-1) && (parent_y == y))
-	  ) 
-	{
-		NewNode = MapSearchNode( x-1, y );
-		astarsearch->AddSuccessor( NewNode );
-	}	
+	return (float)(grid_.minCost * (dx + dy));
+}
 
-	if( (NavTileHandle::pCurrNavTileHandle->getMap( x, y-1 ) < TILE_STATE_CLOSED) 
-		&& !((parent_x == x) && (parent_y == y-1))
-	  ) 
+//-------------------------------------------------------------------------------------
+void TilePathSearch::push(int idx, int parentIdx, float g)
+{
+	KBEUnordered_map<int, Node>::iterator iter = nodes_.find(idx);
+	if(iter != nodes_.end())
 	{
-		NewNode = MapSearchNode( x, y-1 );
-		astarsearch->AddSuccessor( NewNode );
-	}	
+		if(iter->second.closed || iter->second.g <= g)
+			return;
 
-	if( (NavTileHandle::pCurrNavTileHandle->getMap( x+1, y ) < TILE_STATE_CLOSED)
-		&& !((parent_x == x+1) && (parent_y == y))
-	  ) 
+		iter->second.g = g;
+		iter->second.parent = parentIdx;
+	}
+	else
 	{
-		NewNode = MapSearchNode( x+1, y );
-		astarsearch->AddSuccessor( NewNode );
+		Node& node = nodes_[idx];
+		node.g = g;
+		node.parent = parentIdx;
 	}
-		
-	if( (NavTileHandle::pCurrNavTileHandle->getMap( x, y+1 ) < TILE_STATE_CLOSED) 
-		&& !((parent_x == x) && (parent_y == y+1))
-		)
+
+	open_.push(OpenNode(g + heuristic(idx % grid_.width, idx / grid_.width), g, idx));
+}
+
+//-------------------------------------------------------------------------------------
+void TilePathSearch::expandAStar(int idx)
+{
+	int x = idx % grid_.width;
+	int y = idx / grid_.width;
+
+	// ӵǰtile߳ȥĴǵǰtileĴۣ б0.41421356(1ֵ)
+	float g = nodes_[idx].g;
+	float cost = (float)grid_.get(x, y);
+
+	static const int dirs[8][2] = {{-1, 0}, {0, -1}, {1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+	int ndirs = direction8_ ? 8 : 4;
+
+	for(int i = 0; i < ndirs; ++i)
 	{
-		NewNode = MapSearchNode( x, y+1 );
-		astarsearch->AddSuccessor( NewNode );
-	}	
+		int dx = dirs[i][0];
+		int dy = dirs[i][1];
+
+		if(!grid_.passable(x + dx, y + dy))
+			continue;
 
-	// 8ƶ
-	if(NavTileHandle::pCurrNavTileHandle->direction8())
+		if(dx != 0 && dy != 0)
+		{
+			// ǽ
+			if(!grid_.passable(x + dx, y) || !grid_.passable(x, y + dy))
+				continue;
+
+			push(index(x + dx, y + dy), idx, g + cost + (SQRT2 - 1.f));
+		}
+		else
+		{
+			push(index(x + dx, y + dy), idx, g + cost);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void TilePathSearch::expandJPS(int idx)
+{
+	int x = idx % grid_.width;
+	int y = idx / grid_.width;
+
+	const Node& node = nodes_[idx];
+	float g = node.g;
+	int parent = node.parent;
+
+	int dirs[8][2];
+	int ndirs = 0;
+
+	if(parent < 0)
 	{
-		if( (NavTileHandle::pCurrNavTileHandle->getMap( x + 1, y + 1 ) < TILE_STATE_CLOSED) 
-			&& !((parent_x == x + 1) && (parent_y == y + 1))
-		  ) 
+		// з
+		static const int all[8][2] = {{-1, 0}, {0, -1}, {1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+		for(int i = 0; i < 8; ++i)
 		{
-			NewNode = MapSearchNode( x + 1, y + 1 );
-			astarsearch->AddSuccessor( NewNode );
-		}	
+			dirs[ndirs][0] = all[i][0];
+			dirs[ndirs][1] = all[i][1];
+			++ndirs;
+		}
+	}
+	else
+	{
+		int px = parent % grid_.width;
+		int py = parent / grid_.width;
+		int dx = (x > px) - (x < px);
+		int dy = (y > py) - (y < py);
 
-		if( (NavTileHandle::pCurrNavTileHandle->getMap( x + 1, y-1 ) < TILE_STATE_CLOSED) 
-			&& !((parent_x == x + 1) && (parent_y == y-1))
-		  ) 
+		// üԲǰڵ̵ھӣ ֻȻھӺǿھ
+		if(dx != 0 && dy != 0)
 		{
-			NewNode = MapSearchNode( x + 1, y-1 );
-			astarsearch->AddSuccessor( NewNode );
-		}	
+			bool nextX = grid_.passable(x + dx, y);
+			bool nextY = grid_.passable(x, y + dy);
 
-		if( (NavTileHandle::pCurrNavTileHandle->getMap( x - 1, y + 1) < TILE_STATE_CLOSED)
-			&& !((parent_x == x - 1) && (parent_y == y + 1))
-		  ) 
+			if(nextY) { dirs[ndirs][0] = 0; dirs[ndirs][1] = dy; ++ndirs; }
+			if(nextX) { dirs[ndirs][0] = dx; dirs[ndirs][1] = 0; ++ndirs; }
+			if(nextX && nextY) { dirs[ndirs][0] = dx; dirs[ndirs][1] = dy; ++ndirs; }
+		}
+		else if(dx != 0)
 		{
-			NewNode = MapSearchNode( x - 1, y + 1);
-			astarsearch->AddSuccessor( NewNode );
-		}	
+			bool next = grid_.passable(x + dx, y);
+			bool up = grid_.passable(x, y + 1);
+			bool down = grid_.passable(x, y - 1);
+
+			if(next)
+			{
+				dirs[ndirs][0] = dx; dirs[ndirs][1] = 0; ++ndirs;
+				if(up) { dirs[ndirs][0] = dx; dirs[ndirs][1] = 1; ++ndirs; }
+				if(down) { dirs[ndirs][0] = dx; dirs[ndirs][1] = -1; ++ndirs; }
+			}
 
-		if( (NavTileHandle::pCurrNavTileHandle->getMap( x - 1, y - 1 ) < TILE_STATE_CLOSED) 
-			&& !((parent_x == x - 1) && (parent_y == y - 1))
-			)
+			if(up) { dirs[ndirs][0] = 0; dirs[ndirs][1] = 1; ++ndirs; }
+			if(down) { dirs[ndirs][0] = 0; dirs[ndirs][1] = -1; ++ndirs; }
+		}
+		else
 		{
-			NewNode = MapSearchNode( x - 1, y - 1 );
-			astarsearch->AddSuccessor( NewNode );
-		}	
+			bool next = grid_.passable(x, y + dy);
+			bool right = grid_.passable(x + 1, y);
+			bool left = grid_.passable(x - 1, y);
+
+			if(next)
+			{
+				dirs[ndirs][0] = 0; dirs[ndirs][1] = dy; ++ndirs;
+				if(right) { dirs[ndirs][0] = 1; dirs[ndirs][1] = dy; ++ndirs; }
+				if(left) { dirs[ndirs][0] = -1; dirs[ndirs][1] = dy; ++ndirs; }
+			}
+
+			if(right) { dirs[ndirs][0] = 1; dirs[ndirs][1] = 0; ++ndirs; }
+			if(left) { dirs[ndirs][0] = -1; dirs[ndirs][1] = 0; ++ndirs; }
+		}
 	}
 
-	return true;
+	for(int i = 0; i < ndirs; ++i)
+	{
+		int jumpIdx = jump(x, y, dirs[i][0], dirs[i][1]);
+		if(jumpIdx < 0)
+			continue;
+
+		int jx = jumpIdx % grid_.width;
+		int jy = jumpIdx / grid_.width;
+		int ddx = abs(jx - x);
+		int ddy = abs(jy - y);
+
+		// 뵱ǰڵֱ֮߻45б
+		float cost = (float)std::max(ddx, ddy) + (SQRT2 - 1.f) * (float)std::min(ddx, ddy);
+		push(jumpIdx, idx, g + cost);
+	}
 }
 
 //-------------------------------------------------------------------------------------
-// given this node, what does it cost to move to successor. In the case
-// of our map the answer is the map terrain value at this node since that is 
-// conceptually where we're moving
-float NavTileHandle::MapSearchNode::GetCost( MapSearchNode &successor )
+int TilePathSearch::jump(int x, int y, int dx, int dy) const
 {
-	/*
-		һtileѰ·Լ۱
-		ÿtileԶ0~5Լ۱ֵ ֵԽԼ۱Խ
-		磺 ǰȻܹͨǰ· ǳ 
-		ǰΪٹ· ߷ǳ졣
-	*/
-	
-	/*
-		ۣ
-		ͨùʽʾΪf = g + h.
-		gǴ㵽ǰĴ.
-		hǵǰ㵽յĹƴۣͨۺ.
-
-		һٱϵĽڵ㣬Χ8ڵ㣬ԿΧ8Ĵ۶1
-		ȷ㣬4Ĵ1µ1.414ǡ2ֵǰ˵g.
-		2.8  2.4  2  2.4  2.8
-		2.4  1.4  1  1.4  2.4
-		2    1    0    1    2
-		2.4  1.4  1  1.4  2.4
-		2.8  2.4  2  2.4  2.8
-	*/
-	if(NavTileHandle::pCurrNavTileHandle->direction8())
+	if(dx == 0 || dy == 0)
+		return jumpStraight(x, y, dx, dy);
+
+	while(true)
 	{
-		if (x != successor.x && y != successor.y) {
-			return (float) (NavTileHandle::pCurrNavTileHandle->getMap( x, y ) + 0.41421356/* 1ֵ */); //sqrt(2)
-		}
+		// ǽ
+		if(!grid_.passable(x + dx, y) || !grid_.passable(x, y + dy))
+			return -1;
+
+		x += dx;
+		y += dy;
+
+		if(!grid_.passable(x, y))
+			return -1;
+
+		if(x == gx_ && y == gy_)
+			return index(x, y);
+
+		// бϵĵˮƽֱҵ㣬 ôԼ
+		if(jumpStraight(x, y, dx, 0) >= 0 || jumpStraight(x, y, 0, dy) >= 0)
+			return index(x, y);
 	}
 
-	return (float) NavTileHandle::pCurrNavTileHandle->getMap( x, y );
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------
+int TilePathSearch::jumpStraight(int x, int y, int dx, int dy) const
+{
+	while(true)
+	{
+		x += dx;
+		y += dy;
+
+		if(!grid_.passable(x, y))
+			return -1;
 
+		if(x == gx_ && y == gy_)
+			return index(x, y);
+
+		// ǿھ
+		if(dx != 0)
+		{
+			if((grid_.passable(x, y - 1) && !grid_.passable(x - dx, y - 1)) ||
+				(grid_.passable(x, y + 1) && !grid_.passable(x - dx, y + 1)))
+				return index(x, y);
+		}
+		else
+		{
+			if((grid_.passable(x - 1, y) && !grid_.passable(x - 1, y - dy)) ||
+				(grid_.passable(x + 1, y) && !grid_.passable(x + 1, y - dy)))
+				return index(x, y);
+		}
+	}
+
+	return -1;
 }
 
 //-------------------------------------------------------------------------------------
+void TilePathSearch::solution(std::vector<NavTileHandle::MapSearchNode>& results) const
+{
+	std::vector<int> points;
+
+	int idx = goalIdx_;
+	while(idx >= 0)
+	{
+		points.push_back(idx);
+
+		KBEUnordered_map<int, Node>::const_iterator iter = nodes_.find(idx);
+		if(iter == nodes_.end())
+			break;
+
+		idx = iter->second.parent;
+	}
+
+	// ֮չ· ԭA*һ
+	for(int i = (int)points.size() - 1; i > 0; --i)
+	{
+		int x = points[i] % grid_.width;
+		int y = points[i] / grid_.width;
+		int tx = points[i - 1] % grid_.width;
+		int ty = points[i - 1] / grid_.width;
+		int dx = (tx > x) - (tx < x);
+		int dy = (ty > y) - (ty < y);
+
+		while(x != tx || y != ty)
+		{
+			x += dx;
+			y += dy;
+			results.push_back(NavTileHandle::MapSearchNode(x, y));
+		}
+	}
 }
 
+//-------------------------------------------------------------------------------------
+}
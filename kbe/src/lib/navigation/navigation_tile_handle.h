@@ -23,7 +23,6 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "navigation/navigation_handle.h"
 
-#include "stlastar.h"
 #include "tmxparser/Tmx.h"
 
 namespace KBEngine{
@@ -31,14 +30,6 @@ namespace KBEngine{
 class NavTileHandle : public NavigationHandle
 {
 public:
-	static NavTileHandle* pCurrNavTileHandle;
-	static int currentLayer;
-
-	static void setMapLayer(int layer)
-	{ 
-		currentLayer = layer; 
-	}
-
 	enum TILE_STATE
 	{
 		TILE_STATE_OPENED_COST0 = 0,	// ״̬, ͨ
@@ -59,18 +50,43 @@ public:
 
 		MapSearchNode() { x = y = 0; }
 		MapSearchNode(int px, int py) {x = px; y = py; }
+	};
+
+	/**
+		TMXڼʱɵĽմ۱ ÿtileһֽڣ 
+		TILE_STATE_CLOSEDʾͨ ֻ handle֮乲 
+		Ѱ·״̬ÿβѯջϣ ˶߳̿ͬʱһŵͼѰ·
+	*/
+	class TileLayerGrid
+	{
+	public:
+		TileLayerGrid(): width(0), height(0), costs(), uniformCost(true), minCost(0) {}
+
+		int get(int x, int y) const
+		{
+			if(x < 0 || x >= width || y < 0 || y >= height)
+				return TILE_STATE_CLOSED;
+
+			return costs[y * width + x];
+		}
 
-		float GoalDistanceEstimate( MapSearchNode &nodeGoal );
-		bool IsGoal( MapSearchNode &nodeGoal );
-		bool GetSuccessors( AStarSearch<MapSearchNode> *astarsearch, MapSearchNode *parent_node );
-		float GetCost( MapSearchNode &successor );
-		bool IsSameState( MapSearchNode &rhs );
+		bool passable(int x, int y) const
+		{
+			return get(x, y) < TILE_STATE_CLOSED;
+		}
 
-		void PrintNodeInfo(); 
+		int width;
+		int height;
+		std::vector<uint8> costs;
+
+		// пͨtile۶ͬ ʱʹ(JPS)
+		bool uniformCost;
+
+		// ͨtileеСۣ ڴA*Ĺۺ
+		int minCost;
 	};
-	
-	static MapSearchNode nodeGoal, nodeStart;
-	static AStarSearch<NavTileHandle::MapSearchNode> astarsearch;
+
+	typedef KBEShared_ptr<TileLayerGrid> TileLayerGridPtr;
 
 public:
 	NavTileHandle(bool dir);
@@ -91,7 +107,14 @@ public:
 	static NavigationHandle* create(std::string resPath, const std::map< int, std::string >& params);
 	static NavTileHandle* _create(const std::string& res);
 	
-	int getMap(int x, int y);
+	int getMap(int layer, int x, int y) const;
+
+	/**
+		TMXÿһΪTileLayerGrid
+	*/
+	void compileLayers();
+
+	const TileLayerGrid* layerGrid(int layer) const;
 
 	void bresenhamLine(const MapSearchNode& p0, const MapSearchNode& p1, std::vector<MapSearchNode>& results);
 	void bresenhamLine(int x0, int y0, int x1, int y1, std::vector<MapSearchNode>& results);
@@ -104,6 +127,8 @@ public:
 	Tmx::Map *pTilemap;
 	bool direction8_;
 	std::map< int, std::string > params_;
+
+	std::vector<TileLayerGridPtr> layerGrids_;
 };
 
 }
@@ -644,6 +644,60 @@ void Channel::delayedSend()
 	this->networkInterface().delayedSend(*this);
 }
 
+//-------------------------------------------------------------------------------------
+bool Channel::isSendCoalescing() const
+{
+	return g_intSendCoalescing && isInternal() && protocoltype_ == PROTOCOL_TCP && 
+		pFilter_ == NULL && pKCP_ == NULL;
+}
+
+//-------------------------------------------------------------------------------------
+void Channel::flush()
+{
+	if ((flags_ & FLAG_COALESCING) > 0)
+		this->networkInterface().sendIfCoalesced(*this);
+}
+
+//-------------------------------------------------------------------------------------
+bool Channel::coalesceBundle(Bundle* pBundle)
+{
+	if (!isSendCoalescing() || bundles_.size() == 0)
+		return false;
+
+	Bundle* pLastBundle = bundles_.back();
+	if (pLastBundle->isTCPPacket() != pBundle->isTCPPacket())
+		return false;
+
+	Bundle::Packets& lastPackets = pLastBundle->packets();
+	Bundle::Packets& packets = pBundle->packets();
+
+	Bundle::Packets::iterator iter = packets.begin();
+	for (; iter != packets.end(); ++iter)
+	{
+		Packet* pPacket = (*iter);
+		Packet* pTailPacket = lastPackets.size() > 0 ? lastPackets.back() : NULL;
+
+		// βδʼͲʣռ㹻ֱӿβСֻҪһϵͳ
+		// ҵһbundle֮󣬱֤˳
+		if (pTailPacket && pTailPacket->sentSize == 0 && pTailPacket->space() >= pPacket->length())
+		{
+			pTailPacket->append(pPacket->data() + pPacket->rpos(), pPacket->length());
+			RECLAIM_PACKET(pBundle->isTCPPacket(), pPacket);
+			++g_numCoalescedPackets;
+		}
+		else
+		{
+			pPacket->pBundle(pLastBundle);
+			lastPackets.push_back(pPacket);
+		}
+	}
+
+	packets.clear();
+	Network::Bundle::reclaimPoolObject(pBundle);
+	++g_numCoalescedBundles;
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 const char * Channel::c_str() const
 {
@@ -791,13 +845,36 @@ void Channel::send(Bundle * pBundle)
 	{
 		pBundle->pChannel(this);
 		pBundle->finiMessage(true);
-		bundles_.push_back(pBundle);
+
+		if(!coalesceBundle(pBundle))
+			bundles_.push_back(pBundle);
 	}
 	
 	uint32 bundleSize = (uint32)bundles_.size();
 	if(bundleSize == 0)
 		return;
 
+	// ڲͨͺϲʱдsocketڱ¼ѭʱDelayedChannelsͳһˢ
+	// ݴֽflushBytes
+	if(pBundle && isSendCoalescing() && !sending())
+	{
+		if(g_intSendCoalescingFlushBytes == 0 || (uint32)bundlesLength() < g_intSendCoalescingFlushBytes)
+		{
+			if((flags_ & FLAG_COALESCING) == 0)
+			{
+				flags_ |= FLAG_COALESCING;
+				this->networkInterface().coalescedSend(*this);
+			}
+
+			sendCheck(bundleSize);
+			return;
+		}
+
+		++g_numCoalescedThresholdFlushes;
+	}
+
+	flags_ &= ~FLAG_COALESCING;
+
 	if(!sending())
 	{
 		if (pPacketSender_ == NULL)
@@ -1081,7 +1158,8 @@ bool Channel::handshake(Packet* pPacket)
 		if (websocket::WebSocketProtocol::isWebSocketProtocol(pPacket))
 		{
 			channelType_ = CHANNEL_WEB;
-			if (websocket::WebSocketProtocol::handshake(this, pPacket))
+			uint8 deflateFlags = 0;
+			if (websocket::WebSocketProtocol::handshake(this, pPacket, &deflateFlags))
 			{
 				if (!pPacketReader_ || pPacketReader_->type() != PacketReader::PACKET_READER_TYPE_WEBSOCKET)
 				{
@@ -1089,7 +1167,11 @@ bool Channel::handshake(Packet* pPacket)
 					pPacketReader_ = new WebSocketPacketReader(this);
 				}
 
-				pFilter_ = new WebSocketPacketFilter(this);
+				WebSocketPacketFilter* pWebSocketFilter = new WebSocketPacketFilter(this);
+				if (deflateFlags & websocket::WebSocketProtocol::DEFLATE_ENABLED)
+					pWebSocketFilter->enablePerMessageDeflate(deflateFlags);
+
+				pFilter_ = pWebSocketFilter;
 				DEBUG_MSG(fmt::format("Channel::handshake: websocket({}) successfully!\n", this->c_str()));
 
 				// ζtrueֱֳɹ
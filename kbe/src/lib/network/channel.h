@@ -85,6 +85,7 @@ public:
 		FLAG_HANDSHAKE					= 0x00000004,	// Ѿֹ
 		FLAG_CONDEMN_AND_WAIT_DESTROY	= 0x00000008,	// ƵѾòϷݷϺر
 		FLAG_CONDEMN_AND_DESTROY		= 0x00000010,	// ƵѾòϷر
+		FLAG_COALESCING					= 0x00000020,	// ڲͨϲУݽڱ¼ѭʱˢ
 		FLAG_CONDEMN					= FLAG_CONDEMN_AND_WAIT_DESTROY | FLAG_CONDEMN_AND_DESTROY,
 	};
 
@@ -151,6 +152,10 @@ public:
 	void delayedSend();
 	bool waitSend();
 
+	// ˢϲݴķ
+	void flush();
+	bool isSendCoalescing() const;
+
 	ikcpcb* pKCP() const {
 		return pKCP_;
 	}
@@ -269,6 +274,8 @@ private:
 	void clearState( bool warnOnDiscard = false );
 	EventDispatcher & dispatcher();
 
+	bool coalesceBundle(Bundle* pBundle);
+
 private:
 	NetworkInterface * 			pNetworkInterface_;
 	Traits						traits_;
@@ -78,6 +78,20 @@ uint32						g_extSendWindowBytesOverflow = 65535;
 uint32						g_intSentWindowBytesOverflow = 0;
 uint32						g_extSentWindowBytesOverflow = 0;
 
+// ڲͨͺϲ
+bool						g_intSendCoalescing = false;
+uint32						g_intSendCoalescingFlushBytes = 65536;
+uint64						g_numCoalescedBundles = 0;
+uint64						g_numCoalescedPackets = 0;
+uint64						g_numCoalescedThresholdFlushes = 0;
+
+// websocket permessage-deflate
+bool						g_websocketPerMessageDeflate = false;
+uint32						g_websocketDeflateMinSize = 128;
+int							g_websocketDeflateLevel = 1;
+uint64						g_websocketDeflateBytesIn = 0;
+uint64						g_websocketDeflateBytesOut = 0;
+
 // ͨͳʱ
 uint32						g_intReSendInterval = 10;
 uint32						g_intReSendRetries = 0;
@@ -94,6 +108,11 @@ bool initializeWatcher()
 	WATCH_OBJECT("network/numPacketsReceived", g_numPacketsReceived);
 	WATCH_OBJECT("network/numBytesSent", g_numBytesSent);
 	WATCH_OBJECT("network/numBytesReceived", g_numBytesReceived);
+	WATCH_OBJECT("network/sendCoalescing/numCoalescedBundles", g_numCoalescedBundles);
+	WATCH_OBJECT("network/sendCoalescing/numCoalescedPackets", g_numCoalescedPackets);
+	WATCH_OBJECT("network/sendCoalescing/numThresholdFlushes", g_numCoalescedThresholdFlushes);
+	WATCH_OBJECT("network/websocket/deflateBytesIn", g_websocketDeflateBytesIn);
+	WATCH_OBJECT("network/websocket/deflateBytesOut", g_websocketDeflateBytesOut);
 	
 	std::vector<MessageHandlers*>::iterator iter = MessageHandlers::messageHandlers().begin();
 	for(; iter != MessageHandlers::messageHandlers().end(); ++iter)
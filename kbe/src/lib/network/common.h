@@ -438,6 +438,20 @@ extern uint32						g_extSendWindowBytesOverflow;
 extern uint32						g_intSentWindowBytesOverflow;
 extern uint32						g_extSentWindowBytesOverflow;
 
+// ڲͨͺϲ
+extern bool							g_intSendCoalescing;
+extern uint32						g_intSendCoalescingFlushBytes;
+extern uint64						g_numCoalescedBundles;
+extern uint64						g_numCoalescedPackets;
+extern uint64						g_numCoalescedThresholdFlushes;
+
+// websocket permessage-deflate
+extern bool							g_websocketPerMessageDeflate;
+extern uint32						g_websocketDeflateMinSize;
+extern int							g_websocketDeflateLevel;
+extern uint64						g_websocketDeflateBytesIn;
+extern uint64						g_websocketDeflateBytesOut;
+
 bool initializeWatcher();
 bool initialize();
 void finalise(void);
@@ -30,16 +30,24 @@ namespace Network
 {
 
 //-------------------------------------------------------------------------------------
-void DelayedChannels::init(EventDispatcher & dispatcher, NetworkInterface* pNetworkInterface)
+void DelayedChannels::init(EventDispatcher & dispatcher, NetworkInterface* pNetworkInterface, bool flushTask)
 {
 	pNetworkInterface_ = pNetworkInterface;
-	dispatcher.addTask( this );
+	flushTask_ = flushTask;
+
+	if (flushTask_)
+		dispatcher.addFlushTask( this );
+	else
+		dispatcher.addTask( this );
 }
 
 //-------------------------------------------------------------------------------------
 void DelayedChannels::fini(EventDispatcher & dispatcher)
 {
-	dispatcher.cancelTask( this );
+	if (flushTask_)
+		dispatcher.cancelFlushTask( this );
+	else
+		dispatcher.cancelTask( this );
 }
 
 //-------------------------------------------------------------------------------------
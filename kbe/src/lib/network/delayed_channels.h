@@ -36,7 +36,11 @@ class NetworkInterface;
 class DelayedChannels : public Task
 {
 public:
-	void init(EventDispatcher & dispatcher, NetworkInterface* pNetworkInterface);
+	/** 
+		flushTaskΪtrueʱÿֽpollerȴ֮ǰˢ(ڲͨͺϲ)
+		һ¼ѭд
+	*/
+	void init(EventDispatcher & dispatcher, NetworkInterface* pNetworkInterface, bool flushTask = false);
 	void fini(EventDispatcher & dispatcher);
 
 	void add(Channel & channel);
@@ -50,6 +54,7 @@ private:
 	ChannelAddrs channeladdrs_;
 
 	NetworkInterface* pNetworkInterface_;
+	bool flushTask_;
 };
 
 }
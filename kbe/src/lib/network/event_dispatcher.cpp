@@ -41,6 +41,7 @@ EventDispatcher::EventDispatcher() :
 	totSpareTime_(0),
 	lastStatisticsGathered_(0),
 	pTasks_(new Tasks),
+	pFlushTasks_(new Tasks),
 	pErrorReporter_(NULL),
 	pTimers_(new Timers64)
 	
@@ -54,6 +55,7 @@ EventDispatcher::~EventDispatcher()
 {
 	SAFE_RELEASE(pErrorReporter_);
 	SAFE_RELEASE(pTasks_);
+	SAFE_RELEASE(pFlushTasks_);
 	SAFE_RELEASE(pPoller_);
 	
 	if (!pTimers_->empty())
@@ -145,6 +147,18 @@ bool EventDispatcher::cancelTask(Task * pTask)
 	return pTasks_->cancel(pTask);
 }
 
+//-------------------------------------------------------------------------------------
+void EventDispatcher::addFlushTask(Task * pTask)
+{
+	pFlushTasks_->add(pTask);
+}
+
+//-------------------------------------------------------------------------------------
+bool EventDispatcher::cancelFlushTask(Task * pTask)
+{
+	return pFlushTasks_->cancel(pTask);
+}
+
 //-------------------------------------------------------------------------------------
 double EventDispatcher::calculateWait() const
 {
@@ -165,6 +179,12 @@ void EventDispatcher::processTasks()
 	pTasks_->process();
 }
 
+//-------------------------------------------------------------------------------------
+void EventDispatcher::processFlushTasks()
+{
+	pFlushTasks_->process();
+}
+
 //-------------------------------------------------------------------------------------
 void EventDispatcher::processTimers()
 {
@@ -187,6 +207,9 @@ void EventDispatcher::processStats()
 //-------------------------------------------------------------------------------------
 int EventDispatcher::processNetwork(bool shouldIdle)
 {
+	// pollerȴ֮ǰȰѱݴķˢڵȴڼ
+	this->processFlushTasks();
+
 	double maxWait = shouldIdle ? this->calculateWait() : 0.0;
 	return pPoller_->processPendingEvents(maxWait);
 }
@@ -58,6 +58,10 @@ public:
 	
 	void addTask(Task * pTask);
 	bool cancelTask(Task * pTask);
+
+	// ÿֽpollerȴ֮ǰִе(磺ڲͨϲ͵ˢ)
+	void addFlushTask(Task * pTask);
+	bool cancelFlushTask(Task * pTask);
 	
 	INLINE double maxWait() const;
 	INLINE void maxWait(double seconds);
@@ -86,6 +90,7 @@ private:
 		bool recurrent);
 
 	void processTasks();
+	void processFlushTasks();
 	void processTimers();
 	void processStats();
 	
@@ -104,6 +109,7 @@ protected:
 	TimeStamp		lastStatisticsGathered_;
 	
 	Tasks* pTasks_;
+	Tasks* pFlushTasks_;
 	ErrorReporter * pErrorReporter_;
 	Timers64* pTimers_;
 	EventPoller* pPoller_;
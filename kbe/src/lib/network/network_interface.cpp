@@ -57,6 +57,7 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 	pExtUdpListenerReceiver_(NULL),
 	pIntListenerReceiver_(NULL),
 	pDelayedChannels_(new DelayedChannels()),
+	pCoalescedChannels_(new DelayedChannels()),
 	pChannelTimeOutHandler_(NULL),
 	pChannelDeregisterHandler_(NULL),
 	numExtChannels_(0)
@@ -103,12 +104,18 @@ NetworkInterface::NetworkInterface(Network::EventDispatcher * pDispatcher,
 		"please check for kbengine[_defs].xml!\n");
 
 	pDelayedChannels_->init(this->dispatcher(), this);
+	pCoalescedChannels_->init(this->dispatcher(), this, true);
 }
 
 //-------------------------------------------------------------------------------------
 NetworkInterface::~NetworkInterface()
 {
+	// ֮ͨǰȽϲݴķˢ
 	ChannelMap::iterator iter = channelMap_.begin();
+	for (; iter != channelMap_.end(); ++iter)
+		iter->second->flush();
+
+	iter = channelMap_.begin();
 	while (iter != channelMap_.end())
 	{
 		ChannelMap::iterator oldIter = iter++;
@@ -124,10 +131,12 @@ NetworkInterface::~NetworkInterface()
 	if (pDispatcher_ != NULL)
 	{
 		pDelayedChannels_->fini(this->dispatcher());
+		pCoalescedChannels_->fini(this->dispatcher());
 		pDispatcher_ = NULL;
 	}
 
 	SAFE_RELEASE(pDelayedChannels_);
+	SAFE_RELEASE(pCoalescedChannels_);
 	SAFE_RELEASE(pExtListenerReceiver_);
 	SAFE_RELEASE(pIntListenerReceiver_);
 }
@@ -330,6 +339,18 @@ void NetworkInterface::sendIfDelayed(Channel & channel)
 	pDelayedChannels_->sendIfDelayed(channel);
 }
 
+//-------------------------------------------------------------------------------------
+void NetworkInterface::coalescedSend(Channel & channel)
+{
+	pCoalescedChannels_->add(channel);
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::sendIfCoalesced(Channel & channel)
+{
+	pCoalescedChannels_->sendIfDelayed(channel);
+}
+
 //-------------------------------------------------------------------------------------
 void NetworkInterface::handleTimeout(TimerHandle handle, void * arg)
 {
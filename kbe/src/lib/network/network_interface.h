@@ -94,6 +94,10 @@ public:
 	/**  */
 	void sendIfDelayed(Channel & channel);
 	void delayedSend(Channel & channel);
+
+	/** ڲͨͺϲ delayedSendֿ ıͨķʱ */
+	void sendIfCoalesced(Channel & channel);
+	void coalescedSend(Channel & channel);
 	
 	bool good() const{ return (!pExtListenerReceiver_ || extTcpEndpoint_.good()) && (!pIntListenerReceiver_ || intTcpEndpoint_.good()); }
 
@@ -123,6 +127,7 @@ private:
 	ListenerReceiver *						pIntListenerReceiver_;
 	
 	DelayedChannels * 						pDelayedChannels_;
+	DelayedChannels * 						pCoalescedChannels_;
 	
 	ChannelTimeOutHandler *					pChannelTimeOutHandler_;	// ʱͨɱ׽ ֪ϲclientϿ
 	ChannelDeregisterHandler *				pChannelDeregisterHandler_;
@@ -337,7 +337,7 @@ void PacketReader::mergeFragmentMessage(Packet* pPacket)
 	}
 	else
 	{
-		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data(), opsize);
+		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data() + pPacket->rpos(), opsize);
 		pFragmentDatasRemain_ -= opsize;
 		pFragmentDatasWpos_ += opsize;
 		pPacket->rpos(pPacket->rpos() + opsize);
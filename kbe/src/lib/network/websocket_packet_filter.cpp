@@ -27,6 +27,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/tcp_packet.h"
 #include "network/network_interface.h"
 #include "network/packet_receiver.h"
+#include "zlib/zlib.h"
 
 namespace KBEngine { 
 namespace Network
@@ -38,13 +39,21 @@ WebSocketPacketFilter::WebSocketPacketFilter(Channel* pChannel):
 	fragmentDatasFlag_(FRAGMENT_MESSAGE_HREAD),
 	msg_opcode_(0),
 	msg_fin_(0),
+	msg_rsv1_(0),
 	msg_masked_(0),
 	msg_mask_(0),
+	msg_mask_offset_(0),
 	msg_length_field_(0),
 	msg_payload_length_(0),
 	msg_frameType_(websocket::WebSocketProtocol::ERROR_FRAME),
 	pChannel_(pChannel),
-	pTCPPacket_(NULL)
+	pTCPPacket_(NULL),
+	pDeflater_(NULL),
+	pInflater_(NULL),
+	deflatingMessage_(false),
+	inflatingMessage_(false),
+	deflaterNoContextTakeover_(false),
+	inflaterNoContextTakeover_(false)
 {
 }
 
@@ -52,6 +61,56 @@ WebSocketPacketFilter::WebSocketPacketFilter(Channel* pChannel):
 WebSocketPacketFilter::~WebSocketPacketFilter()
 {
 	reset();
+
+	if (pDeflater_)
+	{
+		deflateEnd(pDeflater_);
+		SAFE_RELEASE(pDeflater_);
+	}
+
+	if (pInflater_)
+	{
+		inflateEnd(pInflater_);
+		SAFE_RELEASE(pInflater_);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool WebSocketPacketFilter::enablePerMessageDeflate(uint8 flags)
+{
+	if (pDeflater_)
+		return true;
+
+	pDeflater_ = new z_stream;
+	memset(pDeflater_, 0, sizeof(z_stream));
+
+	// windowBitsʾzlibͷraw deflate
+	if (deflateInit2(pDeflater_, g_websocketDeflateLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		ERROR_MSG(fmt::format("WebSocketPacketFilter::enablePerMessageDeflate: deflateInit2 error! addr={}!\n",
+			pChannel_->c_str()));
+
+		SAFE_RELEASE(pDeflater_);
+		return false;
+	}
+
+	pInflater_ = new z_stream;
+	memset(pInflater_, 0, sizeof(z_stream));
+
+	if (inflateInit2(pInflater_, -15) != Z_OK)
+	{
+		ERROR_MSG(fmt::format("WebSocketPacketFilter::enablePerMessageDeflate: inflateInit2 error! addr={}!\n",
+			pChannel_->c_str()));
+
+		deflateEnd(pDeflater_);
+		SAFE_RELEASE(pDeflater_);
+		SAFE_RELEASE(pInflater_);
+		return false;
+	}
+
+	deflaterNoContextTakeover_ = (flags & websocket::WebSocketProtocol::DEFLATE_SERVER_NO_CONTEXT_TAKEOVER) > 0;
+	inflaterNoContextTakeover_ = (flags & websocket::WebSocketProtocol::DEFLATE_CLIENT_NO_CONTEXT_TAKEOVER) > 0;
+	return true;
 }
 
 //-------------------------------------------------------------------------------------
@@ -59,8 +118,10 @@ void WebSocketPacketFilter::reset()
 {
 	msg_opcode_ = 0;
 	msg_fin_ = 0;
+	msg_rsv1_ = 0;
 	msg_masked_ = 0;
 	msg_mask_ = 0;
+	msg_mask_offset_ = 0;
 	msg_length_field_ = 0;
 	msg_payload_length_ = 0;
 	pFragmentDatasRemain_ = 0;
@@ -107,7 +168,48 @@ Reason WebSocketPacketFilter::send(Channel * pChannel, PacketSender& sender, Pac
 		}
 	}
 
-	websocket::WebSocketProtocol::makeFrame(frameType, pPacket, pRetTCPPacket);
+	bool compressed = false;
+
+	if (pDeflater_)
+	{
+		bool isMessageBegin = frameType == websocket::WebSocketProtocol::BINARY_FRAME || 
+			frameType == websocket::WebSocketProtocol::INCOMPLETE_BINARY_FRAME;
+
+		bool isMessageEnd = frameType == websocket::WebSocketProtocol::BINARY_FRAME || 
+			frameType == websocket::WebSocketProtocol::END_FRAME;
+
+		// ǷѹϢĵһ֡֡
+		if (isMessageBegin)
+		{
+			uint32 messageLength = pBundle ? (uint32)pBundle->packetsLength() : (uint32)pPacket->length();
+			deflatingMessage_ = messageLength >= g_websocketDeflateMinSize;
+		}
+
+		if (deflatingMessage_)
+		{
+			TCPPacket* pDeflatePacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+			if (!deflateDatas(pPacket, pDeflatePacket, isMessageEnd))
+			{
+				ERROR_MSG(fmt::format("WebSocketPacketFilter::send: deflate error! addr={}!\n",
+					pChannel_->c_str()));
+
+				TCPPacket::reclaimPoolObject(pDeflatePacket);
+				TCPPacket::reclaimPoolObject(pRetTCPPacket);
+				return REASON_WEBSOCKET_ERROR;
+			}
+
+			g_websocketDeflateBytesIn += pPacket->length();
+			g_websocketDeflateBytesOut += pDeflatePacket->length();
+
+			pDeflatePacket->swap(*(static_cast<KBEngine::MemoryStream*>(pPacket)));
+			TCPPacket::reclaimPoolObject(pDeflatePacket);
+
+			compressed = isMessageBegin;
+		}
+	}
+
+	websocket::WebSocketProtocol::makeFrame(frameType, pPacket, pRetTCPPacket, compressed);
 
 	int space = pPacket->length() - pRetTCPPacket->space();
 	if(space > 0)
@@ -142,7 +244,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 				reset();
 
 				// ûд棬ȳֱӽͷϢ㹻ɹһ
-				pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pPacket, msg_opcode_, msg_fin_, msg_masked_, 
+				pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pPacket, msg_opcode_, msg_fin_, msg_rsv1_, msg_masked_, 
 					msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
 
 				if(pFragmentDatasRemain_ > 0)
@@ -154,8 +256,15 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 				}
 				else
 				{
-					fragmentDatasFlag_ = FRAGMENT_MESSAGE_DATAS;
-					pFragmentDatasRemain_ = (int32)msg_payload_length_;
+					if (onFrameHeader(pChannel, receiver) != REASON_SUCCESS)
+						msg_frameType_ = websocket::WebSocketProtocol::ERROR_FRAME;
+
+					// ǷЯû򲻽data
+					if(msg_payload_length_ > 0)
+					{
+						fragmentDatasFlag_ = FRAGMENT_MESSAGE_DATAS;
+						pFragmentDatasRemain_ = (int32)msg_payload_length_;
+					}
 				}
 			}
 			else
@@ -181,7 +290,7 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 					pPacket->read_skip(pFragmentDatasRemain_);
 					
 					size_t buffer_rpos = pTCPPacket_->rpos();
-					pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pTCPPacket_, msg_opcode_, msg_fin_, msg_masked_, 
+					pFragmentDatasRemain_ = websocket::WebSocketProtocol::getFrame(pTCPPacket_, msg_opcode_, msg_fin_, msg_rsv1_, msg_masked_, 
 						msg_mask_, msg_length_field_, msg_payload_length_, msg_frameType_);
 
 					// Ȼ0 ˵Ҫհ
@@ -200,6 +309,9 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 						TCPPacket::reclaimPoolObject(pTCPPacket_);
 						pTCPPacket_ = NULL;
 
+						if (onFrameHeader(pChannel, receiver) != REASON_SUCCESS)
+							msg_frameType_ = websocket::WebSocketProtocol::ERROR_FRAME;
+
 						// ǷЯû򲻽data
 						if(msg_payload_length_ > 0)
 						{
@@ -284,26 +396,26 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 				return REASON_WEBSOCKET_ERROR;
 			}
 
-			if(pTCPPacket_ == NULL)
-				pTCPPacket_ = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
-
-			if(pFragmentDatasRemain_ <= (int32)pPacket->length())
-			{
-				pTCPPacket_->append(pPacket->data() + pPacket->rpos(), pFragmentDatasRemain_);
-				pPacket->read_skip((size_t)pFragmentDatasRemain_);
-				pFragmentDatasRemain_ = 0;
-			}
-			else
-			{
-				pTCPPacket_->append(*(static_cast<MemoryStream*>(pPacket)));
-				pFragmentDatasRemain_ -= pPacket->length();
-				pPacket->done();
-			}
-
 			Reason reason = REASON_SUCCESS;
 
 			if (msg_frameType_ == websocket::WebSocketProtocol::PING_FRAME)
 			{
+				if(pTCPPacket_ == NULL)
+					pTCPPacket_ = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+
+				if(pFragmentDatasRemain_ <= (int32)pPacket->length())
+				{
+					pTCPPacket_->append(pPacket->data() + pPacket->rpos(), pFragmentDatasRemain_);
+					pPacket->read_skip((size_t)pFragmentDatasRemain_);
+					pFragmentDatasRemain_ = 0;
+				}
+				else
+				{
+					pTCPPacket_->append(*(static_cast<MemoryStream*>(pPacket)));
+					pFragmentDatasRemain_ -= pPacket->length();
+					pPacket->done();
+				}
+
 				// ʣݵΪֹ
 				if (pFragmentDatasRemain_ > 0)
 					continue;
@@ -324,23 +436,43 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 			}
 			else
 			{
-				if (!websocket::WebSocketProtocol::decodingDatas(pTCPPacket_, msg_masked_, msg_mask_))
+				// ֱڽյİϽ룬ٿм仺
+				size_t size = KBE_MIN((size_t)pFragmentDatasRemain_, pPacket->length());
+
+				if (msg_masked_)
 				{
-					ERROR_MSG(fmt::format("WebSocketPacketFilter::recv: decoding-frame error! addr={}!\n",
-						pChannel_->c_str()));
+					websocket::WebSocketProtocol::unmask(pPacket->data() + pPacket->rpos(), size, 
+						msg_mask_, msg_mask_offset_);
+				}
 
-					this->pChannel_->condemn("WebSocketPacketFilter::recv: decoding-frame error!");
-					reset();
+				msg_mask_offset_ += size;
+				pFragmentDatasRemain_ -= (int32)size;
 
-					TCPPacket::reclaimPoolObject(static_cast<TCPPacket*>(pPacket));
-					return REASON_WEBSOCKET_ERROR;
+				if (inflatingMessage_)
+				{
+					bool messageEnd = pFragmentDatasRemain_ == 0 && msg_fin_;
+					reason = inflateDatas(pChannel, receiver, pPacket->data() + pPacket->rpos(), size, messageEnd);
+					pPacket->read_skip(size);
+
+					if (messageEnd)
+						inflatingMessage_ = false;
 				}
+				else if (size == pPacket->length())
+				{
+					// ʣݶһֱ֡ӽ
+					if(pFragmentDatasRemain_ == 0)
+						reset();
 
-				reason = PacketFilter::recv(pChannel, receiver, pTCPPacket_);
-				KBE_ASSERT(reason == REASON_SUCCESS);
+					return PacketFilter::recv(pChannel, receiver, pPacket);
+				}
+				else
+				{
+					TCPPacket* pDatasPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+					pDatasPacket->append(pPacket->data() + pPacket->rpos(), size);
+					pPacket->read_skip(size);
 
-				// pTCPPacket_Ҫ
-				pTCPPacket_ = NULL;
+					reason = PacketFilter::recv(pChannel, receiver, pDatasPacket);
+				}
 			}
 
 			if(pFragmentDatasRemain_ == 0)
@@ -359,6 +491,140 @@ Reason WebSocketPacketFilter::recv(Channel * pChannel, PacketReceiver & receiver
 	return REASON_SUCCESS;
 }
 
+//-------------------------------------------------------------------------------------
+Reason WebSocketPacketFilter::onFrameHeader(Channel * pChannel, PacketReceiver & receiver)
+{
+	// ܱ֡ѹ
+	if (msg_opcode_ >= 0x8)
+		return msg_rsv1_ ? REASON_WEBSOCKET_ERROR : REASON_SUCCESS;
+
+	// Ϣĵһ֡RSV1ǱʾϢѹ֡RSV1
+	if (msg_opcode_ != 0x0)
+	{
+		if (msg_rsv1_ && !pInflater_)
+			return REASON_WEBSOCKET_ERROR;
+
+		inflatingMessage_ = msg_rsv1_ > 0;
+	}
+	else if (msg_rsv1_)
+	{
+		return REASON_WEBSOCKET_ERROR;
+	}
+
+	// ûݵĽ֡ҲҪϢβѹ
+	if (inflatingMessage_ && msg_fin_ && msg_payload_length_ == 0)
+	{
+		inflatingMessage_ = false;
+		return inflateDatas(pChannel, receiver, NULL, 0, true);
+	}
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+bool WebSocketPacketFilter::deflateDatas(Packet* pPacket, Packet* pOutPacket, bool messageEnd)
+{
+	pDeflater_->next_in = (Bytef*)(pPacket->data() + pPacket->rpos());
+	pDeflater_->avail_in = (uInt)pPacket->length();
+
+	do
+	{
+		if (pOutPacket->space() < 64)
+			pOutPacket->data_resize(pOutPacket->size() + KBE_MAX(pPacket->length(), (size_t)256));
+
+		pDeflater_->next_out = (Bytef*)(pOutPacket->data() + pOutPacket->wpos());
+		pDeflater_->avail_out = (uInt)pOutPacket->space();
+
+		int ret = deflate(pDeflater_, Z_SYNC_FLUSH);
+		if (ret != Z_OK && ret != Z_BUF_ERROR)
+			return false;
+
+		pOutPacket->wpos(pOutPacket->size() - pDeflater_->avail_out);
+	} while (pDeflater_->avail_out == 0);
+
+	// RFC7692: ϢʱȥZ_SYNC_FLUSH0x00 0x00 0xff 0xff
+	if (messageEnd && pOutPacket->length() >= 4)
+	{
+		const uint8* pTail = pOutPacket->data() + pOutPacket->wpos() - 4;
+		if (pTail[0] == 0x00 && pTail[1] == 0x00 && pTail[2] == 0xff && pTail[3] == 0xff)
+			pOutPacket->wpos(pOutPacket->wpos() - 4);
+	}
+
+	// server_no_context_takeover: һϢϢ
+	if (messageEnd && deflaterNoContextTakeover_ && deflateReset(pDeflater_) != Z_OK)
+		return false;
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+Reason WebSocketPacketFilter::inflateDatas(Channel * pChannel, PacketReceiver & receiver, 
+	const uint8* pDatas, size_t size, bool messageEnd)
+{
+	static const uint8 s_messageTail[4] = { 0x00, 0x00, 0xff, 0xff };
+
+	for (int step = 0; step < 2; ++step)
+	{
+		if (step == 0)
+		{
+			pInflater_->next_in = (Bytef*)pDatas;
+			pInflater_->avail_in = (uInt)size;
+		}
+		else
+		{
+			// ϢʱϷͷȥϢβ
+			if (!messageEnd)
+				break;
+
+			pInflater_->next_in = (Bytef*)s_messageTail;
+			pInflater_->avail_in = 4;
+		}
+
+		while (true)
+		{
+			TCPPacket* pOutPacket = TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+			pInflater_->next_out = (Bytef*)pOutPacket->data();
+			pInflater_->avail_out = (uInt)pOutPacket->size();
+
+			int ret = inflate(pInflater_, Z_SYNC_FLUSH);
+			if (ret != Z_OK && ret != Z_BUF_ERROR && ret != Z_STREAM_END)
+			{
+				ERROR_MSG(fmt::format("WebSocketPacketFilter::inflateDatas: inflate error({})! addr={}!\n",
+					ret, pChannel_->c_str()));
+
+				TCPPacket::reclaimPoolObject(pOutPacket);
+				return REASON_WEBSOCKET_ERROR;
+			}
+
+			if (ret == Z_STREAM_END)
+				inflateReset(pInflater_);
+
+			bool outputFull = pInflater_->avail_out == 0;
+			pOutPacket->wpos(pOutPacket->size() - pInflater_->avail_out);
+
+			if (pOutPacket->length() > 0)
+			{
+				Reason reason = PacketFilter::recv(pChannel, receiver, pOutPacket);
+				if (reason != REASON_SUCCESS)
+					return reason;
+			}
+			else
+			{
+				TCPPacket::reclaimPoolObject(pOutPacket);
+			}
+
+			if (!outputFull && (pInflater_->avail_in == 0 || ret == Z_BUF_ERROR))
+				break;
+		}
+	}
+
+	// client_no_context_takeover: ͻÿϢӿյĿʼѹ
+	if (messageEnd && inflaterNoContextTakeover_)
+		inflateReset(pInflater_);
+
+	return REASON_SUCCESS;
+}
+
 //-------------------------------------------------------------------------------------
 Reason WebSocketPacketFilter::onPing(Channel * pChannel, Packet* pPacket)
 {
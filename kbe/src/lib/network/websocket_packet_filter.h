@@ -25,6 +25,8 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/packet_filter.h"
 #include "network/websocket_protocol.h"
 
+struct z_stream_s;
+
 namespace KBEngine { 
 namespace Network
 {
@@ -39,10 +41,22 @@ public:
 	Reason send(Channel * pChannel, PacketSender& sender, Packet * pPacket, int userarg) override;
 	virtual Reason recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
 
+	/**
+		ʱЭpermessage-deflateѹѹ
+		flagsΪWebSocketProtocol::DeflateFlagsЭno_context_takeoverһÿϢ֮
+	*/
+	bool enablePerMessageDeflate(uint8 flags);
+	bool perMessageDeflate() const { return pDeflater_ != NULL; }
+
 protected:
 	void reset();
 	Reason onPing(Channel * pChannel, Packet* pPacket);
 
+	Reason onFrameHeader(Channel * pChannel, PacketReceiver & receiver);
+
+	bool deflateDatas(Packet* pPacket, Packet* pOutPacket, bool messageEnd);
+	Reason inflateDatas(Channel * pChannel, PacketReceiver & receiver, const uint8* pDatas, size_t size, bool messageEnd);
+
 protected:
 	enum FragmentDataTypes
 	{
@@ -55,8 +69,10 @@ protected:
 
 	uint8										msg_opcode_;
 	uint8										msg_fin_;
+	uint8										msg_rsv1_;
 	uint8										msg_masked_;
 	uint32										msg_mask_;
+	size_t										msg_mask_offset_;
 	int32										msg_length_field_;
 	uint64										msg_payload_length_;
 	websocket::WebSocketProtocol::FrameType		msg_frameType_;
@@ -64,6 +80,14 @@ protected:
 	Channel*									pChannel_;
 
 	TCPPacket*									pTCPPacket_;
+
+	// permessage-deflate
+	struct z_stream_s*							pDeflater_;
+	struct z_stream_s*							pInflater_;
+	bool										deflatingMessage_;
+	bool										inflatingMessage_;
+	bool										deflaterNoContextTakeover_;
+	bool										inflaterNoContextTakeover_;
 };
 
 
@@ -21,11 +21,17 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "websocket_protocol.h"
 #include "common/memorystream.h"
 #include "common/memorystream_converter.h"
+#include "network/common.h"
 #include "network/channel.h"
 #include "network/packet.h"
 #include "common/base64.h"
 #include "common/sha1.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KBE_WEBSOCKET_SSE2
+#endif
+
 #if KBE_PLATFORM == PLATFORM_WIN32
 #ifdef _DEBUG
 #pragma comment(lib, "libeay32_d.lib")
@@ -82,7 +88,7 @@ bool WebSocketProtocol::isWebSocketProtocol(MemoryStream* s)
 }
 
 //-------------------------------------------------------------------------------------
-bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
+bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s, uint8* pDeflateFlags)
 {
 	KBE_ASSERT(s != NULL);
 	
@@ -164,6 +170,29 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 
 	szHost = findIter->second;
 
+	std::string szExtensions;
+
+	if (pDeflateFlags)
+	{
+		*pDeflateFlags = 0;
+
+		uint8 flags = 0;
+		findIter = headers.find("Sec-WebSocket-Extensions");
+		if (g_websocketPerMessageDeflate && findIter != headers.end() && acceptPerMessageDeflate(findIter->second, flags))
+		{
+			// ˫ʹĬϵ15λڣͻҪno_context_takeoverҪӦ
+			szExtensions = "Sec-WebSocket-Extensions: permessage-deflate";
+
+			if (flags & DEFLATE_SERVER_NO_CONTEXT_TAKEOVER)
+				szExtensions += "; server_no_context_takeover";
+
+			if (flags & DEFLATE_CLIENT_NO_CONTEXT_TAKEOVER)
+				szExtensions += "; client_no_context_takeover";
+
+			szExtensions += "\r\n";
+			*pDeflateFlags = flags;
+		}
+	}
 
     std::string server_key = szKey;
 
@@ -186,9 +215,10 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 								"Connection: Upgrade\r\n"
 								"Sec-WebSocket-Accept: {}\r\n"
 								"{}"
+								"{}"
 								"WebSocket-Location: ws://{}/WebManagerSocket\r\n"
 								"WebSocket-Protocol: WebManagerSocket\r\n\r\n", 
-								server_key, szOrigin, szHost);
+								server_key, szOrigin, szExtensions, szHost);
 
 	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	(*pBundle) << ackHandshake;
@@ -197,14 +227,79 @@ bool WebSocketProtocol::handshake(Network::Channel* pChannel, MemoryStream* s)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+bool WebSocketProtocol::acceptPerMessageDeflate(const std::string& extensions, uint8& flags)
+{
+	// : permessage-deflate; client_max_window_bits, x-webkit-deflate-frame
+	std::vector<std::string> offers;
+	KBEngine::strutil::kbe_splits(extensions, ",", offers);
+
+	std::vector<std::string>::iterator iter = offers.begin();
+	for (; iter != offers.end(); ++iter)
+	{
+		std::vector<std::string> params;
+		KBEngine::strutil::kbe_splits((*iter), ";", params);
+
+		if (params.size() == 0 || KBEngine::strutil::kbe_trim(params[0]) != "permessage-deflate")
+			continue;
+
+		bool accept = true;
+		flags = DEFLATE_ENABLED;
+
+		for (size_t i = 1; i < params.size(); ++i)
+		{
+			std::string param = KBEngine::strutil::kbe_trim(params[i]);
+
+			std::string name = param;
+			std::string::size_type findex = param.find('=');
+			if (findex != std::string::npos)
+				name = KBEngine::strutil::kbe_trim(param.substr(0, findex));
+
+			if (name == "server_no_context_takeover")
+			{
+				flags |= DEFLATE_SERVER_NO_CONTEXT_TAKEOVER;
+			}
+			else if (name == "client_no_context_takeover")
+			{
+				flags |= DEFLATE_CLIENT_NO_CONTEXT_TAKEOVER;
+			}
+			else if (name == "server_max_window_bits")
+			{
+				// ˷ʹù̶15λڣͻҪСĴ򲻽
+				if (findex != std::string::npos && atoi(param.substr(findex + 1).c_str()) < 15)
+				{
+					accept = false;
+					break;
+				}
+			}
+			else if (name != "client_max_window_bits")
+			{
+				// RFC7692: ʶĲܾ
+				accept = false;
+				break;
+			}
+		}
+
+		if (accept)
+			return true;
+	}
+
+	flags = 0;
+	return false;
+}
+
 //-------------------------------------------------------------------------------------
 int WebSocketProtocol::makeFrame(WebSocketProtocol::FrameType frame_type, 
-	Packet * pInPacket, Packet * pOutPacket)
+	Packet * pInPacket, Packet * pOutPacket, bool compressed)
 {
 	uint64 size = pInPacket->length(); 
 
-	// дframe
-	(*pOutPacket) << ((uint8)frame_type); 
+	// дframeͣѹϢڵһ֡RSV1
+	uint8 firstByte = (uint8)frame_type;
+	if (compressed)
+		firstByte |= 0x40;
+
+	(*pOutPacket) << firstByte; 
 
 	if(size <= 125)
 	{
@@ -231,7 +326,7 @@ int WebSocketProtocol::makeFrame(WebSocketProtocol::FrameType frame_type,
 }
 
 //-------------------------------------------------------------------------------------
-int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_masked, uint32& msg_mask, 
+int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_rsv1, uint8& msg_masked, uint32& msg_mask, 
 		int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType)
 {
 	/*
@@ -269,6 +364,7 @@ int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_
 
 	msg_opcode = bytedata & 0x0F;
 	msg_fin = (bytedata >> 7) & 0x01;
+	msg_rsv1 = (bytedata >> 6) & 0x01;
 
 	// ڶֽ, ϢĵڶֽҪϢ, λ01Ƿ봦
 	(*pPacket) >> bytedata;
@@ -367,20 +463,58 @@ int WebSocketProtocol::getFrame(Packet * pPacket, uint8& msg_opcode, uint8& msg_
 }
 
 //-------------------------------------------------------------------------------------
-bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask)
+bool WebSocketProtocol::decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, size_t maskOffset)
 {
 	// 
 	if(msg_masked) 
 	{
-		uint8* c = pPacket->data() + pPacket->rpos();
-		for(int i=0; i<(int)pPacket->length(); i++) {
-			c[i] = c[i] ^ ((uint8*)(&msg_mask))[i % 4];
-		}
+		unmask(pPacket->data() + pPacket->rpos(), pPacket->length(), msg_mask, maskOffset);
 	}
 
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void WebSocketProtocol::unmask(uint8* pDatas, size_t size, uint32 msg_mask, size_t maskOffset)
+{
+	// תǰݶӦλ֮ÿδֽ4ıλֲ
+	uint8 mask[4];
+	for (int i = 0; i < 4; ++i)
+		mask[i] = ((uint8*)(&msg_mask))[(maskOffset + i) % 4];
+
+	size_t i = 0;
+
+#ifdef KBE_WEBSOCKET_SSE2
+	if (size >= 16)
+	{
+		uint32 mask32;
+		memcpy(&mask32, mask, 4);
+
+		const __m128i mask128 = _mm_set1_epi32((int)mask32);
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i v = _mm_loadu_si128((const __m128i*)(pDatas + i));
+			_mm_storeu_si128((__m128i*)(pDatas + i), _mm_xor_si128(v, mask128));
+		}
+	}
+#endif
+
+	uint64 mask64;
+	memcpy(&mask64, mask, 4);
+	memcpy(((uint8*)&mask64) + 4, mask, 4);
+
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64 v;
+		memcpy(&v, pDatas + i, 8);
+		v ^= mask64;
+		memcpy(pDatas + i, &v, 8);
+	}
+
+	for (; i < size; ++i)
+		pDatas[i] ^= mask[i % 4];
+}
+
 std::string WebSocketProtocol::getFrameTypeName(FrameType frame_type)
 {
 	if (frame_type == NEXT_FRAME)
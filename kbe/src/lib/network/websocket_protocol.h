@@ -70,6 +70,14 @@ public:
 		CLOSE_FRAME = 0x08
 	};
 
+	/** ʱЭ̵permessage-deflate */
+	enum DeflateFlags
+	{
+		DEFLATE_ENABLED							= 0x01,
+		DEFLATE_SERVER_NO_CONTEXT_TAKEOVER		= 0x02,	// ÿϢ֮ѹ
+		DEFLATE_CLIENT_NO_CONTEXT_TAKEOVER		= 0x04	// ͻÿϢ֮ѹ
+	};
+
 	/**
 		ǷwebsocketЭ
 	*/
@@ -78,16 +86,26 @@ public:
 	/**
 		websocketЭ
 	*/
-	static bool handshake(Network::Channel* pChannel, MemoryStream* s);
+	static bool handshake(Network::Channel* pChannel, MemoryStream* s, uint8* pDeflateFlags = NULL);
 
 	/**
 		֡
 	*/
-	static int makeFrame(FrameType frame_type, Packet* pInPacket, Packet* pOutPacket);
-	static int getFrame(Packet* pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_masked, uint32& msg_mask, 
+	static int makeFrame(FrameType frame_type, Packet* pInPacket, Packet* pOutPacket, bool compressed = false);
+	static int getFrame(Packet* pPacket, uint8& msg_opcode, uint8& msg_fin, uint8& msg_rsv1, uint8& msg_masked, uint32& msg_mask, 
 		int32& msg_length_field, uint64& msg_payload_length, FrameType& frameType);
 
-	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask);
+	static bool decodingDatas(Packet* pPacket, uint8 msg_masked, uint32 msg_mask, size_t maskOffset = 0);
+
+	/**
+		봦maskOffsetΪһ֡Ѿֽ(ݿʱλҪ)
+	*/
+	static void unmask(uint8* pDatas, size_t size, uint32 msg_mask, size_t maskOffset = 0);
+
+	/**
+		ͻǷṩ˿Խܵpermessage-deflateչ(RFC7692)ʱflagsЭ̵DeflateFlags
+	*/
+	static bool acceptPerMessageDeflate(const std::string& extensions, uint8& flags);
 
 	static std::string getFrameTypeName(FrameType frame_type);
 };
@@ -0,0 +1,106 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef KBE_PY_FREELIST_H
+#define KBE_PY_FREELIST_H
+
+#include "common/common.h"
+
+namespace KBEngine{ namespace script{
+
+/*
+	űڴ
+	Vector2/3/4Сڽűбʱ٣
+	ڴ鲻黹ϵͳǻһֱͬӸá
+	űֻڳGIL߳д٣
+*/
+template<typename T, size_t MAX_SIZE = 1024>
+class PyFreeList
+{
+public:
+	~PyFreeList()
+	{
+		std::vector<void*>::iterator iter = blocks_.begin();
+		for(; iter != blocks_.end(); ++iter)
+			::operator delete((*iter));
+
+		blocks_.clear();
+	}
+
+	static void* alloc(size_t size)
+	{
+		PyFreeList& freeList = instance();
+		if(size != sizeof(T) || freeList.blocks_.empty())
+			return ::operator new(size);
+
+		void* p = freeList.blocks_.back();
+		freeList.blocks_.pop_back();
+		return p;
+	}
+
+	static void release(void* p, size_t size)
+	{
+		if(p == NULL)
+			return;
+
+		PyFreeList& freeList = instance();
+		if(size != sizeof(T) || freeList.blocks_.size() >= MAX_SIZE)
+		{
+			::operator delete(p);
+			return;
+		}
+
+		freeList.blocks_.push_back(p);
+	}
+
+	static size_t size()
+	{
+		return instance().blocks_.size();
+	}
+
+private:
+	static PyFreeList& instance()
+	{
+		// ⲻͷţ ֤ھ̬ʼ׶ʹʱѾ죬
+		// ھ̬׶жʱҲ
+		static PyFreeList* pFreeList = new PyFreeList();
+		return *pFreeList;
+	}
+
+	std::vector<void*> blocks_;
+};
+
+/** Ϊűṩʹÿoperator new/delete */
+#define SCRIPT_FREELIST_ALLOCATOR(CLASS)													\
+	static void* operator new(size_t size)													\
+	{																						\
+		return script::PyFreeList<CLASS>::alloc(size);										\
+	}																						\
+																							\
+	static void operator delete(void* p, size_t size)										\
+	{																						\
+		script::PyFreeList<CLASS>::release(p, size);										\
+	}																						\
+
+}
+}
+
+#endif // KBE_PY_FREELIST_H
@@ -23,12 +23,19 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "scriptstdouterr.h"
 #include "py_macros.h"
 #include "helper/profile.h"
+#include "helper/watcher.h"
+#include "common/timestamp.h"
 
 namespace KBEngine{ namespace script {
 
 PyObject* PyGC::collectMethod_ = NULL;
 PyObject* PyGC::set_debugMethod_ = NULL;
-KBEUnordered_map<std::string, int> PyGC::tracingCountMap_;
+PyObject* PyGC::get_countMethod_ = NULL;
+PyObject* PyGC::freezeMethod_ = NULL;
+int PyGC::tracingCounts_[PyGC::MAX_TRACING_SLOTS];
+char PyGC::tracingNames_[PyGC::MAX_TRACING_SLOTS][PyGC::MAX_TRACING_NAME];
+int32 PyGC::tracingSlotCount_ = 0;
+int32 PyGC::tracingDroppedCount_ = 0;
 
 uint32 PyGC::DEBUG_STATS = 0;
 uint32 PyGC::DEBUG_COLLECTABLE = 0;
@@ -38,12 +45,32 @@ uint32 PyGC::DEBUG_LEAK = 0;
 	
 bool PyGC::isInit = false;
 
+bool PyGC::tickScheduled_ = false;
+int PyGC::thresholds_[3] = {700, 10, 10};
+float PyGC::tickBudget_ = 2.f;
+float PyGC::fullCollectInterval_ = 60.f;
+uint64 PyGC::lastFullCollectTime_ = 0;
+
+float PyGC::tickPause_ = 0.f;
+float PyGC::maxTickPause_ = 0.f;
+uint32 PyGC::collections_[3] = {0, 0, 0};
+
+uint32 PyGC::deferredTicks_ = 0;
+uint64 PyGC::deferStartTime_ = 0;
+uint32 PyGC::forcedCollections_ = 0;
+
 
 //-------------------------------------------------------------------------------------
 bool PyGC::initialize(void)
 {
 	if(isInit)
 		return true;
+
+	if(tracingDroppedCount_ > 0)
+	{
+		ERROR_MSG(fmt::format("PyGC::initialize: {} tracing categories were not registered, all {} slots are in use!\n", 
+			tracingDroppedCount_, (int)MAX_TRACING_SLOTS));
+	}
 	
 	PyObject* gcModule = PyImport_ImportModule("gc");
 
@@ -63,6 +90,31 @@ bool PyGC::initialize(void)
 			PyErr_PrintEx(0);
 		}
 
+		get_countMethod_ = PyObject_GetAttrString(gcModule, "get_count");
+		if(!get_countMethod_)
+		{
+			ERROR_MSG("PyGC::init: get get_count error!\n");
+			PyErr_PrintEx(0);
+		}
+
+		// python3.7ṩgc.freeze ûʱ
+		freezeMethod_ = PyObject_GetAttrString(gcModule, "freeze");
+		if(!freezeMethod_)
+			PyErr_Clear();
+
+		PyObject* pyThresholds = PyObject_CallMethod(gcModule, const_cast<char*>("get_threshold"), const_cast<char*>(""));
+		if(pyThresholds)
+		{
+			if(!PyArg_ParseTuple(pyThresholds, "iii", &thresholds_[0], &thresholds_[1], &thresholds_[2]))
+				PyErr_Clear();
+
+			Py_DECREF(pyThresholds);
+		}
+		else
+		{
+			PyErr_Clear();
+		}
+
 		PyObject* flag = NULL;
 		
 		flag = PyObject_GetAttrString(gcModule, "DEBUG_STATS");
@@ -149,9 +201,15 @@ void PyGC::finalise(void)
 {
 	Py_XDECREF(collectMethod_);
 	Py_XDECREF(set_debugMethod_);
+	Py_XDECREF(get_countMethod_);
+	Py_XDECREF(freezeMethod_);
 	
 	collectMethod_ = NULL;
 	set_debugMethod_ = NULL;	
+	get_countMethod_ = NULL;
+	freezeMethod_ = NULL;
+	tickScheduled_ = false;
+	isInit = false;
 }
 
 //-------------------------------------------------------------------------------------
@@ -193,47 +251,192 @@ void PyGC::set_debug(uint32 flags)
 }
 
 //-------------------------------------------------------------------------------------
-void PyGC::incTracing(std::string name)
+void PyGC::enableTickSchedule(float tickBudget, float fullCollectInterval)
+{
+	if(!isInit || !get_countMethod_)
+		return;
+
+	PyObject* gcModule = PyImport_ImportModule("gc");
+	if(!gcModule)
+	{
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
+	PyObject* pyRet = PyObject_CallMethod(gcModule, const_cast<char*>("disable"), const_cast<char*>(""));
+	Py_DECREF(gcModule);
+
+	if(!pyRet)
+	{
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
+	Py_DECREF(pyRet);
+
+	tickScheduled_ = true;
+	tickBudget_ = tickBudget;
+	fullCollectInterval_ = fullCollectInterval;
+	lastFullCollectTime_ = timestamp();
+
+	INFO_MSG(fmt::format("PyGC::enableTickSchedule: tickBudget={}ms, fullCollectInterval={}s, thresholds=({}, {}, {})\n", 
+		tickBudget_, fullCollectInterval_, thresholds_[0], thresholds_[1], thresholds_[2]));
+}
+
+//-------------------------------------------------------------------------------------
+void PyGC::onTick()
 {
-	KBEUnordered_map<std::string, int>::iterator iter = tracingCountMap_.find(name);
-	if(iter == tracingCountMap_.end())
+	if(!tickScheduled_)
+		return;
+
+	PyObject* pyCounts = PyObject_CallFunction(get_countMethod_, const_cast<char*>(""));
+	if(!pyCounts)
+	{
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
+	int counts[3] = {0, 0, 0};
+	if(!PyArg_ParseTuple(pyCounts, "iii", &counts[0], &counts[1], &counts[2]))
+		PyErr_Clear();
+
+	Py_DECREF(pyCounts);
+
+	// pythonԶһ£ ѡֵһ
+	// һtickĻѳԤʱ tickֻ0գ ϴƳٵtick
+	// 0Ԥʱϴһֱòգ ƳٹúǿƲһ
+	// ȫ޷֣ ֻƵ
+	int8 generation = -1;
+	uint64 now = timestamp();
+	bool overBudget = tickPause_ > tickBudget_;
+
+	if(counts[0] > thresholds_[0])
+		generation = 0;
+
+	if(counts[1] > thresholds_[1])
 	{
-		tracingCountMap_[name] = 0;
-		iter = tracingCountMap_.find(name);
+		if(overBudget)
+		{
+			if(deferredTicks_++ == 0)
+				deferStartTime_ = now;
+
+			if(deferredTicks_ > MAX_DEFERRED_TICKS || 
+				double(now - deferStartTime_) * 1000.0 / stampsPerSecondD() >= MAX_DEFERRED_MS)
+			{
+				overBudget = false;
+				++forcedCollections_;
+			}
+		}
+	}
+	else
+	{
+		deferredTicks_ = 0;
+	}
+
+	if(!overBudget && counts[1] > thresholds_[1])
+	{
+		deferredTicks_ = 0;
+
+		generation = 1;
+
+		if(counts[2] > thresholds_[2] && 
+			double(now - lastFullCollectTime_) / stampsPerSecondD() >= fullCollectInterval_)
+		{
+			generation = 2;
+		}
+	}
+
+	if(generation < 0)
+	{
+		tickPause_ = 0.f;
+		return;
 	}
 
-	iter->second = iter->second + 1;
+	collect(generation);
+
+	uint64 end = timestamp();
+	tickPause_ = float(double(end - now) * 1000.0 / stampsPerSecondD());
+
+	if(tickPause_ > maxTickPause_)
+		maxTickPause_ = tickPause_;
+
+	++collections_[generation];
+
+	if(generation == 2)
+		lastFullCollectTime_ = end;
 }
 
 //-------------------------------------------------------------------------------------
-void PyGC::decTracing(std::string name)
+void PyGC::freeze()
 {
-	KBEUnordered_map<std::string, int>::iterator iter = tracingCountMap_.find(name);
-	if(iter == tracingCountMap_.end())
+	if(!isInit || !freezeMethod_)
+		return;
+
+	// Ƚһգ Ҳ
+	collect();
+
+	PyObject* pyRet = PyObject_CallFunction(freezeMethod_, const_cast<char*>(""));
+	if(!pyRet)
 	{
+		SCRIPT_ERROR_CHECK();
 		return;
 	}
 
-	iter->second = iter->second - 1;
-	KBE_ASSERT(iter->second >= 0);
+	Py_DECREF(pyRet);
+	INFO_MSG("PyGC::freeze: the current heap has been frozen.\n");
+}
+
+//-------------------------------------------------------------------------------------
+bool PyGC::initializeWatcher()
+{
+	WATCH_OBJECT("pyGC/tickPause", tickPause_);
+	WATCH_OBJECT("pyGC/maxTickPause", maxTickPause_);
+	WATCH_OBJECT("pyGC/gen0Collections", collections_[0]);
+	WATCH_OBJECT("pyGC/gen1Collections", collections_[1]);
+	WATCH_OBJECT("pyGC/gen2Collections", collections_[2]);
+	WATCH_OBJECT("pyGC/forcedCollections", forcedCollections_);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+int32 PyGC::registerTracing(const char* name)
+{
+	for(int32 i = 0; i < tracingSlotCount_; ++i)
+	{
+		if(strncmp(tracingNames_[i], name, MAX_TRACING_NAME - 1) == 0)
+			return i;
+	}
+
+	if(tracingSlotCount_ >= MAX_TRACING_SLOTS)
+	{
+		// ܴھ̬ʼ׶Σ ־ϵͳ
+		++tracingDroppedCount_;
+		fprintf(stderr, "PyGC::registerTracing: no free slot for %s, max %d!\n", name, (int)MAX_TRACING_SLOTS);
+		return -1;
+	}
+
+	int32 slot = tracingSlotCount_++;
+	strncpy(tracingNames_[slot], name, MAX_TRACING_NAME - 1);
+	tracingNames_[slot][MAX_TRACING_NAME - 1] = '\0';
+	tracingCounts_[slot] = 0;
+	return slot;
 }
 
 //-------------------------------------------------------------------------------------
 void PyGC::debugTracing(bool shuttingdown)
 {
-	KBEUnordered_map<std::string, int>::iterator iter = tracingCountMap_.begin();
-	for(; iter != tracingCountMap_.end(); ++iter)
+	for(int32 i = 0; i < tracingSlotCount_; ++i)
 	{
 		if(shuttingdown)
 		{
-			if(iter->second == 0)
+			if(tracingCounts_[i] == 0)
 				continue;
 
-			ERROR_MSG(fmt::format("PyGC::debugTracing(): {} : leaked({})\n", iter->first, iter->second));
+			ERROR_MSG(fmt::format("PyGC::debugTracing(): {} : leaked({})\n", tracingNames_[i], tracingCounts_[i]));
 		}
 		else
 		{
-			Script::getSingleton().pyStdouterr()->pyPrint(fmt::format("PyGC::debugTracing(): {} : {}", iter->first, iter->second));
+			Script::getSingleton().pyStdouterr()->pyPrint(fmt::format("PyGC::debugTracing(): {} : {}", tracingNames_[i], tracingCounts_[i]));
 		}
 	}
 }
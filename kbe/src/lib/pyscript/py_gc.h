@@ -50,16 +50,56 @@ public:
 		õԱ־
 	*/
 	static void set_debug(uint32 flags);
+
+	/** 
+		ӹѭյĵ
+		رpythonԶգ ΪÿtickʱݸԤлգ
+		tickм䴥ȫɿ
+		tickBudget: ÿtickպʱԤ() һλճԤʱƳϴ
+		fullCollectInterval: ȫ֮С()
+	*/
+	static void enableTickSchedule(float tickBudget, float fullCollectInterval);
+
+	/** 
+		ÿtickʱã ִһηִ
+	*/
+	static void onTick();
+
+	/** 
+		ᵱǰеж(gc.freeze) ֮Ļղɨ
+		һɡԶصʵ崴Ϻ
+	*/
+	static void freeze();
+
+	static bool initializeWatcher();
 	
+	/**
+		עһ׷ λ
+		ͬ𷵻ͬһλ ھ̬ʼ׶ε
+		λʱ-1 𲻱׷٣ initializeʱ
+	*/
+	static int32 registerTracing(const char* name);
+
 	/**
 		Ӽ
 	*/
-	static void incTracing(std::string name);
+	static void incTracing(int32 slot)
+	{
+		if(slot >= 0)
+			++tracingCounts_[slot];
+	}
 
 	/**
 		ټ
 	*/
-	static void decTracing(std::string name);
+	static void decTracing(int32 slot)
+	{
+		if(slot < 0)
+			return;
+
+		--tracingCounts_[slot];
+		KBE_ASSERT(tracingCounts_[slot] >= 0);
+	}
 
 	/**
 		debug׷kbeװpy
@@ -74,10 +114,43 @@ public:
 private:
 	static PyObject* collectMethod_;							// cPicket.dumpsָ
 	static PyObject* set_debugMethod_;							// cPicket.loadsָ
+	static PyObject* get_countMethod_;							// gc.get_countָ
+	static PyObject* freezeMethod_;								// gc.freezeָ
+
+	static bool tickScheduled_;									// ǷtickеȻ
+	static int thresholds_[3];									// pythonĻֵ
+	static float tickBudget_;									// ÿtickպʱԤ()
+	static float fullCollectInterval_;							// ȫյС()
+	static uint64 lastFullCollectTime_;							// һȫյʱ
+
+	static float tickPause_;									// һtickպʱ()
+	static float maxTickPause_;									// tickʱ()
+	static uint32 collections_[3];								// ȻյĴ
+
+	enum
+	{
+		MAX_DEFERRED_TICKS = 10,								// ϴƳٵtick
+		MAX_DEFERRED_MS = 1000									// ϴƳٵʱ()
+	};
+
+	static uint32 deferredTicks_;								// ϴƳٵtick
+	static uint64 deferStartTime_;								// ϴʼƳٵʱ
+	static uint32 forcedCollections_;							// Ƴٹöǿƽеϴմ
 
 	static bool	isInit;											// ǷѾʼ
 
-	static KBEUnordered_map<std::string, int> tracingCountMap_;	// ׷ضĶ
+	enum
+	{
+		MAX_TRACING_SLOTS = 64,
+		MAX_TRACING_NAME = 64
+	};
+
+	// ׷ضĶ Բλ ÿιʱַϣ
+	// ΪPOD̬飬 κζ̬ʼ֮ǰ
+	static int tracingCounts_[MAX_TRACING_SLOTS];
+	static char tracingNames_[MAX_TRACING_SLOTS][MAX_TRACING_NAME];
+	static int32 tracingSlotCount_;
+	static int32 tracingDroppedCount_;							// λδע
 } ;
 
 }
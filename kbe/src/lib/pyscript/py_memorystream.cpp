@@ -42,6 +42,9 @@ PySequenceMethods PyMemoryStream::seqMethods =
 	0				// intargfunc sq_inplace_repeat;	x *= n
 };
 
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("MemoryStream");
+
 SCRIPT_METHOD_DECLARE_BEGIN(PyMemoryStream)
 SCRIPT_METHOD_DECLARE("append",				append,			METH_VARARGS, 0)
 SCRIPT_METHOD_DECLARE("pop",				pop,			METH_VARARGS, 0)
@@ -72,7 +75,7 @@ ScriptObject(getScriptType(), false),
 readonly_(readonly)
 {
 	initialize(strDictInitData);
-	script::PyGC::incTracing("MemoryStream");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -81,7 +84,7 @@ ScriptObject(getScriptType(), false),
 readonly_(readonly)
 {
 	initialize(pyDictInitData);
-	script::PyGC::incTracing("MemoryStream");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -90,7 +93,7 @@ ScriptObject(getScriptType(), false),
 readonly_(readonly)
 {
 	initialize(streamInitData);
-	script::PyGC::incTracing("MemoryStream");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -99,7 +102,7 @@ ScriptObject(getScriptType(), false),
 readonly_(readonly)
 {
 	initialize("");
-	script::PyGC::incTracing("MemoryStream");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
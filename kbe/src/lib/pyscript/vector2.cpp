@@ -95,6 +95,9 @@ static int tp_compare(PyObject* v, PyObject* w)
 	return 0;
 }
 */
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Vector2");
+
 SCRIPT_METHOD_DECLARE_BEGIN(ScriptVector2)
 SCRIPT_METHOD_DECLARE("distTo",							pyDistTo,					METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE("distSqrTo",						pyDistSqrTo,				METH_VARARGS,		0)
@@ -125,34 +128,33 @@ ScriptObject(getScriptType(), false),
 val_(v),
 isCopy_(true)
 {
-	script::PyGC::incTracing("Vector2");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector2::ScriptVector2(Vector2 v):
 ScriptObject(getScriptType(), false),
+localVal_(v),
 isCopy_(false)
 {
-	val_ = new Vector2(v);
-	script::PyGC::incTracing("Vector2");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector2::ScriptVector2(float x, float y):
 ScriptObject(getScriptType(), false),
+localVal_(x, y),
 isCopy_(false)
 {
-	val_ = new Vector2(x, y);
-	script::PyGC::incTracing("Vector2");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector2::~ScriptVector2()
 {
-	if(!isCopy_)
-		delete val_;
-
-	script::PyGC::decTracing("Vector2");
+	script::PyGC::decTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
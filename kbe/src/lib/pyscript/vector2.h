@@ -24,6 +24,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "math/math.h"
 #include "scriptobject.h"
 #include "pickler.h"
+#include "py_freelist.h"
 	
 namespace KBEngine{ namespace script{
 	
@@ -31,6 +32,9 @@ class ScriptVector2 : public ScriptObject
 {		
 	/** ໯ һЩpy */
 	INSTANCE_SCRIPT_HREADER(ScriptVector2, ScriptObject)
+
+	/** űлʱ ʹÿڴ */
+	SCRIPT_FREELIST_ALLOCATOR(ScriptVector2)
 public:	
 	static PySequenceMethods seqMethods;
 	static PyNumberMethods numberMethods;
@@ -127,6 +131,7 @@ public:
 
 private:
 	Vector2*			val_;
+	Vector2				localVal_;											// ʱֵڶڣ Ķѷ
 	bool				isCopy_;
 	bool				isReadOnly_;
 	static const int 	VECTOR_SIZE;
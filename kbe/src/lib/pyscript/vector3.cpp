@@ -95,6 +95,9 @@ static int tp_compare(PyObject* v, PyObject* w)
 	return 0;
 }
 */
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Vector3");
+
 SCRIPT_METHOD_DECLARE_BEGIN(ScriptVector3)
 SCRIPT_METHOD_DECLARE("flatDistTo",						pyFlatDistTo,				METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("flatDistSqrTo",					pyFlatDistSqrTo,			METH_VARARGS,				0)
@@ -129,37 +132,36 @@ val_(v),
 isRef_(true),
 _pyVector3ChangedCallback(pyVector3ChangedCallback)
 {
-	script::PyGC::incTracing("Vector3");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector3::ScriptVector3(Vector3 v):
 ScriptObject(getScriptType(), false),
+localVal_(v),
 isRef_(false),
 _pyVector3ChangedCallback(NULL)
 {
-	val_ = new Vector3(v);
-	script::PyGC::incTracing("Vector3");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector3::ScriptVector3(float x, float y, float z):
 ScriptObject(getScriptType(), false),
+localVal_(x, y, z),
 isRef_(false),
 _pyVector3ChangedCallback(NULL)
 {
-	val_ = new Vector3(x, y, z);
-	script::PyGC::incTracing("Vector3");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector3::~ScriptVector3()
 {
-	if(!isRef_)
-		delete val_;
-
 	_pyVector3ChangedCallback = NULL;
-	script::PyGC::decTracing("Vector3");
+	script::PyGC::decTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -167,7 +169,8 @@ void ScriptVector3::onLoseRef()
 {
 	setPYVector3ChangedCallback(NULL);
 	isRef_ = false;
-	val_ = new Vector3((*val_));
+	localVal_ = (*val_);
+	val_ = &localVal_;
 }
 
 //-------------------------------------------------------------------------------------
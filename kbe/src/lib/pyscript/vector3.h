@@ -24,6 +24,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "math/math.h"
 #include "scriptobject.h"
 #include "pickler.h"
+#include "py_freelist.h"
 	
 namespace KBEngine{ namespace script{
 	
@@ -31,6 +32,9 @@ class ScriptVector3 : public ScriptObject
 {		
 	/** ໯ һЩpy */
 	INSTANCE_SCRIPT_HREADER(ScriptVector3, ScriptObject)
+
+	/** űлʱ ʹÿڴ */
+	SCRIPT_FREELIST_ALLOCATOR(ScriptVector3)
 public:	
 	typedef std::tr1::function<void (void)> PYVector3ChangedCallback;
 
@@ -145,6 +149,7 @@ public:
 
 private:
 	Vector3*						val_;
+	Vector3							localVal_;						// ʱֵڶڣ Ķѷ
 	bool							isRef_;
 	bool							isReadOnly_;
 	static const int 				VECTOR_SIZE;
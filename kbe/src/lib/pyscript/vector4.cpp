@@ -96,6 +96,9 @@ static int tp_compare(PyObject* v, PyObject* w)
 	return 0;
 }
 */
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Vector4");
+
 SCRIPT_METHOD_DECLARE_BEGIN(ScriptVector4)
 SCRIPT_METHOD_DECLARE("distTo",							pyDistTo,					METH_VARARGS,			0)
 SCRIPT_METHOD_DECLARE("distSqrTo",						pyDistSqrTo,				METH_VARARGS,			0)
@@ -127,34 +130,33 @@ ScriptObject(getScriptType(), false),
 val_(v),
 isCopy_(true)
 {
-	script::PyGC::incTracing("Vector4");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector4::ScriptVector4(Vector4 v):
 ScriptObject(getScriptType(), false),
+localVal_(v),
 isCopy_(false)
 {
-	val_ = new Vector4(v);
-	script::PyGC::incTracing("Vector4");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector4::ScriptVector4(float x, float y, float z, float w):
 ScriptObject(getScriptType(), false),
+localVal_(x, y, z, w),
 isCopy_(false)
 {
-	val_ = new Vector4(x, y, z, w);
-	script::PyGC::incTracing("Vector4");
+	val_ = &localVal_;
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
 ScriptVector4::~ScriptVector4()
 {
-	if(!isCopy_)
-		delete val_;
-
-	script::PyGC::decTracing("Vector4");
+	script::PyGC::decTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
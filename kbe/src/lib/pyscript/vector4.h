@@ -24,6 +24,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "math/math.h"
 #include "scriptobject.h"
 #include "pickler.h"
+#include "py_freelist.h"
 	
 namespace KBEngine{ namespace script{
 	
@@ -31,6 +32,9 @@ class ScriptVector4 : public ScriptObject
 {		
 	/** ໯ һЩpy */
 	INSTANCE_SCRIPT_HREADER(ScriptVector4, ScriptObject)
+
+	/** űлʱ ʹÿڴ */
+	SCRIPT_FREELIST_ALLOCATOR(ScriptVector4)
 public:	
 	static PySequenceMethods seqMethods;
 	static PyNumberMethods numberMethods;
@@ -128,6 +132,7 @@ public:
 
 private:
 	Vector4*			val_;
+	Vector4				localVal_;											// ʱֵڶڣ Ķѷ
 	bool				isCopy_;
 	bool				isReadOnly_;
 	static const int 	VECTOR_SIZE;
@@ -45,6 +45,10 @@ kb_env_(),
 respaths_(),
 isInit_(false),
 respool_(),
+pResIndex_(new RES_INDEX()),
+resIndexMutex_(),
+resIndexHits_(0),
+resIndexMisses_(0),
 mutex_()
 {
 }
@@ -61,6 +65,9 @@ bool Resmgr::initializeWatcher()
 	WATCH_OBJECT("syspaths/KBE_ROOT", kb_env_.root_path);
 	WATCH_OBJECT("syspaths/KBE_RES_PATH", kb_env_.res_path);
 	WATCH_OBJECT("syspaths/KBE_BIN_PATH", kb_env_.bin_path);
+	WATCH_OBJECT("resmgr/indexSize", this, &Resmgr::resIndexSize);
+	WATCH_OBJECT("resmgr/indexHits", this, &Resmgr::resIndexHits);
+	WATCH_OBJECT("resmgr/indexMisses", this, &Resmgr::resIndexMisses);
 	return true;
 }
 
@@ -112,6 +119,9 @@ void Resmgr::updatePaths()
 		strutil::kbe_replace(kb_env_.bin_path, "//", "/");
 	}
 
+	// ԴĿ¼ıʧЧbuildResIndex½
+	std::atomic_store(&pResIndex_, std::shared_ptr<const RES_INDEX>(new RES_INDEX()));
+
 	respaths_.clear();
 	std::string tbuf = kb_env_.res_path;
 	char splitFlag = ';';
@@ -184,9 +194,169 @@ bool Resmgr::initialize()
 	isInit_ = true;
 
 	respool_.clear();
+
+	buildResIndex();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Resmgr::buildResIndex()
+{
+	std::shared_ptr<RES_INDEX> pIndex(new RES_INDEX());
+
+	// respaths_˳ͬԴԿǰĿ¼Ϊ׼Ŀ¼ҵĽһ
+	std::vector<std::string>::iterator iter = respaths_.begin();
+	for(; iter != respaths_.end(); ++iter)
+	{
+		if((*iter).size() == 0)
+			continue;
+
+		indexResPath(*pIndex, (*iter), "", 0);
+	}
+
+	KBEngine::thread::ThreadGuard tg(&resIndexMutex_);
+
+	std::atomic_store(&pResIndex_, std::shared_ptr<const RES_INDEX>(pIndex));
+	resIndexHits_ = 0;
+	resIndexMisses_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void Resmgr::indexResPath(RES_INDEX& index, const std::string& respath, const std::string& relpath, int depth)
+{
+	// ֹɵѭ
+	if(depth > 32)
+		return;
+
+	std::string dirpath = respath + relpath;
+	strutil::kbe_replace(dirpath, "\\", "/");
+	strutil::kbe_replace(dirpath, "//", "/");
+
+#if KBE_PLATFORM != PLATFORM_WIN32
+	DIR* dir = opendir(dirpath.c_str());
+	if (dir == NULL)
+		return;
+
+	struct dirent* filename;
+	while ((filename = readdir(dir)) != NULL)
+	{
+		// Ŀ¼ļ(.svn.git)
+		if (filename->d_name[0] == '.')
+			continue;
+
+		std::string name = relpath + filename->d_name;
+		std::string fpath = dirpath + filename->d_name;
+
+		struct stat s;
+		if (stat(fpath.c_str(), &s) != 0)
+			continue;
+
+		if (S_ISDIR(s.st_mode))
+		{
+			indexResPath(index, respath, name + "/", depth + 1);
+		}
+		else if (index.find(name) == index.end())
+		{
+			index[name] = fpath;
+		}
+	}
+
+	closedir(dir);
+#else
+	WIN32_FIND_DATAA findFileData;
+	HANDLE hFind = FindFirstFileA((dirpath + "*").c_str(), &findFileData);
+	if (INVALID_HANDLE_VALUE == hFind)
+		return;
+
+	do
+	{
+		if (findFileData.cFileName[0] == '.')
+			continue;
+
+		std::string name = relpath + findFileData.cFileName;
+
+		if (findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			indexResPath(index, respath, name + "/", depth + 1);
+		}
+		else if (index.find(name) == index.end())
+		{
+			index[name] = dirpath + findFileData.cFileName;
+		}
+	} while (FindNextFileA(hFind, &findFileData));
+
+	FindClose(hFind);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+static std::string resIndexKey(const char* res)
+{
+	std::string key = res;
+	strutil::kbe_replace(key, "\\", "/");
+	strutil::kbe_replace(key, "//", "/");
+
+	if (key.size() > 0 && key[0] == '/')
+		key.erase(0, 1);
+
+	return key;
+}
+
+//-------------------------------------------------------------------------------------
+size_t Resmgr::resIndexSize() const
+{
+	return std::atomic_load(&pResIndex_)->size();
+}
+
+//-------------------------------------------------------------------------------------
+bool Resmgr::findResIndex(const char* res, std::string& path)
+{
+	// ʱֱҲļ
+	std::shared_ptr<const RES_INDEX> pIndex = std::atomic_load(&pResIndex_);
+
+	RES_INDEX::const_iterator iter = pIndex->find(resIndexKey(res));
+	if (iter == pIndex->end())
+	{
+		++resIndexMisses_;
+		return false;
+	}
+
+	path = iter->second;
+	++resIndexHits_;
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void Resmgr::addResIndex(const char* res, const std::string& path)
+{
+	if (!isInit_)
+		return;
+
+	std::string key = resIndexKey(res);
+
+	KBEngine::thread::ThreadGuard tg(&resIndexMutex_);
+
+	std::shared_ptr<RES_INDEX> pIndex(new RES_INDEX(*std::atomic_load(&pResIndex_)));
+	(*pIndex)[key] = path;
+	std::atomic_store(&pResIndex_, std::shared_ptr<const RES_INDEX>(pIndex));
+}
+
+//-------------------------------------------------------------------------------------
+void Resmgr::invalidateResIndex(const char* res)
+{
+	std::string key = resIndexKey(res);
+
+	KBEngine::thread::ThreadGuard tg(&resIndexMutex_);
+
+	std::shared_ptr<const RES_INDEX> pCurrIndex = std::atomic_load(&pResIndex_);
+	if (pCurrIndex->find(key) == pCurrIndex->end())
+		return;
+
+	std::shared_ptr<RES_INDEX> pIndex(new RES_INDEX(*pCurrIndex));
+	pIndex->erase(key);
+	std::atomic_store(&pResIndex_, std::shared_ptr<const RES_INDEX>(pIndex));
+}
+
 //-------------------------------------------------------------------------------------
 void Resmgr::print(void)
 {
@@ -211,6 +381,10 @@ std::string Resmgr::matchRes(const std::string& res)
 //-------------------------------------------------------------------------------------
 std::string Resmgr::matchRes(const char* res)
 {
+	std::string indexPath;
+	if (findResIndex(res, indexPath))
+		return indexPath;
+
 	std::vector<std::string>::iterator iter = respaths_.begin();
 
 	for(; iter != respaths_.end(); ++iter)
@@ -222,6 +396,7 @@ std::string Resmgr::matchRes(const char* res)
 
 		if (access(fpath.c_str(), 0) == 0)
 		{
+			addResIndex(res, fpath);
 			return fpath;
 		}
 	}
@@ -232,6 +407,10 @@ std::string Resmgr::matchRes(const char* res)
 //-------------------------------------------------------------------------------------
 bool Resmgr::hasRes(const std::string& res)
 {
+	std::string indexPath;
+	if (findResIndex(res.c_str(), indexPath))
+		return true;
+
 	std::vector<std::string>::iterator iter = respaths_.begin();
 
 	for(; iter != respaths_.end(); ++iter)
@@ -243,6 +422,7 @@ bool Resmgr::hasRes(const std::string& res)
 
 		if (access(fpath.c_str(), 0) == 0)
 		{
+			addResIndex(res.c_str(), fpath);
 			return true;
 		}
 	}
@@ -253,6 +433,18 @@ bool Resmgr::hasRes(const std::string& res)
 //-------------------------------------------------------------------------------------
 FILE* Resmgr::openRes(std::string res, const char* mode)
 {
+	std::string indexPath;
+	if (findResIndex(res.c_str(), indexPath))
+	{
+		FILE * f = fopen (indexPath.c_str(), mode);
+		if(f != NULL)
+			return f;
+
+		// ֮ļѱɾƶ
+		if (access(indexPath.c_str(), 0) != 0)
+			invalidateResIndex(res.c_str());
+	}
+
 	std::vector<std::string>::iterator iter = respaths_.begin();
 
 	for(; iter != respaths_.end(); ++iter)
@@ -265,6 +457,7 @@ FILE* Resmgr::openRes(std::string res, const char* mode)
 		FILE * f = fopen (fpath.c_str(), mode);
 		if(f != NULL)
 		{
+			addResIndex(res.c_str(), fpath);
 			return f;
 		}
 	}
@@ -30,6 +30,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "common/timer.h"
 #include "xml/xml.h"	
 #include "common/smartpointer.h"
+#include <atomic>
 	
 namespace KBEngine{
 
@@ -133,16 +134,46 @@ public:
 
 	void update();
 
+	/**
+		ԴĿ¼Դ(·->·)֮ĲֻҪһιϣѯٷļϵͳ
+		ûеԴ˵Ŀ¼ңҵԴĿ¼ıʱգ
+		openResеļʧʱƳڼɾڿǰĿ¼½ͬԴҪµô˽ӿ
+	*/
+	void buildResIndex();
+
+	/**
+		Ƴһ֪ڵԴ´βһ˵Ŀ¼
+	*/
+	void invalidateResIndex(const char* res);
+
+	size_t resIndexSize() const;
+	uint32 resIndexHits() const { return resIndexHits_; }
+	uint32 resIndexMisses() const { return resIndexMisses_; }
+
 private:
 
 	virtual void handleTimeout(TimerHandle handle, void * arg);
 
+	typedef KBEUnordered_map< std::string, std::string > RES_INDEX;
+
+	void indexResPath(RES_INDEX& index, const std::string& respath, const std::string& relpath, int depth);
+	bool findResIndex(const char* res, std::string& path);
+	void addResIndex(const char* res, const std::string& path);
+
 	KBEEnv kb_env_;
 	std::vector<std::string> respaths_;
 	bool isInit_;
 
 	KBEUnordered_map< std::string, ResourceObjectPtr > respool_;
 
+	// ԴkeyΪ淶·
+	// ڶ߳вңдʱ: ʱstd::atomic_loadȡõǰ
+	// ޸ʱresIndexMutex_¸һ޸ĺ滻mutex_ڳmutex_ʱ
+	std::shared_ptr<const RES_INDEX> pResIndex_;
+	KBEngine::thread::ThreadMutex resIndexMutex_;
+	std::atomic<uint32> resIndexHits_;
+	std::atomic<uint32> resIndexMisses_;
+
 	KBEngine::thread::ThreadMutex mutex_;
 };
 
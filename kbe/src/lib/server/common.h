@@ -232,6 +232,23 @@ std::string datatype2nativetype(uint16 datatype);
 int getMacMD5();
 int getMD5(std::string data);
 
+/**
+	executeRawDatabaseCommandStreamֶֿε
+	ʽ: uint8 flags, [flags & RAW_DB_STREAM_HEADER: uint32 nfields, nfields * (string name, uint8 type)],
+	uint32 nrows, nrows * (nullλͼ, NULLֵֶ), [flags & RAW_DB_STREAM_FINISHED: uint64 affectedRows, uint64 lastInsertID]
+*/
+enum RAW_DB_FIELD_TYPE
+{
+	RAW_DB_FIELD_TYPE_BLOB = 0,			// blob
+	RAW_DB_FIELD_TYPE_INT = 1,			// int64
+	RAW_DB_FIELD_TYPE_UINT = 2,			// uint64
+	RAW_DB_FIELD_TYPE_DOUBLE = 3,		// double
+	RAW_DB_FIELD_TYPE_STRING = 4,		// blob, utf-8ı
+};
+
+#define RAW_DB_STREAM_HEADER						0x01
+#define RAW_DB_STREAM_FINISHED						0x02
+
 }
 
 #endif // KBE_SERVER_COMMON_H
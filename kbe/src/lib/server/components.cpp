@@ -28,6 +28,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/udp_packet.h"
 #include "network/tcp_packet.h"
 #include "network/bundle_broadcast.h"
+#include "network/endpoint.h"
 #include "network/network_interface.h"
 #include "client_lib/client_interface.h"
 #include "server/serverconfig.h"
@@ -78,7 +79,11 @@ findIdx_(0),
 extraData1_(0),
 extraData2_(0),
 extraData3_(0),
-extraData4_(0)
+extraData4_(0),
+pSubscribeEndpoint_(NULL),
+lastSubscribeTime_(0),
+startupTime_(timestamp()),
+startupTimeline_()
 {
 }
 
@@ -96,6 +101,9 @@ void Components::initialize(Network::NetworkInterface * pNetworkInterface, COMPO
 	componentType_ = componentType;
 	componentID_ = componentID;
 
+	startupTime_ = timestamp();
+	startupTimeline_.clear();
+
 	for(uint8 i=0; i<8; ++i)
 		findComponentTypes_[i] = UNKNOWN_COMPONENT_TYPE;
 
@@ -143,6 +151,7 @@ void Components::initialize(Network::NetworkInterface * pNetworkInterface, COMPO
 //-------------------------------------------------------------------------------------
 void Components::finalise()
 {
+	closeSubscription();
 	clear(0, false);
 }
 
@@ -1221,6 +1230,28 @@ bool Components::findComponents()
 			COMPONENT_TYPE findComponentType = (COMPONENT_TYPE)findComponentTypes_[findIdx_];
 			static int count = 0;
 
+			// machineѾ͹, ٹ㲥ѯȴʱ
+			if(pSubscribeEndpoint_ && getComponents(findComponentType).size() > 0)
+			{
+				addStartupPhase(fmt::format("find {}(push)", COMPONENT_NAME_EX(findComponentType)));
+				count = 0;
+
+				if(findComponentType == LOGGER_TYPE)
+				{
+					findComponentTypes_[findIdx_] = -1;
+					if(connectComponent(findComponentType, getUserUID(), 0) != 0)
+					{
+						ERROR_MSG(fmt::format("Components::findComponents: register self to {} error!\n",
+							COMPONENT_NAME_EX(findComponentType)));
+						findIdx_++;
+						return false;
+					}
+				}
+
+				findIdx_++;
+				continue;
+			}
+
 			if(count <= 15)
 			{
 				INFO_MSG(fmt::format("Components::findComponents: find {}({})...\n",
@@ -1335,6 +1366,7 @@ RESTART_RECV:
 					//  loggerȥ Ծͬ־
 					if(findComponentType == (int8)LOGGER_TYPE)
 					{
+						addStartupPhase(fmt::format("find {}", COMPONENT_NAME_EX(findComponentType)));
 						findComponentTypes_[findIdx_] = -1;
 						if(connectComponent(static_cast<COMPONENT_TYPE>(findComponentType), getUserUID(), 0) != 0)
 						{
@@ -1358,6 +1390,7 @@ RESTART_RECV:
 			{
 				if(Components::getSingleton().getComponents((COMPONENT_TYPE)findComponentType).size() > 0)
 				{
+					addStartupPhase(fmt::format("find {}", COMPONENT_NAME_EX(findComponentType)));
 					findIdx_++;
 					count = 0;
 				}
@@ -1383,6 +1416,8 @@ RESTART_RECV:
 							WARNING_MSG(fmt::format("Components::findComponents: not found {}!\n",
 								COMPONENT_NAME_EX((COMPONENT_TYPE)findComponentType)));
 
+							addStartupPhase(fmt::format("skip {}", COMPONENT_NAME_EX(findComponentType)));
+
 							findComponentTypes_[findIdx_] = -1; // ־
 							count = 0;
 							findIdx_++;
@@ -1439,6 +1474,25 @@ RESTART_RECV:
 void Components::onFoundAllComponents()
 {
 	INFO_MSG("Components::process(): Found all the components!\n");
+
+	closeSubscription();
+	addStartupPhase("register");
+
+	std::string timeline;
+	uint64 lastPhaseTime = startupTime_;
+	std::vector< std::pair<std::string, uint64> >::iterator iter = startupTimeline_.begin();
+
+	for(; iter != startupTimeline_.end(); ++iter)
+	{
+		if(timeline.size() > 0)
+			timeline += ", ";
+
+		timeline += fmt::format("{}={}ms", iter->first, (iter->second - lastPhaseTime) * 1000 / stampsPerSecond());
+		lastPhaseTime = iter->second;
+	}
+
+	INFO_MSG(fmt::format("Components::onFoundAllComponents: startup timeline(total {}ms): {}\n",
+		(lastPhaseTime - startupTime_) * 1000 / stampsPerSecond(), timeline));
 	if (_pHandler)
 		_pHandler->onAllComponentFound();
 
@@ -1613,14 +1667,25 @@ bool Components::process()
 		}
 
 		state_ = 1;
+		addStartupPhase("identity");
 
+		// ʧҲûϵ, Ȼʹù㲥ѯ
+		subscribeComponents();
 		return true;
 	}
 	else
 	{
 		static uint64 lastTime = timestamp();
+
+		// յmachine͵, صȴһֲѯ
+		bool hasPushed = false;
+		if(state_ == 1)
+		{
+			subscribeComponents();
+			hasPushed = recvPushedComponents();
+		}
 			
-		if(timestamp() - lastTime > uint64(stampsPerSecond()))
+		if(hasPushed || timestamp() - lastTime > uint64(stampsPerSecond()))
 		{
 			if(!findComponents())
 			{
@@ -1638,6 +1703,173 @@ bool Components::process()
 	return false;
 }
 
+//-------------------------------------------------------------------------------------
+bool Components::subscribeComponents()
+{
+	if(pSubscribeEndpoint_ && timestamp() - lastSubscribeTime_ < uint64(COMPONENT_SUBSCRIBE_TTL / 3) * stampsPerSecond())
+		return true;
+
+	if(pSubscribeEndpoint_ == NULL)
+	{
+		pSubscribeEndpoint_ = new Network::EndPoint();
+		pSubscribeEndpoint_->socket(SOCK_DGRAM);
+
+		if (!pSubscribeEndpoint_->good() || 
+			pSubscribeEndpoint_->bind(0, pNetworkInterface()->intTcpAddr().ip) != 0)
+		{
+			WARNING_MSG(fmt::format("Components::subscribeComponents: Cannot create subscription socket, {}\n",
+				kbe_strerror()));
+
+			closeSubscription();
+			return false;
+		}
+
+		pSubscribeEndpoint_->setnonblocking(true);
+	}
+
+	u_int16_t recvPort = 0;
+	u_int32_t recvAddr = 0;
+
+	if(pSubscribeEndpoint_->getlocaladdress(&recvPort, &recvAddr) != 0)
+	{
+		closeSubscription();
+		return false;
+	}
+
+	srand(KBEngine::getSystemTime());
+	uint16 nport = KBE_PORT_START + (rand() % 1000);
+
+	Network::BundleBroadcast bhandler(*pNetworkInterface(), nport);
+	if(!bhandler.good())
+		return false;
+
+	bhandler.newMessage(MachineInterface::subscribeComponents);
+	MachineInterface::subscribeComponentsArgs6::staticAddToBundle(bhandler, getUserUID(), getUsername(), 
+		componentType_, componentID_, pNetworkInterface()->intTcpAddr().ip, recvPort);
+
+	ENGINE_COMPONENT_INFO cinfos = ServerConfig::getSingleton().getKBMachine();
+	std::vector< std::string >::iterator machine_addresses_iter = cinfos.machine_addresses.begin();
+	for(; machine_addresses_iter != cinfos.machine_addresses.end(); ++machine_addresses_iter)
+		bhandler.addBroadCastAddress((*machine_addresses_iter));
+
+	if(!bhandler.broadcast())
+	{
+		ERROR_MSG("Components::subscribeComponents: broadcast error!\n");
+		return false;
+	}
+
+	bhandler.close();
+	lastSubscribeTime_ = timestamp();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Components::closeSubscription()
+{
+	if(pSubscribeEndpoint_ == NULL)
+		return;
+
+	// machine˵ĶĻЧںԶʧЧ
+	pSubscribeEndpoint_->close();
+	SAFE_RELEASE(pSubscribeEndpoint_);
+}
+
+//-------------------------------------------------------------------------------------
+bool Components::isFindComponentType(COMPONENT_TYPE componentType) const
+{
+	for(uint8 i=0; i<8 && findComponentTypes_[i] != UNKNOWN_COMPONENT_TYPE; ++i)
+	{
+		if(findComponentTypes_[i] == (int8)componentType)
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool Components::recvPushedComponents()
+{
+	if(pSubscribeEndpoint_ == NULL)
+		return false;
+
+	bool changed = false;
+	char buffer[PACKET_MAX_SIZE_UDP];
+
+	while(true)
+	{
+		sockaddr_in sin;
+		int len = pSubscribeEndpoint_->recvfrom(buffer, PACKET_MAX_SIZE_UDP, sin);
+		if(len <= 0)
+			break;
+
+		MemoryStream s;
+		s.append(buffer, len);
+
+		while(s.length() > 0)
+		{
+			MachineInterface::onBroadcastInterfaceArgs25 args;
+
+			try
+			{
+				args.createFromStream(s);
+			}
+			catch(MemoryStreamException &)
+			{
+				break;
+			}
+
+			COMPONENT_TYPE componentType = (COMPONENT_TYPE)args.componentType;
+
+			if(args.componentIDEx != componentID_ || args.uid != getUserUID() || 
+				!isFindComponentType(componentType))
+				continue;
+
+			ComponentInfos* cinfos = findComponent(componentType, args.uid, args.componentID);
+
+			if(args.state == COMPONENT_STATE_STOP)
+			{
+				// ѾϵͨϿ
+				if(cinfos && cinfos->pChannel == NULL)
+				{
+					INFO_MSG(fmt::format("Components::recvPushedComponents: {}({}) down.\n",
+						COMPONENT_NAME_EX(componentType), args.componentID));
+
+					delComponent(args.uid, componentType, args.componentID);
+					changed = true;
+				}
+
+				continue;
+			}
+
+			if(cinfos)
+				continue;
+
+			INFO_MSG(fmt::format("Components::recvPushedComponents: found {}, addr:{}:{}\n",
+				COMPONENT_NAME_EX(componentType),
+				inet_ntoa((struct in_addr&)args.intaddr),
+				ntohs(args.intport)));
+
+			if (checkComponents(args.uid, args.componentID, args.pid))
+			{
+				addComponent(args.uid, args.username.c_str(),
+					componentType, args.componentID, args.globalorderid, args.grouporderid, args.gus,
+					args.intaddr, args.intport, args.extaddr, args.extport, args.extaddrEx, args.pid, args.cpu, args.mem,
+					args.usedmem, args.extradata, args.extradata1, args.extradata2, args.extradata3);
+
+				changed = true;
+			}
+		}
+	}
+
+	return changed;
+}
+
+//-------------------------------------------------------------------------------------
+void Components::addStartupPhase(const std::string& phase)
+{
+	startupTimeline_.push_back(std::make_pair(phase, timestamp()));
+}
+
 //-------------------------------------------------------------------------------------		
 	
 }
@@ -36,12 +36,16 @@ namespace Network
 class Channel;
 class Address;
 class NetworkInterface;
+class EndPoint;
 }
 
 // ComponentInfos.flags־
 #define COMPONENT_FLAG_NORMAL 0x00000000
 #define COMPONENT_FLAG_SHUTTINGDOWN 0x00000001
 
+// machine¼Ч(), Ҫڵǰ
+#define COMPONENT_SUBSCRIBE_TTL 30
+
 class Components : public Task, public Singleton<Components>
 {
 public:
@@ -228,6 +232,24 @@ private:
 
 	void onFoundAllComponents();
 
+	/**
+		machine¼, machineͶȴÿһֹ㲥ѯĳʱ
+	*/
+	bool subscribeComponents();
+	void closeSubscription();
+
+	/**
+		machine͹¼, б仯true
+	*/
+	bool recvPushedComponents();
+
+	bool isFindComponentType(COMPONENT_TYPE componentType) const;
+
+	/**
+		¼ĳ׶ɵʱ
+	*/
+	void addStartupPhase(const std::string& phase);
+
 private:
 	COMPONENTS								_baseapps;
 	COMPONENTS								_cellapps;
@@ -266,6 +288,14 @@ private:
 	uint64									extraData2_;
 	uint64									extraData3_;
 	uint64									extraData4_;
+
+	// machine͵¼
+	Network::EndPoint*						pSubscribeEndpoint_;
+	uint64									lastSubscribeTime_;
+
+	// ʱ, ¼ÿֽ׶ɵʱ
+	uint64									startupTime_;
+	std::vector< std::pair<std::string, uint64> >	startupTimeline_;
 };
 
 }
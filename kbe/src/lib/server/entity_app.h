@@ -41,6 +41,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "server/globaldata_client.h"
 #include "server/globaldata_server.h"
 #include "server/callbackmgr.h"	
+#include "server/raw_db_streams.h"
 #include "entitydef/entitydef.h"
 #include "entitydef/entities.h"
 #include "entitydef/entity_call.h"
@@ -128,6 +129,7 @@ public:
 	ArraySize entitiesSize() const { return (ArraySize)pEntities_->size(); }
 
 	PY_CALLBACKMGR& callbackMgr(){ return pyCallbackMgr_; }	
+	RawDBStreams& rawDBStreams(){ return rawDBStreams_; }
 
 	EntityIDClient& idClient(){ return idClient_; }
 
@@ -165,6 +167,22 @@ public:
 	*/
 	void onBroadcastCenterDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** ӿ
+		dbmgrÿtickϲ㲥globalbaseAppDatacellAppDatacenterDataݸı
+	*/
+	void onBroadcastGlobalDataBatch(Network::Channel* pChannel, KBEngine::MemoryStream& s);
+
+	/** 
+		ȡĳȫݶűصƣṩbaseAppDatacellAppData
+	*/
+	virtual GlobalDataClient* findGlobalData(uint8 dataType, const char*& setCallback, const char*& delCallback);
+
+	/** 
+		Ӧһȫݸı(ֵɾ)֪ͨű
+	*/
+	void onGlobalDataEntryChanged(GlobalDataClient* pData, const char* setCallback, const char* delCallback, 
+		uint8 op, const std::string& key, const std::string& value);
+
 	/** ӿ
 		ִһpythonָ
 	*/
@@ -258,6 +276,9 @@ protected:
 
 	PY_CALLBACKMGR											pyCallbackMgr_;
 
+	// executeRawDatabaseCommandStreamδ
+	RawDBStreams											rawDBStreams_;
+
 	uint64													lastTimestamp_;
 
 	// ̵ǰ
@@ -280,6 +301,7 @@ gameTimer_(),
 pGlobalData_(NULL),
 pCenterData_(NULL),
 pyCallbackMgr_(),
+rawDBStreams_(),
 lastTimestamp_(timestamp()),
 load_(0.f)
 {
@@ -320,6 +342,12 @@ bool EntityApp<E>::initialize()
 	{
 		gameTimer_ = this->dispatcher().addTimer(1000000 / g_kbeSrvConfig.gameUpdateHertz(), this,
 								reinterpret_cast<void *>(TIMEOUT_GAME_TICK));
+
+		if(g_kbeSrvConfig.scriptGCTickSchedule())
+		{
+			script::PyGC::enableTickSchedule(g_kbeSrvConfig.scriptGCTickBudget(), 
+				g_kbeSrvConfig.scriptGCFullCollectInterval());
+		}
 	}
 
 	lastTimestamp_ = timestamp();
@@ -330,7 +358,7 @@ template<class E>
 bool EntityApp<E>::initializeWatcher()
 {
 	WATCH_OBJECT("entitiesSize", this, &EntityApp<E>::entitiesSize);
-	return ServerApp::initializeWatcher();
+	return ServerApp::initializeWatcher() && script::PyGC::initializeWatcher();
 }
 
 template<class E>
@@ -341,6 +369,7 @@ void EntityApp<E>::finalise(void)
 	WATCH_FINALIZE;
 	
 	pyCallbackMgr_.finalise();
+	rawDBStreams_.clear();
 	ScriptTimers::finalise(*this);
 
 	if(pEntities_)
@@ -355,6 +384,7 @@ template<class E>
 bool EntityApp<E>::installEntityDef()
 {
 	EntityDef::entityAliasID(ServerConfig::getSingleton().getCellApp().aliasEntityID);
+	EntityDef::entityAliasIDSlots(ServerConfig::getSingleton().getCellApp().aliasEntityIDSlots);
 	EntityDef::entitydefAliasID(ServerConfig::getSingleton().getCellApp().entitydefAliasID);
 	
 	if(!EntityDef::installScript(this->getScript().getModule()))
@@ -716,6 +746,9 @@ void EntityApp<E>::handleTimeout(TimerHandle handle, void * arg)
 	{
 		case TIMEOUT_GAME_TICK:
 			this->handleGameTick();
+
+			// tick߼ȫɺٽգ մtick
+			script::PyGC::onTick();
 			break;
 		default:
 			break;
@@ -1311,6 +1344,12 @@ void EntityApp<E>::onBroadcastGlobalDataChanged(Network::Channel* pChannel, KBEn
 		return;
 	}
 
+	if(!pGlobalData_->isSubscribedKey(pyKey))
+	{
+		Py_DECREF(pyKey);
+		return;
+	}
+
 	if(isDelete)
 	{
 		if(pGlobalData_->del(pyKey))
@@ -1403,6 +1442,121 @@ void EntityApp<E>::onBroadcastCenterDataChanged(Network::Channel* pChannel, KBEn
 	Py_DECREF(pyKey);
 }
 
+template<class E>
+GlobalDataClient* EntityApp<E>::findGlobalData(uint8 dataType, const char*& setCallback, const char*& delCallback)
+{
+	switch(dataType)
+	{
+	case GlobalDataServer::GLOBAL_DATA:
+		setCallback = "onGlobalData";
+		delCallback = "onGlobalDataDel";
+		return pGlobalData_;
+	case GlobalDataServer::CENTER_DATA:
+		setCallback = "onCenterData";
+		delCallback = "onCenterDataDel";
+		return pCenterData_;
+	default:
+		break;
+	};
+
+	return NULL;
+}
+
+template<class E>
+void EntityApp<E>::onBroadcastGlobalDataBatch(Network::Channel* pChannel, KBEngine::MemoryStream& s)
+{
+	if(pChannel->isExternal())
+		return;
+
+	uint8 dataType;
+	s >> dataType;
+
+	const char* setCallback = NULL;
+	const char* delCallback = NULL;
+
+	GlobalDataClient* pData = findGlobalData(dataType, setCallback, delCallback);
+	if(pData == NULL)
+	{
+		ERROR_MSG(fmt::format("EntityApp::onBroadcastGlobalDataBatch: not found dataType({})!\n", dataType));
+		s.done();
+		return;
+	}
+
+	std::string key, value;
+
+	while(s.length() > 0)
+	{
+		uint8 op;
+		s >> op;
+		s.readBlob(key);
+
+		if(op != GlobalDataServer::DATA_OP_DEL)
+			s.readBlob(value);
+		else
+			value.clear();
+
+		onGlobalDataEntryChanged(pData, setCallback, delCallback, op, key, value);
+	}
+}
+
+template<class E>
+void EntityApp<E>::onGlobalDataEntryChanged(GlobalDataClient* pData, const char* setCallback, const char* delCallback, 
+	uint8 op, const std::string& key, const std::string& value)
+{
+	PyObject * pyKey = script::Pickler::unpickle(key);
+	if(pyKey == NULL)
+	{
+		ERROR_MSG("EntityApp::onGlobalDataEntryChanged: no has key!\n");
+		return;
+	}
+
+	// 󵽴dbmgr֮ǰĸıܰٹĵkey
+	if(!pData->isSubscribedKey(pyKey))
+	{
+		Py_DECREF(pyKey);
+		return;
+	}
+
+	if(op == GlobalDataServer::DATA_OP_DEL)
+	{
+		if(pData->del(pyKey))
+		{
+			// ֪ͨű
+			SCRIPT_OBJECT_CALL_ARGS1(getEntryScript().get(), const_cast<char*>(delCallback), 
+				const_cast<char*>("O"), pyKey, false);
+		}
+
+		Py_DECREF(pyKey);
+		return;
+	}
+
+	PyObject * pyValue = script::Pickler::unpickle(value);
+
+	if(pyValue && op != GlobalDataServer::DATA_OP_SET)
+	{
+		PyObject* pyNewValue = pData->applyDelta(pyKey, op, pyValue);
+		Py_DECREF(pyValue);
+		pyValue = pyNewValue;
+	}
+
+	if(pyValue == NULL)
+	{
+		ERROR_MSG(fmt::format("EntityApp::onGlobalDataEntryChanged: no has value! op={}\n", op));
+		Py_DECREF(pyKey);
+		return;
+	}
+
+	if(pData->write(pyKey, pyValue))
+	{
+		// ֪ͨű
+		SCRIPT_OBJECT_CALL_ARGS2(getEntryScript().get(), const_cast<char*>(setCallback), 
+			const_cast<char*>("OO"), pyKey, pyValue, false);
+	}
+
+	Py_DECREF(pyValue);
+	Py_DECREF(pyKey);
+}
+
 template<class E>
 void EntityApp<E>::onExecScriptCommand(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -30,6 +30,8 @@ namespace KBEngine{
 
 
 SCRIPT_METHOD_DECLARE_BEGIN(GlobalDataClient)
+SCRIPT_METHOD_DECLARE("subscribe",			subscribe,			METH_VARARGS,		0)
+SCRIPT_METHOD_DECLARE("unsubscribe",		unsubscribe,		METH_VARARGS,		0)
 SCRIPT_METHOD_DECLARE_END()
 
 
@@ -157,5 +159,182 @@ void GlobalDataClient::onDataChanged(PyObject* key, PyObject* value, bool isDele
 	}
 }
 
+//-------------------------------------------------------------------------------------
+PyObject* GlobalDataClient::applyDelta(PyObject* pyKey, uint8 op, PyObject* pyDelta)
+{
+	PyObject* pyOld = PyDict_GetItem(pyDict_, pyKey);
+	PyObject* pyArg1 = NULL;
+	PyObject* pyArg2 = NULL;
+
+	if(!pyOld || !PyTuple_Check(pyDelta) || PyTuple_GET_SIZE(pyDelta) != 2)
+		return NULL;
+
+	pyArg1 = PyTuple_GET_ITEM(pyDelta, 0);
+	pyArg2 = PyTuple_GET_ITEM(pyDelta, 1);
+
+	if(op == GlobalDataServer::DATA_OP_DICT_DELTA)
+	{
+		if(!PyDict_Check(pyOld) || !PyDict_Check(pyArg1) || !PyList_Check(pyArg2))
+			return NULL;
+
+		// ޸ľֵűпܻ
+		PyObject* pyNew = PyDict_Copy(pyOld);
+		if(!pyNew || PyDict_Update(pyNew, pyArg1) == -1)
+		{
+			Py_XDECREF(pyNew);
+			PyErr_Clear();
+			return NULL;
+		}
+
+		for(Py_ssize_t i = 0; i < PyList_GET_SIZE(pyArg2); ++i)
+		{
+			if(PyDict_DelItem(pyNew, PyList_GET_ITEM(pyArg2, i)) == -1)
+				PyErr_Clear();
+		}
+
+		return pyNew;
+	}
+	else if(op == GlobalDataServer::DATA_OP_LIST_DELTA)
+	{
+		if(!PyList_Check(pyOld) || !PyLong_Check(pyArg1) || !PyList_Check(pyArg2))
+			return NULL;
+
+		Py_ssize_t start = PyLong_AsSsize_t(pyArg1);
+		if(start < 0 || start > PyList_GET_SIZE(pyOld))
+		{
+			PyErr_Clear();
+			return NULL;
+		}
+
+		PyObject* pyNew = PyList_GetSlice(pyOld, 0, start);
+		if(!pyNew || PyList_SetSlice(pyNew, start, start, pyArg2) == -1)
+		{
+			Py_XDECREF(pyNew);
+			PyErr_Clear();
+			return NULL;
+		}
+
+		return pyNew;
+	}
+
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------
+bool GlobalDataClient::isSubscribedKey(PyObject* pyKey)
+{
+	if(prefixes_.size() == 0)
+		return true;
+
+	if(!PyUnicode_Check(pyKey))
+		return false;
+
+	Py_ssize_t size = 0;
+	const char* str = PyUnicode_AsUTF8AndSize(pyKey, &size);
+	if(!str)
+	{
+		PyErr_Clear();
+		return false;
+	}
+
+	std::vector<std::string>::iterator iter = prefixes_.begin();
+	for(; iter != prefixes_.end(); ++iter)
+	{
+		if((size_t)size >= (*iter).size() && memcmp(str, (*iter).data(), (*iter).size()) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+void GlobalDataClient::removeUnsubscribedKeys()
+{
+	PyObject* pyKeys = PyDict_Keys(pyDict_);
+	if(!pyKeys)
+	{
+		PyErr_Clear();
+		return;
+	}
+
+	for(Py_ssize_t i = 0; i < PyList_GET_SIZE(pyKeys); ++i)
+	{
+		PyObject* pyKey = PyList_GET_ITEM(pyKeys, i);
+		if(!isSubscribedKey(pyKey) && PyDict_DelItem(pyDict_, pyKey) == -1)
+			PyErr_Clear();
+	}
+
+	Py_DECREF(pyKeys);
+}
+
+//-------------------------------------------------------------------------------------
+void GlobalDataClient::sendSubscribe(const std::string& prefix, bool isSubscribe)
+{
+	Components::COMPONENTS& channels = Components::getSingleton().getComponents(serverComponentType_);
+	Components::COMPONENTS::iterator iter = channels.begin();
+	uint8 dataType = dataType_;
+
+	for(; iter != channels.end(); ++iter)
+	{
+		Network::Channel* lpChannel = iter->pChannel;
+		KBE_ASSERT(lpChannel != NULL);
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(DbmgrInterface::onGlobalDataSubscribe);
+		(*pBundle) << dataType;
+		(*pBundle) << isSubscribe;
+		(*pBundle) << prefix;
+		(*pBundle) << g_componentID;
+		lpChannel->send(pBundle);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* GlobalDataClient::__py_subscribe(PyObject* self, PyObject* args)
+{
+	char* prefix = NULL;
+	if(!PyArg_ParseTuple(args, "s", &prefix))
+		return NULL;
+
+	GlobalDataClient* pGlobalDataClient = static_cast<GlobalDataClient*>(self);
+	std::vector<std::string>& prefixes = pGlobalDataClient->prefixes_;
+
+	if(std::find(prefixes.begin(), prefixes.end(), prefix) != prefixes.end())
+		S_Return;
+
+	prefixes.push_back(prefix);
+
+	// һζʱƳزͬkeydbmgrᲹǰ׺µ
+	if(prefixes.size() == 1)
+		pGlobalDataClient->removeUnsubscribedKeys();
+
+	pGlobalDataClient->sendSubscribe(prefix, true);
+	S_Return;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* GlobalDataClient::__py_unsubscribe(PyObject* self, PyObject* args)
+{
+	char* prefix = NULL;
+	if(!PyArg_ParseTuple(args, "s", &prefix))
+		return NULL;
+
+	GlobalDataClient* pGlobalDataClient = static_cast<GlobalDataClient*>(self);
+	std::vector<std::string>& prefixes = pGlobalDataClient->prefixes_;
+
+	std::vector<std::string>::iterator iter = std::find(prefixes.begin(), prefixes.end(), prefix);
+	if(iter == prefixes.end())
+		S_Return;
+
+	prefixes.erase(iter);
+
+	// ûκζĺdbmgrᲹȫ
+	if(prefixes.size() > 0)
+		pGlobalDataClient->removeUnsubscribedKeys();
+
+	pGlobalDataClient->sendSubscribe(prefix, false);
+	S_Return;
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -44,6 +44,18 @@ public:
 	
 	/** ݸı֪ͨ */
 	void onDataChanged(PyObject* key, PyObject* value, bool isDelete = false);
+
+	/** dbmgr·(GlobalDataServer::DATA_OP_*_DELTA)Ӧõǰֵϣֵ()ʧܷNULL */
+	PyObject* applyDelta(PyObject* pyKey, uint8 op, PyObject* pyDelta);
+
+	/** keyǷڱضĵǰ׺ڣ֮ǰ;еĸıҪ */
+	bool isSubscribedKey(PyObject* pyKey);
+
+	/** 
+		űĻȡkeyǰ׺ֻ֮յƥַkeyĸı䣬زƥkeyᱻƳ
+	*/
+	static PyObject* __py_subscribe(PyObject* self, PyObject* args);
+	static PyObject* __py_unsubscribe(PyObject* self, PyObject* args);
 	
 	/** øȫݿͻ˵ķ */
 	void setServerComponentType(COMPONENT_TYPE ct){ serverComponentType_ = ct; }
@@ -51,6 +63,11 @@ public:
 private:
 	COMPONENT_TYPE					serverComponentType_;				// GlobalDataServerڷ
 	GlobalDataServer::DATA_TYPE 	dataType_;
+
+	std::vector<std::string>		prefixes_;							// Ѷĵkeyǰ׺Ϊиı
+
+	void removeUnsubscribedKeys();
+	void sendSubscribe(const std::string& prefix, bool isSubscribe);
 } ;
 
 }
@@ -19,12 +19,23 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "globaldata_server.h"
 #include "components.h"
+#include "serverconfig.h"
 #include "network/channel.h"
+#include "network/bundle.h"
+#include "pyscript/pickler.h"
 
 #include "../../server/cellapp/cellapp_interface.h"
 #include "../../server/baseapp/baseapp_interface.h"
 
 namespace KBEngine{ 
+
+uint64 GlobalDataServer::numWrites = 0;
+uint64 GlobalDataServer::numMergedWrites = 0;
+uint64 GlobalDataServer::numSentBatches = 0;
+uint64 GlobalDataServer::numSentEntries = 0;
+uint64 GlobalDataServer::numSentBytes = 0;
+uint64 GlobalDataServer::numSentDeltas = 0;
+uint64 GlobalDataServer::numDeltaSavedBytes = 0;
 		
 //-------------------------------------------------------------------------------------
 GlobalDataServer::GlobalDataServer(DATA_TYPE dataType):
@@ -46,7 +57,7 @@ bool GlobalDataServer::write(Network::Channel* pChannel, COMPONENT_TYPE componen
 
 	DATA_MAP_KEY iter = dict_.find(key);
 	if(iter != dict_.end()){
-		iter->second = value.c_str();
+		iter->second = value;
 		return true;
 	}
 	
@@ -57,12 +68,16 @@ bool GlobalDataServer::write(Network::Channel* pChannel, COMPONENT_TYPE componen
 //-------------------------------------------------------------------------------------
 bool GlobalDataServer::del(Network::Channel* pChannel, COMPONENT_TYPE componentType, const std::string& key)
 {
-	if(!dict_.erase(key)){
+	DATA_MAP_KEY iter = dict_.find(key);
+	if(iter == dict_.end()){
 		ERROR_MSG(fmt::format("GlobalDataServer::del: not found the key:[{}]\n", key.c_str()));
 		return false;
 	}
 
+	// Ҫɾ֮ǰ¼еֵ
 	broadcastDataChanged(pChannel, componentType, key, "", true);
+
+	dict_.erase(iter);
 	return true;	
 }
 
@@ -70,8 +85,291 @@ bool GlobalDataServer::del(Network::Channel* pChannel, COMPONENT_TYPE componentT
 void GlobalDataServer::broadcastDataChanged(Network::Channel* pChannel, COMPONENT_TYPE componentType, 
 										const std::string& key, const std::string& value, bool isDelete)
 {
-	INFO_MSG(fmt::format("GlobalDataServer::broadcastDataChanged: writer({0}, addr={4}), keySize={1}, valSize={2}, isDelete={3}\n",
-		COMPONENT_NAME_EX(componentType), key.size(), value.size(), (int)isDelete, pChannel->c_str()));
+	// 㲥ȼ¼flushChangesкϲͬһkeyڱtickڵĶθı
+	++numWrites;
+
+	std::map<std::string, PendingChange>::iterator iter = pendingChanges_.find(key);
+	if(iter == pendingChanges_.end())
+	{
+		PendingChange& change = pendingChanges_[key];
+		change.isDelete = isDelete;
+		change.writers.push_back(pChannel);
+
+		DATA_MAP_KEY diter = dict_.find(key);
+		change.hasBase = diter != dict_.end();
+		if(change.hasBase)
+			change.base = diter->second;
+
+		pendingKeys_.push_back(key);
+		return;
+	}
+
+	++numMergedWrites;
+
+	PendingChange& change = iter->second;
+	change.isDelete = isDelete;
+
+	if(std::find(change.writers.begin(), change.writers.end(), pChannel) == change.writers.end())
+		change.writers.push_back(pChannel);
+}
+
+//-------------------------------------------------------------------------------------
+Network::Bundle* GlobalDataServer::newBatchBundle(COMPONENT_TYPE componentType)
+{
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+	if(componentType == CELLAPP_TYPE)
+	{
+		(*pBundle).newMessage(CellappInterface::onBroadcastGlobalDataBatch);
+	}
+	else if(componentType == BASEAPP_TYPE)
+	{
+		(*pBundle).newMessage(BaseappInterface::onBroadcastGlobalDataBatch);
+	}
+	else
+	{
+		KBE_ASSERT(false && "componentType error!\n");
+	}
+
+	uint8 dataType = dataType_;
+	(*pBundle) << dataType;
+	return pBundle;
+}
+
+//-------------------------------------------------------------------------------------
+void GlobalDataServer::addBatchEntry(Network::Bundle* pBundle, uint8 op, 
+	const std::string& key, const std::string& value)
+{
+	(*pBundle) << op;
+
+	ArraySize slen = key.size();
+	(*pBundle) << slen;
+	(*pBundle).assign(key.data(), slen);
+
+	if(op != DATA_OP_DEL)
+	{
+		slen = value.size();
+		(*pBundle) << slen;
+		(*pBundle).assign(value.data(), slen);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+const std::string& GlobalDataServer::keyName(const std::string& key)
+{
+	DATA_MAP_KEY iter = keyNames_.find(key);
+	if(iter != keyNames_.end())
+		return iter->second;
+
+	std::string& name = keyNames_[key];
+
+	PyObject* pyKey = script::Pickler::unpickle(key);
+	if(pyKey)
+	{
+		if(PyUnicode_Check(pyKey))
+		{
+			Py_ssize_t size = 0;
+			const char* str = PyUnicode_AsUTF8AndSize(pyKey, &size);
+			if(str)
+				name.assign(str, size);
+			else
+				PyErr_Clear();
+		}
+
+		Py_DECREF(pyKey);
+	}
+	else
+	{
+		PyErr_Clear();
+	}
+
+	return name;
+}
+
+//-------------------------------------------------------------------------------------
+bool GlobalDataServer::isSubscribed(COMPONENT_ID componentID, const std::string& key)
+{
+	SUBSCRIPTIONS::iterator iter = subscriptions_.find(componentID);
+	if(iter == subscriptions_.end())
+		return true;
+
+	const std::string& name = keyName(key);
+
+	std::vector<std::string>::iterator piter = iter->second.begin();
+	for(; piter != iter->second.end(); ++piter)
+	{
+		if(name.compare(0, (*piter).size(), (*piter)) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+static bool isEqual(PyObject* a, PyObject* b)
+{
+	// 11.0True1pythonȣ͸ıҲҪͬ
+	if(Py_TYPE(a) != Py_TYPE(b))
+		return false;
+
+	if(PyList_CheckExact(a) || PyTuple_CheckExact(a))
+	{
+		Py_ssize_t size = PySequence_Fast_GET_SIZE(a);
+		if(size != PySequence_Fast_GET_SIZE(b))
+			return false;
+
+		for(Py_ssize_t i = 0; i < size; ++i)
+		{
+			if(!isEqual(PySequence_Fast_GET_ITEM(a, i), PySequence_Fast_GET_ITEM(b, i)))
+				return false;
+		}
+
+		return true;
+	}
+
+	if(PyDict_CheckExact(a))
+	{
+		if(PyDict_Size(a) != PyDict_Size(b))
+			return false;
+
+		PyObject *pyKey, *pyVal;
+		Py_ssize_t pos = 0;
+
+		while(PyDict_Next(a, &pos, &pyKey, &pyVal))
+		{
+			PyObject* pyOther = PyDict_GetItem(b, pyKey);
+			if(!pyOther || !isEqual(pyVal, pyOther))
+				return false;
+		}
+
+		return true;
+	}
+
+	int ret = PyObject_RichCompareBool(a, b, Py_EQ);
+	if(ret < 0)
+		PyErr_Clear();
+
+	return ret == 1;
+}
+
+//-------------------------------------------------------------------------------------
+bool GlobalDataServer::makeDelta(const std::string& base, const std::string& value, uint8& op, std::string& delta)
+{
+	PyObject* pyBase = script::Pickler::unpickle(base);
+	if(!pyBase)
+	{
+		PyErr_Clear();
+		return false;
+	}
+
+	PyObject* pyValue = script::Pickler::unpickle(value);
+	if(!pyValue)
+	{
+		PyErr_Clear();
+		Py_DECREF(pyBase);
+		return false;
+	}
+
+	PyObject* pyDelta = NULL;
+
+	if(PyDict_CheckExact(pyBase) && PyDict_CheckExact(pyValue))
+	{
+		PyObject* pyUpdates = PyDict_New();
+		PyObject* pyRemoved = PyList_New(0);
+
+		PyObject *pyKey, *pyVal;
+		Py_ssize_t pos = 0;
+
+		while(PyDict_Next(pyValue, &pos, &pyKey, &pyVal))
+		{
+			PyObject* pyOld = PyDict_GetItem(pyBase, pyKey);
+			if(!pyOld || !isEqual(pyOld, pyVal))
+				PyDict_SetItem(pyUpdates, pyKey, pyVal);
+		}
+
+		pos = 0;
+		while(PyDict_Next(pyBase, &pos, &pyKey, &pyVal))
+		{
+			if(PyDict_Contains(pyValue, pyKey) != 1)
+				PyList_Append(pyRemoved, pyKey);
+		}
+
+		pyDelta = PyTuple_Pack(2, pyUpdates, pyRemoved);
+		Py_DECREF(pyUpdates);
+		Py_DECREF(pyRemoved);
+		op = DATA_OP_DICT_DELTA;
+	}
+	else if(PyList_CheckExact(pyBase) && PyList_CheckExact(pyValue))
+	{
+		Py_ssize_t baseSize = PyList_GET_SIZE(pyBase);
+		Py_ssize_t valueSize = PyList_GET_SIZE(pyValue);
+		Py_ssize_t start = 0;
+
+		// ֻʹӵһͬԪؿʼβշظӦý
+		while(start < baseSize && start < valueSize &&
+			isEqual(PyList_GET_ITEM(pyBase, start), PyList_GET_ITEM(pyValue, start)))
+		{
+			++start;
+		}
+
+		PyObject* pyTail = PyList_GetSlice(pyValue, start, valueSize);
+		pyDelta = Py_BuildValue("(nO)", start, pyTail);
+		Py_DECREF(pyTail);
+		op = DATA_OP_LIST_DELTA;
+	}
+
+	Py_DECREF(pyBase);
+	Py_DECREF(pyValue);
+
+	if(!pyDelta)
+		return false;
+
+	delta = script::Pickler::pickle(pyDelta, 0);
+	Py_DECREF(pyDelta);
+
+	return delta.size() > 0 && delta.size() < value.size();
+}
+
+//-------------------------------------------------------------------------------------
+void GlobalDataServer::flushChanges()
+{
+	if(pendingKeys_.size() == 0)
+		return;
+
+	const ENGINE_COMPONENT_INFO& dbcfg = g_kbeSrvConfig.getDBMgr();
+
+	// ÿkeyĸıֻһΣж߹
+	std::vector<uint8> ops;
+	std::vector<std::string> values;
+	ops.resize(pendingKeys_.size());
+	values.resize(pendingKeys_.size());
+
+	for(size_t i = 0; i < pendingKeys_.size(); ++i)
+	{
+		const std::string& key = pendingKeys_[i];
+		PendingChange& change = pendingChanges_[key];
+
+		if(change.isDelete)
+		{
+			ops[i] = DATA_OP_DEL;
+			continue;
+		}
+
+		const std::string& value = dict_[key];
+		ops[i] = DATA_OP_SET;
+
+		// дʱÿд߳еԼдмֵֻδдkeyĶЧд߻յֵ
+		if(dbcfg.globalDataDeltaMode && change.hasBase && value.size() >= dbcfg.globalDataDeltaMinSize &&
+			makeDelta(change.base, value, ops[i], values[i]))
+		{
+			++numSentDeltas;
+			numDeltaSavedBytes += value.size() - values[i].size();
+			continue;
+		}
+
+		ops[i] = DATA_OP_SET;
+		values[i] = value;
+	}
 
 	std::vector<COMPONENT_TYPE>::iterator iter = concernComponentTypes_.begin();
 	for(; iter != concernComponentTypes_.end(); ++iter)
@@ -85,151 +383,160 @@ void GlobalDataServer::broadcastDataChanged(Network::Channel* pChannel, COMPONEN
 			Network::Channel* lpChannel = iter1->pChannel;
 			KBE_ASSERT(lpChannel != NULL);
 
-			if(pChannel == lpChannel)
-				continue;
-
 			if(dataType_ == BASEAPP_DATA && iter1->componentType != BASEAPP_TYPE)
 				continue;
 				
 			if(dataType_ == CELLAPP_DATA && iter1->componentType != CELLAPP_TYPE)
 				continue;
 
-			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+			Network::Bundle* pBundle = NULL;
+			size_t numEntries = 0;
 
-			switch(dataType_)
+			for(size_t i = 0; i < pendingKeys_.size(); ++i)
 			{
-			case GLOBAL_DATA:
-				if(iter1->componentType == CELLAPP_TYPE)
-				{
-					(*pBundle).newMessage(CellappInterface::onBroadcastGlobalDataChanged);
-				}
-				else if(iter1->componentType == BASEAPP_TYPE)
-				{
-					(*pBundle).newMessage(BaseappInterface::onBroadcastGlobalDataChanged);
-				}
-				else
-				{
-					KBE_ASSERT(false && "componentType error!\n");
-				}
-				break;
-			case BASEAPP_DATA:
-				(*pBundle).newMessage(BaseappInterface::onBroadcastBaseAppDataChanged);
-				break;
-			case CELLAPP_DATA:
-				(*pBundle).newMessage(CellappInterface::onBroadcastCellAppDataChanged);
-				break;
-			case CENTER_DATA:
-				if (iter1->componentType == CELLAPP_TYPE)
-				{
-					(*pBundle).newMessage(CellappInterface::onBroadcastCenterDataChanged);
-				}
-				else if (iter1->componentType == BASEAPP_TYPE)
-				{
-					(*pBundle).newMessage(BaseappInterface::onBroadcastCenterDataChanged);
-				}
+				const std::string& key = pendingKeys_[i];
+				const std::vector<Network::Channel*>& writers = pendingChanges_[key].writers;
+
+				bool isWriter = std::find(writers.begin(), writers.end(), lpChannel) != writers.end();
+
+				// ΨһдѾյֵ
+				if(isWriter && writers.size() == 1)
+					continue;
+
+				if(!isSubscribed(iter1->cid, key))
+					continue;
+
+				if(!pBundle)
+					pBundle = newBatchBundle(iter1->componentType);
+
+				if(isWriter && ops[i] != DATA_OP_SET && ops[i] != DATA_OP_DEL)
+					addBatchEntry(pBundle, DATA_OP_SET, key, dict_[key]);
 				else
-				{
-					KBE_ASSERT(false && "componentType is error!\n");
-				}
-				break;
-			default:
-				KBE_ASSERT(false && "dataType error!\n");
-				break;
-			};
-
-			
-			(*pBundle) << isDelete;
-			ArraySize slen = key.size();
-			(*pBundle) << slen;
-			(*pBundle).assign(key.data(), slen);
-
-			if(!isDelete)
-			{
-				slen = value.size();
-				(*pBundle) << slen;
-				(*pBundle).assign(value.data(), slen);
+					addBatchEntry(pBundle, ops[i], key, values[i]);
+
+				++numEntries;
 			}
 
+			if(!pBundle)
+				continue;
+
+			++numSentBatches;
+			numSentEntries += numEntries;
+			numSentBytes += pBundle->packetsLength();
 			lpChannel->send(pBundle);
 		}
 	}
+
+	// ɾkeyҪ
+	for(size_t i = 0; i < pendingKeys_.size(); ++i)
+	{
+		if(ops[i] == DATA_OP_DEL)
+			keyNames_.erase(pendingKeys_[i]);
+	}
+
+	pendingChanges_.clear();
+	pendingKeys_.clear();
 }
 
 //-------------------------------------------------------------------------------------
 void GlobalDataServer::onGlobalDataClientLogon(Network::Channel* client, COMPONENT_TYPE componentType)
 {
-	bool isDelete = false;
+	if(dataType_ == BASEAPP_DATA && componentType != BASEAPP_TYPE)
+		return;
+
+	if(dataType_ == CELLAPP_DATA && componentType != CELLAPP_TYPE)
+		return;
+
+	// Ƚ۵ĸı䷢ȥ֤¿ͻõȫһ
+	flushChanges();
+
+	if(dict_.size() == 0)
+		return;
+
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(client);
+	COMPONENT_ID componentID = cinfos ? cinfos->cid : 0;
+
+	Network::Bundle* pBundle = newBatchBundle(componentType);
 
 	DATA_MAP_KEY iter = dict_.begin();
 	for(; iter != dict_.end(); ++iter)
 	{
-		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
-		
-		switch(dataType_)
+		if(cinfos && !isSubscribed(componentID, iter->first))
+			continue;
+
+		addBatchEntry(pBundle, DATA_OP_SET, iter->first, iter->second);
+	}
+
+	client->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void GlobalDataServer::onSubscribe(Network::Channel* pChannel, COMPONENT_ID componentID, 
+	const std::string& prefix, bool isSubscribe)
+{
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(pChannel);
+	if(!cinfos || cinfos->cid != componentID)
+	{
+		ERROR_MSG(fmt::format("GlobalDataServer::onSubscribe: not found component({}), addr={}!\n",
+			componentID, pChannel->c_str()));
+
+		return;
+	}
+
+	// ߳еһι㲥Ϊ׼
+	flushChanges();
+
+	Network::Bundle* pBundle = newBatchBundle(cinfos->componentType);
+	size_t numEntries = 0;
+
+	if(isSubscribe)
+	{
+		std::vector<std::string>& prefixes = subscriptions_[componentID];
+		if(std::find(prefixes.begin(), prefixes.end(), prefix) == prefixes.end())
+			prefixes.push_back(prefix);
+
+		// ǰ׺µĵǰ
+		DATA_MAP_KEY iter = dict_.begin();
+		for(; iter != dict_.end(); ++iter)
 		{
-		case GLOBAL_DATA:
-			if(componentType == CELLAPP_TYPE)
-			{
-				(*pBundle).newMessage(CellappInterface::onBroadcastGlobalDataChanged);
-			}
-			else if(componentType == BASEAPP_TYPE)
-			{
-				(*pBundle).newMessage(BaseappInterface::onBroadcastGlobalDataChanged);
-			}
-			else
-			{
-				KBE_ASSERT(false && "componentType error!\n");
-			}
-			break;
-		case BASEAPP_DATA:
-			if(componentType != BASEAPP_TYPE)
-			{
-				Network::Bundle::reclaimPoolObject(pBundle);
+			const std::string& name = keyName(iter->first);
+			if(name.compare(0, prefix.size(), prefix) != 0)
 				continue;
-			}
 
-			(*pBundle).newMessage(BaseappInterface::onBroadcastBaseAppDataChanged);
-			break;
-		case CELLAPP_DATA:
-			if(componentType != CELLAPP_TYPE)
-			{
-				Network::Bundle::reclaimPoolObject(pBundle);
-				continue;
-			}
+			addBatchEntry(pBundle, DATA_OP_SET, iter->first, iter->second);
+			++numEntries;
+		}
+	}
+	else
+	{
+		SUBSCRIPTIONS::iterator iter = subscriptions_.find(componentID);
+		if(iter != subscriptions_.end())
+		{
+			std::vector<std::string>& prefixes = iter->second;
+			prefixes.erase(std::remove(prefixes.begin(), prefixes.end(), prefix), prefixes.end());
 
-			(*pBundle).newMessage(CellappInterface::onBroadcastCellAppDataChanged);
-			break;
-		case CENTER_DATA:
-			if (componentType == CELLAPP_TYPE)
-			{
-				(*pBundle).newMessage(CellappInterface::onBroadcastCenterDataChanged);
-			}
-			else if (componentType == BASEAPP_TYPE)
-			{
-				(*pBundle).newMessage(BaseappInterface::onBroadcastCenterDataChanged);
-			}
-			else
+			// ѾûκζģָΪиı䣬ȫ
+			if(prefixes.size() == 0)
 			{
-				KBE_ASSERT(false && "componentType is error!\n");
-			}
-			break;
-		default:
-			KBE_ASSERT(false && "dataType error!\n");
-			break;
-		};
+				subscriptions_.erase(iter);
 
-		(*pBundle) << isDelete;
-
-		ArraySize slen = iter->first.size();
-		(*pBundle) << slen;
-		(*pBundle).assign(iter->first.data(), slen);
-
-		slen = iter->second.size();
-		(*pBundle) << slen;
-		(*pBundle).assign(iter->second.data(), slen);
+				DATA_MAP_KEY diter = dict_.begin();
+				for(; diter != dict_.end(); ++diter)
+				{
+					addBatchEntry(pBundle, DATA_OP_SET, diter->first, diter->second);
+					++numEntries;
+				}
+			}
+		}
+	}
 
-		client->send(pBundle);
+	if(numEntries == 0)
+	{
+		Network::Bundle::reclaimPoolObject(pBundle);
+		return;
 	}
+
+	pChannel->send(pBundle);
 }
 
 //-------------------------------------------------------------------------------------
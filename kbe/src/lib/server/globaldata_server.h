@@ -27,6 +27,7 @@ namespace KBEngine{
 namespace Network
 {
 	class Channel;
+	class Bundle;
 }
 
 class GlobalDataServer
@@ -40,6 +41,15 @@ public:
 		CENTER_DATA
 	};
 
+	/** ϢÿıĲ */
+	enum DATA_OP
+	{
+		DATA_OP_SET			= 0,	// ֵ
+		DATA_OP_DEL			= 1,	// ɾ
+		DATA_OP_DICT_DELTA	= 2,	// dict: (µdict, ɾkeyб)
+		DATA_OP_LIST_DELTA	= 3		// list: (ʼ, Ӹʼβ)
+	};
+
 public:	
 	GlobalDataServer(DATA_TYPE dataType);
 	virtual ~GlobalDataServer();
@@ -60,13 +70,54 @@ public:
 	/** һµĿͻ˵½ */
 	void onGlobalDataClientLogon(Network::Channel* client, COMPONENT_TYPE componentType);
 
+	/** ĳĻȡһkeyǰ׺(keyΪַʱǰ׺ƥ)ûκζĵиı */
+	void onSubscribe(Network::Channel* pChannel, COMPONENT_ID componentID, const std::string& prefix, bool isSubscribe);
+
+	/** tickڻ۵ĸıϲÿֻһϢ */
+	void flushChanges();
+
+	/** basevalueĽṹͬΪdictlistСʱtrue */
+	static bool makeDelta(const std::string& base, const std::string& value, uint8& op, std::string& delta);
+
+	/** ͳ */
+	static uint64 numWrites;
+	static uint64 numMergedWrites;
+	static uint64 numSentBatches;
+	static uint64 numSentEntries;
+	static uint64 numSentBytes;
+	static uint64 numSentDeltas;
+	static uint64 numDeltaSavedBytes;
+
 protected:
+	/** tickĳkeyĴ㲥ı */
+	struct PendingChange
+	{
+		bool isDelete;
+		bool hasBase;
+		std::string base;								// tickʼʱеֵڼ
+		std::vector<Network::Channel*> writers;			// tickдkey
+	};
+
+	Network::Bundle* newBatchBundle(COMPONENT_TYPE componentType);
+	void addBatchEntry(Network::Bundle* pBundle, uint8 op, const std::string& key, const std::string& value);
+
+	bool isSubscribed(COMPONENT_ID componentID, const std::string& key);
+	const std::string& keyName(const std::string& key);
+
 	DATA_TYPE dataType_;
 
 	std::vector<COMPONENT_TYPE> concernComponentTypes_;						// GlobalDataServerҪĵ
 	typedef std::map<std::string, std::string> DATA_MAP;
 	typedef DATA_MAP::iterator DATA_MAP_KEY;
 	DATA_MAP dict_;
+
+	std::map<std::string, PendingChange> pendingChanges_;
+	std::vector<std::string> pendingKeys_;					// д˳
+
+	typedef std::map<COMPONENT_ID, std::vector<std::string> > SUBSCRIPTIONS;
+	SUBSCRIPTIONS subscriptions_;
+
+	DATA_MAP keyNames_;										// picklekey -> ַkey(ַkeyΪ)
 } ;
 
 }
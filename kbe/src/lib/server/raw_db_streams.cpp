@@ -0,0 +1,247 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "raw_db_streams.h"
+#include "server/common.h"
+#include "common/memorystream.h"
+
+namespace KBEngine
+{
+
+//-------------------------------------------------------------------------------------
+RawDBStreams::RawDBStreams():
+lastID_(0),
+streams_()
+{
+}
+
+//-------------------------------------------------------------------------------------
+RawDBStreams::~RawDBStreams()
+{
+	streams_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+CALLBACK_ID RawDBStreams::add(PyObject* pycallback)
+{
+	// 0ΪЧID
+	if(++lastID_ == 0)
+		++lastID_;
+
+	Stream& stream = streams_[lastID_];
+	stream.pycallback = pycallback;
+	return lastID_;
+}
+
+//-------------------------------------------------------------------------------------
+void RawDBStreams::remove(CALLBACK_ID streamID)
+{
+	streams_.erase(streamID);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* RawDBStreams::readRows(Stream& stream, MemoryStream& s)
+{
+	uint32 nrows = 0;
+	s >> nrows;
+
+	uint32 nfields = (uint32)stream.types.size();
+	std::vector<uint8> nullbits((nfields + 7) / 8);
+
+	PyObject* pyRows = PyList_New(nrows);
+
+	for(uint32 i = 0; i < nrows; ++i)
+	{
+		if(nullbits.size() > 0)
+			s.read(&nullbits[0], nullbits.size());
+
+		PyObject* pyRow = PyTuple_New(nfields);
+
+		for(uint32 j = 0; j < nfields; ++j)
+		{
+			PyObject* pyCell = NULL;
+
+			if(nullbits[j / 8] & (1 << (j % 8)))
+			{
+				Py_INCREF(Py_None);
+				pyCell = Py_None;
+			}
+			else
+			{
+				switch(stream.types[j])
+				{
+				case RAW_DB_FIELD_TYPE_INT:
+				{
+					int64 v;
+					s >> v;
+					pyCell = PyLong_FromLongLong(v);
+					break;
+				}
+				case RAW_DB_FIELD_TYPE_UINT:
+				{
+					uint64 v;
+					s >> v;
+					pyCell = PyLong_FromUnsignedLongLong(v);
+					break;
+				}
+				case RAW_DB_FIELD_TYPE_DOUBLE:
+				{
+					double v;
+					s >> v;
+					pyCell = PyFloat_FromDouble(v);
+					break;
+				}
+				case RAW_DB_FIELD_TYPE_STRING:
+				{
+					std::string v;
+					s.readBlob(v);
+
+					// Ƿutf-8ֽڱʧ
+					pyCell = PyUnicode_DecodeUTF8(v.data(), v.size(), "surrogateescape");
+					break;
+				}
+				default:
+				{
+					std::string v;
+					s.readBlob(v);
+					pyCell = PyBytes_FromStringAndSize(v.data(), v.size());
+					break;
+				}
+				};
+			}
+
+			PyTuple_SET_ITEM(pyRow, j, pyCell);
+		}
+
+		PyList_SET_ITEM(pyRows, i, pyRow);
+	}
+
+	return pyRows;
+}
+
+//-------------------------------------------------------------------------------------
+void RawDBStreams::onChunk(MemoryStream& s)
+{
+	CALLBACK_ID streamID = 0;
+	std::string err;
+
+	s >> streamID;
+	s >> err;
+
+	STREAMS::iterator iter = streams_.find(streamID);
+	if(iter == streams_.end())
+	{
+		ERROR_MSG(fmt::format("RawDBStreams::onChunk: not found stream:{}.\n", streamID));
+		s.done();
+		return;
+	}
+
+	Stream& stream = iter->second;
+	PyObjectPtr pycallback = stream.pycallback;
+
+	if(err.size() > 0)
+	{
+		s.done();
+		streams_.erase(iter);
+
+		PyObject* pyError = PyUnicode_FromString(err.c_str());
+		callback(pycallback, Py_None, Py_None, Py_None, Py_None, true, pyError);
+		Py_DECREF(pyError);
+		return;
+	}
+
+	uint8 flags = 0;
+	s >> flags;
+
+	if(flags & RAW_DB_STREAM_HEADER)
+	{
+		uint32 nfields = 0;
+		s >> nfields;
+
+		stream.types.resize(nfields);
+
+		PyObject* pyColumns = PyTuple_New(nfields);
+		for(uint32 i = 0; i < nfields; ++i)
+		{
+			std::string name;
+			s >> name >> stream.types[i];
+			PyTuple_SET_ITEM(pyColumns, i, PyUnicode_DecodeUTF8(name.data(), name.size(), "surrogateescape"));
+		}
+
+		stream.pycolumns = pyColumns;
+		Py_DECREF(pyColumns);
+	}
+
+	PyObject* pyRows = readRows(stream, s);
+	PyObjectPtr pycolumns = stream.pycolumns;
+
+	bool finished = (flags & RAW_DB_STREAM_FINISHED) > 0;
+	PyObject* pyAffectedRows = Py_None;
+	PyObject* pyInsertID = Py_None;
+	Py_INCREF(pyAffectedRows);
+	Py_INCREF(pyInsertID);
+
+	if(finished)
+	{
+		uint64 affectedRows = 0, lastInsertID = 0;
+		s >> affectedRows >> lastInsertID;
+
+		// ֻвؽ
+		if(stream.types.size() == 0)
+		{
+			Py_DECREF(pyAffectedRows);
+			Py_DECREF(pyInsertID);
+			pyAffectedRows = PyLong_FromUnsignedLongLong(affectedRows);
+			pyInsertID = PyLong_FromUnsignedLongLong(lastInsertID);
+		}
+
+		// صпٴηµƳ
+		streams_.erase(iter);
+	}
+
+	s.done();
+
+	callback(pycallback, pyRows, pycolumns.get() ? pycolumns.get() : Py_None, 
+		pyAffectedRows, pyInsertID, finished, Py_None);
+
+	Py_DECREF(pyRows);
+	Py_DECREF(pyAffectedRows);
+	Py_DECREF(pyInsertID);
+}
+
+//-------------------------------------------------------------------------------------
+void RawDBStreams::callback(PyObjectPtr pycallback, PyObject* pyRows, PyObject* pyColumns, 
+	PyObject* pyAffectedRows, PyObject* pyInsertID, bool finished, PyObject* pyError)
+{
+	if(pycallback.get() == NULL)
+		return;
+
+	PyObject* pyResult = PyObject_CallFunction(pycallback.get(), 
+		const_cast<char*>("OOOOOO"), pyRows, pyColumns, pyAffectedRows, pyInsertID, 
+		finished ? Py_True : Py_False, pyError);
+
+	if(pyResult != NULL)
+		Py_DECREF(pyResult);
+	else
+		SCRIPT_ERROR_CHECK();
+}
+
+//-------------------------------------------------------------------------------------
+}
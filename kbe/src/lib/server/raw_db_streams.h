@@ -0,0 +1,84 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_RAW_DB_STREAMS_H
+#define KBE_RAW_DB_STREAMS_H
+
+#include "common/common.h"
+#include "pyscript/scriptobject.h"
+#include "pyscript/pyobject_pointer.h"
+
+namespace KBEngine
+{
+
+class MemoryStream;
+
+/*
+	űexecuteRawDatabaseCommandStreamĻص
+	dbmgrֿ鷢͹ÿ鶼typedݻصһνűֱ
+	callback(rows, columns, affectedRows, insertID, finished, error)
+*/
+class RawDBStreams
+{
+public:
+	struct Stream
+	{
+		PyObjectPtr pycallback;
+		PyObjectPtr pycolumns;
+		std::vector<uint8> types;
+	};
+
+	typedef std::map<CALLBACK_ID, Stream> STREAMS;
+
+	RawDBStreams();
+	~RawDBStreams();
+
+	/**
+		ǼһµID
+	*/
+	CALLBACK_ID add(PyObject* pycallback);
+
+	/**
+		һ(ûܷͳȥ)
+	*/
+	void remove(CALLBACK_ID streamID);
+
+	/**
+		dbmgrһ: CALLBACK_ID streamID, std::string error, [chunk]
+	*/
+	void onChunk(MemoryStream& s);
+
+	void clear() { streams_.clear(); }
+
+	size_t size() const { return streams_.size(); }
+
+protected:
+	void callback(PyObjectPtr pycallback, PyObject* pyRows, PyObject* pyColumns, 
+		PyObject* pyAffectedRows, PyObject* pyInsertID, bool finished, PyObject* pyError);
+
+	PyObject* readRows(Stream& stream, MemoryStream& s);
+
+	CALLBACK_ID lastID_;
+	STREAMS streams_;
+};
+
+}
+
+#endif // KBE_RAW_DB_STREAMS_H
@@ -55,6 +55,10 @@ ServerConfig::ServerConfig():
 	thread_init_create_(1),
 	thread_pre_create_(2),
 	thread_max_create_(8),
+	script_gc_tickSchedule_(true),
+	script_gc_tickBudget_(2.f),
+	script_gc_fullCollectInterval_(60.f),
+	script_gc_freezeAfterStartup_(true),
 	emailServerInfo_(),
 	emailAtivationInfo_(),
 	emailResetPasswordInfo_(),
@@ -205,6 +209,34 @@ bool ServerConfig::loadConfig(std::string fileName)
 		}
 	}
 
+	rootNode = xml->getRootNode("script_gc");
+	if(rootNode != NULL)
+	{
+		TiXmlNode* childnode = xml->enterNode(rootNode, "tickSchedule");
+		if(childnode)
+		{
+			script_gc_tickSchedule_ = (xml->getValStr(childnode) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "tickBudget");
+		if(childnode)
+		{
+			script_gc_tickBudget_ = KBE_MAX(0.f, float(xml->getValFloat(childnode)));
+		}
+
+		childnode = xml->enterNode(rootNode, "fullCollectInterval");
+		if(childnode)
+		{
+			script_gc_fullCollectInterval_ = KBE_MAX(0.f, float(xml->getValFloat(childnode)));
+		}
+
+		childnode = xml->enterNode(rootNode, "freezeAfterStartup");
+		if(childnode)
+		{
+			script_gc_freezeAfterStartup_ = (xml->getValStr(childnode) == "true");
+		}
+	}
+
 	rootNode = xml->getRootNode("channelCommon");
 	if(rootNode != NULL)
 	{
@@ -286,6 +318,34 @@ bool ServerConfig::loadConfig(std::string fileName)
 				channelCommon_.extWriteBufferSize = KBE_MAX(0, xml->getValInt(childnode1));
 		}
 
+		childnode = xml->enterNode(rootNode, "sendCoalescing");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "internal");
+			if(childnode1)
+				Network::g_intSendCoalescing = (xml->getValStr(childnode1) == "true");
+
+			childnode1 = xml->enterNode(childnode, "flushBytes");
+			if(childnode1)
+				Network::g_intSendCoalescingFlushBytes = KBE_MAX(0, xml->getValInt(childnode1));
+		}
+
+		childnode = xml->enterNode(rootNode, "websocket");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "permessageDeflate");
+			if(childnode1)
+				Network::g_websocketPerMessageDeflate = (xml->getValStr(childnode1) == "true");
+
+			childnode1 = xml->enterNode(childnode, "deflateMinSize");
+			if(childnode1)
+				Network::g_websocketDeflateMinSize = KBE_MAX(0, xml->getValInt(childnode1));
+
+			childnode1 = xml->enterNode(childnode, "deflateLevel");
+			if(childnode1)
+				Network::g_websocketDeflateLevel = KBE_MIN(9, KBE_MAX(0, xml->getValInt(childnode1)));
+		}
+
 		childnode = xml->enterNode(rootNode, "windowOverflow");
 		if(childnode)
 		{
@@ -601,6 +661,11 @@ bool ServerConfig::loadConfig(std::string fileName)
 			_cellAppInfo.entitydefAliasID = (xml->getValStr(node) == "true");
 		}
 
+		node = xml->enterNode(rootNode, "aliasEntityIDSlots");
+		if(node != NULL){
+			_cellAppInfo.aliasEntityIDSlots = (xml->getValStr(node) == "true");
+		}
+
 		node = xml->enterNode(rootNode, "loadSmoothingBias");
 		if(node != NULL)
 			_cellAppInfo.loadSmoothingBias = float(xml->getValFloat(node));
@@ -694,6 +759,12 @@ bool ServerConfig::loadConfig(std::string fileName)
 			{
 				_cellAppInfo.witness_timeout = uint16(xml->getValInt(childnode));
 			}
+
+			childnode = xml->enterNode(node, "enterViewBytesPerTick");
+			if(childnode)
+			{
+				_cellAppInfo.witness_enterViewBytesPerTick = uint32(xml->getValInt(childnode));
+			}
 		}
 	}
 	
@@ -1077,6 +1148,10 @@ bool ServerConfig::loadConfig(std::string fileName)
 					else
 						missingFields.push_back("numConnections");
 						
+					node = xml->enterNode(interfaceNode, "preparedStatements");
+					if(node != NULL)
+						pDBInfo->db_preparedStatements = xml->getValStr(node) == "true";
+
 					node = xml->enterNode(interfaceNode, "unicodeString");
 					if(node != NULL)
 					{
@@ -1183,6 +1258,82 @@ bool ServerConfig::loadConfig(std::string fileName)
 			_dbmgrInfo.isShareDB = (xml->getValStr(node) == "true");
 		}
 
+		node = xml->enterNode(rootNode, "globalData");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "deltaMode");
+			if (childnode)
+				_dbmgrInfo.globalDataDeltaMode = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(node, "deltaMinSize");
+			if (childnode)
+				_dbmgrInfo.globalDataDeltaMinSize = xml->getValInt(childnode);
+		}
+
+		node = xml->enterNode(rootNode, "loginAdmission");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "loginsPerSecond");
+			if (childnode)
+				_dbmgrInfo.loginAdmissionPerSecond = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "burst");
+			if (childnode)
+				_dbmgrInfo.loginAdmissionBurst = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "maxQueueSize");
+			if (childnode)
+				_dbmgrInfo.loginAdmissionMaxQueue = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "notifyInterval");
+			if (childnode)
+				_dbmgrInfo.loginAdmissionNotifyInterval = (float)xml->getValFloat(childnode);
+		}
+
+		node = xml->enterNode(rootNode, "accountCache");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "size");
+			if (childnode)
+				_dbmgrInfo.accountCacheMaxSize = xml->getValInt(childnode);
+
+			childnode = xml->enterNode(node, "timeout");
+			if (childnode)
+				_dbmgrInfo.accountCacheTimeout = (float)xml->getValFloat(childnode);
+		}
+
+		node = xml->enterNode(rootNode, "entitylog");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "inMemory");
+			if (childnode)
+				_dbmgrInfo.entityLogInMemory = (xml->getValStr(childnode) == "true");
+
+			childnode = xml->enterNode(node, "flushInterval");
+			if (childnode)
+				_dbmgrInfo.entityLogFlushInterval = (float)xml->getValFloat(childnode);
+		}
+
+		node = xml->enterNode(rootNode, "rawDatabaseStream");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "chunkRows");
+			if (childnode)
+				_dbmgrInfo.rawStreamChunkRows = KBE_MAX(1, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "chunkSize");
+			if (childnode)
+				_dbmgrInfo.rawStreamChunkSize = KBE_MAX(1024, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "maxBacklog");
+			if (childnode)
+				_dbmgrInfo.rawStreamMaxBacklog = KBE_MAX(0, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "maxStreams");
+			if (childnode)
+				_dbmgrInfo.rawStreamMaxStreams = KBE_MAX(0, xml->getValInt(childnode));
+		}
+
 		node = xml->enterNode(rootNode, "account_system");
 		if(node != NULL)
 		{
@@ -1500,6 +1651,19 @@ bool ServerConfig::loadConfig(std::string fileName)
 			_botsInfo.forceInternalLogin = (xml->getValStr(node) == "true");
 		}
 
+		node = xml->enterNode(rootNode, "ioThreads");
+		if (node != NULL){
+			_botsInfo.bots_ioThreads = KBE_MAX(0, xml->getValInt(node));
+		}
+
+		node = xml->enterNode(rootNode, "scenario");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "tickInterval");
+			if (childnode)
+				_botsInfo.bots_scenario_tickInterval = KBE_MAX(0.f, (float)xml->getValFloat(childnode));
+		}
+
 		node = xml->enterNode(rootNode, "telnet_service");
 		if(node != NULL)
 		{
@@ -1570,6 +1734,52 @@ bool ServerConfig::loadConfig(std::string fileName)
 				_loggerInfo.telnet_deflayer = xml->getValStr(childnode);
 			}
 		}
+
+		node = xml->enterNode(rootNode, "store");
+		if (node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "enable");
+			if (childnode)
+			{
+				_loggerInfo.logStore_enable = (xml->getValStr(childnode) == "true");
+			}
+
+			childnode = xml->enterNode(node, "path");
+			if (childnode)
+			{
+				_loggerInfo.logStore_path = xml->getValStr(childnode);
+			}
+
+			childnode = xml->enterNode(node, "segmentSize");
+			if (childnode)
+			{
+				_loggerInfo.logStore_segmentSize = uint32(xml->getValInt(childnode));
+			}
+
+			childnode = xml->enterNode(node, "blockSize");
+			if (childnode)
+			{
+				_loggerInfo.logStore_blockSize = uint32(xml->getValInt(childnode));
+			}
+
+			childnode = xml->enterNode(node, "flushInterval");
+			if (childnode)
+			{
+				_loggerInfo.logStore_flushInterval = float(xml->getValFloat(childnode));
+			}
+
+			childnode = xml->enterNode(node, "textLogs");
+			if (childnode)
+			{
+				_loggerInfo.logStore_textLogs = (xml->getValStr(childnode) == "true");
+			}
+
+			childnode = xml->enterNode(node, "maxQueryResults");
+			if (childnode)
+			{
+				_loggerInfo.logStore_maxQueryResults = uint32(xml->getValInt(childnode));
+			}
+		}
 	}
 
 	rootNode = xml->getRootNode("centermgr");
@@ -105,6 +105,7 @@ struct DBInterfaceInfo
 		isPure = false;
 		db_numConnections = 5;
 		db_passwordEncrypt = true;
+		db_preparedStatements = true;
 
 		memset(name, 0, sizeof(name));
 		memset(db_type, 0, sizeof(db_type));
@@ -126,6 +127,7 @@ struct DBInterfaceInfo
 	bool db_passwordEncrypt;								// dbǷǼܵ
 	char db_name[MAX_NAME];									// ݿ
 	uint16 db_numConnections;								// ݿ
+	bool db_preparedStatements;								// Ƿʹ÷Ԥ(mysql)
 	std::string db_unicodeString_characterSet;				// ݿַ
 	std::string db_unicodeString_collation;
 	std::string auto_increment_offset;						// ֶƫֵ
@@ -144,11 +146,37 @@ typedef struct EngineComponentInfo
 		use_coordinate_system = true;
 		account_type = 3;
 		debugDBMgr = false;
+		globalDataDeltaMode = false;
+		globalDataDeltaMinSize = 256;
+		loginAdmissionPerSecond = 0;
+		loginAdmissionBurst = 50;
+		loginAdmissionMaxQueue = 10000;
+		loginAdmissionNotifyInterval = 2.f;
+		accountCacheMaxSize = 0;
+		accountCacheTimeout = 60.f;
+		entityLogInMemory = true;
+		entityLogFlushInterval = 1.f;
+		rawStreamChunkRows = 1000;
+		rawStreamChunkSize = 65536;
+		rawStreamMaxBacklog = 1024 * 1024;
+		rawStreamMaxStreams = 4;
 
 		externalAddress[0] = '\0';
 
 		isOnInitCallPropertysSetMethods = true;
 		forceInternalLogin = false;
+		bots_ioThreads = 0;
+		bots_scenario_tickInterval = 1.f;
+		aliasEntityIDSlots = false;
+		witness_enterViewBytesPerTick = 0;
+
+		logStore_enable = false;
+		logStore_path = "logs/store";
+		logStore_segmentSize = 64 * 1024 * 1024;
+		logStore_blockSize = 65536;
+		logStore_flushInterval = 0.5f;
+		logStore_textLogs = true;
+		logStore_maxQueryResults = 10000;
 	}
 
 	~EngineComponentInfo()
@@ -167,6 +195,7 @@ typedef struct EngineComponentInfo
 	float defaultViewRadius;								// cellappڵеplayerview뾶С
 	float defaultViewHysteresisArea;						// cellappڵеplayerviewͺΧ
 	uint16 witness_timeout;									// ۲Ĭϳʱʱ()
+	uint32 witness_enterViewBytesPerTick;					// ÿ۲ÿtickentityViewݵֽԤ㣬 Ϊ0
 	const Network::Address* externalTcpAddr;					// ⲿַ
 	const Network::Address* internalTcpAddr;					// ڲַ
 	COMPONENT_ID componentID;
@@ -183,6 +212,7 @@ typedef struct EngineComponentInfo
 
 	bool aliasEntityID;										// ŻEntityIDviewΧС255EntityID, 䵽clientʱʹ1ֽαID 
 	bool entitydefAliasID;									// ŻentityԺͷ㲥ʱռõĴentityͻԻ߿ͻ˲255ʱ uiduid䵽clientʱʹ1ֽڱID
+	bool aliasEntityIDSlots;								// aliasEntityIDʹȶĲλ䣬 뿪Viewʱؽӳ䣬 256ʱʹ2ֽڱID
 
 	char internalInterface[MAX_NAME];						// ڲӿ
 	char externalInterface[MAX_NAME];						// ⲿӿ
@@ -231,6 +261,9 @@ typedef struct EngineComponentInfo
 	uint32 bots_account_name_suffix_inc;					// ˺Ƶĺ׺, 0ʹ baseNumд
 	std::string bots_account_passwd;						// ˺ŵ
 
+	uint32 bots_ioThreads;									// ȡ߳ 0Ϊ߳жȡ
+	float bots_scenario_tickInterval;						// ˳űonTickĵü()
+
 	uint32 tcp_SOMAXCONN;									// listenֵ
 
 	int8 encrypt_login;										// ܵ¼Ϣ
@@ -253,6 +286,33 @@ typedef struct EngineComponentInfo
 
 	bool debugDBMgr;										// debugģʽ¿дϢ
 
+	bool globalDataDeltaMode;								// dbmgr㲥dict/list͵globalݸıʱǷֻ
+	uint32 globalDataDeltaMinSize;							// ֵpickleݴڵڸôСųԼ
+
+	uint32 loginAdmissionPerSecond;							// dbmgrÿеĵ¼0Ϊ
+	uint32 loginAdmissionBurst;								// ˲еĵ¼(Ͱ)
+	uint32 loginAdmissionMaxQueue;							// ¼ŶӶ󳤶ȣܾ
+	float loginAdmissionNotifyInterval;						// ŶеĿͻŶλõļ()
+
+	uint32 accountCacheMaxSize;								// ˺Ϣ0Ϊ
+	float accountCacheTimeout;								// ˺ϢЧʱ()
+
+	bool entityLogInMemory;									// Ƿڴάentitylog(shareDBʱЧ)
+	float entityLogFlushInterval;							// ڴentitylogĸıдݿļ()
+
+	uint32 rawStreamChunkRows;								// executeRawDatabaseCommandStreamÿĬϵ
+	uint32 rawStreamChunkSize;								// executeRawDatabaseCommandStreamÿֽ
+	uint32 rawStreamMaxBacklog;								// ͨδ͵ݳֵʱͣȡһ
+	uint32 rawStreamMaxStreams;								// ͬʱе(ÿռһݿ)
+
+	bool logStore_enable;									// loggerǷ־дƷֶļ(ʱ//)
+	std::string logStore_path;								// ־ֶļĴĿ¼
+	uint32 logStore_segmentSize;							// ֶļֽлµķֶ
+	uint32 logStore_blockSize;								// ֶÿֽ
+	float logStore_flushInterval;							// δдĿȴ()ɺ̨߳д
+	bool logStore_textLogs;									// ǷȻͨlog4cxxı־
+	uint32 logStore_maxQueryResults;						// βѯʷ־ص
+
 	bool isOnInitCallPropertysSetMethods;					// (bots)רãEntityʼʱǷ񴥷Եset_*¼
 
 	bool isCrossServerEnable;								// Ƿÿ
@@ -304,6 +364,11 @@ public:
 	uint32 tickMaxBufferedLogs() const { return tick_max_buffered_logs_; }
 	uint32 tickMaxSyncLogs() const { return tick_max_sync_logs_; }
 
+	bool scriptGCTickSchedule() const { return script_gc_tickSchedule_; }
+	float scriptGCTickBudget() const { return script_gc_tickBudget_; }
+	float scriptGCFullCollectInterval() const { return script_gc_fullCollectInterval_; }
+	bool scriptGCFreezeAfterStartup() const { return script_gc_freezeAfterStartup_; }
+
 	INLINE float channelExternalTimeout(void) const;
 	INLINE bool isPureDBInterfaceName(const std::string& dbInterfaceName);
 	INLINE DBInterfaceInfo* dbInterface(const std::string& name);
@@ -355,6 +420,11 @@ public:
 	float thread_timeout_;											// Ĭϳʱʱ()
 
 	uint32 thread_init_create_, thread_pre_create_, thread_max_create_;
+
+	bool script_gc_tickSchedule_;									// Ƿtickʱpython
+	float script_gc_tickBudget_;									// ÿtickպʱԤ()
+	float script_gc_fullCollectInterval_;							// ȫյС()
+	bool script_gc_freezeAfterStartup_;								// ɺǷ񶳽ᵱǰ(gc.freeze)
 	
 	EmailServerInfo	emailServerInfo_;
 	EmailSendInfo emailAtivationInfo_;
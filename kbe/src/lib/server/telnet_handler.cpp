@@ -25,6 +25,8 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/endpoint.h"
 #include "network/network_interface.h"
 #include "pyscript/script.h"
+#include "helper/profile.h"
+#include "resmgr/resmgr.h"
 
 #ifndef CODE_INLINE
 #include "telnet_handler.inl"
@@ -200,6 +202,8 @@ std::string TelnetHandler::help()
 		"\r\n\t\t usage: \":eventprofile 30\""
 		"\r\n[:networkprofile]: collects and reports the network profiles \r\n\t\tof a server process over a period of time."
 		"\r\n\t\t usage: \":networkprofile 30\""
+		"\r\n[:ctrace        ]: dumps the c++ profile events of the last few seconds \r\n\t\tto a chrome trace file(chrome://tracing) in the log directory \r\n\t\t(or the user res directory)."
+		"\r\n\t\t usage: \":ctrace 10\""
 		"\r\n\r\n\033[0m";
 };
 
@@ -766,6 +770,61 @@ bool TelnetHandler::processCommand()
 		readonly();
 		return false;
 	}
+	else if(cmd.find(":ctrace") == 0)
+	{
+		float timelen = 10.f;
+
+		cmd.erase(cmd.find(":ctrace"), strlen(":ctrace"));
+		if(cmd.size() > 0)
+		{
+			try
+			{
+				KBEngine::StringConv::str2value(timelen, cmd.c_str());
+			}
+			catch(...)  
+			{
+				timelen = 10.f;
+			}
+
+			if(timelen <= 0.f)
+				timelen = 10.f;
+		}
+
+		uint32 eventCount = 0;
+		std::string datas = ProfileGroup::dumpChromeTrace(timelen, eventCount);
+
+		// д־Ŀ¼ ûļ־ʱдûԴĿ¼ ̵ĹĿ¼
+		std::string path = DebugHelper::getSingleton().getLogName();
+		if(path.size() > 0)
+		{
+			strutil::kbe_replace(path, "\\", "/");
+			std::string::size_type pos = path.rfind("/");
+			path = (pos == std::string::npos) ? "" : path.substr(0, pos + 1);
+		}
+
+		if(path.size() == 0)
+			path = Resmgr::getSingleton().getPyUserResPath();
+
+		std::string filename = fmt::format("{}{}_{}_{}.trace.json", path, COMPONENT_NAME_EX(g_componentType), 
+			g_componentID, (uint64)time(NULL));
+
+		std::string str;
+		FILE* f = fopen(filename.c_str(), "wb");
+		if(f)
+		{
+			fwrite(datas.data(), 1, datas.size(), f);
+			fclose(f);
+			str = fmt::format("\r\n{} events written to {}.\r\n", eventCount, filename);
+		}
+		else
+		{
+			str = fmt::format("\r\nunable to write {}.\r\n", filename);
+		}
+
+		pEndPoint_->send(str.c_str(), str.size());
+		sendNewLine();
+		return true;
+	}
 	else if(cmd.find(":networkprofile") == 0)
 	{
 		uint32 timelen = 10;
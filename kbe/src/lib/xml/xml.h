@@ -133,6 +133,21 @@ public:
 		return true;
 	}
 
+	/**ʹһѾõĵ(ӻлԭ)xmlӹĵ*/
+	bool openDocument(TiXmlDocument* txdoc)
+	{
+		if(txdoc_)
+		{
+			txdoc_->Clear();
+			delete txdoc_;
+		}
+
+		txdoc_ = txdoc;
+		rootElement_ = txdoc_->RootElement();
+		isGood_ = rootElement_ != NULL;
+		return isGood_;
+	}
+
 	/**ȡԪ*/
 	TiXmlElement* getRootElement(void){return rootElement_;}
 
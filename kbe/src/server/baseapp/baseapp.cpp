@@ -31,6 +31,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "entity_messages_forward_handler.h"
 #include "forward_message_over_handler.h"
 #include "sync_entitystreamtemplate_handler.h"
+#include "data_download_cache.h"
 #include "common/timestamp.h"
 #include "common/kbeversion.h"
 #include "common/sha1.h"
@@ -355,6 +356,12 @@ bool Baseapp::initializeWatcher()
 	WATCH_OBJECT("numClients", this, &Baseapp::numClients);
 	WATCH_OBJECT("load", this, &Baseapp::_getLoad);
 	WATCH_OBJECT("stats/runningTime", &runningTime);
+	WATCH_OBJECT("stats/dataDownload/numContents", &DataDownloadCache::numContents);
+	WATCH_OBJECT("stats/dataDownload/cachedBytes", &DataDownloadCache::cachedBytes);
+	WATCH_OBJECT("stats/dataDownload/numHits", DataDownloadCache::numHits);
+	WATCH_OBJECT("stats/dataDownload/numLoads", DataDownloadCache::numLoads);
+	WATCH_OBJECT("stats/dataDownload/numSentBytes", DataDownloadCache::numSentBytes);
+	WATCH_OBJECT("stats/dataDownload/numThrottled", DataDownloadCache::numThrottled);
 	return EntityApp<Entity>::initializeWatcher();
 }
 
@@ -389,6 +396,7 @@ bool Baseapp::installPyModules()
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		createEntityAnywhereFromDBID,	__py_createEntityAnywhereFromDBID,							METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		createEntityRemotelyFromDBID,	__py_createEntityRemotelyFromDBID,							METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		executeRawDatabaseCommand,		__py_executeRawDatabaseCommand,								METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		executeRawDatabaseCommandStream,	__py_executeRawDatabaseCommandStream,						METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		quantumPassedPercent,			__py_quantumPassedPercent,									METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		charge,							__py_charge,												METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		registerReadFileDescriptor,		PyFileDescriptor::__py_registerReadFileDescriptor,			METH_VARARGS,			0);
@@ -3197,6 +3205,93 @@ void Baseapp::executeRawDatabaseCommand(const char* datas, uint32 size, PyObject
 	dbmgrinfos->pChannel->send(pBundle);
 }
 
+//-------------------------------------------------------------------------------------
+PyObject* Baseapp::__py_executeRawDatabaseCommandStream(PyObject* self, PyObject* args)
+{
+	PyObject* pycallback = NULL;
+	PyObject* pyDBInterfaceName = NULL;
+	unsigned int chunkRows = 0;
+
+	char* data = NULL;
+	Py_ssize_t size;
+
+	if(!PyArg_ParseTuple(args, "s#O|IO", &data, &size, &pycallback, &chunkRows, &pyDBInterfaceName))
+	{
+		PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args error!");
+		PyErr_PrintEx(0);
+		S_Return;
+	}
+
+	if(!PyCallable_Check(pycallback))
+	{
+		PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args2 not is callable!");
+		PyErr_PrintEx(0);
+		S_Return;
+	}
+
+	std::string dbInterfaceName = "default";
+	if (pyDBInterfaceName)
+	{
+		dbInterfaceName = PyUnicode_AsUTF8AndSize(pyDBInterfaceName, NULL);
+		
+		if (!g_kbeSrvConfig.dbInterface(dbInterfaceName))
+		{
+			PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args4, incorrect dbInterfaceName(%s)!", 
+				dbInterfaceName.c_str());
+			
+			PyErr_PrintEx(0);
+			S_Return;
+		}
+	}
+
+	Baseapp::getSingleton().executeRawDatabaseCommandStream(data, (uint32)size, pycallback, (uint32)chunkRows, dbInterfaceName);
+	S_Return;
+}
+
+//-------------------------------------------------------------------------------------
+void Baseapp::executeRawDatabaseCommandStream(const char* datas, uint32 size, PyObject* pycallback, uint32 chunkRows, const std::string& dbInterfaceName)
+{
+	if(datas == NULL)
+	{
+		ERROR_MSG("KBEngine::executeRawDatabaseCommandStream: execute error!\n");
+		return;
+	}
+
+	Components::ComponentInfos* dbmgrinfos = Components::getSingleton().getDbmgr();
+	if(dbmgrinfos == NULL || dbmgrinfos->pChannel == NULL || dbmgrinfos->cid == 0)
+	{
+		ERROR_MSG("KBEngine::executeRawDatabaseCommandStream: not found dbmgr!\n");
+		return;
+	}
+
+	int dbInterfaceIndex = g_kbeSrvConfig.dbInterfaceName2dbInterfaceIndex(dbInterfaceName);
+	if (dbInterfaceIndex < 0)
+	{
+		ERROR_MSG(fmt::format("KBEngine::executeRawDatabaseCommandStream: not found dbInterface({})!\n",
+			dbInterfaceName));
+
+		return;
+	}
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(DbmgrInterface::executeRawDatabaseCommandStream);
+	(*pBundle) << (uint16)dbInterfaceIndex;
+	(*pBundle) << componentID_ << componentType_;
+	(*pBundle) << rawDBStreams_.add(pycallback);
+	(*pBundle) << chunkRows;
+	(*pBundle).appendBlob(datas, size);
+	dbmgrinfos->pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void Baseapp::onExecuteRawDatabaseCommandStreamCB(Network::Channel* pChannel, KBEngine::MemoryStream& s)
+{
+	if(pChannel->isExternal())
+		return;
+
+	rawDBStreams_.onChunk(s);
+}
+
 //-------------------------------------------------------------------------------------
 void Baseapp::onExecuteRawDatabaseCommandCB(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -3548,6 +3643,19 @@ void Baseapp::onDbmgrInitCompleted(Network::Channel* pChannel,
 	pInitProgressHandler_->start();
 }
 
+//-------------------------------------------------------------------------------------
+GlobalDataClient* Baseapp::findGlobalData(uint8 dataType, const char*& setCallback, const char*& delCallback)
+{
+	if(dataType == GlobalDataServer::BASEAPP_DATA)
+	{
+		setCallback = "onBaseAppData";
+		delCallback = "onBaseAppDataDel";
+		return pBaseAppData_;
+	}
+
+	return EntityApp<Entity>::findGlobalData(dataType, setCallback, delCallback);
+}
+
 //-------------------------------------------------------------------------------------
 void Baseapp::onBroadcastBaseAppDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -4482,6 +4590,105 @@ void Baseapp::forwardMessageToClientFromCellapp(Network::Channel* pChannel,
 	s.done();
 }
 
+//-------------------------------------------------------------------------------------
+void Baseapp::forwardMessageToClientsFromCellapp(Network::Channel* pChannel, 
+												KBEngine::MemoryStream& s)
+{
+	AUTO_SCOPED_PROFILE("forwardMessageToClientsFromCellapp");
+
+	if(pChannel->isExternal())
+		return;
+
+	Network::MessageID normalMsgID = 0, optimizedMsgID = 0;
+	ENTITY_ID entityID = 0;
+	ArraySize payloadSize = 0;
+	uint32 count = 0;
+
+	s >> normalMsgID >> optimizedMsgID >> entityID >> payloadSize;
+
+	const uint8* pPayload = s.data() + s.rpos();
+	s.read_skip(payloadSize);
+	s >> count;
+
+	Network::MessageHandler* pNormalMsgHandler = ClientInterface::messageHandlers.find(normalMsgID);
+	Network::MessageHandler* pOptimizedMsgHandler = ClientInterface::messageHandlers.find(optimizedMsgID);
+
+	if(!pNormalMsgHandler || !pOptimizedMsgHandler)
+	{
+		ERROR_MSG(fmt::format("Baseapp::forwardMessageToClientsFromCellapp: not found msgHandler(msgid={}, {}), entityID({}).\n", 
+			normalMsgID, optimizedMsgID, entityID));
+
+		s.done();
+		return;
+	}
+
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(pChannel);
+
+	for(uint32 i = 0; i < count; ++i)
+	{
+		ENTITY_ID targetID = 0;
+		uint8 aliasIDSize = 0;
+		uint16 aliasID = 0;
+		s >> targetID >> aliasIDSize;
+
+		if(aliasIDSize > 0)
+			s >> aliasID;
+
+		Entity* pEntity = pEntities_->find(targetID);
+		if(pEntity == NULL)
+			continue;
+
+		EntityCallAbstract* entitycall = static_cast<EntityCallAbstract*>(pEntity->clientEntityCall());
+		if(entitycall == NULL)
+			continue;
+
+		BaseMessagesForwardClientHandler* pBufferedSendToClientMessages = pEntity->pBufferedSendToClientMessages();
+
+		//ҪжԴǷͬ
+		if (pBufferedSendToClientMessages)
+		{
+			if (!cinfos || cinfos->cid != pBufferedSendToClientMessages->cellappID())
+				pBufferedSendToClientMessages = NULL;
+		}
+
+		Network::Channel* pClientChannel = entitycall->getChannel();
+		Network::Bundle* pSendBundle = NULL;
+
+		if (!pClientChannel || pBufferedSendToClientMessages)
+			pSendBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		else
+			pSendBundle = pClientChannel->createSendBundle();
+
+		if(aliasIDSize == sizeof(uint8))
+		{
+			pSendBundle->newMessage(*pOptimizedMsgHandler);
+			(*pSendBundle) << (uint8)aliasID;
+		}
+		else if(aliasIDSize == sizeof(uint16))
+		{
+			pSendBundle->newMessage(*pOptimizedMsgHandler);
+			(*pSendBundle) << aliasID;
+		}
+		else
+		{
+			pSendBundle->newMessage(*pNormalMsgHandler);
+			(*pSendBundle) << entityID;
+		}
+
+		if(payloadSize > 0)
+			(*pSendBundle).append(pPayload, (int)payloadSize);
+
+		if (!pBufferedSendToClientMessages)
+		{
+			static_cast<Proxy*>(pEntity)->sendToClient(pSendBundle, true);
+		}
+		else
+		{
+			pBufferedSendToClientMessages->pushMessages(pSendBundle);
+		}
+	}
+}
+
 //-------------------------------------------------------------------------------------
 void Baseapp::forwardMessageToCellappFromCellapp(Network::Channel* pChannel, 
 												KBEngine::MemoryStream& s)
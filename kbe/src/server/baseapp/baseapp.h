@@ -273,6 +273,13 @@ public:
 	void executeRawDatabaseCommand(const char* datas, uint32 size, PyObject* pycallback, ENTITY_ID eid, const std::string& dbInterfaceName);
 	void onExecuteRawDatabaseCommandCB(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** 
+		dbmgrִһݿֿص: callback(rows, columns, affectedRows, insertID, finished, error)
+	*/
+	static PyObject* __py_executeRawDatabaseCommandStream(PyObject* self, PyObject* args);
+	void executeRawDatabaseCommandStream(const char* datas, uint32 size, PyObject* pycallback, uint32 chunkRows, const std::string& dbInterfaceName);
+	void onExecuteRawDatabaseCommandStreamCB(Network::Channel* pChannel, KBEngine::MemoryStream& s);
+
 	/** ӿ
 		dbmgrͳʼϢ
 		startID: ʼENTITY_ID ʼλ
@@ -290,6 +297,11 @@ public:
 	*/
 	void onBroadcastBaseAppDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** 
+		ȡĳȫݶűص
+	*/
+	virtual GlobalDataClient* findGlobalData(uint8 dataType, const char*& setCallback, const char*& delCallback);
+
 	/** ӿ
 		¼
 	*/
@@ -389,6 +401,11 @@ public:
 	*/
 	void forwardMessageToClientFromCellapp(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** ӿ
+		cellappתͬһentityϢclientϢֻЯһΣbaseappƸÿĿ
+	*/
+	void forwardMessageToClientsFromCellapp(Network::Channel* pChannel, KBEngine::MemoryStream& s);
+
 	/** ӿ
 		cellappתentityϢĳbaseEntitycellEntity
 	*/
@@ -124,6 +124,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onBroadcastGlobalDataChanged,					NETWORK_VARIABLE_MESSAGE)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onBroadcastBaseAppDataChanged,					NETWORK_VARIABLE_MESSAGE)
 	BASEAPP_MESSAGE_DECLARE_STREAM(onBroadcastCenterDataChanged,					NETWORK_VARIABLE_MESSAGE)
+	BASEAPP_MESSAGE_DECLARE_STREAM(onBroadcastGlobalDataBatch,					NETWORK_VARIABLE_MESSAGE)
 
 	// յ¼
 	BASEAPP_MESSAGE_DECLARE_STREAM(receiveAcrossServerRequest,						 NETWORK_VARIABLE_MESSAGE)
@@ -220,6 +221,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	// executeRawDatabaseCommanddbmgrĻص
 	BASEAPP_MESSAGE_DECLARE_STREAM(onExecuteRawDatabaseCommandCB,					NETWORK_VARIABLE_MESSAGE)
 
+	// executeRawDatabaseCommandStreamdbmgrصһ
+	BASEAPP_MESSAGE_DECLARE_STREAM(onExecuteRawDatabaseCommandStreamCB,			NETWORK_VARIABLE_MESSAGE)
+
 	// cellappentitycell
 	BASEAPP_MESSAGE_DECLARE_STREAM(onBackupEntityCellData,							NETWORK_VARIABLE_MESSAGE)
 
@@ -229,6 +233,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	// cellappתentityϢclient
 	BASEAPP_MESSAGE_DECLARE_STREAM(forwardMessageToClientFromCellapp,				NETWORK_VARIABLE_MESSAGE)
 
+	// cellappתͬһentityϢclient
+	BASEAPP_MESSAGE_DECLARE_STREAM(forwardMessageToClientsFromCellapp,				NETWORK_VARIABLE_MESSAGE)
+
 	// cellappתentityϢĳbaseEntitycellEntity
 	BASEAPP_MESSAGE_DECLARE_STREAM(forwardMessageToCellappFromCellapp,				NETWORK_VARIABLE_MESSAGE)
 
@@ -21,6 +21,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "baseapp.h"
 #include "data_download.h"
 #include "data_downloads.h"
+#include "data_download_cache.h"
 #include "resmgr/resmgr.h"
 
 #include "client_lib/client_interface.h"
@@ -37,9 +38,7 @@ pDataDownloads_(NULL),
 sentStart_(false),
 totalBytes_(0),
 totalSentBytes_(0),
-remainSent_(0),
-currSent_(0),
-stream_(NULL),
+pContent_(NULL),
 entityID_(0),
 error_(false)
 {
@@ -48,7 +47,7 @@ error_(false)
 //-------------------------------------------------------------------------------------
 DataDownload::~DataDownload()
 {
-	SAFE_RELEASE_ARRAY(stream_);
+	DataDownloadCache::release(pContent_);
 
 	Proxy* proxy = static_cast<Proxy*>(Baseapp::getSingleton().findEntity(entityID_));
 
@@ -79,7 +78,7 @@ bool DataDownload::send(const Network::MessageHandler& msgHandler, Network::Bund
 //-------------------------------------------------------------------------------------
 thread::TPTask::TPTaskState DataDownload::presentMainThread()
 {
-	if(error_)
+	if(error_ || pContent_ == NULL || pContent_->error())
 	{
 		ERROR_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread error.\n", 
 			entityID(), id(), (int)type()));
@@ -87,76 +86,81 @@ thread::TPTask::TPTaskState DataDownload::presentMainThread()
 		return thread::TPTask::TPTASK_STATE_COMPLETED; 
 	}
 
-	uint32 datasize = GAME_PACKET_MAX_SIZE_TCP - sizeof(int16) - sizeof(uint32);
+	totalBytes_ = pContent_->size();
 
-	if ((remainSent_ > 0 && currSent_ < remainSent_) || totalBytes_ == 0)
+	if(!sentStart_)
 	{
 		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		pBundle->newMessage(ClientInterface::onStreamDataStarted);
+		(*pBundle) << this->id();
+		(*pBundle) << totalBytes_;
+		(*pBundle) << descr_;
+		(*pBundle) << type();
 
-		if(!sentStart_)
+		sentStart_ = true;
+		if(!send(ClientInterface::onStreamDataStarted, pBundle))
 		{
-			pBundle->newMessage(ClientInterface::onStreamDataStarted);
-			(*pBundle) << this->id();
-			(*pBundle) << totalBytes_;
-			(*pBundle) << descr_;
-			(*pBundle) << type();
-
-			sentStart_ = true;
-			if(!send(ClientInterface::onStreamDataStarted, pBundle))
-			{
-				DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
-					entityID(), id(), (int)type()));
-
-				return thread::TPTask::TPTASK_STATE_COMPLETED; 
-			}
-
-			return thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD; 
+			DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
+				entityID(), id(), (int)type()));
+
+			return thread::TPTask::TPTASK_STATE_COMPLETED; 
 		}
 
-		pBundle->newMessage(ClientInterface::onStreamDataRecv);
-		(*pBundle) << id();
+		return thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD; 
+	}
 
-		if(remainSent_ - currSent_ > datasize)
-		{
-			(*pBundle) << datasize;
-			(*pBundle).append(getOutStream() + currSent_, datasize);
+	Proxy* proxy = static_cast<Proxy*>(Baseapp::getSingleton().findEntity(entityID_));
+	Network::Channel* pChannel = proxy && proxy->clientEntityCall() ? proxy->clientEntityCall()->getChannel() : NULL;
+	if(pChannel == NULL)
+	{
+		DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
+			entityID(), id(), (int)type()));
 
-			currSent_ += datasize;
-			totalSentBytes_ += datasize;
+		error_ = true;
+		return thread::TPTask::TPTASK_STATE_COMPLETED; 
+	}
 
-			if(!send(ClientInterface::onStreamDataRecv, pBundle))
-			{
-				DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
-					entityID(), id(), (int)type()));
+	// ոÿͻ˷ʹڵĻѹtickͶ٣ļؼռϷϢ
+	uint32 budget = DataDownloadCache::clientTickBudget((uint32)pChannel->bundlesLength());
+	if(budget > totalBytes_ - totalSentBytes_)
+		budget = totalBytes_ - totalSentBytes_;
 
-				error_ = true;
-				return thread::TPTask::TPTASK_STATE_COMPLETED; 
-			}
-		}
-		else
-		{
-			datasize = remainSent_ - currSent_;
-			(*pBundle) << datasize;
-			(*pBundle).append(getOutStream() + currSent_, datasize);
+	budget = DataDownloadCache::consumeTickBudget(budget);
 
-			if(!send(ClientInterface::onStreamDataRecv, pBundle))
-			{
-				DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
-					entityID(), id(), (int)type()));
+	uint32 datasize = GAME_PACKET_MAX_SIZE_TCP - sizeof(int16) - sizeof(uint32);
+	uint32 sentBytes = 0;
+
+	while(sentBytes < budget)
+	{
+		uint32 size = budget - sentBytes;
+		if(size > datasize)
+			size = datasize;
 
-				error_ = true;
-				return thread::TPTask::TPTASK_STATE_COMPLETED; 
-			}
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		pBundle->newMessage(ClientInterface::onStreamDataRecv);
+		(*pBundle) << id();
+		(*pBundle) << size;
+		(*pBundle).append(pContent_->data() + totalSentBytes_, size);
+
+		if(!send(ClientInterface::onStreamDataRecv, pBundle))
+		{
+			DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread exit.\n",
+				entityID(), id(), (int)type()));
 
-			totalSentBytes_ += datasize;
-			currSent_ = remainSent_;
+			error_ = true;
+			return thread::TPTask::TPTASK_STATE_COMPLETED; 
 		}
+
+		sentBytes += size;
+		totalSentBytes_ += size;
 	}
 
+	DataDownloadCache::numSentBytes += sentBytes;
+
 	if(totalSentBytes_ == totalBytes_)
 	{
-		DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({0}), downloadID({1}), type({6}), sentBytes={5},{2}/{3} ({4:.2f}%).\n",
-			entityID(), id(), totalSentBytes_, this->totalBytes(), 100.0f, datasize, (int)type()));
+		DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({0}), downloadID({1}), type({5}), sentBytes={2}/{3} ({4:.2f}%).\n",
+			entityID(), id(), totalSentBytes_, this->totalBytes(), 100.0f, (int)type()));
 
 		pDataDownloads_->onDownloadCompleted(this);
 
@@ -170,18 +174,6 @@ thread::TPTask::TPTaskState DataDownload::presentMainThread()
 		return thread::TPTask::TPTASK_STATE_COMPLETED; 
 	}
 	
-	DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({0}), downloadID({1}), type({6}), sentBytes={5},{2}/{3} ({4:.2f}%).\n",
-		entityID(), id(), totalSentBytes_, this->totalBytes(), 
-		(((float)totalSentBytes_ / (float)this->totalBytes()) * 100.0f), datasize, type()));
-
-	if(currSent_ == remainSent_)
-	{
-		DEBUG_MSG(fmt::format("DataDownload::presentMainThread: proxy({}), downloadID({}), type({}), thread-continue.\n",
-			entityID(), id(), (int)type()));
-
-		return thread::TPTask::TPTASK_STATE_CONTINUE_CHILDTHREAD; 
-	}
-
 	return thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD; 
 }
 
@@ -198,9 +190,8 @@ DataDownload(objptr, descr, id)
 	}	
 	else
 	{
-		totalBytes_ = (uint32)PyBytes_GET_SIZE(pyobj);
-		stream_ = new char[totalBytes_ + 1];
-		memcpy(getOutStream(), PyBytes_AS_STRING(pyobj), totalBytes_);
+		pContent_ = DataDownloadCache::acquireString(PyBytes_AS_STRING(pyobj), (uint32)PyBytes_GET_SIZE(pyobj));
+		totalBytes_ = pContent_->size();
 		Py_DECREF(pyobj);
 	}
 }
@@ -216,17 +207,6 @@ bool StringDataDownload::process()
 	return false;
 }
 
-//-------------------------------------------------------------------------------------
-char* StringDataDownload::getOutStream()
-{
-	remainSent_ = totalBytes_ - totalSentBytes_;
-	if(remainSent_ > 65535)
-		remainSent_ = 65535;
-	
-	currSent_ = 0;
-	return stream_ + totalSentBytes_;
-}
-
 //-------------------------------------------------------------------------------------
 int8 StringDataDownload::type()
 {
@@ -239,7 +219,6 @@ FileDataDownload::FileDataDownload(PyObjectPtr objptr,
 DataDownload(objptr, descr, id)
 {
 	path_ = PyUnicode_AsUTF8AndSize(objptr.get(), NULL);
-	stream_ = new char[65537];
 }
 
 //-------------------------------------------------------------------------------------
@@ -250,30 +229,11 @@ FileDataDownload::~FileDataDownload()
 //-------------------------------------------------------------------------------------
 bool FileDataDownload::process()
 {
-	ResourceObjectPtr fptr = Resmgr::getSingleton().openResource(path_.c_str(), "rb");
-	if(fptr == NULL || !fptr->valid())
-	{
-		ERROR_MSG(fmt::format("FileDataDownload::process(): can't open {}.\n", 
-			Resmgr::getSingleton().matchRes(path_).c_str()));
-		
-		error_ = true;
-		return false;
-	}
-
-	FileObject* f = static_cast<FileObject*>(fptr.get());
-	if(totalBytes_ == 0)
-	{
-		f->seek(0, SEEK_END);
-		totalBytes_ = f->tell();
-	}
-
-	f->seek(totalSentBytes_, SEEK_SET);
-	remainSent_ = f->read(stream_, 65535);
-	currSent_ = 0;
-
-	if(remainSent_ == 0)
-		remainSent_ = totalBytes_ - totalSentBytes_;
+	// ͬһļֻᱻȡһΣĿͻ˹ͬһ
+	if(pContent_ == NULL)
+		pContent_ = DataDownloadCache::acquireFile(path_);
 
+	error_ = pContent_->error();
 	return false;
 }
 
@@ -30,6 +30,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 namespace KBEngine{
 
 class DataDownloads;
+class DataDownloadContent;
 
 class DataDownload : public thread::TPTask
 {
@@ -56,8 +57,6 @@ public:
 
 	uint32 totalBytes() const{ return totalBytes_; }
 
-	virtual char* getOutStream(){ return stream_; }
-
 	virtual int8 type() = 0;
 protected:
 	PyObjectPtr objptr_;
@@ -71,10 +70,9 @@ protected:
 
 	// ܹ͵ֽ
 	uint32 totalSentBytes_;
-	uint32 remainSent_;
-	uint32 currSent_;
 
-	char* stream_;
+	// ͬݵ
+	DataDownloadContent* pContent_;
 
 	ENTITY_ID entityID_;
 
@@ -91,8 +89,6 @@ public:
 
 	virtual bool process();
 
-	virtual char* getOutStream();
-
 	virtual int8 type();
 };
 
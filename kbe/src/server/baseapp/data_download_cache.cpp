@@ -0,0 +1,214 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "baseapp.h"
+#include "data_download_cache.h"
+#include "resmgr/resmgr.h"
+#include "common/md5.h"
+#include "thread/threadguard.h"
+
+namespace KBEngine{	
+
+uint64 DataDownloadCache::numHits = 0;
+uint64 DataDownloadCache::numLoads = 0;
+uint64 DataDownloadCache::numSentBytes = 0;
+uint64 DataDownloadCache::numThrottled = 0;
+
+DataDownloadCache::CONTENTS DataDownloadCache::contents_;
+uint64 DataDownloadCache::cachedBytes_ = 0;
+thread::ThreadMutex DataDownloadCache::mutex_;
+GAME_TIME DataDownloadCache::budgetTime_ = 0;
+uint32 DataDownloadCache::tickBudget_ = 0;
+
+//-------------------------------------------------------------------------------------
+DataDownloadContent::DataDownloadContent(const std::string& key):
+key_(key),
+datas_(),
+refs_(0),
+loaded_(false),
+error_(false),
+loadMutex_()
+{
+}
+
+//-------------------------------------------------------------------------------------
+DataDownloadContent::~DataDownloadContent()
+{
+}
+
+//-------------------------------------------------------------------------------------
+DataDownloadContent* DataDownloadCache::acquire(const std::string& key, bool& found)
+{
+	thread::ThreadGuard tg(&mutex_);
+
+	CONTENTS::iterator iter = contents_.find(key);
+	found = iter != contents_.end();
+
+	DataDownloadContent* pContent = NULL;
+
+	if(found)
+	{
+		pContent = iter->second;
+		++numHits;
+	}
+	else
+	{
+		pContent = new DataDownloadContent(key);
+		contents_[key] = pContent;
+	}
+
+	++pContent->refs_;
+	return pContent;
+}
+
+//-------------------------------------------------------------------------------------
+DataDownloadContent* DataDownloadCache::acquireFile(const std::string& path)
+{
+	bool found = false;
+	DataDownloadContent* pContent = acquire(std::string("file:") + path, found);
+
+	// ߳̿ڶȡȴɼ
+	thread::ThreadGuard tg(&pContent->loadMutex_);
+
+	if(pContent->loaded_)
+		return pContent;
+
+	pContent->loaded_ = true;
+
+	ResourceObjectPtr fptr = Resmgr::getSingleton().openResource(path.c_str(), "rb");
+	if(fptr == NULL || !fptr->valid())
+	{
+		ERROR_MSG(fmt::format("DataDownloadCache::acquireFile(): can't open {}.\n", 
+			Resmgr::getSingleton().matchRes(path).c_str()));
+
+		pContent->error_ = true;
+		return pContent;
+	}
+
+	FileObject* f = static_cast<FileObject*>(fptr.get());
+	f->seek(0, SEEK_END);
+	uint32 size = f->tell();
+	f->seek(0, SEEK_SET);
+
+	pContent->datas_.resize(size);
+
+	uint32 readSize = 0;
+	while(readSize < size)
+	{
+		uint32 len = f->read(&pContent->datas_[readSize], size - readSize);
+		if(len == 0)
+			break;
+
+		readSize += len;
+	}
+
+	if(readSize != size)
+	{
+		ERROR_MSG(fmt::format("DataDownloadCache::acquireFile(): read {} error({}/{}).\n", 
+			path, readSize, size));
+
+		pContent->error_ = true;
+		return pContent;
+	}
+
+	thread::ThreadGuard tg1(&mutex_);
+	cachedBytes_ += size;
+	++numLoads;
+	return pContent;
+}
+
+//-------------------------------------------------------------------------------------
+DataDownloadContent* DataDownloadCache::acquireString(const char* datas, uint32 size)
+{
+	std::string key = fmt::format("string:{}:{}", KBE_MD5::getDigest(datas, size), size);
+
+	bool found = false;
+	DataDownloadContent* pContent = acquire(key, found);
+
+	if(!found)
+	{
+		pContent->datas_.assign(datas, size);
+		pContent->loaded_ = true;
+
+		thread::ThreadGuard tg(&mutex_);
+		cachedBytes_ += size;
+		++numLoads;
+	}
+
+	return pContent;
+}
+
+//-------------------------------------------------------------------------------------
+void DataDownloadCache::release(DataDownloadContent* pContent)
+{
+	if(pContent == NULL)
+		return;
+
+	thread::ThreadGuard tg(&mutex_);
+
+	if(--pContent->refs_ > 0)
+		return;
+
+	cachedBytes_ -= pContent->size();
+	contents_.erase(pContent->key());
+	delete pContent;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 DataDownloadCache::consumeTickBudget(uint32 wanted)
+{
+	uint32 bitsPerSecondTotal = g_kbeSrvConfig.getBaseApp().downloadBitsPerSecondTotal;
+	if(bitsPerSecondTotal == 0)
+		return wanted;
+
+	if(budgetTime_ != g_kbetime)
+	{
+		budgetTime_ = g_kbetime;
+		tickBudget_ = bitsPerSecondTotal / 8 / g_kbeSrvConfig.gameUpdateHertz();
+	}
+
+	if(wanted > tickBudget_)
+		wanted = tickBudget_;
+
+	tickBudget_ -= wanted;
+	return wanted;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 DataDownloadCache::clientTickBudget(uint32 backlogBytes)
+{
+	uint32 bitsPerSecondPerClient = g_kbeSrvConfig.getBaseApp().downloadBitsPerSecondPerClient;
+
+	// ʱÿtickҲֻһڵݣһͻ
+	uint32 budget = bitsPerSecondPerClient > 0 ? 
+		bitsPerSecondPerClient / 8 / g_kbeSrvConfig.gameUpdateHertz() : 65535;
+
+	// һηݻѹڷʹУ˵ͻ˽ղϷϢͨ
+	if(backlogBytes >= budget)
+	{
+		++numThrottled;
+		return 0;
+	}
+
+	return budget - backlogBytes;
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,104 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_DATA_DOWNLOAD_CACHE_H
+#define KBE_DATA_DOWNLOAD_CACHE_H
+
+#include "helper/debug_helper.h"
+#include "common/common.h"
+#include "thread/threadmutex.h"
+
+namespace KBEngine{
+
+/*
+	һݱص(ļַ)ͬһݵ
+*/
+class DataDownloadContent
+{
+public:
+	DataDownloadContent(const std::string& key);
+	~DataDownloadContent();
+
+	const std::string& key() const{ return key_; }
+
+	const char* data() const{ return datas_.data(); }
+	uint32 size() const{ return (uint32)datas_.size(); }
+
+	bool error() const{ return error_; }
+
+protected:
+	friend class DataDownloadCache;
+
+	std::string key_;
+	std::string datas_;
+
+	int refs_;
+	bool loaded_;
+	bool error_;
+
+	// ֤ͬһļֻһ̶߳ȡһ
+	thread::ThreadMutex loadMutex_;
+};
+
+/*
+	ݻ棬Ѱַ(ļ·ַmd5)ͬһڴֻһݣ
+	һͷʱա
+	ͬʱÿtickܴԤ㡣
+*/
+class DataDownloadCache
+{
+public:
+	/** ȡһļݣһλȡʱȡļ߳е */
+	static DataDownloadContent* acquireFile(const std::string& path);
+
+	/** ȡһַݣͬݹһݣ߳е */
+	static DataDownloadContent* acquireString(const char* datas, uint32 size);
+
+	static void release(DataDownloadContent* pContent);
+
+	/** ӱtickعĴwantedֽڣʵʿõֽ */
+	static uint32 consumeTickBudget(uint32 wanted);
+
+	/** ÿͻ˱tickɷ͵ֽѾ۳˸ͨʹδ */
+	static uint32 clientTickBudget(uint32 backlogBytes);
+
+	static uint32 numContents(){ return (uint32)contents_.size(); }
+	static uint64 cachedBytes(){ return cachedBytes_; }
+
+	static uint64 numHits;
+	static uint64 numLoads;
+	static uint64 numSentBytes;
+	static uint64 numThrottled;
+
+private:
+	static DataDownloadContent* acquire(const std::string& key, bool& found);
+
+	typedef std::map<std::string, DataDownloadContent*> CONTENTS;
+	static CONTENTS contents_;
+	static uint64 cachedBytes_;
+	static thread::ThreadMutex mutex_;
+
+	static GAME_TIME budgetTime_;
+	static uint32 tickBudget_;
+};
+
+}
+
+#endif // KBE_DATA_DOWNLOAD_CACHE_H
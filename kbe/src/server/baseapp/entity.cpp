@@ -40,6 +40,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine{
 
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Entity");
+
 ENTITY_METHOD_DECLARE_BEGIN(Baseapp, Entity)
 SCRIPT_METHOD_DECLARE("createCellEntity",				createCellEntity,				METH_VARARGS,			0)
 SCRIPT_METHOD_DECLARE("createCellEntityInNewSpace",		createCellEntityInNewSpace,		METH_VARARGS,			0)
@@ -82,7 +85,7 @@ dbInterfaceIndex_(0)
 {
 	setDirty();
 
-	script::PyGC::incTracing("Entity");
+	script::PyGC::incTracing(g_tracingSlot);
 	ENTITY_INIT_PROPERTYS(Entity);
 
 	// ʼcellData
@@ -101,7 +104,7 @@ Entity::~Entity()
 	if(Baseapp::getSingleton().pEntities())
 		Baseapp::getSingleton().pEntities()->pGetbages()->erase(id());
 
-	script::PyGC::decTracing("Entity");
+	script::PyGC::decTracing(g_tracingSlot);
 }	
 
 //-------------------------------------------------------------------------------------
@@ -273,6 +273,10 @@ bool InitProgressHandler::process()
 
 	if(completed)
 	{
+		// ɣ ʱдǳڴĶ ȫղɨ
+		if(g_kbeSrvConfig.scriptGCFreezeAfterStartup())
+			script::PyGC::freeze();
+
 		delete this;
 		return false;
 	}
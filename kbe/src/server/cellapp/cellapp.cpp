@@ -26,6 +26,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "coordinate_node.h"
 #include "view_trigger.h"
 #include "watch_obj_pools.h"
+#include "clients_fanout.h"
 #include "cellapp_interface.h"
 #include "entity_remotemethod.h"
 #include "initprogress_handler.h"
@@ -162,6 +163,14 @@ bool Cellapp::initializeWatcher()
 	WATCH_OBJECT("load", this, &Cellapp::_getLoad);
 	WATCH_OBJECT("spaceSize", &KBEngine::getUsername);
 	WATCH_OBJECT("stats/runningTime", &runningTime);
+	WATCH_OBJECT("stats/clientsFanout/numSentMessages", ClientsFanout::numSentMessages);
+	WATCH_OBJECT("stats/clientsFanout/numSentTargets", ClientsFanout::numSentTargets);
+	WATCH_OBJECT("stats/witness/numVolatileUpdates", Witness::numVolatileUpdates);
+	WATCH_OBJECT("stats/witness/numVolatileUpdateBytes", Witness::numVolatileUpdateBytes);
+	WATCH_OBJECT("stats/witness/numEnterViews", Witness::numEnterViews);
+	WATCH_OBJECT("stats/witness/numEnterViewBytes", Witness::numEnterViewBytes);
+	WATCH_OBJECT("stats/witness/numEnterViewSnapshotHits", Witness::numEnterViewSnapshotHits);
+	WATCH_OBJECT("stats/witness/numEnterViewDeferred", Witness::numEnterViewDeferred);
 	return EntityApp<Entity>::initializeWatcher() && WatchObjectPool::initWatchPools();
 }
 
@@ -188,6 +197,7 @@ bool Cellapp::installPyModules()
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		time,							__py_gametime,											METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		createEntity,					__py_createEntity,										METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		executeRawDatabaseCommand,		__py_executeRawDatabaseCommand,							METH_VARARGS,			0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), 		executeRawDatabaseCommandStream,	__py_executeRawDatabaseCommandStream,						METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		reloadScript,					__py_reloadScript,										METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		registerReadFileDescriptor,		PyFileDescriptor::__py_registerReadFileDescriptor,		METH_VARARGS,			0);
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),		registerWriteFileDescriptor,	PyFileDescriptor::__py_registerWriteFileDescriptor,		METH_VARARGS,			0);
@@ -636,6 +646,97 @@ void Cellapp::executeRawDatabaseCommand(const char* datas, uint32 size, PyObject
 	dbmgrinfos->pChannel->send(pBundle);
 }
 
+//-------------------------------------------------------------------------------------
+PyObject* Cellapp::__py_executeRawDatabaseCommandStream(PyObject* self, PyObject* args)
+{
+	PyObject* pycallback = NULL;
+	PyObject* pyDBInterfaceName = NULL;
+	unsigned int chunkRows = 0;
+
+	char* data = NULL;
+	Py_ssize_t size;
+
+	if(!PyArg_ParseTuple(args, "s#O|IO", &data, &size, &pycallback, &chunkRows, &pyDBInterfaceName))
+	{
+		PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args error!");
+		PyErr_PrintEx(0);
+		S_Return;
+	}
+
+	if(!PyCallable_Check(pycallback))
+	{
+		PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args2 not is callable!");
+		PyErr_PrintEx(0);
+		S_Return;
+	}
+
+	std::string dbInterfaceName = "default";
+	if (pyDBInterfaceName)
+	{
+		dbInterfaceName = PyUnicode_AsUTF8AndSize(pyDBInterfaceName, NULL);
+		
+		if (!g_kbeSrvConfig.dbInterface(dbInterfaceName))
+		{
+			PyErr_Format(PyExc_TypeError, "KBEngine::executeRawDatabaseCommandStream: args4, incorrect dbInterfaceName(%s)!", 
+				dbInterfaceName.c_str());
+			
+			PyErr_PrintEx(0);
+			S_Return;
+		}
+	}
+
+	Cellapp::getSingleton().executeRawDatabaseCommandStream(data, (uint32)size, pycallback, (uint32)chunkRows, dbInterfaceName);
+	S_Return;
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::executeRawDatabaseCommandStream(const char* datas, uint32 size, PyObject* pycallback, uint32 chunkRows, const std::string& dbInterfaceName)
+{
+	if(datas == NULL)
+	{
+		ERROR_MSG("KBEngine::executeRawDatabaseCommandStream: execute error!\n");
+		return;
+	}
+
+	Components::COMPONENTS& cts = Components::getSingleton().getComponents(DBMGR_TYPE);
+	Components::ComponentInfos* dbmgrinfos = NULL;
+
+	if(cts.size() > 0)
+		dbmgrinfos = &(*cts.begin());
+	if(dbmgrinfos == NULL || dbmgrinfos->pChannel == NULL || dbmgrinfos->cid == 0)
+	{
+		ERROR_MSG("KBEngine::executeRawDatabaseCommandStream: not found dbmgr!\n");
+		return;
+	}
+
+	int dbInterfaceIndex = g_kbeSrvConfig.dbInterfaceName2dbInterfaceIndex(dbInterfaceName);
+	if (dbInterfaceIndex < 0)
+	{
+		ERROR_MSG(fmt::format("KBEngine::executeRawDatabaseCommandStream: not found dbInterface({})!\n",
+			dbInterfaceName));
+
+		return;
+	}
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(DbmgrInterface::executeRawDatabaseCommandStream);
+	(*pBundle) << (uint16)dbInterfaceIndex;
+	(*pBundle) << componentID_ << componentType_;
+	(*pBundle) << rawDBStreams_.add(pycallback);
+	(*pBundle) << chunkRows;
+	(*pBundle).appendBlob(datas, size);
+	dbmgrinfos->pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void Cellapp::onExecuteRawDatabaseCommandStreamCB(Network::Channel* pChannel, KBEngine::MemoryStream& s)
+{
+	if(pChannel->isExternal())
+		return;
+
+	rawDBStreams_.onChunk(s);
+}
+
 //-------------------------------------------------------------------------------------
 void Cellapp::onExecuteRawDatabaseCommandCB(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -819,6 +920,19 @@ void Cellapp::onDbmgrInitCompleted(Network::Channel* pChannel,
 	pInitProgressHandler_->start();
 }
 
+//-------------------------------------------------------------------------------------
+GlobalDataClient* Cellapp::findGlobalData(uint8 dataType, const char*& setCallback, const char*& delCallback)
+{
+	if(dataType == GlobalDataServer::CELLAPP_DATA)
+	{
+		setCallback = "onCellAppData";
+		delCallback = "onCellAppDataDel";
+		return pCellAppData_;
+	}
+
+	return EntityApp<Entity>::findGlobalData(dataType, setCallback, delCallback);
+}
+
 //-------------------------------------------------------------------------------------
 void Cellapp::onBroadcastCellAppDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
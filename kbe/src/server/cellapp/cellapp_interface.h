@@ -106,6 +106,7 @@ NETWORK_INTERFACE_DECLARE_BEGIN(CellappInterface)
 	CELLAPP_MESSAGE_DECLARE_STREAM(onBroadcastGlobalDataChanged,					NETWORK_VARIABLE_MESSAGE)
 	CELLAPP_MESSAGE_DECLARE_STREAM(onBroadcastCellAppDataChanged,					NETWORK_VARIABLE_MESSAGE)
 	CELLAPP_MESSAGE_DECLARE_STREAM(onBroadcastCenterDataChanged,					NETWORK_VARIABLE_MESSAGE)
+	CELLAPP_MESSAGE_DECLARE_STREAM(onBroadcastGlobalDataBatch,					NETWORK_VARIABLE_MESSAGE)
 
 	// baseEntity󴴽һµspaceС
 	CELLAPP_MESSAGE_DECLARE_STREAM(onCreateCellEntityInNewSpaceFromBaseapp,			NETWORK_VARIABLE_MESSAGE)
@@ -143,6 +144,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(CellappInterface)
 	// executeRawDatabaseCommanddbmgrĻص
 	CELLAPP_MESSAGE_DECLARE_STREAM(onExecuteRawDatabaseCommandCB,					NETWORK_VARIABLE_MESSAGE)
 
+	// executeRawDatabaseCommandStreamdbmgrصһ
+	CELLAPP_MESSAGE_DECLARE_STREAM(onExecuteRawDatabaseCommandStreamCB,			NETWORK_VARIABLE_MESSAGE)
+
 	// baseȡcelldata
 	CELLAPP_MESSAGE_DECLARE_STREAM(reqBackupEntityCellData,							NETWORK_VARIABLE_MESSAGE)
 
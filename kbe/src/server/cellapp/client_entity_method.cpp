@@ -156,7 +156,7 @@ PyObject* ClientEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 		if(ialiasID != -1)
 		{
 			KBE_ASSERT(msgHandler.msgID == ClientInterface::onRemoteMethodCallOptimized.msgID);
-			(*pSendBundle)  << (uint8)ialiasID;
+			srcEntity->pWitness()->addAliasIDToBundle(pSendBundle, ialiasID);
 		}
 		else
 		{
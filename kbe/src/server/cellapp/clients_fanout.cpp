@@ -0,0 +1,130 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "cellapp.h"
+#include "entity.h"
+#include "witness.h"
+#include "clients_fanout.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "network/message_handler.h"
+#include "../../server/baseapp/baseapp_interface.h"
+
+namespace KBEngine{	
+
+uint64 ClientsFanout::numSentMessages = 0;
+uint64 ClientsFanout::numSentTargets = 0;
+
+//-------------------------------------------------------------------------------------
+ClientsFanout::ClientsFanout(const Network::MessageHandler& normalMsgHandler, 
+	const Network::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID) :
+normalMsgHandler_(normalMsgHandler),
+optimizedMsgHandler_(optimizedMsgHandler),
+entityID_(entityID),
+pPayload_(MemoryStream::createPoolObject(OBJECTPOOL_POINT)),
+channelTargets_()
+{
+}
+
+//-------------------------------------------------------------------------------------
+ClientsFanout::~ClientsFanout()
+{
+	MemoryStream::reclaimPoolObject(pPayload_);
+}
+
+//-------------------------------------------------------------------------------------
+size_t ClientsFanout::addWitness(Entity* pViewEntity, Network::Channel* pChannel)
+{
+	int ialiasID = -1;
+	const Network::MessageHandler& msgHandler = pViewEntity->pWitness()->getViewEntityMessageHandler(normalMsgHandler_,
+		optimizedMsgHandler_, entityID_, ialiasID);
+
+	if(ialiasID != -1)
+	{
+		KBE_ASSERT(msgHandler.msgID == optimizedMsgHandler_.msgID);
+	}
+	else
+	{
+		KBE_ASSERT(msgHandler.msgID == normalMsgHandler_.msgID);
+	}
+
+	Target target;
+	target.entityID = pViewEntity->id();
+	target.aliasID = (uint16)(ialiasID != -1 ? ialiasID : 0);
+	target.aliasIDSize = (ialiasID != -1 ? pViewEntity->pWitness()->aliasIDSize() : 0);
+
+	ChannelTargets::iterator iter = channelTargets_.begin();
+	for(; iter != channelTargets_.end(); ++iter)
+	{
+		if(iter->first == pChannel)
+			break;
+	}
+
+	if(iter == channelTargets_.end())
+	{
+		channelTargets_.push_back(std::make_pair(pChannel, Targets()));
+		iter = channelTargets_.end() - 1;
+	}
+
+	iter->second.push_back(target);
+
+	return NETWORK_MESSAGE_ID_SIZE + NETWORK_MESSAGE_LENGTH_SIZE + 
+		(ialiasID != -1 ? target.aliasIDSize : sizeof(ENTITY_ID)) + pPayload_->length();
+}
+
+//-------------------------------------------------------------------------------------
+void ClientsFanout::send()
+{
+	ChannelTargets::iterator iter = channelTargets_.begin();
+	for(; iter != channelTargets_.end(); ++iter)
+	{
+		Network::Channel* pChannel = iter->first;
+		Targets& targets = iter->second;
+
+		Network::Bundle* pSendBundle = pChannel->createSendBundle();
+		(*pSendBundle).newMessage(BaseappInterface::forwardMessageToClientsFromCellapp);
+		(*pSendBundle) << normalMsgHandler_.msgID;
+		(*pSendBundle) << optimizedMsgHandler_.msgID;
+		(*pSendBundle) << entityID_;
+		(*pSendBundle).appendBlob(pPayload_->data() + pPayload_->rpos(), (ArraySize)pPayload_->length());
+		(*pSendBundle) << (uint32)targets.size();
+
+		Targets::iterator titer = targets.begin();
+		for(; titer != targets.end(); ++titer)
+		{
+			(*pSendBundle) << titer->entityID;
+			(*pSendBundle) << titer->aliasIDSize;
+
+			if(titer->aliasIDSize > 0)
+				(*pSendBundle) << titer->aliasID;
+		}
+
+		pChannel->send(pSendBundle);
+
+		++numSentMessages;
+		numSentTargets += targets.size();
+	}
+
+	channelTargets_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,92 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef KBE_CLIENTS_FANOUT_H
+#define KBE_CLIENTS_FANOUT_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "helper/debug_helper.h"
+
+namespace KBEngine{
+
+namespace Network
+{
+class Channel;
+class MessageHandler;
+}
+
+class Entity;
+
+/*
+	㲥ͻ˵ͬһϢ(allClientsotherClientsOTHER_CLIENTS)
+	۲ڵbaseappϲһforwardMessageToClientsFromCellappϢֻЯһΣ
+	baseappյٰĿбƵÿͻ(ҰĿʹñID)
+*/
+class ClientsFanout
+{
+public:
+	ClientsFanout(const Network::MessageHandler& normalMsgHandler, 
+		const Network::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID);
+
+	~ClientsFanout();
+
+	MemoryStream& payload() { return *pPayload_; }
+
+	/**
+		һ۲ߣ۲ߵĿͻյϢ
+	*/
+	size_t addWitness(Entity* pViewEntity, Network::Channel* pChannel);
+
+	/**
+		ÿĿbaseappһϢ
+	*/
+	void send();
+
+	static uint64 numSentMessages;
+	static uint64 numSentTargets;
+
+private:
+	struct Target
+	{
+		ENTITY_ID entityID;
+		uint16 aliasID;
+
+		// IDֽ 0ʾʹentityID
+		uint8 aliasIDSize;
+	};
+
+	typedef std::vector<Target> Targets;
+
+	// baseapp٣ԲҼɣͬʱ״γֵ˳
+	typedef std::vector< std::pair<Network::Channel*, Targets> > ChannelTargets;
+
+	const Network::MessageHandler& normalMsgHandler_;
+	const Network::MessageHandler& optimizedMsgHandler_;
+	ENTITY_ID entityID_;
+
+	MemoryStream* pPayload_;
+	ChannelTargets channelTargets_;
+};
+
+}
+
+#endif // KBE_CLIENTS_FANOUT_H
@@ -20,6 +20,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "witness.h"
 #include "cellapp.h"
+#include "clients_fanout.h"
 #include "entitydef/method.h"
 #include "clients_remote_entity_method.h"
 #include "network/bundle.h"
@@ -158,7 +159,12 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			pEntity->pWitness()->sendToClient(ClientInterface::onRemoteMethodCall, pSendBundle);
 		}
 
-		// 㲥
+		// 㲥ˣbaseappϲϢֻһ
+		ClientsFanout fanout(ClientInterface::onRemoteMethodCall, ClientInterface::onRemoteMethodCallOptimized, pEntity->id());
+
+		if(mstream->wpos() > 0)
+			fanout.payload().append(mstream->data(), mstream->wpos());
+
 		std::list<ENTITY_ID>::const_iterator iter = entities.begin();
 		for(; iter != entities.end(); ++iter)
 		{
@@ -179,29 +185,7 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 			if (!pViewEntity->pWitness()->entityInView(pEntity->id()))
 				continue;
 			
-			Network::Bundle* pSendBundle = pChannel->createSendBundle();
-			NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pViewEntity->id(), (*pSendBundle));
-			
-			int ialiasID = -1;
-			const Network::MessageHandler& msgHandler = 
-			pViewEntity->pWitness()->getViewEntityMessageHandler(ClientInterface::onRemoteMethodCall,
-					ClientInterface::onRemoteMethodCallOptimized, pEntity->id(), ialiasID);
-
-			ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, msgHandler, viewEntityMessage);
-
-			if(ialiasID != -1)
-			{
-				KBE_ASSERT(msgHandler.msgID == ClientInterface::onRemoteMethodCallOptimized.msgID);
-				(*pSendBundle)  << (uint8)ialiasID;
-			}
-			else
-			{
-				KBE_ASSERT(msgHandler.msgID == ClientInterface::onRemoteMethodCall.msgID);
-				(*pSendBundle)  << pEntity->id();
-			}
-
-			if(mstream->wpos() > 0)
-				(*pSendBundle).append(mstream->data(), (int)mstream->wpos());
+			size_t msgLength = fanout.addWitness(pViewEntity, pChannel);
 
 			if(Network::g_trace_packet > 0)
 			{
@@ -228,17 +212,15 @@ PyObject* ClientsRemoteEntityMethod::callmethod(PyObject* args, PyObject* kwds)
 					DebugHelper::getSingleton().changeLogger(COMPONENT_NAME_EX(g_componentType));
 			}
 
-			ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, msgHandler, viewEntityMessage);
-
 			// ¼¼С
 			g_publicClientEventHistoryStats.trackEvent(pViewEntity->scriptName(),
 				methodDescription->getName(), 
-				pSendBundle->currMsgLength(), 
+				msgLength, 
 				"::");
-
-			pViewEntity->pWitness()->sendToClient(ClientInterface::onRemoteMethodCallOptimized, pSendBundle);
 		}
 
+		fanout.send();
+
 		MemoryStream::reclaimPoolObject(mstream);
 	}
 
@@ -27,6 +27,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "range_trigger.h"
 #include "all_clients.h"
 #include "client_entity.h"
+#include "clients_fanout.h"
 #include "controllers.h"	
 #include "real_entity_method.h"
 #include "entity_coordinate_node.h"
@@ -61,6 +62,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 namespace KBEngine{
 
 //-------------------------------------------------------------------------------------
+// PyGC׷ٴĲλ
+static int32 g_tracingSlot = script::PyGC::registerTracing("Entity");
+
 ENTITY_METHOD_DECLARE_BEGIN(Cellapp, Entity)
 SCRIPT_METHOD_DECLARE("setViewRadius",				pySetViewRadius,				METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("getViewRadius",				pyGetViewRadius,				METH_VARARGS,				0)
@@ -78,6 +82,11 @@ SCRIPT_METHOD_DECLARE("moveToPoint",				pyMoveToPoint,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("moveToEntity",				pyMoveToEntity,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("accelerate",					pyAccelerate,					METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("entitiesInRange",			pyEntitiesInRange,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("entitiesInBox",				pyEntitiesInBox,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("entitiesInSector",			pyEntitiesInSector,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("entitiesInSegment",			pyEntitiesInSegment,			METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("entitiesNearest",			pyEntitiesNearest,				METH_VARARGS,				0)
+SCRIPT_METHOD_DECLARE("entitiesInRangeMulti",		pyEntitiesInRangeMulti,			METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("entitiesInView",				pyEntitiesInView,				METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("teleport",					pyTeleport,						METH_VARARGS,				0)
 SCRIPT_METHOD_DECLARE("destroySpace",				pyDestroySpace,					METH_VARARGS,				0)
@@ -158,6 +167,7 @@ pyLocalPositionChangedCallback_(),
 pyLocalDirectionChangedCallback_(),
 layer_(0),
 pCustomVolatileinfo_(NULL),
+pClientSnapshot_(NULL),
 pParent_(NULL),
 children_()
 {
@@ -180,7 +190,7 @@ children_()
 		pEntityCoordinateNode_ = new EntityCoordinateNode(this);
 	}
 
-	script::PyGC::incTracing("Entity");
+	script::PyGC::incTracing(g_tracingSlot);
 }
 
 //-------------------------------------------------------------------------------------
@@ -189,6 +199,7 @@ Entity::~Entity()
 	ENTITY_DECONSTRUCTION(Entity);
 
 	S_RELEASE(pCustomVolatileinfo_);
+	invalidateClientSnapshot();
 
 	S_RELEASE(clientEntityCall_);
 	S_RELEASE(baseEntityCall_);
@@ -215,7 +226,7 @@ Entity::~Entity()
 	if(Cellapp::getSingleton().pEntities())
 		Cellapp::getSingleton().pEntities()->pGetbages()->erase(id());
 
-	script::PyGC::decTracing("Entity");
+	script::PyGC::decTracing(g_tracingSlot);
 }	
 
 //-------------------------------------------------------------------------------------
@@ -706,14 +717,18 @@ PyObject* Entity::onScriptGetAttribute(PyObject* attr)
 //-------------------------------------------------------------------------------------
 void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, PyObject* pyData, bool dontNotifySelf)
 {
+	uint32 flags = propertyDescription->getFlags();
+
+	// ghostҲɴ˴£ жreal֮ǰÿʧЧ
+	if((flags & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) > 0)
+		invalidateClientSnapshot();
+
 	// һrealEntityڳʼ
 	if(!isReal() || initing())
 		return;
 
 	if(propertyDescription->isPersistent())
 		setDirty();
-	
-	uint32 flags = propertyDescription->getFlags();
 
 	// ȴһҪ㲥ģ
 	MemoryStream* mstream = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
@@ -748,6 +763,16 @@ void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, Py
 	{
 		DETAIL_TYPE propertyDetailLevel = propertyDescription->getDetailLevel();
 
+		// baseappϲϢֻһ
+		ClientsFanout fanout(ClientInterface::onUpdatePropertys, ClientInterface::onUpdatePropertysOptimized, id());
+
+		if(pScriptModule_->usePropertyDescrAlias())
+			fanout.payload() << propertyDescription->aliasIDAsUint8();
+		else
+			fanout.payload() << propertyDescription->getUType();
+
+		fanout.payload().append(*mstream);
+
 		std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
 		for(; witer != witnesses_.end(); ++witer)
 		{
@@ -773,43 +798,16 @@ void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, Py
 
 			if(pScriptModule_->getDetailLevel().level[propertyDetailLevel].inLevel(lengthPos.length()))
 			{
-				Network::Bundle* pSendBundle = pChannel->createSendBundle();
-				NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity->id(), (*pSendBundle));
-				
-				int ialiasID = -1;
-				const Network::MessageHandler& msgHandler = pEntity->pWitness()->getViewEntityMessageHandler(ClientInterface::onUpdatePropertys, 
-					ClientInterface::onUpdatePropertysOptimized, id(), ialiasID);
-				
-				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, msgHandler, viewEntityMessage);
-				
-				if(ialiasID != -1)
-				{
-					KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertysOptimized.msgID);
-					(*pSendBundle)  << (uint8)ialiasID;
-				}
-				else
-				{
-					KBE_ASSERT(msgHandler.msgID == ClientInterface::onUpdatePropertys.msgID);
-					(*pSendBundle)  << id();
-				}
-				
-				if(pScriptModule_->usePropertyDescrAlias())
-					(*pSendBundle) << propertyDescription->aliasIDAsUint8();
-				else
-					(*pSendBundle) << propertyDescription->getUType();
+				size_t msgLength = fanout.addWitness(pEntity, pChannel);
 
-				pSendBundle->append(*mstream);
-				
 				// ¼¼С
 				g_publicClientEventHistoryStats.trackEvent(scriptName(), 
 					propertyDescription->getName(), 
-					pSendBundle->currMsgLength());
-
-				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, msgHandler, viewEntityMessage);
-
-				pEntity->pWitness()->sendToClient(ClientInterface::onUpdatePropertysOptimized, pSendBundle);
+					msgLength);
 			}
 		}
+
+		fanout.send();
 	}
 
 	/*
@@ -1376,10 +1374,97 @@ void Entity::delWitnessed(Entity* entity)
 	// ʱִ
 	// onDelWitnessed();
 
+	// ûй۲ˣ ҲûбıҪ
+	if (witnesses_count_ == 0)
+		invalidateClientSnapshot();
+
 	if(Cellapp::getSingleton().pWitnessedTimeoutHandler())
 		Cellapp::getSingleton().pWitnessedTimeoutHandler()->addWitnessed(this);
 }
 
+//-------------------------------------------------------------------------------------
+bool Entity::addClientSnapshotToStream(MemoryStream* s)
+{
+	bool cached = pClientSnapshot_ != NULL;
+
+	if (!cached)
+	{
+		pClientSnapshot_ = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+		addOtherClientDataToStream(pClientSnapshot_, true);
+	}
+
+	s->append(*pClientSnapshot_);
+
+	// ͵ԿԱԭ޸(self.items.append(x)) ᾭonDefDataChanged ܻ
+	addOtherClientDataToStream(s, false);
+	return cached;
+}
+
+//-------------------------------------------------------------------------------------
+static bool isSnapshotDataType(DataType* pDataType)
+{
+	switch(pDataType->type())
+	{
+	case DATA_TYPE_STRING:
+	case DATA_TYPE_DIGIT:
+	case DATA_TYPE_BLOB:
+	case DATA_TYPE_UNICODE:
+	case DATA_TYPE_ENTITYCALL:
+		return true;
+	default:
+		break;
+	};
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::addOtherClientDataToStream(MemoryStream* s, bool snapshotTypes)
+{
+	PyObject* pydict = PyObject_GetAttrString(this, "__dict__");
+	if(pydict == NULL)
+	{
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP& propertyDescrs = pScriptModule()->getClientPropertyDescriptions();
+	ScriptDefModule::PROPERTYDESCRIPTION_MAP::iterator iter = propertyDescrs.begin();
+	for(; iter != propertyDescrs.end(); ++iter)
+	{
+		PropertyDescription* propertyDescription = iter->second;
+		if((propertyDescription->getFlags() & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) <= 0)
+			continue;
+
+		DataType* pDataType = propertyDescription->getDataType();
+		if(isSnapshotDataType(pDataType) != snapshotTypes)
+			continue;
+
+		PyObject* pyVal = PyDict_GetItemString(pydict, propertyDescription->getName());
+		if(pyVal == NULL)
+			continue;
+
+		if(pScriptModule()->usePropertyDescrAlias())
+			(*s) << propertyDescription->aliasIDAsUint8();
+		else
+			(*s) << propertyDescription->getUType();
+
+		pDataType->addToStream(s, pyVal);
+	}
+
+	Py_DECREF(pydict);
+}
+
+//-------------------------------------------------------------------------------------
+void Entity::invalidateClientSnapshot()
+{
+	if (pClientSnapshot_ == NULL)
+		return;
+
+	MemoryStream::reclaimPoolObject(pClientSnapshot_);
+	pClientSnapshot_ = NULL;
+}
+
 //-------------------------------------------------------------------------------------
 void Entity::onDelWitnessed()
 {
@@ -3411,6 +3496,350 @@ PyObject* Entity::__py_pyEntitiesInRange(PyObject* self, PyObject* args)
 	return pyList;
 }
 
+//-------------------------------------------------------------------------------------
+static bool checkSpatialQueryEntity(Entity* pobj, const char* funcName)
+{
+	if (!pobj->isReal())
+	{
+		PyErr_Format(PyExc_AssertionError, "%s::%s: not is real entity(%d).",
+			pobj->scriptName(), funcName, pobj->id());
+		PyErr_PrintEx(0);
+		return false;
+	}
+
+	if (pobj->isDestroyed() && !pobj->hasFlags(ENTITY_FLAGS_DESTROYING) /* ڼ */)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::%s: entity(%d) is destroyed!",
+			pobj->scriptName(), funcName, pobj->id());
+		PyErr_PrintEx(0);
+		return false;
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool parseSpatialQueryEntityType(Entity* pobj, const char* funcName, PyObject* pyEntityType, 
+	int& entityUType, bool& foundType)
+{
+	entityUType = -1;
+	foundType = true;
+
+	if (pyEntityType == NULL || pyEntityType == Py_None)
+		return true;
+
+	if (!PyUnicode_Check(pyEntityType))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::%s: args(entityType) error! entity(%d)",
+			pobj->scriptName(), funcName, pobj->id());
+		PyErr_PrintEx(0);
+		return false;
+	}
+
+	ScriptDefModule* sm = EntityDef::findScriptModule(PyUnicode_AsUTF8AndSize(pyEntityType, NULL));
+	if (sm == NULL)
+	{
+		foundType = false;
+		return true;
+	}
+
+	entityUType = sm->getUType();
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static bool parseSpatialQueryPosition(Entity* pobj, const char* funcName, const char* argName, 
+	PyObject* pyPosition, Position3D& pos)
+{
+	if (pyPosition == NULL || pyPosition == Py_None)
+		return true;
+
+	if (!PySequence_Check(pyPosition) || PySequence_Size(pyPosition) < 3)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::%s: args(%s) error! entity(%d)",
+			pobj->scriptName(), funcName, argName, pobj->id());
+		PyErr_PrintEx(0);
+		return false;
+	}
+
+	script::ScriptVector3::convertPyObjectToVector3(pos, pyPosition);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+static PyObject* spatialQueryResultsToPyList(const std::vector<Entity*>& foundEntities)
+{
+	PyObject* pyList = PyList_New(foundEntities.size());
+
+	for (size_t i = 0; i < foundEntities.size(); ++i)
+	{
+		Entity* pEntity = foundEntities[i];
+		Py_INCREF(pEntity);
+		PyList_SET_ITEM(pyList, i, pEntity);
+	}
+
+	return pyList;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::__py_pyEntitiesInBox(PyObject* self, PyObject* args)
+{
+	Entity* pobj = static_cast<Entity*>(self);
+
+	if (!checkSpatialQueryEntity(pobj, "entitiesInBox"))
+		return 0;
+
+	PyObject* pyMinPosition = NULL, *pyMaxPosition = NULL, *pyEntityType = NULL;
+
+	if (!PyArg_ParseTuple(args, "OO|O", &pyMinPosition, &pyMaxPosition, &pyEntityType) ||
+		pyMinPosition == Py_None || pyMaxPosition == Py_None)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::entitiesInBox: args error! entity(%d)",
+			pobj->scriptName(), pobj->id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D minPos, maxPos;
+	if (!parseSpatialQueryPosition(pobj, "entitiesInBox", "minPosition", pyMinPosition, minPos) ||
+		!parseSpatialQueryPosition(pobj, "entitiesInBox", "maxPosition", pyMaxPosition, maxPos))
+		return 0;
+
+	int entityUType = -1;
+	bool foundType = true;
+	if (!parseSpatialQueryEntityType(pobj, "entitiesInBox", pyEntityType, entityUType, foundType))
+		return 0;
+
+	if (!foundType || !pobj->pEntityCoordinateNode())
+		return PyList_New(0);
+
+	// еСֵߵ
+	Position3D boxMin(std::min(minPos.x, maxPos.x), std::min(minPos.y, maxPos.y), std::min(minPos.z, maxPos.z));
+	Position3D boxMax(std::max(minPos.x, maxPos.x), std::max(minPos.y, maxPos.y), std::max(minPos.z, maxPos.z));
+
+	std::vector<Entity*> findentities;
+	EntityCoordinateNode::entitiesInBox(findentities, pobj->pEntityCoordinateNode(), boxMin, boxMax, entityUType);
+	return spatialQueryResultsToPyList(findentities);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::__py_pyEntitiesInSector(PyObject* self, PyObject* args)
+{
+	Entity* pobj = static_cast<Entity*>(self);
+
+	if (!checkSpatialQueryEntity(pobj, "entitiesInSector"))
+		return 0;
+
+	PyObject* pyEntityType = NULL, *pyPosition = NULL, *pyYaw = NULL;
+	float radius = 0.f, angle = 0.f;
+
+	if (!PyArg_ParseTuple(args, "ff|OOO", &radius, &angle, &pyEntityType, &pyPosition, &pyYaw))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::entitiesInSector: args error! entity(%d)",
+			pobj->scriptName(), pobj->id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D originpos = pobj->position();
+	if (!parseSpatialQueryPosition(pobj, "entitiesInSector", "position", pyPosition, originpos))
+		return 0;
+
+	float yaw = pobj->direction().yaw();
+	if (pyYaw && pyYaw != Py_None)
+	{
+		if (!PyFloat_Check(pyYaw) && !PyLong_Check(pyYaw))
+		{
+			PyErr_Format(PyExc_TypeError, "%s::entitiesInSector: args(yaw) error! entity(%d)",
+				pobj->scriptName(), pobj->id());
+			PyErr_PrintEx(0);
+			return 0;
+		}
+
+		yaw = (float)PyFloat_AsDouble(pyYaw);
+	}
+
+	int entityUType = -1;
+	bool foundType = true;
+	if (!parseSpatialQueryEntityType(pobj, "entitiesInSector", pyEntityType, entityUType, foundType))
+		return 0;
+
+	if (!foundType || !pobj->pEntityCoordinateNode())
+		return PyList_New(0);
+
+	std::vector<Entity*> findentities;
+	EntityCoordinateNode::entitiesInSector(findentities, pobj->pEntityCoordinateNode(), originpos, yaw, radius, angle, entityUType);
+	return spatialQueryResultsToPyList(findentities);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::__py_pyEntitiesInSegment(PyObject* self, PyObject* args)
+{
+	Entity* pobj = static_cast<Entity*>(self);
+
+	if (!checkSpatialQueryEntity(pobj, "entitiesInSegment"))
+		return 0;
+
+	PyObject* pyEndPosition = NULL, *pyEntityType = NULL, *pyStartPosition = NULL;
+	float width = 0.f;
+
+	if (!PyArg_ParseTuple(args, "Of|OO", &pyEndPosition, &width, &pyEntityType, &pyStartPosition) || 
+		pyEndPosition == Py_None)
+	{
+		PyErr_Format(PyExc_TypeError, "%s::entitiesInSegment: args error! entity(%d)",
+			pobj->scriptName(), pobj->id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D startPos = pobj->position();
+	Position3D endPos;
+
+	if (!parseSpatialQueryPosition(pobj, "entitiesInSegment", "endPosition", pyEndPosition, endPos) ||
+		!parseSpatialQueryPosition(pobj, "entitiesInSegment", "startPosition", pyStartPosition, startPos))
+		return 0;
+
+	int entityUType = -1;
+	bool foundType = true;
+	if (!parseSpatialQueryEntityType(pobj, "entitiesInSegment", pyEntityType, entityUType, foundType))
+		return 0;
+
+	if (!foundType || !pobj->pEntityCoordinateNode())
+		return PyList_New(0);
+
+	std::vector<Entity*> findentities;
+	EntityCoordinateNode::entitiesInSegment(findentities, pobj->pEntityCoordinateNode(), startPos, endPos, width, entityUType);
+	return spatialQueryResultsToPyList(findentities);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::__py_pyEntitiesNearest(PyObject* self, PyObject* args)
+{
+	Entity* pobj = static_cast<Entity*>(self);
+
+	if (!checkSpatialQueryEntity(pobj, "entitiesNearest"))
+		return 0;
+
+	PyObject* pyEntityType = NULL, *pyPosition = NULL;
+	uint32 count = 0;
+	float radius = 0.f;
+
+	if (!PyArg_ParseTuple(args, "If|OO", &count, &radius, &pyEntityType, &pyPosition))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::entitiesNearest: args error! entity(%d)",
+			pobj->scriptName(), pobj->id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	Position3D originpos = pobj->position();
+	if (!parseSpatialQueryPosition(pobj, "entitiesNearest", "position", pyPosition, originpos))
+		return 0;
+
+	int entityUType = -1;
+	bool foundType = true;
+	if (!parseSpatialQueryEntityType(pobj, "entitiesNearest", pyEntityType, entityUType, foundType))
+		return 0;
+
+	if (!foundType || !pobj->pEntityCoordinateNode())
+		return PyList_New(0);
+
+	std::vector<Entity*> findentities;
+	EntityCoordinateNode::entitiesNearest(findentities, pobj->pEntityCoordinateNode(), originpos, count, radius, entityUType);
+	return spatialQueryResultsToPyList(findentities);
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Entity::__py_pyEntitiesInRangeMulti(PyObject* self, PyObject* args)
+{
+	Entity* pobj = static_cast<Entity*>(self);
+
+	if (!checkSpatialQueryEntity(pobj, "entitiesInRangeMulti"))
+		return 0;
+
+	PyObject* pyPositions = NULL, *pyEntityType = NULL, *pyResults = NULL;
+	float radius = 0.f;
+
+	if (!PyArg_ParseTuple(args, "Of|OO", &pyPositions, &radius, &pyEntityType, &pyResults) || 
+		!PySequence_Check(pyPositions) || (pyResults && pyResults != Py_None && !PyList_Check(pyResults)))
+	{
+		PyErr_Format(PyExc_TypeError, "%s::entitiesInRangeMulti: args error! entity(%d)",
+			pobj->scriptName(), pobj->id());
+		PyErr_PrintEx(0);
+		return 0;
+	}
+
+	int entityUType = -1;
+	bool foundType = true;
+	if (!parseSpatialQueryEntityType(pobj, "entitiesInRangeMulti", pyEntityType, entityUType, foundType))
+		return 0;
+
+	Py_ssize_t size = PySequence_Size(pyPositions);
+
+	// Ƚȫĵ㣬κһĶűĽб
+	static std::vector<Position3D> positions;
+	positions.clear();
+
+	for (Py_ssize_t i = 0; i < size; ++i)
+	{
+		PyObject* pyPosition = PySequence_GetItem(pyPositions, i);
+
+		if (pyPosition == NULL || pyPosition == Py_None)
+		{
+			Py_XDECREF(pyPosition);
+
+			PyErr_Format(PyExc_TypeError, "%s::entitiesInRangeMulti: args(positions[%d]) is None! entity(%d)",
+				pobj->scriptName(), (int)i, pobj->id());
+			PyErr_PrintEx(0);
+			return 0;
+		}
+
+		Position3D originpos;
+		bool ret = parseSpatialQueryPosition(pobj, "entitiesInRangeMulti", "positions", pyPosition, originpos);
+		Py_DECREF(pyPosition);
+
+		if (!ret)
+			return 0;
+
+		positions.push_back(originpos);
+	}
+
+	// űԴһlistʹãÿβѯб
+	if (pyResults && pyResults != Py_None)
+	{
+		PyList_SetSlice(pyResults, 0, PyList_GET_SIZE(pyResults), NULL);
+		Py_INCREF(pyResults);
+	}
+	else
+	{
+		pyResults = PyList_New(0);
+	}
+
+	// ÿĵĽֻʵIDѯڶε֮临
+	static std::vector<Entity*> findentities;
+
+	std::vector<Position3D>::const_iterator iter = positions.begin();
+	for (; iter != positions.end(); ++iter)
+	{
+		const Position3D& originpos = (*iter);
+		findentities.clear();
+
+		if (foundType && pobj->pEntityCoordinateNode())
+			EntityCoordinateNode::entitiesInRange(findentities, pobj->pEntityCoordinateNode(), originpos, radius, entityUType);
+
+		PyObject* pyIDs = PyTuple_New(findentities.size());
+
+		for (size_t j = 0; j < findentities.size(); ++j)
+			PyTuple_SET_ITEM(pyIDs, j, PyLong_FromLong(findentities[j]->id()));
+
+		PyList_Append(pyResults, pyIDs);
+		Py_DECREF(pyIDs);
+	}
+
+	findentities.clear();
+	return pyResults;
+}
+
 //-------------------------------------------------------------------------------------
 void Entity::_sendBaseTeleportResult(ENTITY_ID sourceEntityID, COMPONENT_ID sourceBaseAppID, SPACE_ID spaceID, SPACE_ID lastSpaceID, bool fromCellTeleport)
 {
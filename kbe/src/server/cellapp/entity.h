@@ -405,6 +405,23 @@ public:
 	*/
 	static PyObject* __py_pyEntitiesInRange(PyObject* self, PyObject* args);
 
+	/** 
+		űĳ״Χڵĳ͵entities 
+	*/
+	static PyObject* __py_pyEntitiesInBox(PyObject* self, PyObject* args);
+	static PyObject* __py_pyEntitiesInSector(PyObject* self, PyObject* args);
+	static PyObject* __py_pyEntitiesInSegment(PyObject* self, PyObject* args);
+
+	/** 
+		űĳλɸentities 
+	*/
+	static PyObject* __py_pyEntitiesNearest(PyObject* self, PyObject* args);
+
+	/** 
+		űһĵķΧѯÿĵ㷵һentityID 
+	*/
+	static PyObject* __py_pyEntitiesInRangeMulti(PyObject* self, PyObject* args);
+
 	/** 
 		űViewΧڵentities 
 	*/
@@ -448,6 +465,16 @@ public:
 	*/
 	void addWitnessed(Entity* entity);
 
+	/** 
+		ͻ˿ɼԿд ڵһʹʱ벢棬
+		ͻ˿ɼԸıʧЧ ۲ͬʱentityʱֻҪ
+		ȿԱԭ޸ĵԲգ ÿ±
+		@return: Ƿ˻
+	*/
+	bool addClientSnapshotToStream(MemoryStream* s);
+	void invalidateClientSnapshot();
+	void addOtherClientDataToStream(MemoryStream* s, bool snapshotTypes);
+
 	/** 
 		Ƴһ۲Ĺ۲ 
 	*/
@@ -793,6 +820,9 @@ protected:
 	// ûùVolatileinfo˴VolatileinfoΪNULLʹScriptDefModuleVolatileinfo
 	VolatileInfo*											pCustomVolatileinfo_;
 
+	// ͻ˿ɼԵı룬 ΪNULLʾҪ±
+	MemoryStream*											pClientSnapshot_;
+
 	// Entity
 	Entity*													pParent_;
 	CHILD_ENTITIES											children_;
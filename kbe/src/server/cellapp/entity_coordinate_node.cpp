@@ -19,6 +19,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <iterator>
+#include <queue>
 #include "entity_coordinate_node.h"
 #include "entity.h"
 #include "coordinate_system.h"
@@ -229,80 +230,263 @@ CoordinateNode* findNearestNode(CoordinateNode* rootNode, const Position3D& orig
 	}
 }
 
+//-------------------------------------------------------------------------------------
+INLINE bool isEntityTypeMatched(Entity* pEntity, int entityUType)
+{
+	return entityUType == -1 || pEntity->pScriptModule()->getUType() == (ENTITY_SCRIPT_UID)entityUType;
+}
+
+//-------------------------------------------------------------------------------------
+INLINE bool isValidEntityNode(CoordinateNode* pNode)
+{
+	return pNode->hasFlags(COORDINATE_NODE_FLAG_ENTITY) && !pNode->hasFlags(COORDINATE_NODE_FLAG_HIDE_OR_REMOVED);
+}
+
 //-------------------------------------------------------------------------------------
 /**
- һϷϷΧentity
- ģ NODEWRAP ȡֵΪ֮һ
-   - CoordinateNodeWrapX
-   - CoordinateNodeWrapZ
-   - CoordinateNodeWrapY
+ λ֮ƽûYʱֻxzƽ
 */
-template <class NODEWRAP>
-void entitiesInAxisRange(std::set<Entity*>& foundEntities, CoordinateNode* rootNode,
-	const Position3D& originPos, float radius, int entityUType)
+INLINE float distanceSquared(const Position3D& pos1, const Position3D& pos2)
+{
+	float dx = pos1.x - pos2.x;
+	float dz = pos1.z - pos2.z;
+	float dy = CoordinateSystem::hasY ? pos1.y - pos2.y : 0.f;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+//-------------------------------------------------------------------------------------
+/**
+ X[minX, maxX]֮entityVISITORȷ״ж
+ ֻҪһϱҪ3Ľ󽻼
+*/
+template <class VISITOR>
+void visitEntitiesInXRange(CoordinateNode* rootNode, float minX, float maxX, int entityUType, VISITOR& visitor)
 {
-	CoordinateNode* pCoordinateNode = findNearestNode<NODEWRAP>(rootNode, originPos);
+	Position3D centerPos(0.f, 0.f, 0.f);
+	centerPos.x = (minX + maxX) * 0.5f;
+
+	CoordinateNode* pCoordinateNode = findNearestNode<CoordinateNodeWrapX>(rootNode, centerPos);
 	if (!pCoordinateNode)
 		return;
 
-	NODEWRAP wrap(pCoordinateNode, originPos);
+	CoordinateNodeWrapX wrap(pCoordinateNode, centerPos);
 
-	// ڵԼҲԼӽȥ
 	if (wrap.isEntityNode() && wrap.valid())
 	{
 		Entity* pEntity = wrap.currentNodeEntity();
+		float x = pEntity->position().x;
 
-		if (entityUType == -1 || pEntity->pScriptModule()->getUType() == (ENTITY_SCRIPT_UID)entityUType)
-		{
-			if (wrap.length() <= radius)
-			{
-				foundEntities.insert(pEntity);
-			}
-		}
+		if (x >= minX && x <= maxX && isEntityTypeMatched(pEntity, entityUType))
+			visitor(pEntity);
 	}
 
 	while (wrap.prev())
 	{
-		if (wrap.isEntityNode() && wrap.valid())
-		{
-			Entity* pEntity = wrap.currentNodeEntity();
+		if (!wrap.isEntityNode() || !wrap.valid())
+			continue;
 
-			if (entityUType == -1 || pEntity->pScriptModule()->getUType() == (ENTITY_SCRIPT_UID)entityUType)
-			{
-				if (wrap.length() <= radius)
-				{
-					foundEntities.insert(pEntity);
-				}
-				else
-				{
-					break;
-				}
-			}
-		}
+		Entity* pEntity = wrap.currentNodeEntity();
+
+		// X򣬳ΧߵĽڵֻԶ
+		if (pEntity->position().x < minX)
+			break;
+
+		if (isEntityTypeMatched(pEntity, entityUType))
+			visitor(pEntity);
 	};
 
 	wrap.reset();
 
 	while (wrap.next())
 	{
-		if (wrap.isEntityNode() && wrap.valid())
+		if (!wrap.isEntityNode() || !wrap.valid())
+			continue;
+
+		Entity* pEntity = wrap.currentNodeEntity();
+
+		if (pEntity->position().x > maxX)
+			break;
+
+		if (isEntityTypeMatched(pEntity, entityUType))
+			visitor(pEntity);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+typedef std::pair<float, Entity*> NEAREST_ENTITY;
+typedef std::priority_queue<NEAREST_ENTITY> NEAREST_ENTITIES;
+
+INLINE void addNearestEntity(NEAREST_ENTITIES& nearestEntities, uint32 count, float radiusSq,
+	const Position3D& originPos, Entity* pEntity, int entityUType)
+{
+	if (!isEntityTypeMatched(pEntity, entityUType))
+		return;
+
+	float lengthSq = distanceSquared(pEntity->position(), originPos);
+	if (lengthSq > radiusSq)
+		return;
+
+	if (nearestEntities.size() < count)
+	{
+		nearestEntities.push(NEAREST_ENTITY(lengthSq, pEntity));
+	}
+	else if (lengthSq < nearestEntities.top().first)
+	{
+		nearestEntities.pop();
+		nearestEntities.push(NEAREST_ENTITY(lengthSq, pEntity));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+class RangeQueryVisitor
+{
+public:
+	RangeQueryVisitor(std::vector<Entity*>& foundEntities, const Position3D& originPos, float radius) :
+		foundEntities_(foundEntities),
+		originPos_(originPos),
+		radius_(radius) {}
+
+	INLINE void operator()(Entity* pEntity) {
+		const Position3D& pos = pEntity->position();
+
+		if (fabs(pos.z - originPos_.z) > radius_)
+			return;
+
+		if (CoordinateSystem::hasY && fabs(pos.y - originPos_.y) > radius_)
+			return;
+
+		foundEntities_.push_back(pEntity);
+	}
+
+protected:
+	std::vector<Entity*>& foundEntities_;
+	const Position3D& originPos_;
+	float radius_;
+};
+
+//-------------------------------------------------------------------------------------
+class BoxQueryVisitor
+{
+public:
+	BoxQueryVisitor(std::vector<Entity*>& foundEntities, const Position3D& minPos, const Position3D& maxPos) :
+		foundEntities_(foundEntities),
+		minPos_(minPos),
+		maxPos_(maxPos) {}
+
+	INLINE void operator()(Entity* pEntity) {
+		const Position3D& pos = pEntity->position();
+
+		if (pos.z < minPos_.z || pos.z > maxPos_.z)
+			return;
+
+		if (CoordinateSystem::hasY && (pos.y < minPos_.y || pos.y > maxPos_.y))
+			return;
+
+		foundEntities_.push_back(pEntity);
+	}
+
+protected:
+	std::vector<Entity*>& foundEntities_;
+	const Position3D& minPos_;
+	const Position3D& maxPos_;
+};
+
+//-------------------------------------------------------------------------------------
+class SectorQueryVisitor
+{
+public:
+	SectorQueryVisitor(std::vector<Entity*>& foundEntities, const Position3D& originPos, 
+		float yaw, float radius, float angle) :
+		foundEntities_(foundEntities),
+		originPos_(originPos),
+		dirX_(sinf(yaw)),
+		dirZ_(cosf(yaw)),
+		radius_(radius),
+		cosHalfAngle_(cosf(angle * 0.5f)),
+		fullCircle_(angle >= KBE_2PI) {}
+
+	INLINE void operator()(Entity* pEntity) {
+		const Position3D& pos = pEntity->position();
+
+		if (CoordinateSystem::hasY && fabs(pos.y - originPos_.y) > radius_)
+			return;
+
+		// xzƽжϣVector3::yaw()һ
+		float dx = pos.x - originPos_.x;
+		float dz = pos.z - originPos_.z;
+		float lengthSq = dx * dx + dz * dz;
+
+		if (lengthSq > radius_ * radius_)
+			return;
+
+		if (!fullCircle_ && lengthSq > 0.f)
 		{
-			Entity* pEntity = wrap.currentNodeEntity();
+			float cosAngle = (dx * dirX_ + dz * dirZ_) / sqrtf(lengthSq);
+			if (cosAngle < cosHalfAngle_)
+				return;
+		}
 
-			if (entityUType == -1 || pEntity->pScriptModule()->getUType() == (ENTITY_SCRIPT_UID)entityUType)
-			{
-				if (wrap.length() <= radius)
-				{
-					foundEntities.insert(pEntity);
-				}
-				else
-				{
-					break;
-				}
-			}
+		foundEntities_.push_back(pEntity);
+	}
+
+protected:
+	std::vector<Entity*>& foundEntities_;
+	const Position3D& originPos_;
+	float dirX_, dirZ_;
+	float radius_;
+	float cosHalfAngle_;
+	bool fullCircle_;
+};
+
+//-------------------------------------------------------------------------------------
+class SegmentQueryVisitor
+{
+public:
+	SegmentQueryVisitor(std::vector<Entity*>& foundEntities, const Position3D& startPos, 
+		const Position3D& endPos, float width) :
+		foundEntities_(foundEntities),
+		startPos_(startPos),
+		segment_(endPos - startPos),
+		segmentLengthSq_(0.f),
+		widthSq_(width * width)
+	{
+		if (!CoordinateSystem::hasY)
+			segment_.y = 0.f;
+
+		segmentLengthSq_ = segment_.x * segment_.x + segment_.y * segment_.y + segment_.z * segment_.z;
+	}
+
+	INLINE void operator()(Entity* pEntity) {
+		const Position3D& pos = pEntity->position();
+
+		// ҵ߶ʵĵ
+		float t = 0.f;
+		if (segmentLengthSq_ > 0.f)
+		{
+			float dy = CoordinateSystem::hasY ? pos.y - startPos_.y : 0.f;
+			t = ((pos.x - startPos_.x) * segment_.x + dy * segment_.y + (pos.z - startPos_.z) * segment_.z) / segmentLengthSq_;
+
+			if (t < 0.f)
+				t = 0.f;
+			else if (t > 1.f)
+				t = 1.f;
 		}
-	};
-}
+
+		Position3D nearestPos = startPos_ + segment_ * t;
+
+		if (distanceSquared(pos, nearestPos) > widthSq_)
+			return;
+
+		foundEntities_.push_back(pEntity);
+	}
+
+protected:
+	std::vector<Entity*>& foundEntities_;
+	const Position3D& startPos_;
+	Vector3 segment_;
+	float segmentLengthSq_;
+	float widthSq_;
+};
 
 //-------------------------------------------------------------------------------------
 EntityCoordinateNode::EntityCoordinateNode(Entity* pEntity):
@@ -485,26 +669,110 @@ bool EntityCoordinateNode::delWatcherNode(CoordinateNode* pNode)
 void EntityCoordinateNode::entitiesInRange(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
 									  const Position3D& originPos, float radius, int entityUType)
 {
-	std::set<Entity*> entities_X;
-	std::set<Entity*> entities_Z;
+	RangeQueryVisitor visitor(foundEntities, originPos, radius);
+	visitEntitiesInXRange(rootNode, originPos.x - radius, originPos.x + radius, entityUType, visitor);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityCoordinateNode::entitiesInBox(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
+									  const Position3D& minPos, const Position3D& maxPos, int entityUType)
+{
+	BoxQueryVisitor visitor(foundEntities, minPos, maxPos);
+	visitEntitiesInXRange(rootNode, minPos.x, maxPos.x, entityUType, visitor);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityCoordinateNode::entitiesInSector(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
+									  const Position3D& originPos, float yaw, float radius, float angle, int entityUType)
+{
+	SectorQueryVisitor visitor(foundEntities, originPos, yaw, radius, angle);
+	visitEntitiesInXRange(rootNode, originPos.x - radius, originPos.x + radius, entityUType, visitor);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityCoordinateNode::entitiesInSegment(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
+									  const Position3D& startPos, const Position3D& endPos, float width, int entityUType)
+{
+	SegmentQueryVisitor visitor(foundEntities, startPos, endPos, width);
+	visitEntitiesInXRange(rootNode, std::min(startPos.x, endPos.x) - width, 
+		std::max(startPos.x, endPos.x) + width, entityUType, visitor);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityCoordinateNode::entitiesNearest(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode,
+									  const Position3D& originPos, uint32 count, float radius, int entityUType)
+{
+	if (count == 0)
+		return;
 
-	entitiesInAxisRange<CoordinateNodeWrapX>(entities_X, rootNode, originPos, radius, entityUType);
-	entitiesInAxisRange<CoordinateNodeWrapZ>(entities_Z, rootNode, originPos, radius, entityUType);
+	CoordinateNode* pCoordinateNode = findNearestNode<CoordinateNodeWrapX>(rootNode, originPos);
+	if (!pCoordinateNode)
+		return;
 
-	// Y
-	if (CoordinateSystem::hasY)
+	// 󶥶ѣѶĿǰҵĵcountentity
+	NEAREST_ENTITIES nearestEntities;
+	float radiusSq = radius * radius;
+
+	if (isValidEntityNode(pCoordinateNode))
+	{
+		addNearestEntity(nearestEntities, count, radiusSq, originPos, 
+			static_cast<EntityCoordinateNode*>(pCoordinateNode)->pEntity(), entityUType);
+	}
+
+	// ĵĽڵ㿪ʼͬʱչÿȡXϸһ
+	// XϵľѾڵcountľʱʣµĽڵ㲻ܸ
+	CoordinateNode* pLeftNode = pCoordinateNode->pPrevX();
+	CoordinateNode* pRightNode = pCoordinateNode->pNextX();
+
+	while (true)
 	{
-		std::set<Entity*> entities_Y;
-		entitiesInAxisRange<CoordinateNodeWrapY>(entities_Y, rootNode, originPos, radius, entityUType);
+		// entityڵ
+		while (pLeftNode && !isValidEntityNode(pLeftNode))
+			pLeftNode = pLeftNode->pPrevX();
 
+		while (pRightNode && !isValidEntityNode(pRightNode))
+			pRightNode = pRightNode->pNextX();
 
-		std::set<Entity*> res_set;
-		set_intersection(entities_X.begin(), entities_X.end(), entities_Z.begin(), entities_Z.end(), std::inserter(res_set, res_set.end()));
-		set_intersection(res_set.begin(), res_set.end(), entities_Y.begin(), entities_Y.end(), std::back_inserter(foundEntities));
+		if (!pLeftNode && !pRightNode)
+			break;
+
+		float leftLength = pLeftNode ? 
+			fabs(static_cast<EntityCoordinateNode*>(pLeftNode)->pEntity()->position().x - originPos.x) : FLT_MAX;
+
+		float rightLength = pRightNode ? 
+			fabs(static_cast<EntityCoordinateNode*>(pRightNode)->pEntity()->position().x - originPos.x) : FLT_MAX;
+
+		CoordinateNode* pCurrNode = NULL;
+		float length = 0.f;
+
+		if (leftLength <= rightLength)
+		{
+			pCurrNode = pLeftNode;
+			length = leftLength;
+			pLeftNode = pLeftNode->pPrevX();
+		}
+		else
+		{
+			pCurrNode = pRightNode;
+			length = rightLength;
+			pRightNode = pRightNode->pNextX();
+		}
+
+		if (length > radius || (nearestEntities.size() >= count && length * length >= nearestEntities.top().first))
+			break;
+
+		addNearestEntity(nearestEntities, count, radiusSq, originPos, 
+			static_cast<EntityCoordinateNode*>(pCurrNode)->pEntity(), entityUType);
 	}
-	else
+
+	// ɽԶ˳
+	size_t startIdx = foundEntities.size();
+	foundEntities.resize(startIdx + nearestEntities.size());
+
+	for (size_t i = foundEntities.size(); i > startIdx; --i)
 	{
-		set_intersection(entities_X.begin(), entities_X.end(), entities_Z.begin(), entities_Z.end(), std::back_inserter(foundEntities));
+		foundEntities[i - 1] = nearestEntities.top().second;
+		nearestEntities.pop();
 	}
 }
 
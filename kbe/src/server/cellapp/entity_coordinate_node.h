@@ -52,9 +52,34 @@ public:
 	
 	bool delWatcherNode(CoordinateNode* pNode);
 
+	/**
+		ռѯֻXϱѡڵȷ״ж
+		entityUTypeΪ-1ʱʵ
+	*/
 	static void entitiesInRange(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode, 
 		const Position3D& orginPos, float radius, int entityUType = -1);
 
+	static void entitiesInBox(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode, 
+		const Position3D& minPos, const Position3D& maxPos, int entityUType = -1);
+
+	/**
+		xzƽϣyawΪangleΪεŽ()
+	*/
+	static void entitiesInSector(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode, 
+		const Position3D& originPos, float yaw, float radius, float angle, int entityUType = -1);
+
+	/**
+		߶ξ벻widthʵ壬߻ͨ
+	*/
+	static void entitiesInSegment(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode, 
+		const Position3D& startPos, const Position3D& endPos, float width, int entityUType = -1);
+
+	/**
+		radiusΧcountʵ壬ɽԶ
+	*/
+	static void entitiesNearest(std::vector<Entity*>& foundEntities, CoordinateNode* rootNode, 
+		const Position3D& originPos, uint32 count, float radius, int entityUType = -1);
+
 	virtual void onRemove();
 
 protected:
@@ -49,6 +49,12 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine{	
 
+uint64 Witness::numVolatileUpdates = 0;
+uint64 Witness::numVolatileUpdateBytes = 0;
+uint64 Witness::numEnterViews = 0;
+uint64 Witness::numEnterViewBytes = 0;
+uint64 Witness::numEnterViewSnapshotHits = 0;
+uint64 Witness::numEnterViewDeferred = 0;
 
 //-------------------------------------------------------------------------------------
 Witness::Witness():
@@ -59,7 +65,8 @@ pViewTrigger_(NULL),
 pViewHysteresisAreaTrigger_(NULL),
 viewEntities_(),
 viewEntities_map_(),
-clientViewSize_(0)
+clientViewSize_(0),
+aliasAllocator_()
 {
 	updatableName = "Witness";
 }
@@ -237,6 +244,7 @@ void Witness::clear(Entity* pEntity)
 	viewRadius_ = 0.0f;
 	viewHysteresisArea_ = 5.0f;
 	clientViewSize_ = 0;
+	aliasAllocator_.clear();
 
 	// Ҫ٣滹
 	// ˴ٿܻΪenterViewпܵʵ
@@ -418,6 +426,7 @@ void Witness::onEnterView(ViewTrigger* pViewTrigger, Entity* pEntity)
 					_addViewEntityIDToBundle(pSendBundle, pEntityRef);
 					ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
 					pClientMB->sendCall(pSendBundle);
+					onViewEntityLeaveClient(pEntityRef);
 
 					KBE_ASSERT(clientViewSize_ > 0);
 					--clientViewSize_;
@@ -456,7 +465,12 @@ void Witness::onEnterView(ViewTrigger* pViewTrigger, Entity* pEntity)
 	pEntityRef->flags(pEntityRef->flags() | ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
 	viewEntities_.push_back(pEntityRef);
 	viewEntities_map_[pEntityRef->id()] = pEntityRef;
-	pEntityRef->aliasID(viewEntities_map_.size() - 1);
+
+	// λʵͻʱŷ
+	if(EntityDef::entityAliasIDSlots())
+		pEntityRef->aliasID(-1);
+	else
+		pEntityRef->aliasID(viewEntities_map_.size() - 1);
 	
 	pEntity->addWitnessed(pEntity_);
 	pSelfEntity->onEnteredView(pEntity);
@@ -514,9 +528,11 @@ void Witness::resetViewEntities()
 		}
 
 		(*iter)->flags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
+		(*iter)->aliasID(-1);
 		++iter;
 	}
 	
+	aliasAllocator_.clear();
 	updateEntitiesAliasID();
 }
 
@@ -661,6 +677,14 @@ void Witness::_addViewEntityIDToBundle(Network::Bundle* pBundle, EntityRef* pEnt
 	{
 		(*pBundle) << pEntityRef->id();
 	}
+	else if(EntityDef::entityAliasIDSlots())
+	{
+		// ͻ˰Լķ״̬ȡȣ ֻѽͻ˵ʵŻᱻд
+		if ((pEntityRef->flags() & (ENTITYREF_FLAG_NORMAL)) > 0 && pEntityRef->aliasID() >= 0)
+			aliasAllocator_.addToStream((*pBundle), (uint16)pEntityRef->aliasID());
+		else
+			(*pBundle) << pEntityRef->id();
+	}
 	else
 	{
 		// ע⣺ڸģⲿʹãֿܳͻ˱ҲentityID
@@ -695,13 +719,13 @@ const Network::MessageHandler& Witness::getViewEntityMessageHandler(const Networ
 	}
 	else
 	{
-		if (clientViewSize_ > 255)
+		if (clientViewSize_ > 255 && !EntityDef::entityAliasIDSlots())
 		{
 			return normalMsgHandler;
 		}
 		else
 		{
-			uint8 aliasID = 0;
+			int aliasID = 0;
 			if(entityID2AliasID(entityID, aliasID))
 			{
 				ialiasID = aliasID;
@@ -718,7 +742,7 @@ const Network::MessageHandler& Witness::getViewEntityMessageHandler(const Networ
 }
 
 //-------------------------------------------------------------------------------------
-bool Witness::entityID2AliasID(ENTITY_ID id, uint8& aliasID)
+bool Witness::entityID2AliasID(ENTITY_ID id, int& aliasID)
 {
 	VIEW_ENTITIES_MAP::iterator iter = viewEntities_map_.find(id);
 	if (iter == viewEntities_map_.end())
@@ -735,19 +759,65 @@ bool Witness::entityID2AliasID(ENTITY_ID id, uint8& aliasID)
 	}
 
 	// 
-	if (pEntityRef->aliasID() > 255)
+	if (pEntityRef->aliasID() < 0 || 
+		(pEntityRef->aliasID() > 255 && !EntityDef::entityAliasIDSlots()))
 	{
 		aliasID = 0;
 		return false;
 	}
 	
-	aliasID = (uint8)pEntityRef->aliasID();
+	aliasID = pEntityRef->aliasID();
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+uint8 Witness::aliasIDSize() const
+{
+	if(EntityDef::entityAliasIDSlots())
+		return aliasAllocator_.aliasIDSize();
+
+	return sizeof(uint8);
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::addAliasIDToBundle(Network::Bundle* pBundle, int aliasID)
+{
+	KBE_ASSERT(aliasID >= 0);
+
+	if(EntityDef::entityAliasIDSlots())
+		aliasAllocator_.addToStream((*pBundle), (uint16)aliasID);
+	else
+		(*pBundle) << (uint8)aliasID;
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::onViewEntityEnterClient(EntityRef* pEntityRef)
+{
+	if(!EntityDef::entityAliasIDSlots())
+		return;
+
+	// ͻյonEntityEnterWorldʱͬĹ
+	pEntityRef->aliasID(aliasAllocator_.alloc(pEntityRef->id()));
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::onViewEntityLeaveClient(EntityRef* pEntityRef)
+{
+	if(!EntityDef::entityAliasIDSlots())
+		return;
+
+	// ͻڴonEntityLeaveWorldͬĹ
+	aliasAllocator_.reclaim(pEntityRef->id());
+	pEntityRef->aliasID(-1);
+}
+
 //-------------------------------------------------------------------------------------
 void Witness::updateEntitiesAliasID()
 {
+	// λȶģ Ҫؽ
+	if(EntityDef::entityAliasIDSlots())
+		return;
+
 	int n = 0;
 	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
 	for(; iter != viewEntities_.end(); ++iter)
@@ -760,6 +830,54 @@ void Witness::updateEntitiesAliasID()
 	}
 }
 
+//-------------------------------------------------------------------------------------
+static bool cmpEnterPendingDistance(const std::pair<float, EntityRef*>& a, const std::pair<float, EntityRef*>& b)
+{
+	return a.first < b.first;
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::prioritizeEnterPendingEntities()
+{
+	std::vector< std::pair<float, EntityRef*> > pendings;
+	const Position3D& basePos = pEntity_->position();
+
+	VIEW_ENTITIES::iterator iter = viewEntities_.begin();
+	for(; iter != viewEntities_.end(); )
+	{
+		EntityRef* pEntityRef = (*iter);
+		if((pEntityRef->flags() & ENTITYREF_FLAG_ENTER_CLIENT_PENDING) > 0)
+		{
+			// Ѿڵentityǰ棬 update콫Ƴ
+			float distSq = 0.f;
+			if(pEntityRef->pEntity())
+			{
+				Position3D lengthPos = pEntityRef->pEntity()->position() - basePos;
+				distSq = KBEVec3LengthSq(&lengthPos);
+			}
+
+			pendings.push_back(std::make_pair(distSq, pEntityRef));
+			iter = viewEntities_.erase(iter);
+			continue;
+		}
+
+		++iter;
+	}
+
+	if(pendings.size() == 0)
+		return;
+
+	std::stable_sort(pendings.begin(), pendings.end(), cmpEnterPendingDistance);
+
+	// ڿͻϵentity˳򱣳ֲ䣬 Ƴٵentityʼѽentity֮
+	// ʽıIDͻ˰˳бȻһ
+	std::vector< std::pair<float, EntityRef*> >::iterator piter = pendings.begin();
+	for(; piter != pendings.end(); ++piter)
+		viewEntities_.push_back(piter->second);
+
+	updateEntitiesAliasID();
+}
+
 //-------------------------------------------------------------------------------------
 bool Witness::update()
 {
@@ -802,6 +920,13 @@ bool Witness::update()
 		NETWORK_ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pEntity_->id(), (*pSendBundle));
 		addBaseDataToStream(pSendBundle);
 
+		// entityͬʱViewʱ(ͽǡView뾶ı) ֽԤ̯tick
+		static uint32 enterViewBytesPerTick = g_kbeSrvConfig.getCellApp().witness_enterViewBytesPerTick;
+		uint32 enterViewBytes = 0;
+
+		if(enterViewBytesPerTick > 0)
+			prioritizeEnterPendingEntities();
+
 		VIEW_ENTITIES::iterator iter = viewEntities_.begin();
 		for(; iter != viewEntities_.end(); )
 		{
@@ -822,11 +947,25 @@ bool Witness::update()
 					continue;
 				}
 				
+				// tickԤ꣬ ֵȴ״̬һtick ÿtickٽһ
+				if(enterViewBytesPerTick > 0 && enterViewBytes >= enterViewBytesPerTick)
+				{
+					++numEnterViewDeferred;
+					++iter;
+					continue;
+				}
+
 				pEntityRef->removeflags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
 
+				// λó۲أ ÿεд룬 Բֱӿ۲߻Ŀ
 				MemoryStream* s1 = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
 				otherEntity->addPositionAndDirectionToStream(*s1, true);			
-				otherEntity->addClientDataToStream(s1, true);
+				if(otherEntity->addClientSnapshotToStream(s1))
+					++numEnterViewSnapshotHits;
+
+				enterViewBytes += (uint32)s1->length();
+				++numEnterViews;
+				numEnterViewBytes += s1->length();
 				
 				ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onUpdatePropertys, updatePropertys);
 				(*pSendBundle) << otherEntity->id();
@@ -853,6 +992,7 @@ bool Witness::update()
 				ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityEnterWorld, entityEnterWorld);
 
 				pEntityRef->flags(ENTITYREF_FLAG_NORMAL);
+				onViewEntityEnterClient(pEntityRef);
 
 				KBE_ASSERT(clientViewSize_ != 65535);
 
@@ -867,6 +1007,7 @@ bool Witness::update()
 					ENTITY_MESSAGE_FORWARD_CLIENT_BEGIN(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
 					_addViewEntityIDToBundle(pSendBundle, pEntityRef);
 					ENTITY_MESSAGE_FORWARD_CLIENT_END(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, leaveWorld);
+					onViewEntityLeaveClient(pEntityRef);
 					
 					KBE_ASSERT(clientViewSize_ > 0);
 					--clientViewSize_;
@@ -883,6 +1024,8 @@ bool Witness::update()
 				Entity* otherEntity = pEntityRef->pEntity();
 				if(otherEntity == NULL)
 				{
+					// û֪ͨͻ뿪 ͻȻռλ ˲ղλ
+					// ͬһʵٴνʱ˶õԭĲλ
 					viewEntities_map_.erase(pEntityRef->id());
 					EntityRef::reclaimPoolObject(pEntityRef);
 					iter = viewEntities_.erase(iter);
@@ -894,7 +1037,14 @@ bool Witness::update()
 				
 				KBE_ASSERT(pEntityRef->flags() == ENTITYREF_FLAG_NORMAL);
 				
+				size_t lastMsgLength = pSendBundle->currMsgLength();
 				addUpdateToStream(pSendBundle, getEntityVolatileDataUpdateFlags(otherEntity), pEntityRef);
+
+				if (pSendBundle->currMsgLength() > lastMsgLength)
+				{
+					++numVolatileUpdates;
+					numVolatileUpdateBytes += pSendBundle->currMsgLength() - lastMsgLength;
+				}
 			}
 
 			++iter;
@@ -28,6 +28,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "common/common.h"
 #include "common/objectpool.h"
 #include "math/math.h"
+#include "entitydef/entity_alias_allocator.h"
 
 // #define NDEBUG
 // windows include	
@@ -155,7 +156,17 @@ public:
 	const Network::MessageHandler& getViewEntityMessageHandler(const Network::MessageHandler& normalMsgHandler,
 											   const Network::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID, int& ialiasID);
 
-	bool entityID2AliasID(ENTITY_ID id, uint8& aliasID);
+	bool entityID2AliasID(ENTITY_ID id, int& aliasID);
+
+	/**
+		ǰIDõֽ
+	*/
+	uint8 aliasIDSize() const;
+
+	/**
+		ǰдgetViewEntityMessageHandlerõıID
+	*/
+	void addAliasIDToBundle(Network::Bundle* pBundle, int aliasID);
 
 	/**
 		ʹúЭ¿ͻ
@@ -196,6 +207,16 @@ public:
 	/** ȡλ */
 	void relativePosition(Position3D& out, Entity* otherEntity, bool isOptimized = true );
 
+	// ͬͻ˵λóͳ
+	static uint64 numVolatileUpdates;
+	static uint64 numVolatileUpdateBytes;
+
+	// entityͻViewͳƣ ԿյĴֽԤ㱻ƳٵĴ
+	static uint64 numEnterViews;
+	static uint64 numEnterViewBytes;
+	static uint64 numEnterViewSnapshotHits;
+	static uint64 numEnterViewDeferred;
+
 private:
 	/**
 		viewentityС256ֻλ
@@ -206,6 +227,18 @@ private:
 		updateִʱviewбиıʱҪentityRefaliasID
 	*/
 	void updateEntitiesAliasID();
+
+	/**
+		ȴͻ˵entityɽԶŵviewбĩβ
+		witness/enterViewBytesPerTickֶtickʱentityȳ
+	*/
+	void prioritizeEnterPendingEntities();
+
+	/**
+		ʵ뿪ͻʱ䡢ղλID(aliasEntityIDSlots)
+	*/
+	void onViewEntityEnterClient(EntityRef* pEntityRef);
+	void onViewEntityLeaveClient(EntityRef* pEntityRef);
 		
 private:
 	Entity*									pEntity_;
@@ -225,6 +258,9 @@ private:
 	Direction3D								lastBaseDir_;
 
 	uint16									clientViewSize_;
+
+	// aliasEntityIDSlotsģʽͻ˱һµıID
+	EntityAliasAllocator					aliasAllocator_;
 };
 
 }
@@ -0,0 +1,181 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "account_cache.h"
+#include "common/strutil.h"
+#include "common/timestamp.h"
+#include "server/serverconfig.h"
+#include "thread/threadguard.h"
+
+namespace KBEngine{	
+
+uint64 AccountCache::numHits = 0;
+uint64 AccountCache::numMisses = 0;
+uint64 AccountCache::numEvicted = 0;
+uint64 AccountCache::numInvalidated = 0;
+
+AccountCache::ENTRIES AccountCache::entries_;
+std::list<std::string> AccountCache::lru_;
+uint64 AccountCache::generation_ = 0;
+thread::ThreadMutex AccountCache::mutex_;
+
+//-------------------------------------------------------------------------------------
+bool AccountCache::enabled()
+{
+	return g_kbeSrvConfig.getDBMgr().accountCacheMaxSize > 0;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 AccountCache::size()
+{
+	thread::ThreadGuard tg(&mutex_);
+	return (uint32)entries_.size();
+}
+
+//-------------------------------------------------------------------------------------
+uint64 AccountCache::generation()
+{
+	thread::ThreadGuard tg(&mutex_);
+	return generation_;
+}
+
+//-------------------------------------------------------------------------------------
+std::string AccountCache::makeKey(const std::string& dbInterfaceName, const std::string& accountName)
+{
+	std::string key = dbInterfaceName;
+	key.push_back('\0');
+	key += strutil::toLower(accountName);
+	return key;
+}
+
+//-------------------------------------------------------------------------------------
+bool AccountCache::find(const std::string& dbInterfaceName, const std::string& accountName, ACCOUNT_INFOS& info)
+{
+	if (!enabled())
+		return false;
+
+	std::string key = makeKey(dbInterfaceName, accountName);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	ENTRIES::iterator iter = entries_.find(key);
+	if (iter == entries_.end())
+	{
+		++numMisses;
+		return false;
+	}
+
+	Entry& entry = iter->second;
+
+	// ڻߴСдͬ(ݿСдʱһ˺)δ
+	if (timestamp() >= entry.expireTime || entry.accountName != accountName)
+	{
+		lru_.erase(entry.lruIter);
+		entries_.erase(iter);
+		++numMisses;
+		return false;
+	}
+
+	lru_.splice(lru_.begin(), lru_, entry.lruIter);
+
+	info.name = entry.accountName;
+	info.dbid = entry.dbid;
+	info.flags = entry.flags;
+	info.deadline = entry.deadline;
+	info.password = entry.password;
+
+	++numHits;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void AccountCache::update(const std::string& dbInterfaceName, const std::string& accountName, 
+	const ACCOUNT_INFOS& info, uint64 generation)
+{
+	if (!enabled() || info.dbid == 0)
+		return;
+
+	ENGINE_COMPONENT_INFO& dbcfg = g_kbeSrvConfig.getDBMgr();
+	std::string key = makeKey(dbInterfaceName, accountName);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	if (generation != generation_)
+		return;
+
+	ENTRIES::iterator iter = entries_.find(key);
+	if (iter == entries_.end())
+	{
+		while (entries_.size() >= dbcfg.accountCacheMaxSize && lru_.size() > 0)
+		{
+			entries_.erase(lru_.back());
+			lru_.pop_back();
+			++numEvicted;
+		}
+
+		lru_.push_front(key);
+		iter = entries_.insert(std::make_pair(key, Entry())).first;
+		iter->second.lruIter = lru_.begin();
+	}
+	else
+	{
+		lru_.splice(lru_.begin(), lru_, iter->second.lruIter);
+	}
+
+	Entry& entry = iter->second;
+	entry.accountName = accountName;
+	entry.dbid = info.dbid;
+	entry.flags = info.flags;
+	entry.deadline = info.deadline;
+	entry.password = info.password;
+	entry.expireTime = timestamp() + uint64(dbcfg.accountCacheTimeout * stampsPerSecond());
+}
+
+//-------------------------------------------------------------------------------------
+void AccountCache::invalidate(const std::string& dbInterfaceName, const std::string& accountName)
+{
+	if (accountName.size() == 0)
+		return;
+
+	std::string key = makeKey(dbInterfaceName, accountName);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	++generation_;
+
+	ENTRIES::iterator iter = entries_.find(key);
+	if (iter == entries_.end())
+		return;
+
+	lru_.erase(iter->second.lruIter);
+	entries_.erase(iter);
+	++numInvalidated;
+}
+
+//-------------------------------------------------------------------------------------
+void AccountCache::clear()
+{
+	thread::ThreadGuard tg(&mutex_);
+	entries_.clear();
+	lru_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+}
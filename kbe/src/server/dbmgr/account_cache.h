@@ -0,0 +1,95 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_ACCOUNT_CACHE_H
+#define KBE_ACCOUNT_CACHE_H
+
+#include "helper/debug_helper.h"
+#include "common/common.h"
+#include "thread/threadmutex.h"
+#include "db_interface/entity_table.h"
+
+namespace KBEngine{
+
+/*
+	˺Ϣ棬¼ʱȴѯ˺ŵdbidflagsdeadlineժҪ
+	ٷݿ⡣
+	(LRṶ)ÿ¼йʱ䣬롢flags޸Ļ˺żʱʧЧ
+	db߳бʣнӿڶ̰߳ȫġ
+*/
+class AccountCache
+{
+public:
+	/** ѯ棬зtrueinfodbidflagsdeadlinepassword */
+	static bool find(const std::string& dbInterfaceName, const std::string& accountName, ACCOUNT_INFOS& info);
+
+	/** 
+		һݿѯ˺Ϣ
+		generationΪѯݿ֮ǰgeneration()õֵڼ˺ʧЧ򲻻棬
+		db̸߳޸ĵ뱻βѯľݸ
+	*/
+	static void update(const std::string& dbInterfaceName, const std::string& accountName, 
+		const ACCOUNT_INFOS& info, uint64 generation);
+
+	static uint64 generation();
+
+	/** ˺ŵ롢flagsȱ޸ĺãʹ仺ʧЧ */
+	static void invalidate(const std::string& dbInterfaceName, const std::string& accountName);
+
+	static void clear();
+
+	static bool enabled();
+	static uint32 size();
+
+	static uint64 numHits;
+	static uint64 numMisses;
+	static uint64 numEvicted;
+	static uint64 numInvalidated;
+
+private:
+	struct Entry
+	{
+		std::string accountName;
+		DBID dbid;
+		uint32 flags;
+		uint64 deadline;
+		std::string password;
+		uint64 expireTime;
+		std::list<std::string>::iterator lruIter;
+	};
+
+	// ݿܶ˺СдУͳһСдѯʱٱȶԭ
+	static std::string makeKey(const std::string& dbInterfaceName, const std::string& accountName);
+
+	typedef KBEUnordered_map<std::string, Entry> ENTRIES;
+	static ENTRIES entries_;
+
+	// ʹõǰ
+	static std::list<std::string> lru_;
+
+	// ÿinvalidate
+	static uint64 generation_;
+
+	static thread::ThreadMutex mutex_;
+};
+
+}
+
+#endif // KBE_ACCOUNT_CACHE_H
@@ -26,6 +26,8 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "interfaces_handler.h"
 #include "sync_app_datas_handler.h"
 #include "update_dblog_handler.h"
+#include "account_cache.h"
+#include "entitylog_registry.h"
 #include "db_mysql/kbe_table_mysql.h"
 #include "network/common.h"
 #include "network/tcp_packet.h"
@@ -77,6 +79,7 @@ Dbmgr::Dbmgr(Network::EventDispatcher& dispatcher,
 	pUpdateDBServerLogHandler_(NULL),
 	pTelnetServer_(NULL),
 	loseBaseappts_(),
+	loginAdmission_(),
 	centermgrInfo_(NULL)
 {
 	KBEngine::Network::MessageHandlers::pMainMessageHandlers = &DbmgrInterface::messageHandlers;
@@ -360,6 +363,35 @@ bool Dbmgr::initializeWatcher()
 	WATCH_OBJECT("numExecuteRawDatabaseCommand", numExecuteRawDatabaseCommand_);
 	WATCH_OBJECT("numCreatedAccount", numCreatedAccount_);
 
+	WATCH_OBJECT("globalData/numWrites", GlobalDataServer::numWrites);
+	WATCH_OBJECT("globalData/numMergedWrites", GlobalDataServer::numMergedWrites);
+	WATCH_OBJECT("globalData/numSentBatches", GlobalDataServer::numSentBatches);
+	WATCH_OBJECT("globalData/numSentEntries", GlobalDataServer::numSentEntries);
+	WATCH_OBJECT("globalData/numSentBytes", GlobalDataServer::numSentBytes);
+	WATCH_OBJECT("globalData/numSentDeltas", GlobalDataServer::numSentDeltas);
+	WATCH_OBJECT("globalData/numDeltaSavedBytes", GlobalDataServer::numDeltaSavedBytes);
+
+	WATCH_OBJECT("loginAdmission/queueSize", &loginAdmission_, &LoginAdmission::queueSize);
+	WATCH_OBJECT("loginAdmission/numAdmitted", LoginAdmission::numAdmitted);
+	WATCH_OBJECT("loginAdmission/numQueued", LoginAdmission::numQueued);
+	WATCH_OBJECT("loginAdmission/numRejected", LoginAdmission::numRejected);
+	WATCH_OBJECT("loginAdmission/numDropped", LoginAdmission::numDropped);
+	WATCH_OBJECT("loginAdmission/totalWaitMS", LoginAdmission::totalWaitMS);
+	WATCH_OBJECT("loginAdmission/maxWaitMS", LoginAdmission::maxWaitMS);
+
+	WATCH_OBJECT("accountCache/size", &AccountCache::size);
+	WATCH_OBJECT("accountCache/numHits", AccountCache::numHits);
+	WATCH_OBJECT("accountCache/numMisses", AccountCache::numMisses);
+	WATCH_OBJECT("accountCache/numEvicted", AccountCache::numEvicted);
+	WATCH_OBJECT("accountCache/numInvalidated", AccountCache::numInvalidated);
+
+	WATCH_OBJECT("entitylog/size", &EntityLogRegistry::size);
+	WATCH_OBJECT("entitylog/numJournalOps", EntityLogRegistry::numJournalOps);
+	WATCH_OBJECT("entitylog/numFlushedOps", EntityLogRegistry::numFlushedOps);
+	WATCH_OBJECT("entitylog/numFlushFailed", EntityLogRegistry::numFlushFailed);
+
+	WATCH_OBJECT("rawDatabaseStreams/size", &DBTaskExecuteRawDatabaseCommandStream::numStreams);
+
 	KBEUnordered_map<std::string, Buffered_DBTasks>::iterator bditer = bufferedDBTasksMaps_.begin();
 	for (; bditer != bufferedDBTasksMaps_.end(); ++bditer)
 	{
@@ -408,6 +440,18 @@ void Dbmgr::handleMainTick()
 	threadPool_.onMainThreadTick();
 	DBUtil::handleMainTick();
 	networkInterface().processChannels(&DbmgrInterface::messageHandlers);
+
+	// õʷŶеĵ¼
+	loginAdmission_.tick();
+
+	// ڴentitylogĸıдݿ
+	EntityLogRegistry::flush();
+
+	// tickglobalݵĸıϲ㲥
+	pGlobalData_->flushChanges();
+	pBaseAppData_->flushChanges();
+	pCellAppData_->flushChanges();
+	pCenterData_->flushChanges();
 }
 
 //-------------------------------------------------------------------------------------
@@ -1120,6 +1164,36 @@ void Dbmgr::onBroadcastGlobalDataChanged(Network::Channel* pChannel, KBEngine::M
 	};
 }
 
+//-------------------------------------------------------------------------------------
+void Dbmgr::onGlobalDataSubscribe(Network::Channel* pChannel, KBEngine::MemoryStream& s)
+{
+	uint8 dataType;
+	bool isSubscribe;
+	std::string prefix;
+	COMPONENT_ID componentID;
+
+	s >> dataType >> isSubscribe >> prefix >> componentID;
+
+	switch(dataType)
+	{
+	case GlobalDataServer::GLOBAL_DATA:
+		pGlobalData_->onSubscribe(pChannel, componentID, prefix, isSubscribe);
+		break;
+	case GlobalDataServer::BASEAPP_DATA:
+		pBaseAppData_->onSubscribe(pChannel, componentID, prefix, isSubscribe);
+		break;
+	case GlobalDataServer::CELLAPP_DATA:
+		pCellAppData_->onSubscribe(pChannel, componentID, prefix, isSubscribe);
+		break;
+	case GlobalDataServer::CENTER_DATA:
+		pCenterData_->onSubscribe(pChannel, componentID, prefix, isSubscribe);
+		break;
+	default:
+		ERROR_MSG(fmt::format("Dbmgr::onGlobalDataSubscribe: dataType({}) error!\n", dataType));
+		break;
+	};
+}
+
 //-------------------------------------------------------------------------------------
 void Dbmgr::onBroadcastCenterDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -1182,7 +1256,7 @@ void Dbmgr::onAccountLogin(Network::Channel* pChannel, KBEngine::MemoryStream& s
 		return;
 	}
 
-	findBestInterfacesHandler()->loginAccount(pChannel, loginName, password, datas);
+	loginAdmission_.onAccountLogin(pChannel, loginName, password, datas);
 }
 
 //-------------------------------------------------------------------------------------
@@ -1300,6 +1374,35 @@ void Dbmgr::executeRawDatabaseCommand(Network::Channel* pChannel,
 	}
 
 	s.done();
+}
+
+//-------------------------------------------------------------------------------------
+void Dbmgr::executeRawDatabaseCommandStream(Network::Channel* pChannel, 
+									  KBEngine::MemoryStream& s)
+{
+	uint16 dbInterfaceIndex = 0;
+	s >> dbInterfaceIndex;
+
+	std::string dbInterfaceName = g_kbeSrvConfig.dbInterfaceIndex2dbInterfaceName(dbInterfaceIndex);
+	if (dbInterfaceName.size() == 0)
+	{
+		ERROR_MSG(fmt::format("Dbmgr::executeRawDatabaseCommandStream: not found dbInterface({})!\n", dbInterfaceIndex));
+		s.done();
+		return;
+	}
+
+	thread::ThreadPool* pThreadPool = DBUtil::pThreadPool(dbInterfaceName);
+	if (!pThreadPool)
+	{
+		ERROR_MSG(fmt::format("Dbmgr::executeRawDatabaseCommandStream: not found pThreadPool(dbInterface={})!\n", dbInterfaceName));
+		s.done();
+		return;
+	}
+
+	pThreadPool->addTask(new DBTaskExecuteRawDatabaseCommandStream(pChannel ? pChannel->addr() : Network::Address::NONE, 
+		s, dbInterfaceName));
+
+	s.done();
 
 	++numExecuteRawDatabaseCommand_;
 }
@@ -35,6 +35,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "server/globaldata_client.h"
 #include "server/callbackmgr.h"	
 #include "server/globaldata_server.h"
+#include "login_admission.h"
 #include "common/timer.h"
 #include "network/endpoint.h"
 #include "resmgr/resmgr.h"
@@ -161,6 +162,7 @@ public:
 	*/
 	void onGlobalDataClientLogon(Network::Channel* pChannel, COMPONENT_TYPE componentType);
 	void onBroadcastGlobalDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s);
+	void onGlobalDataSubscribe(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 	void onBroadcastCenterDataChanged(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
 	/** ӿ
@@ -207,6 +209,11 @@ public:
 	*/
 	void executeRawDatabaseCommand(Network::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** ӿ
+		ִݿѯֿʽظ
+	*/
+	void executeRawDatabaseCommandStream(Network::Channel* pChannel, KBEngine::MemoryStream& s);
+
 	/** ӿ
 		ĳentity浵
 	*/
@@ -345,6 +352,9 @@ protected:
 
 	std::map<COMPONENT_ID, uint64>						loseBaseappts_;
 
+	// ¼Ŷ
+	LoginAdmission										loginAdmission_;
+
 	PY_CALLBACKMGR										pyCallbackMgr_;
 
 	Components::ComponentInfos							*centermgrInfo_;
@@ -100,6 +100,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(DbmgrInterface)
 	// globalݸı
 	DBMGR_MESSAGE_DECLARE_STREAM(onBroadcastGlobalDataChanged,		NETWORK_VARIABLE_MESSAGE)
 
+	// Ļȡglobalݵkeyǰ׺
+	DBMGR_MESSAGE_DECLARE_STREAM(onGlobalDataSubscribe,				NETWORK_VARIABLE_MESSAGE)
+
 	// KBEngine.centerDataݸı
 	DBMGR_MESSAGE_DECLARE_STREAM(onBroadcastCenterDataChanged,		NETWORK_VARIABLE_MESSAGE)
 
@@ -147,6 +150,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(DbmgrInterface)
 	// ݿѯ
 	DBMGR_MESSAGE_DECLARE_STREAM(executeRawDatabaseCommand,			NETWORK_VARIABLE_MESSAGE)
 
+	// ݿѯֿʽ
+	DBMGR_MESSAGE_DECLARE_STREAM(executeRawDatabaseCommandStream,	NETWORK_VARIABLE_MESSAGE)
+
 	// ĳentity浵
 	DBMGR_MESSAGE_DECLARE_STREAM(writeEntity,						NETWORK_VARIABLE_MESSAGE)
 
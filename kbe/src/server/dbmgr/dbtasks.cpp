@@ -21,6 +21,8 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "dbtasks.h"
 #include "dbmgr.h"
 #include "buffered_dbtasks.h"
+#include "account_cache.h"
+#include "entitylog_registry.h"
 #include "network/common.h"
 #include "network/message_handler.h"
 #include "thread/threadpool.h"
@@ -318,6 +320,211 @@ thread::TPTask::TPTaskState DBTaskExecuteRawDatabaseCommand::presentMainThread()
 	return thread::TPTask::TPTASK_STATE_COMPLETED;
 }
 
+//-------------------------------------------------------------------------------------
+uint32 DBTaskExecuteRawDatabaseCommandStream::numStreams_ = 0;
+
+//-------------------------------------------------------------------------------------
+DBTaskExecuteRawDatabaseCommandStream::DBTaskExecuteRawDatabaseCommandStream(const Network::Address& addr, 
+	MemoryStream& datas, const std::string& dbInterfaceName):
+DBTask(addr, datas),
+dbInterfaceName_(dbInterfaceName),
+componentID_(0),
+componentType_(UNKNOWN_COMPONENT_TYPE),
+sdatas_(),
+streamID_(0),
+chunkRows_(0),
+error_(),
+pChunk_(NULL),
+pStreamDBI_(NULL),
+started_(false),
+finished_(false),
+chunkSent_(false),
+counted_(false),
+aborted_(false)
+{
+	pChunk_ = MemoryStream::createPoolObject(OBJECTPOOL_POINT);
+
+	// ÿռһݿӣͬʱе
+	if(numStreams_ >= g_kbeSrvConfig.getDBMgr().rawStreamMaxStreams)
+	{
+		error_ = fmt::format("too many streams({})!", numStreams_);
+	}
+	else
+	{
+		++numStreams_;
+		counted_ = true;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskExecuteRawDatabaseCommandStream::~DBTaskExecuteRawDatabaseCommandStream()
+{
+	// Ѿݿ߳йرˣֻ̳߳ض񣬲ȡʣĽ
+	closeStream(true);
+	MemoryStream::reclaimPoolObject(pChunk_);
+
+	if(counted_)
+		--numStreams_;
+}
+
+//-------------------------------------------------------------------------------------
+void DBTaskExecuteRawDatabaseCommandStream::closeStream(bool abort)
+{
+	if(pStreamDBI_ == NULL)
+		return;
+
+	if(abort)
+		pStreamDBI_->abortStream();
+	else
+		pStreamDBI_->endStream();
+
+	pStreamDBI_->detach();
+	SAFE_RELEASE(pStreamDBI_);
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskExecuteRawDatabaseCommandStream::db_thread_process()
+{
+	// Ѿˣݿ߳зʣĽر
+	if(aborted_)
+	{
+		closeStream(true);
+		finished_ = true;
+		return false;
+	}
+
+	if(!started_)
+	{
+		started_ = true;
+
+		(*pDatas_) >> componentID_ >> componentType_;
+		(*pDatas_) >> streamID_ >> chunkRows_;
+		(*pDatas_).readBlob(sdatas_);
+
+		if(chunkRows_ == 0)
+			chunkRows_ = g_kbeSrvConfig.getDBMgr().rawStreamChunkRows;
+
+		if(error_.size() > 0)
+		{
+			finished_ = true;
+			return false;
+		}
+
+		pStreamDBI_ = DBUtil::createInterface(dbInterfaceName_, false);
+		if(pStreamDBI_ == NULL)
+		{
+			error_ = "can't create dbinterface!";
+			finished_ = true;
+			return false;
+		}
+
+		try
+		{
+			if(!pStreamDBI_->queryStream(sdatas_.data(), (uint32)sdatas_.size()))
+			{
+				error_ = pStreamDBI_->getstrerror();
+
+				// ֧ʽѯĽӿ(redis)ûдϢ
+				if(error_.size() == 0)
+					error_ = fmt::format("dbInterface({}) not support queryStream!", dbInterfaceName_);
+			}
+		}
+		catch (std::exception & e)
+		{
+			error_ = e.what();
+		}
+
+		if(error_.size() > 0)
+		{
+			closeStream(false);
+			finished_ = true;
+			return false;
+		}
+	}
+
+	pChunk_->clear(false);
+
+	// 쳣ܽݿ̴߳ﴦ߳Լ
+	try
+	{
+		if(!pStreamDBI_->fetchStream(pChunk_, chunkRows_, g_kbeSrvConfig.getDBMgr().rawStreamChunkSize, finished_))
+		{
+			error_ = pStreamDBI_->getstrerror();
+			if(error_.size() == 0)
+				error_ = "fetchStream error!";
+		}
+	}
+	catch (std::exception & e)
+	{
+		error_ = e.what();
+	}
+
+	if(error_.size() > 0)
+		finished_ = true;
+
+	if(finished_)
+		closeStream(error_.size() > 0);
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState DBTaskExecuteRawDatabaseCommandStream::presentMainThread()
+{
+	if(aborted_)
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+
+	Components::ComponentInfos* cinfos = Components::getSingleton().findComponent(componentType_, componentID_);
+	if(cinfos == NULL || cinfos->pChannel == NULL || cinfos->pChannel->isDestroyed())
+	{
+		ERROR_MSG(fmt::format("DBTask::DBTaskExecuteRawDatabaseCommandStream::presentMainThread: {}({}) not found, stream({}) aborted!\n",
+			COMPONENT_NAME_EX(componentType_), componentID_, streamID_));
+
+		// Ѿˣصݿ̷߳ʣĽ߳жʣ
+		if(pStreamDBI_ && !finished_)
+		{
+			aborted_ = true;
+			return thread::TPTask::TPTASK_STATE_CONTINUE_CHILDTHREAD;
+		}
+
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+	}
+
+	if(!chunkSent_)
+	{
+		chunkSent_ = true;
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+		if (componentType_ == BASEAPP_TYPE)
+			(*pBundle).newMessage(BaseappInterface::onExecuteRawDatabaseCommandStreamCB);
+		else
+			(*pBundle).newMessage(CellappInterface::onExecuteRawDatabaseCommandStreamCB);
+
+		(*pBundle) << streamID_;
+		(*pBundle) << error_;
+
+		if (error_.size() <= 0)
+			(*pBundle).append(pChunk_);
+
+		cinfos->pChannel->send(pBundle);
+	}
+
+	if(finished_)
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+
+	// ʱͣȡݿ
+	uint32 maxBacklog = g_kbeSrvConfig.getDBMgr().rawStreamMaxBacklog;
+	if(maxBacklog > 0 && (uint32)cinfos->pChannel->bundlesLength() > maxBacklog)
+		return thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD;
+
+	chunkSent_ = false;
+
+	// ÿһ鶼Ŷӹõӡ
+	initTime_ = timestamp();
+	return thread::TPTask::TPTASK_STATE_CONTINUE_CHILDTHREAD;
+}
+
 //-------------------------------------------------------------------------------------
 DBTaskWriteEntity::DBTaskWriteEntity(const Network::Address& addr, 
 									 COMPONENT_ID componentID, ENTITY_ID eid, 
@@ -376,7 +583,7 @@ bool DBTaskWriteEntity::db_thread_process()
 		KBEEntityLogTable* pELTable = static_cast<KBEEntityLogTable*>(entityTables.findKBETable(KBE_TABLE_PERFIX "_entitylog"));
 		KBE_ASSERT(pELTable);
 
-		success_ = pELTable->logEntity(pdbi_, inet_ntoa((struct in_addr&)ip), port, entityDBID_, 
+		success_ = EntityLogRegistry::logEntity(pdbi_, pELTable, inet_ntoa((struct in_addr&)ip), port, entityDBID_, 
 			componentID_, eid_, pModule->getUType());
 
 		if(!success_)
@@ -436,7 +643,7 @@ bool DBTaskRemoveEntity::db_thread_process()
 	KBEEntityLogTable* pELTable = static_cast<KBEEntityLogTable*>(entityTables.findKBETable(KBE_TABLE_PERFIX "_entitylog"));
 
 	KBE_ASSERT(pELTable);
-	pELTable->eraseEntityLog(pdbi_, entityDBID_, sid_);
+	EntityLogRegistry::eraseEntityLog(pdbi_, pELTable, entityDBID_, sid_);
 
 	entityTables.removeEntity(pdbi_, entityDBID_, EntityDef::findScriptModule(sid_));
 	return false;
@@ -483,7 +690,7 @@ bool DBTaskDeleteEntityByDBID::db_thread_process()
 
 	ScriptDefModule* pModule = EntityDef::findScriptModule(sid_);
 
-	haslog = pELTable->queryEntity(pdbi_, entityDBID_, entitylog, pModule->getUType());
+	haslog = EntityLogRegistry::queryEntity(pdbi_, pELTable, entityDBID_, entitylog, pModule->getUType());
 
 	// ߼¼
 	if(haslog)
@@ -620,7 +827,7 @@ bool DBTaskLookUpEntityByDBID::db_thread_process()
 	ScriptDefModule* pModule = EntityDef::findScriptModule(sid_);
 
 	// ߼¼
-	if(pELTable->queryEntity(pdbi_, entityDBID_, entitylog, pModule->getUType()))
+	if(EntityLogRegistry::queryEntity(pdbi_, pELTable, entityDBID_, entitylog, pModule->getUType()))
 	{
 		if(entitylog.serverGroupID != (COMPONENT_ID)getUserUID())
 		{
@@ -796,6 +1003,7 @@ bool DBTaskCreateAccount::writeAccount(DBInterface* pdbi, const std::string& acc
 		}
 	}
 
+	AccountCache::invalidate(pdbi->name(), accountName);
 	return true;
 }
 
@@ -964,6 +1172,10 @@ bool DBTaskActivateAccount::db_thread_process()
 	KBE_ASSERT(pTable1);
 
 	success_ = pTable1->activateAccount(pdbi_, code_, info);
+
+	// ı˺ŵflags
+	AccountCache::invalidate(pdbi_->name(), info.name);
+
 	if(!success_)
 	{
 		ERROR_MSG(fmt::format("DBTaskActivateAccount::db_thread_process(): activateAccount({1}) error: {0}\n", 
@@ -1093,6 +1305,7 @@ bool DBTaskAccountResetPassword::db_thread_process()
 	KBE_ASSERT(pTable1);
 
 	success_ = pTable1->resetpassword(pdbi_, accountName_, newpassword_, code_);
+	AccountCache::invalidate(pdbi_->name(), accountName_);
 	return false;
 }
 
@@ -1274,6 +1487,7 @@ bool DBTaskAccountNewPassword::db_thread_process()
 	}
 
 	success_ = pTable->updatePassword(pdbi_, accountName_, KBE_MD5::getDigest(newpassword_.data(), (int)newpassword_.length()));
+	AccountCache::invalidate(pdbi_->name(), accountName_);
 	return false;
 }
 
@@ -1407,13 +1621,22 @@ bool DBTaskQueryAccount::db_thread_process()
 	
 	KBE_ASSERT(pELTable);
 	
-	success_ = pELTable->logEntity(pdbi_, inet_ntoa((struct in_addr&)ip_), port_, dbid_, 
-		componentID_, entityID_, pModule->getUType());
+	bool duplicate = false;
+	success_ = EntityLogRegistry::logEntity(pdbi_, pELTable, inet_ntoa((struct in_addr&)ip_), port_, dbid_, 
+		componentID_, entityID_, pModule->getUType(), &duplicate);
 
-	if(!success_ && pdbi_->getlasterror() > 0)
+	if(!success_)
 	{
-		error_ += "logEntity: ";
-		error_ += pdbi_->getstrerror();
+		// ǼǱм¼ʱûзݿ⣬ ʱgetlasterror֮ǰѯµ
+		if(duplicate)
+		{
+			error_ += "logEntity: entity is already checked out";
+		}
+		else if(pdbi_->getlasterror() > 0)
+		{
+			error_ += "logEntity: ";
+			error_ += pdbi_->getstrerror();
+		}
 	}
 
 	flags_ = info.flags;
@@ -1525,7 +1748,7 @@ bool DBTaskEntityOffline::db_thread_process()
 
 	KBE_ASSERT(pELTable);
 
-	pELTable->eraseEntityLog(pdbi_, EntityDBTask_entityDBID(), sid_);
+	EntityLogRegistry::eraseEntityLog(pdbi_, pELTable, EntityDBTask_entityDBID(), sid_);
 	return false;
 }
 
@@ -1611,7 +1834,17 @@ bool DBTaskAccountLogin::db_thread_process()
 	info.flags = 0;
 	info.deadline = 0;
 
-	if(!pTable->queryAccount(pdbi_, accountName_, info))
+	// ȴ˺Żвѯ¼߷ʱԱ˺Ųѯ
+	bool found = AccountCache::find(pdbi_->name(), accountName_, info);
+	if(!found)
+	{
+		uint64 cacheGeneration = AccountCache::generation();
+		found = pTable->queryAccount(pdbi_, accountName_, info);
+		if(found)
+			AccountCache::update(pdbi_->name(), accountName_, info, cacheGeneration);
+	}
+
+	if(!found)
 	{
 		flags_ = info.flags;
 		deadline_ = info.deadline;
@@ -1677,7 +1910,7 @@ bool DBTaskAccountLogin::db_thread_process()
 
 	retcode_ = SERVER_ERR_ACCOUNT_IS_ONLINE;
 	KBEEntityLogTable::EntityLog entitylog;
-	bool success = !pELTable->queryEntity(pdbi_, info.dbid, entitylog, pModule->getUType());
+	bool success = !EntityLogRegistry::queryEntity(pdbi_, pELTable, info.dbid, entitylog, pModule->getUType());
 
 	// ߼¼
 	if(!success)
@@ -1793,7 +2026,7 @@ bool DBTaskQueryEntity::db_thread_process()
 
 		try
 		{
-			success_ = pELTable->logEntity(pdbi_, addr_.ipAsString(), addr_.port, dbid_, 
+			success_ = EntityLogRegistry::logEntity(pdbi_, pELTable, addr_.ipAsString(), addr_.port, dbid_, 
 				componentID_, entityID_, pModule->getUType());
 		}
 		catch (std::exception & e)
@@ -1813,7 +2046,7 @@ bool DBTaskQueryEntity::db_thread_process()
 
 			try
 			{
-				pELTable->queryEntity(pdbi_, dbid_, entitylog, pModule->getUType());
+				EntityLogRegistry::queryEntity(pdbi_, pELTable, dbid_, entitylog, pModule->getUType());
 			}
 			catch (std::exception & e)
 			{
@@ -1949,7 +2182,7 @@ bool DBTaskEraseBaseappEntityLog::db_thread_process()
 		return false;
 	}
 
-	success_ = pELTable->eraseBaseappEntityLog(pdbi_, componentID_);
+	success_ = EntityLogRegistry::eraseBaseappEntityLog(pdbi_, pELTable, componentID_);
 	return false;
 }
 
@@ -1962,5 +2195,68 @@ thread::TPTask::TPTaskState DBTaskEraseBaseappEntityLog::presentMainThread()
 	return DBTask::presentMainThread();
 }
 
+//-------------------------------------------------------------------------------------
+DBTaskFlushEntityLog::DBTaskFlushEntityLog(EntityLogRegistry::JOURNAL& journal) :
+	DBTask(),
+	journal_(),
+	failed_()
+{
+	journal_.swap(journal);
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskFlushEntityLog::~DBTaskFlushEntityLog()
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskFlushEntityLog::db_thread_process()
+{
+	EntityTables& entityTables = EntityTables::findByInterfaceName(pdbi_->name());
+	KBEEntityLogTable* pELTable = static_cast<KBEEntityLogTable*>(entityTables.findKBETable(KBE_TABLE_PERFIX "_entitylog"));
+
+	if (!pELTable)
+		return false;
+
+	EntityLogRegistry::JOURNAL::iterator iter = journal_.begin();
+	for (; iter != journal_.end(); ++iter)
+	{
+		DBID dbid = iter->first.first;
+		ENTITY_SCRIPT_UID entityType = iter->first.second;
+		EntityLogRegistry::JournalOp& op = iter->second;
+
+		// ɾɵļ¼ʵдµļ¼
+		bool success = pELTable->eraseEntityLog(pdbi_, dbid, entityType);
+
+		if (success && !op.erase)
+		{
+			success = pELTable->logEntity(pdbi_, op.log.ip, op.log.port, dbid, 
+				op.log.componentID, op.log.entityID, entityType);
+		}
+
+		if (!success)
+			failed_.insert(*iter);
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState DBTaskFlushEntityLog::presentMainThread()
+{
+	EntityLogRegistry::numFlushedOps += journal_.size() - failed_.size();
+
+	if (failed_.size() > 0)
+	{
+		EntityLogRegistry::numFlushFailed += failed_.size();
+
+		WARNING_MSG(fmt::format("Dbmgr::DBTaskFlushEntityLog(): {} of {} entitylogs failed to write, retry later! dbInterface={}\n", 
+			failed_.size(), journal_.size(), pdbi_->name()));
+	}
+
+	EntityLogRegistry::onFlushed(pdbi_->name(), failed_);
+	return DBTask::presentMainThread();
+}
+
 //-------------------------------------------------------------------------------------
 }
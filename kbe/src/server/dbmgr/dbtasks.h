@@ -30,6 +30,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/address.h"
 #include "db_interface/db_tasks.h"
 #include "server/server_errors.h"
+#include "entitylog_registry.h"
 
 namespace KBEngine{ 
 
@@ -139,6 +140,51 @@ protected:
 	MemoryStream* pExecret_;
 };
 
+/**
+	ִһsql䣬ֿʽ͸
+	ÿݿ̶̷߳߳ͺͶݵݿ̶߳ȡһ飬
+	ͨлѹݹʱ̵ͣ߳ȴӶѻڴ
+*/
+class DBTaskExecuteRawDatabaseCommandStream : public DBTask
+{
+public:
+	DBTaskExecuteRawDatabaseCommandStream(const Network::Address& addr, MemoryStream& datas, 
+		const std::string& dbInterfaceName);
+
+	virtual ~DBTaskExecuteRawDatabaseCommandStream();
+	virtual bool db_thread_process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	virtual std::string name() const {
+		return "DBTaskExecuteRawDatabaseCommandStream";
+	}
+
+	static uint32 numStreams() { return numStreams_; }
+
+protected:
+	void closeStream(bool abort);
+
+	std::string dbInterfaceName_;
+	COMPONENT_ID componentID_;
+	COMPONENT_TYPE componentType_;
+	std::string sdatas_;
+	CALLBACK_ID streamID_;
+	uint32 chunkRows_;
+	std::string error_;
+	MemoryStream* pChunk_;
+
+	// ʽռסֱ꣬ÿοܱͶݵͬݿ̣߳ʹö
+	DBInterface* pStreamDBI_;
+
+	bool started_;
+	bool finished_;
+	bool chunkSent_;
+	bool counted_;
+	bool aborted_;
+
+	static uint32 numStreams_;
+};
+
 
 /**
 	ִһsql
@@ -671,6 +717,26 @@ protected:
 
 };
 
+/**
+	EntityLogRegistry۵ĸıдkbe_entitylog
+*/
+class DBTaskFlushEntityLog : public DBTask
+{
+public:
+	DBTaskFlushEntityLog(EntityLogRegistry::JOURNAL& journal);
+	virtual ~DBTaskFlushEntityLog();
+	virtual bool db_thread_process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	virtual std::string name() const {
+		return "DBTaskFlushEntityLog";
+	}
+
+protected:
+	EntityLogRegistry::JOURNAL journal_;
+	EntityLogRegistry::JOURNAL failed_;
+};
+
 }
 
 #endif // KBE_DBTASKS_H
@@ -0,0 +1,227 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "entitylog_registry.h"
+#include "dbtasks.h"
+#include "common/timestamp.h"
+#include "db_interface/db_interface.h"
+#include "server/serverconfig.h"
+#include "thread/threadguard.h"
+#include "thread/threadpool.h"
+
+namespace KBEngine{	
+
+uint64 EntityLogRegistry::numJournalOps = 0;
+uint64 EntityLogRegistry::numFlushedOps = 0;
+uint64 EntityLogRegistry::numFlushFailed = 0;
+
+EntityLogRegistry::REGISTRIES EntityLogRegistry::registries_;
+uint64 EntityLogRegistry::lastFlushTime_ = 0;
+thread::ThreadMutex EntityLogRegistry::mutex_;
+
+//-------------------------------------------------------------------------------------
+bool EntityLogRegistry::enabled()
+{
+	ENGINE_COMPONENT_INFO& dbcfg = g_kbeSrvConfig.getDBMgr();
+	return dbcfg.entityLogInMemory && !dbcfg.isShareDB;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 EntityLogRegistry::size()
+{
+	thread::ThreadGuard tg(&mutex_);
+
+	uint32 count = 0;
+
+	REGISTRIES::iterator iter = registries_.begin();
+	for (; iter != registries_.end(); ++iter)
+		count += (uint32)iter->second.logs.size();
+
+	return count;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityLogRegistry::journal(Registry& registry, const KEY& key, bool erase,
+	const KBEEntityLogTable::EntityLog* pLog)
+{
+	JournalOp& op = registry.journal[key];
+	op.erase = erase;
+
+	if (pLog)
+		op.log = *pLog;
+
+	++numJournalOps;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityLogRegistry::logEntity(DBInterface* pdbi, KBEEntityLogTable* pTable, const char* ip, uint32 port, DBID dbid,
+	COMPONENT_ID componentID, ENTITY_ID entityID, ENTITY_SCRIPT_UID entityType, bool* pDuplicate)
+{
+	if (pDuplicate)
+		*pDuplicate = false;
+
+	if (!enabled())
+		return pTable->logEntity(pdbi, ip, port, dbid, componentID, entityID, entityType);
+
+	KEY key(dbid, entityType);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	Registry& registry = registries_[pdbi->name()];
+
+	// ݿͻһѾм¼˵ʵѾ
+	if (registry.logs.find(key) != registry.logs.end())
+	{
+		if (pDuplicate)
+			*pDuplicate = true;
+
+		return false;
+	}
+
+	KBEEntityLogTable::EntityLog& entitylog = registry.logs[key];
+	entitylog.dbid = dbid;
+	entitylog.entityID = entityID;
+	kbe_snprintf(entitylog.ip, MAX_IP, "%s", ip);
+	entitylog.port = (uint16)port;
+	entitylog.componentID = componentID;
+	entitylog.serverGroupID = (COMPONENT_ID)getUserUID();
+
+	journal(registry, key, false, &entitylog);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityLogRegistry::queryEntity(DBInterface* pdbi, KBEEntityLogTable* pTable, DBID dbid,
+	KBEEntityLogTable::EntityLog& entitylog, ENTITY_SCRIPT_UID entityType)
+{
+	if (!enabled())
+		return pTable->queryEntity(pdbi, dbid, entitylog, entityType);
+
+	entitylog.dbid = dbid;
+	entitylog.componentID = 0;
+	entitylog.serverGroupID = 0;
+	entitylog.entityID = 0;
+	entitylog.ip[0] = '\0';
+	entitylog.port = 0;
+
+	thread::ThreadGuard tg(&mutex_);
+
+	REGISTRIES::iterator iter = registries_.find(pdbi->name());
+	if (iter == registries_.end())
+		return false;
+
+	std::map<KEY, KBEEntityLogTable::EntityLog>::iterator logIter = iter->second.logs.find(KEY(dbid, entityType));
+	if (logIter == iter->second.logs.end())
+		return false;
+
+	entitylog = logIter->second;
+	return entitylog.componentID > 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityLogRegistry::eraseEntityLog(DBInterface* pdbi, KBEEntityLogTable* pTable, DBID dbid, ENTITY_SCRIPT_UID entityType)
+{
+	if (!enabled())
+		return pTable->eraseEntityLog(pdbi, dbid, entityType);
+
+	KEY key(dbid, entityType);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	Registry& registry = registries_[pdbi->name()];
+	if (registry.logs.erase(key) > 0)
+		journal(registry, key, true, NULL);
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityLogRegistry::eraseBaseappEntityLog(DBInterface* pdbi, KBEEntityLogTable* pTable, COMPONENT_ID componentID)
+{
+	if (!enabled())
+		return pTable->eraseBaseappEntityLog(pdbi, componentID);
+
+	thread::ThreadGuard tg(&mutex_);
+
+	Registry& registry = registries_[pdbi->name()];
+
+	std::map<KEY, KBEEntityLogTable::EntityLog>::iterator iter = registry.logs.begin();
+	while (iter != registry.logs.end())
+	{
+		if (iter->second.componentID == componentID)
+		{
+			journal(registry, iter->first, true, NULL);
+			registry.logs.erase(iter++);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void EntityLogRegistry::flush()
+{
+	uint64 now = timestamp();
+	if (double(now - lastFlushTime_) / stampsPerSecondD() < g_kbeSrvConfig.getDBMgr().entityLogFlushInterval)
+		return;
+
+	lastFlushTime_ = now;
+
+	thread::ThreadGuard tg(&mutex_);
+
+	REGISTRIES::iterator iter = registries_.begin();
+	for (; iter != registries_.end(); ++iter)
+	{
+		Registry& registry = iter->second;
+		if (registry.flushing || registry.journal.size() == 0)
+			continue;
+
+		thread::ThreadPool* pThreadPool = DBUtil::pThreadPool(iter->first);
+		if (!pThreadPool)
+			continue;
+
+		DBTaskFlushEntityLog* pTask = new DBTaskFlushEntityLog(registry.journal);
+		registry.journal.clear();
+		registry.flushing = true;
+
+		pThreadPool->addTask(pTask);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void EntityLogRegistry::onFlushed(const std::string& dbInterfaceName, JOURNAL& failed)
+{
+	thread::ThreadGuard tg(&mutex_);
+
+	Registry& registry = registries_[dbInterfaceName];
+	registry.flushing = false;
+
+	// дʧܵĸıŻ־´ԣڼѾµĸıµΪ׼
+	JOURNAL::iterator iter = failed.begin();
+	for (; iter != failed.end(); ++iter)
+		registry.journal.insert(*iter);
+}
+
+//-------------------------------------------------------------------------------------
+}
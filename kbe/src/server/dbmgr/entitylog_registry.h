@@ -0,0 +1,111 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_ENTITYLOG_REGISTRY_H
+#define KBE_ENTITYLOG_REGISTRY_H
+
+#include "helper/debug_helper.h"
+#include "common/common.h"
+#include "thread/threadmutex.h"
+#include "db_interface/kbe_tables.h"
+
+namespace KBEngine{
+
+class DBInterface;
+
+/*
+	(ѱ)ʵĵǼǱ
+	dbmgrռݿʱڴάentitylog¼ߡ߶ͬݿ⣬
+	ı¼־У̶߳ںϲ󽻸db߳дkbe_entitylogŲʹá
+	鹲ݿ(shareDB)δʱֱӶдݿеkbe_entitylog
+	db߳бʣнӿڶ̰߳ȫġ
+*/
+class EntityLogRegistry
+{
+public:
+	typedef std::pair<DBID, ENTITY_SCRIPT_UID> KEY;
+
+	struct JournalOp
+	{
+		bool erase;
+		KBEEntityLogTable::EntityLog log;
+	};
+
+	// ͬһʵθıֻ״̬
+	typedef std::map<KEY, JournalOp> JOURNAL;
+
+	static bool enabled();
+
+	/** 
+		KBEEntityLogTableͬӿںͬм¼ʱlogEntityfalse
+		pDuplicateΪNULLʱдǷΪڴм¼ʧ(ʱûзݿ⣬getlasterror)
+	*/
+	static bool logEntity(DBInterface* pdbi, KBEEntityLogTable* pTable, const char* ip, uint32 port, DBID dbid,
+		COMPONENT_ID componentID, ENTITY_ID entityID, ENTITY_SCRIPT_UID entityType, bool* pDuplicate = NULL);
+
+	static bool queryEntity(DBInterface* pdbi, KBEEntityLogTable* pTable, DBID dbid, 
+		KBEEntityLogTable::EntityLog& entitylog, ENTITY_SCRIPT_UID entityType);
+
+	static bool eraseEntityLog(DBInterface* pdbi, KBEEntityLogTable* pTable, DBID dbid, ENTITY_SCRIPT_UID entityType);
+	static bool eraseBaseappEntityLog(DBInterface* pdbi, KBEEntityLogTable* pTable, COMPONENT_ID componentID);
+
+	/** ߳еãдʱݿӿڻ۵ĸı佻db߳д */
+	static void flush();
+
+	/** дɺ߳еãfailedΪдʧҪԵĸı */
+	static void onFlushed(const std::string& dbInterfaceName, JOURNAL& failed);
+
+	static uint32 size();
+
+	static uint64 numJournalOps;
+	static uint64 numFlushedOps;
+	static uint64 numFlushFailed;
+
+private:
+	struct Registry
+	{
+		Registry():
+		logs(),
+		journal(),
+		flushing(false)
+		{
+		}
+
+		std::map<KEY, KBEEntityLogTable::EntityLog> logs;
+		JOURNAL journal;
+
+		// ͬһʱÿݿӿֻһд񣬱֤д˳
+		bool flushing;
+	};
+
+	static void journal(Registry& registry, const KEY& key, bool erase, 
+		const KBEEntityLogTable::EntityLog* pLog);
+
+	typedef std::map<std::string, Registry> REGISTRIES;
+	static REGISTRIES registries_;
+
+	static uint64 lastFlushTime_;
+
+	static thread::ThreadMutex mutex_;
+};
+
+}
+
+#endif // KBE_ENTITYLOG_REGISTRY_H
@@ -0,0 +1,281 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dbmgr.h"
+#include "login_admission.h"
+#include "interfaces_handler.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "network/network_interface.h"
+#include "server/serverconfig.h"
+
+#include "loginapp/loginapp_interface.h"
+
+namespace KBEngine{	
+
+uint64 LoginAdmission::numAdmitted = 0;
+uint64 LoginAdmission::numQueued = 0;
+uint64 LoginAdmission::numRejected = 0;
+uint64 LoginAdmission::numDropped = 0;
+uint64 LoginAdmission::totalWaitMS = 0;
+uint32 LoginAdmission::maxWaitMS = 0;
+
+//-------------------------------------------------------------------------------------
+LoginAdmission::LoginAdmission():
+queue_(),
+queuedNames_(),
+tokens_(0.0),
+lastRefillTime_(0),
+lastNotifyTime_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+LoginAdmission::~LoginAdmission()
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::enabled() const
+{
+	return g_kbeSrvConfig.getDBMgr().loginAdmissionPerSecond > 0;
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::refill()
+{
+	ENGINE_COMPONENT_INFO& dbcfg = g_kbeSrvConfig.getDBMgr();
+	uint64 now = timestamp();
+
+	if (lastRefillTime_ == 0)
+	{
+		tokens_ = (double)dbcfg.loginAdmissionBurst;
+		lastRefillTime_ = now;
+		return;
+	}
+
+	tokens_ += double(now - lastRefillTime_) / stampsPerSecondD() * dbcfg.loginAdmissionPerSecond;
+	lastRefillTime_ = now;
+
+	// 1ƣburstΪ0ʱԶ޷
+	double maxTokens = (double)std::max(dbcfg.loginAdmissionBurst, (uint32)1);
+	if (tokens_ > maxTokens)
+		tokens_ = maxTokens;
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::onAccountLogin(Network::Channel* pChannel, const std::string& loginName,
+	const std::string& password, const std::string& datas)
+{
+	if (!enabled())
+	{
+		admit(pChannel->addr(), loginName, password, datas);
+		return;
+	}
+
+	refill();
+
+	std::map<std::string, QUEUE::iterator>::iterator nameIter = queuedNames_.find(loginName);
+	if (nameIter != queuedNames_.end())
+	{
+		Request& req = *nameIter->second;
+		req.addr = pChannel->addr();
+		req.password = password;
+		req.datas = datas;
+		return;
+	}
+
+	if (queue_.empty() && tokens_ >= 1.0)
+	{
+		tokens_ -= 1.0;
+		admit(pChannel->addr(), loginName, password, datas);
+		return;
+	}
+
+	if (queue_.size() >= g_kbeSrvConfig.getDBMgr().loginAdmissionMaxQueue)
+	{
+		++numRejected;
+		reject(pChannel, loginName, datas, SERVER_ERR_BUSY);
+		return;
+	}
+
+	Request req;
+	req.addr = pChannel->addr();
+	req.loginName = loginName;
+	req.password = password;
+	req.datas = datas;
+	req.queuedTime = timestamp();
+
+	queue_.push_back(req);
+	queuedNames_[loginName] = --queue_.end();
+	++numQueued;
+
+	// ʱ֪ͻŶλã֮tickˢ
+	uint32 position = (uint32)queue_.size();
+	uint32 waitSeconds = (uint32)ceil(double(position) / g_kbeSrvConfig.getDBMgr().loginAdmissionPerSecond);
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(LoginappInterface::onLoginQueueStatus);
+	(*pBundle) << (uint32)1;
+	(*pBundle) << loginName << position << waitSeconds;
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+bool LoginAdmission::admit(const Network::Address& addr, const std::string& loginName,
+	const std::string& password, const std::string& datas)
+{
+	Network::Channel* pChannel = Dbmgr::getSingleton().networkInterface().findChannel(addr);
+	if (!pChannel || pChannel->isDestroyed())
+	{
+		WARNING_MSG(fmt::format("LoginAdmission::admit: loginapp({}) not found, loginName={}!\n",
+			addr.c_str(), loginName));
+
+		++numDropped;
+		return false;
+	}
+
+	std::string name = loginName, pass = password, extra = datas;
+	if (!Dbmgr::getSingleton().findBestInterfacesHandler()->loginAccount(pChannel, name, pass, extra))
+	{
+		reject(pChannel, loginName, datas, SERVER_ERR_SRV_NO_READY);
+		return true;
+	}
+
+	++numAdmitted;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::reject(Network::Channel* pChannel, const std::string& loginName,
+	const std::string& datas, SERVER_ERROR_CODE failedcode)
+{
+	// DBTaskAccountLoginصĸʽһ£loginappݴ֪ͨͻ˵¼ʧ
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	(*pBundle).newMessage(LoginappInterface::onLoginAccountQueryResultFromDbmgr);
+
+	(*pBundle) << failedcode;
+	(*pBundle) << loginName;
+	(*pBundle) << loginName;
+	(*pBundle) << std::string("");
+	(*pBundle) << true;
+	(*pBundle) << (COMPONENT_ID)0;
+	(*pBundle) << (ENTITY_ID)0;
+	(*pBundle) << (DBID)0;
+	(*pBundle) << (uint32)0;
+	(*pBundle) << (uint64)0;
+	(*pBundle).appendBlob(datas);
+
+	pChannel->send(pBundle);
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::tick()
+{
+	if (queue_.empty())
+		return;
+
+	if (!enabled())
+	{
+		// ڼرȫ
+		while (!queue_.empty())
+		{
+			Request& req = queue_.front();
+			admit(req.addr, req.loginName, req.password, req.datas);
+			queuedNames_.erase(req.loginName);
+			queue_.pop_front();
+		}
+
+		return;
+	}
+
+	refill();
+
+	uint64 now = timestamp();
+
+	while (!queue_.empty() && tokens_ >= 1.0)
+	{
+		Request& req = queue_.front();
+
+		if (admit(req.addr, req.loginName, req.password, req.datas))
+		{
+			tokens_ -= 1.0;
+
+			uint32 waitMS = (uint32)(double(now - req.queuedTime) * 1000.0 / stampsPerSecondD());
+			totalWaitMS += waitMS;
+			if (waitMS > maxWaitMS)
+				maxWaitMS = waitMS;
+		}
+
+		queuedNames_.erase(req.loginName);
+		queue_.pop_front();
+	}
+
+	if (queue_.empty())
+		return;
+
+	if (double(now - lastNotifyTime_) / stampsPerSecondD() >= g_kbeSrvConfig.getDBMgr().loginAdmissionNotifyInterval)
+	{
+		lastNotifyTime_ = now;
+		notifyQueueStatus();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void LoginAdmission::notifyQueueStatus()
+{
+	// loginapp飬ÿloginappһϢ
+	typedef std::vector< std::pair<const Request*, uint32> > ENTRIES;
+	std::map<Network::Address, ENTRIES> groups;
+
+	uint32 position = 0;
+	QUEUE::const_iterator iter = queue_.begin();
+	for (; iter != queue_.end(); ++iter)
+		groups[iter->addr].push_back(std::make_pair(&(*iter), ++position));
+
+	double perSecond = (double)g_kbeSrvConfig.getDBMgr().loginAdmissionPerSecond;
+
+	std::map<Network::Address, ENTRIES>::iterator groupIter = groups.begin();
+	for (; groupIter != groups.end(); ++groupIter)
+	{
+		Network::Channel* pChannel = Dbmgr::getSingleton().networkInterface().findChannel(groupIter->first);
+		if (!pChannel || pChannel->isDestroyed())
+			continue;
+
+		ENTRIES& entries = groupIter->second;
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(LoginappInterface::onLoginQueueStatus);
+		(*pBundle) << (uint32)entries.size();
+
+		ENTRIES::iterator entryIter = entries.begin();
+		for (; entryIter != entries.end(); ++entryIter)
+		{
+			(*pBundle) << entryIter->first->loginName;
+			(*pBundle) << entryIter->second;
+			(*pBundle) << (uint32)ceil(double(entryIter->second) / perSecond);
+		}
+
+		pChannel->send(pBundle);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,98 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_LOGIN_ADMISSION_H
+#define KBE_LOGIN_ADMISSION_H
+
+#include "helper/debug_helper.h"
+#include "common/common.h"
+#include "network/address.h"
+
+namespace KBEngine{
+
+namespace Network
+{
+class Channel;
+}
+
+/*
+	¼׼
+	Ͱÿ뽻db̴߳ĵ¼󰴵˳Ŷӣ
+	ͨloginapp֪ͻ˵ǰŶλúԤƵȴʱ䡣
+	ʱֱӾܾ(SERVER_ERR_BUSY)
+*/
+class LoginAdmission
+{
+public:
+	LoginAdmission();
+	~LoginAdmission();
+
+	bool enabled() const;
+
+	/** һ¼󵽴ܷInterfacesHandlerŶ */
+	void onAccountLogin(Network::Channel* pChannel, const std::string& loginName,
+		const std::string& password, const std::string& datas);
+
+	/** ÿtickãơŶӵŶ״̬ */
+	void tick();
+
+	uint32 queueSize(){ return (uint32)queue_.size(); }
+
+	static uint64 numAdmitted;
+	static uint64 numQueued;
+	static uint64 numRejected;
+	static uint64 numDropped;
+	static uint64 totalWaitMS;
+	static uint32 maxWaitMS;
+
+private:
+	struct Request
+	{
+		Network::Address addr;
+		std::string loginName;
+		std::string password;
+		std::string datas;
+		uint64 queuedTime;
+	};
+
+	typedef std::list<Request> QUEUE;
+
+	void refill();
+	bool admit(const Network::Address& addr, const std::string& loginName,
+		const std::string& password, const std::string& datas);
+
+	void reject(Network::Channel* pChannel, const std::string& loginName, 
+		const std::string& datas, SERVER_ERROR_CODE failedcode);
+
+	void notifyQueueStatus();
+
+	QUEUE queue_;
+
+	// ͬһloginNameظʱֻŶе󣬲ıλ
+	std::map<std::string, QUEUE::iterator> queuedNames_;
+
+	double tokens_;
+	uint64 lastRefillTime_;
+	uint64 lastNotifyTime_;
+};
+
+}
+
+#endif // KBE_LOGIN_ADMISSION_H
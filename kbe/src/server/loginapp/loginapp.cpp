@@ -1165,6 +1165,41 @@ void Loginapp::_loginFailed(Network::Channel* pChannel, std::string& loginName,
 	SAFE_RELEASE(infos);
 }
 
+//-------------------------------------------------------------------------------------
+void Loginapp::onLoginQueueStatus(Network::Channel* pChannel, MemoryStream& s)
+{
+	if(pChannel->isExternal())
+		return;
+
+	uint32 count = 0;
+	s >> count;
+
+	TimeStamp now = timestamp();
+
+	for(uint32 i = 0; i < count; ++i)
+	{
+		std::string loginName;
+		uint32 position = 0, waitSeconds = 0;
+		s >> loginName >> position >> waitSeconds;
+
+		PendingLoginMgr::PLInfos* infos = pendingLoginMgr_.find(loginName);
+		if(infos == NULL)
+			continue;
+
+		// Ŷڼ䲻õ¼ʱ
+		infos->lastProcessTime = now;
+
+		Network::Channel* pClientChannel = this->networkInterface().findChannel(infos->addr);
+		if(pClientChannel == NULL)
+			continue;
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+		(*pBundle).newMessage(ClientInterface::onLoginQueuePosition);
+		(*pBundle) << position << waitSeconds;
+		pClientChannel->send(pBundle);
+	}
+}
+
 //-------------------------------------------------------------------------------------
 void Loginapp::onLoginAccountQueryResultFromDbmgr(Network::Channel* pChannel, MemoryStream& s)
 {
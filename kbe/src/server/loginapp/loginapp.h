@@ -154,6 +154,11 @@ public:
 	*/
 	void onLoginAccountQueryResultFromDbmgr(Network::Channel* pChannel, MemoryStream& s);
 
+	/** ӿ
+		dbmgr¼ŶУ֪ͻŶλúԤƵȴʱ
+	*/
+	void onLoginQueueStatus(Network::Channel* pChannel, MemoryStream& s);
+
 	/** ӿ
 		baseappmgrصĵ¼صַ
 	*/
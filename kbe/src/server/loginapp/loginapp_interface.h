@@ -111,6 +111,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(LoginappInterface)
 	// dbmgrѯûϷԽ
 	LOGINAPP_MESSAGE_DECLARE_STREAM(onLoginAccountQueryResultFromDbmgr,				NETWORK_VARIABLE_MESSAGE)
 
+	// dbmgr¼ŶУ֪Ŷλ
+	LOGINAPP_MESSAGE_DECLARE_STREAM(onLoginQueueStatus,								NETWORK_VARIABLE_MESSAGE)
+
 	// baseappmgrصĵ¼صַ
 	LOGINAPP_MESSAGE_DECLARE_ARGS5(onLoginAccountQueryBaseappAddrFromBaseappmgr,	NETWORK_VARIABLE_MESSAGE,
 									std::string,									loginName, 
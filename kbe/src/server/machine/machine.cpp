@@ -59,7 +59,8 @@ Machine::Machine(Network::EventDispatcher& dispatcher,
 	pEPPacketReceiver_(NULL),
 	pEBPacketReceiver_(NULL),
 	pEPLocalPacketReceiver_(NULL),
-	localuids_()
+	localuids_(),
+	subscribers_()
 {
 	SystemInfo::getSingleton().getCPUPer();
 	KBEngine::Network::MessageHandlers::pMainMessageHandlers = &MachineInterface::messageHandlers;
@@ -176,6 +177,8 @@ void Machine::onBroadcastInterface(Network::Channel* pChannel, int32 uid, std::s
 			Components::getSingleton().addComponent(uid, username.c_str(),
 				(KBEngine::COMPONENT_TYPE)componentType, componentID, globalorderid, grouporderid, gus, intaddr, intport, extaddr, extport, extaddrEx,
 				pid, cpu, mem, usedmem, extradata, extradata1, extradata2, extradata3);
+
+			pushComponentUp(Components::getSingleton().findComponent((COMPONENT_TYPE)componentType, uid, componentID));
 		}
 	}
 }
@@ -303,7 +306,10 @@ bool Machine::checkComponentUsable(const Components::ComponentInfos* info, bool
 
 	// ѾԶ
 	if(!ret && autoerase)
+	{
+		pushComponentDown(info->uid, info->componentType, info->cid);
 		Components::getSingleton().delComponent(info->uid, info->componentType, info->cid);
+	}
 
 	return ret;
 }
@@ -466,12 +472,178 @@ void Machine::queryComponentID(Network::Channel* pChannel, COMPONENT_TYPE compon
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Machine::subscribeComponents(Network::Channel* pChannel, int32 uid, std::string& username, 
+	COMPONENT_TYPE componentType, COMPONENT_ID componentID, uint32 finderAddr, uint16 finderRecvPort)
+{
+	if(finderAddr == 0 || finderRecvPort == 0)
+		return;
+
+	SUBSCRIBERS::iterator subIter = subscribers_.find(componentID);
+	bool renew = subIter != subscribers_.end() && subIter->second.addr == finderAddr && 
+		subIter->second.port == finderRecvPort;
+
+	ComponentSubscriber& subscriber = subscribers_[componentID];
+	subscriber.uid = uid;
+	subscriber.componentType = componentType;
+	subscriber.addr = finderAddr;
+	subscriber.port = finderRecvPort;
+	subscriber.expireTime = timestamp() + uint64(COMPONENT_SUBSCRIBE_TTL) * stampsPerSecond();
+
+	if(!renew)
+	{
+		INFO_MSG(fmt::format("Machine::subscribeComponents[{}]: uid:{}, username:{}, "
+				"componentType:{}, componentID:{}, finderaddr:{}, finderRecvPort:{}.\n",
+			pChannel->c_str(), uid, username.c_str(), 
+			COMPONENT_NAME_EX(componentType), componentID,
+			inet_ntoa((struct in_addr&)finderAddr), ntohs(finderRecvPort)));
+	}
+
+	Network::EndPoint ep;
+	ep.socket(SOCK_DGRAM);
+
+	if (!ep.good())
+	{
+		ERROR_MSG("Machine::subscribeComponents: Failed to create socket.\n");
+		return;
+	}
+
+	// ()ʱеĸuid͸, ÿһⳬUDPС
+	int ifind = 0;
+	while(ALL_SERVER_COMPONENT_TYPES[ifind] != UNKNOWN_COMPONENT_TYPE)
+	{
+		Components::COMPONENTS& components = Components::getSingleton().getComponents(ALL_SERVER_COMPONENT_TYPES[ifind++]);
+		Components::COMPONENTS::iterator iter = components.begin();
+
+		for(; iter != components.end(); ++iter)
+		{
+			const Components::ComponentInfos* pinfos = &(*iter);
+
+			if(pinfos->uid != uid || pinfos->cid == componentID)
+				continue;
+
+			if(this->networkInterface().intTcpAddr().ip != pinfos->pIntAddr->ip &&
+				this->networkInterface().extTcpAddr().ip != pinfos->pIntAddr->ip)
+				continue;
+
+			if(!checkComponentUsable(pinfos, false, false))
+				continue;
+
+			Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+			MachineInterface::onBroadcastInterfaceArgs25::staticAddToBundle((*pBundle), pinfos->uid, 
+				pinfos->username, pinfos->componentType, pinfos->cid, componentID, pinfos->globalOrderid, pinfos->groupOrderid, pinfos->gus,
+				pinfos->pIntAddr->ip, pinfos->pIntAddr->port,
+				pinfos->pExtAddr->ip, pinfos->pExtAddr->port, pinfos->externalAddressEx, pinfos->pid, pinfos->cpu, pinfos->mem, pinfos->usedmem, 
+				(int8)COMPONENT_STATE_RUN, KBEngine::getProcessPID(), pinfos->extradata, pinfos->extradata1, pinfos->extradata2, pinfos->extradata3, 0, 0);
+
+			ep.sendto(pBundle, finderRecvPort, finderAddr);
+			Network::Bundle::reclaimPoolObject(pBundle);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void Machine::pushComponentUp(const Components::ComponentInfos* pinfos)
+{
+	if(pinfos == NULL || subscribers_.size() == 0)
+		return;
+
+	Network::EndPoint ep;
+	ep.socket(SOCK_DGRAM);
+
+	if (!ep.good())
+	{
+		ERROR_MSG("Machine::pushComponentUp: Failed to create socket.\n");
+		return;
+	}
+
+	uint64 now = timestamp();
+	SUBSCRIBERS::iterator iter = subscribers_.begin();
+
+	for(; iter != subscribers_.end(); )
+	{
+		if(iter->second.expireTime < now)
+		{
+			subscribers_.erase(iter++);
+			continue;
+		}
+
+		if(iter->second.uid != pinfos->uid || iter->first == pinfos->cid)
+		{
+			++iter;
+			continue;
+		}
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+		MachineInterface::onBroadcastInterfaceArgs25::staticAddToBundle((*pBundle), pinfos->uid, 
+			pinfos->username, pinfos->componentType, pinfos->cid, iter->first, pinfos->globalOrderid, pinfos->groupOrderid, pinfos->gus,
+			pinfos->pIntAddr->ip, pinfos->pIntAddr->port,
+			pinfos->pExtAddr->ip, pinfos->pExtAddr->port, pinfos->externalAddressEx, pinfos->pid, pinfos->cpu, pinfos->mem, pinfos->usedmem, 
+			(int8)COMPONENT_STATE_RUN, KBEngine::getProcessPID(), pinfos->extradata, pinfos->extradata1, pinfos->extradata2, pinfos->extradata3, 0, 0);
+
+		ep.sendto(pBundle, iter->second.port, iter->second.addr);
+		Network::Bundle::reclaimPoolObject(pBundle);
+		++iter;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void Machine::pushComponentDown(int32 uid, COMPONENT_TYPE componentType, COMPONENT_ID componentID)
+{
+	// ٸ
+	subscribers_.erase(componentID);
+
+	if(subscribers_.size() == 0)
+		return;
+
+	Network::EndPoint ep;
+	ep.socket(SOCK_DGRAM);
+
+	if (!ep.good())
+	{
+		ERROR_MSG("Machine::pushComponentDown: Failed to create socket.\n");
+		return;
+	}
+
+	uint64 now = timestamp();
+	SUBSCRIBERS::iterator iter = subscribers_.begin();
+
+	for(; iter != subscribers_.end(); )
+	{
+		if(iter->second.expireTime < now)
+		{
+			subscribers_.erase(iter++);
+			continue;
+		}
+
+		if(iter->second.uid != uid)
+		{
+			++iter;
+			continue;
+		}
+
+		Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+
+		MachineInterface::onBroadcastInterfaceArgs25::staticAddToBundle((*pBundle), uid, 
+			"", componentType, componentID, iter->first, -1, -1, -1, 0, 0, 0, 0, "", 0, 0.f, 0.f, 0, 
+			(int8)COMPONENT_STATE_STOP, KBEngine::getProcessPID(), 0, 0, 0, 0, 0, 0);
+
+		ep.sendto(pBundle, iter->second.port, iter->second.addr);
+		Network::Bundle::reclaimPoolObject(pBundle);
+		++iter;
+	}
+}
+
 //-------------------------------------------------------------------------------------
 void Machine::removeComponentID(COMPONENT_TYPE componentType, COMPONENT_ID componentID, int32 uid)
 {
 	INFO_MSG(fmt::format("Machine::removeComponentID: component={}({}), uid={} \n", 
 		COMPONENT_NAME[componentType], componentID, uid));
 
+	pushComponentDown(uid, componentType, componentID);
+
 	std::map<int32, CID_MAP>::iterator iter = cidMap_.find(uid);
 	if (iter != cidMap_.end())
 	{
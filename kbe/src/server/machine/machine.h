@@ -93,6 +93,19 @@ public:
 	void queryComponentID(Network::Channel* pChannel, COMPONENT_TYPE componentType, COMPONENT_ID componentID,
 		int32 uid, uint16 finderRecvPort, int macMD5, int32 pid);
 
+	/** ӿ
+		ĳappı¼, ʱһα, 
+		֮ڶЧڱı仯ᱻ͸
+	*/
+	void subscribeComponents(Network::Channel* pChannel, int32 uid, std::string& username, 
+		COMPONENT_TYPE componentType, COMPONENT_ID componentID, uint32 finderAddr, uint16 finderRecvPort);
+
+	/**
+		ͱߺ
+	*/
+	void pushComponentUp(const Components::ComponentInfos* pinfos);
+	void pushComponentDown(int32 uid, COMPONENT_TYPE componentType, COMPONENT_ID componentID);
+
 	void removeComponentID(COMPONENT_TYPE componentType, COMPONENT_ID componentID, int32 uid);
 
 	void handleTimeout(TimerHandle handle, void * arg);
@@ -167,6 +180,19 @@ protected:
 
 	std::map<int32, CID_MAP>		cidMap_;
 	std::map<std::string, COMPONENT_ID>		pidMD5Map_;
+
+	struct ComponentSubscriber
+	{
+		int32 uid;
+		COMPONENT_TYPE componentType;
+		uint32 addr;
+		uint16 port;
+		uint64 expireTime;
+	};
+
+	// ˱¼app, keyΪߵcomponentID
+	typedef std::map<COMPONENT_ID, ComponentSubscriber> SUBSCRIBERS;
+	SUBSCRIBERS					subscribers_;
 };
 
 }
@@ -121,6 +121,15 @@ NETWORK_INTERFACE_DECLARE_BEGIN(MachineInterface)
 	// ǿɱǰapp
 	MACHINE_MESSAGE_DECLARE_STREAM(reqKillServer,					NETWORK_VARIABLE_MESSAGE)
 
+	// ĳappı¼
+	MACHINE_MESSAGE_DECLARE_ARGS6(subscribeComponents,				NETWORK_VARIABLE_MESSAGE,
+									int32,							uid, 
+									std::string,					username,
+									COMPONENT_TYPE,					componentType, 
+									COMPONENT_ID,					componentID, 
+									uint32,							addr, 
+									uint16,							finderRecvPort)
+
 NETWORK_INTERFACE_DECLARE_END()
 
 #ifdef DEFINE_IN_INTERFACE
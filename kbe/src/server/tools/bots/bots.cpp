@@ -20,6 +20,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "pybots.h"
 #include "bots.h"
+#include "bots_io_task.h"
 #include "clientobject.h"
 #include "server/telnet_server.h"
 #include "server/components.h"
@@ -60,7 +61,8 @@ reqCreateAndLoginTickCount_(g_kbeSrvConfig.getBots().defaultAddBots_tickCount),
 reqCreateAndLoginTickTime_(g_kbeSrvConfig.getBots().defaultAddBots_tickTime),
 pCreateAndLoginHandler_(NULL),
 pEventPoller_(Network::EventPoller::create()),
-pTelnetServer_(NULL)
+pTelnetServer_(NULL),
+ioTasks_()
 {
 	KBEngine::Network::MessageHandlers::pMainMessageHandlers = &BotsInterface::messageHandlers;
 	Components::getSingleton().initialize(&ninterface, componentType, componentID);
@@ -78,7 +80,35 @@ bool Bots::initialize()
 {
 	// 㲥Լĵַϵkbemachine
 	this->dispatcher().addTask(&Components::getSingleton());
-	return ClientApp::initialize();
+
+	uint32 ioThreads = g_kbeSrvConfig.getBots().bots_ioThreads;
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+	if(ioThreads > 0)
+	{
+		WARNING_MSG("Bots::initialize: bots/ioThreads is not supported on this platform, ignored!\n");
+		ioThreads = 0;
+	}
+#endif
+
+	// IOһֱռ̣߳ ҪΪ߳
+	if(ioThreads > 0)
+		threadPool_.createThreadPool(ioThreads + 1, ioThreads + 1, ioThreads + 4);
+
+	if(!ClientApp::initialize())
+		return false;
+
+	for(uint32 i = 0; i < ioThreads; ++i)
+	{
+		BotsIOTask* pTask = new BotsIOTask(i);
+		ioTasks_.push_back(pTask);
+		threadPool_.addTask(pTask);
+	}
+
+	if(ioThreads > 0)
+		INFO_MSG(fmt::format("Bots::initialize: {} io threads.\n", ioThreads));
+
+	return true;
 }
 
 //-------------------------------------------------------------------------------------	
@@ -147,6 +177,8 @@ void Bots::finalise()
 		SCRIPT_ERROR_CHECK();
 	}
 
+	dumpLatencyStats();
+
 	CLIENTS::iterator iter = clients_.begin();
 	for(; iter != clients_.end(); ++iter)
 	{
@@ -156,6 +188,19 @@ void Bots::finalise()
 
 	clients_.clear();
 
+	// ص߳ʱ ̳߳ͷ
+	std::vector<BotsIOTask*>::iterator ioIter = ioTasks_.begin();
+	for(; ioIter != ioTasks_.end(); ++ioIter)
+		(*ioIter)->stop();
+
+	ioTasks_.clear();
+
+	LATENCY_STATS::iterator latencyIter = latencyStats_.begin();
+	for(; latencyIter != latencyStats_.end(); ++latencyIter)
+		delete latencyIter->second;
+
+	latencyStats_.clear();
+
 	reqCreateAndLoginTotalCount_ = 0;
 	SAFE_RELEASE(pCreateAndLoginHandler_);
 	
@@ -172,6 +217,7 @@ void Bots::finalise()
 bool Bots::installEntityDef()
 {
 	EntityDef::entityAliasID(ServerConfig::getSingleton().getCellApp().aliasEntityID);
+	EntityDef::entityAliasIDSlots(ServerConfig::getSingleton().getCellApp().aliasEntityIDSlots);
 	EntityDef::entitydefAliasID(ServerConfig::getSingleton().getCellApp().entitydefAliasID);
 
 	return ClientApp::installEntityDef();
@@ -193,6 +239,8 @@ bool Bots::installPyModules()
 	registerPyObjectToScript("bots", pPyBots_);
 	
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), addBots, __py_addBots,	METH_VARARGS, 0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), recordLatency, __py_recordLatency,	METH_VARARGS, 0);
+	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(), latencyStats, __py_latencyStats,	METH_VARARGS, 0);
 
 	// עýű
 	APPEND_SCRIPT_MODULE_METHOD(getScript().getModule(),	scriptLogType,	__py_setScriptLogType,	METH_VARARGS,	0)
@@ -412,6 +460,99 @@ PyObject* Bots::__py_setScriptLogType(PyObject* self, PyObject* args)
 	S_Return;
 }
 
+//-------------------------------------------------------------------------------------
+void Bots::recordLatency(const std::string& name, uint64 stamps)
+{
+	recordLatencyMicroseconds(name, uint64(double(stamps) * 1000000.0 / stampsPerSecondD()));
+}
+
+//-------------------------------------------------------------------------------------
+void Bots::recordLatencyMicroseconds(const std::string& name, uint64 us)
+{
+	LATENCY_STATS::iterator iter = latencyStats_.find(name);
+	if(iter == latencyStats_.end())
+		iter = latencyStats_.insert(std::make_pair(name, new LatencyStats(name))).first;
+
+	iter->second->addMicroseconds(us);
+}
+
+//-------------------------------------------------------------------------------------
+void Bots::dumpLatencyStats()
+{
+	if(latencyStats_.empty())
+		return;
+
+	std::string datas = "{";
+
+	LATENCY_STATS::iterator iter = latencyStats_.begin();
+	for(; iter != latencyStats_.end(); ++iter)
+	{
+		INFO_MSG(fmt::format("Bots::dumpLatencyStats: {}\n", iter->second->summary()));
+
+		if(iter != latencyStats_.begin())
+			datas += ",";
+
+		datas += iter->second->toJson();
+	}
+
+	datas += "}";
+
+	std::string filename = fmt::format("bots_latency_{}.json", (uint64)::time(NULL));
+	FILE* f = fopen(filename.c_str(), "wb");
+	if(f)
+	{
+		fwrite(datas.data(), 1, datas.size(), f);
+		fclose(f);
+		INFO_MSG(fmt::format("Bots::dumpLatencyStats: written to {}.\n", filename));
+	}
+	else
+	{
+		ERROR_MSG(fmt::format("Bots::dumpLatencyStats: unable to write {}!\n", filename));
+	}
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Bots::__py_recordLatency(PyObject* self, PyObject* args)
+{
+	char* name = NULL;
+	double seconds = 0.0;
+
+	if(PyTuple_Size(args) != 2 || !PyArg_ParseTuple(args, "sd", &name, &seconds))
+	{
+		PyErr_Format(PyExc_TypeError, "KBEngine::recordLatency(name, seconds): args error!");
+		PyErr_PrintEx(0);
+		return NULL;
+	}
+
+	if(seconds < 0.0)
+		seconds = 0.0;
+
+	Bots::getSingleton().recordLatencyMicroseconds(name, uint64(seconds * 1000000.0));
+	S_Return;
+}
+
+//-------------------------------------------------------------------------------------
+PyObject* Bots::__py_latencyStats(PyObject* self, PyObject* args)
+{
+	PyObject* pyDict = PyDict_New();
+
+	LATENCY_STATS& stats = Bots::getSingleton().latencyStats_;
+	LATENCY_STATS::iterator iter = stats.begin();
+	for(; iter != stats.end(); ++iter)
+	{
+		LatencyStats* pStats = iter->second;
+
+		// (count, avg, p50, p99, max) λ
+		PyObject* pyTuple = Py_BuildValue("(Kdddd)", (unsigned long long)pStats->count(), pStats->avgTime(),
+			pStats->percentile(0.5f), pStats->percentile(0.99f), pStats->maxTime());
+
+		PyDict_SetItemString(pyDict, iter->first.c_str(), pyTuple);
+		Py_DECREF(pyTuple);
+	}
+
+	return pyDict;
+}
+
 //-------------------------------------------------------------------------------------
 void Bots::lookApp(Network::Channel* pChannel)
 {
@@ -537,6 +678,21 @@ ClientObject* Bots::findClient(Network::Channel * pChannel)
 	return NULL;
 }
 
+//-------------------------------------------------------------------------------------
+BotsIOTask* Bots::findIOTask()
+{
+	BotsIOTask* pFound = NULL;
+
+	std::vector<BotsIOTask*>::iterator iter = ioTasks_.begin();
+	for(; iter != ioTasks_.end(); ++iter)
+	{
+		if(pFound == NULL || (*iter)->numSockets() < pFound->numSockets())
+			pFound = (*iter);
+	}
+
+	return pFound;
+}
+
 //-------------------------------------------------------------------------------------
 ClientObject* Bots::findClientByAppID(int32 appID)
 {
@@ -1466,6 +1622,16 @@ void Bots::acrossServerReady(Network::Channel * pChannel, MemoryStream& s)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void Bots::onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds)
+{
+	ClientObject* pClient = findClient(pChannel);
+	if (pClient)
+	{
+		pClient->onLoginQueuePosition(pChannel, position, waitSeconds);
+	}
+}
+
 //-------------------------------------------------------------------------------------
 
 }
@@ -25,6 +25,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 // common include	
 #include "profile.h"
 #include "create_and_login_handler.h"
+#include "latency_stats.h"
 #include "common/timer.h"
 #include "pyscript/script.h"
 #include "network/endpoint.h"
@@ -54,6 +55,7 @@ namespace KBEngine{
 class ClientObject;
 class PyBots;
 class TelnetServer;
+class BotsIOTask;
 
 class Bots  : public ClientApp
 {
@@ -89,6 +91,21 @@ public:
 	*/
 	static PyObject* __py_setScriptLogType(PyObject* self, PyObject* args);
 
+	/**
+		¼һοͻ˹۲쵽ӳ٣ Ʒֱͳ
+		loginloginBaseappenterWorld űԼ¼Զӳ(緽)
+	*/
+	void recordLatency(const std::string& name, uint64 stamps);
+	void recordLatencyMicroseconds(const std::string& name, uint64 us);
+
+	/**
+		ӳͳƵ־ дbots_latency_<ʱ>.json
+	*/
+	void dumpLatencyStats();
+
+	static PyObject* __py_recordLatency(PyObject* self, PyObject* args);
+	static PyObject* __py_latencyStats(PyObject* self, PyObject* args);
+
 	bool run(void);
 
 	/**
@@ -132,6 +149,11 @@ public:
 	ClientObject* findClient(Network::Channel * pChannel);
 	ClientObject* findClientByAppID(int32 appID);
 
+	/** 
+		bots/ioThreadsʱٵIO 򷵻NULL(߳жȡ)
+	*/
+	BotsIOTask* findIOTask();
+
 	static PyObject* __py_addBots(PyObject* self, PyObject* args);
 
 	/** ӿ
@@ -383,6 +405,11 @@ public:
 	*/
 	virtual void acrossServerReady(Network::Channel* pChannel, MemoryStream& s);
 
+	/** ӿ
+		¼Ŷ
+	*/
+	virtual void onLoginQueuePosition(Network::Channel* pChannel, uint32 position, uint32 waitSeconds);
+
 protected:
 	PyBots*													pPyBots_;
 
@@ -399,6 +426,13 @@ protected:
 	Network::EventPoller*									pEventPoller_;
 
 	TelnetServer*											pTelnetServer_;
+
+	// ֵȡIO߳ ̳߳س
+	std::vector<BotsIOTask*>								ioTasks_;
+
+	// ͻ˹۲쵽ĸӳͳ
+	typedef std::map< std::string, LatencyStats* > LATENCY_STATS;
+	LATENCY_STATS											latencyStats_;
 };
 
 }
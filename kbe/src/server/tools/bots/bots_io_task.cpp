@@ -0,0 +1,256 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bots_io_task.h"
+#include "clientobject.h"
+#include "network/common.h"
+#include "network/event_poller.h"
+#include "server/serverconfig.h"
+
+namespace KBEngine{
+
+//-------------------------------------------------------------------------------------
+BotsIOSocket::BotsIOSocket(BotsIOTask* pTask, ClientObject* pClient, int fd):
+pTask_(pTask),
+pClient_(pClient),
+fd_(fd),
+recvBuffer_(),
+error_(false),
+paused_(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+BotsIOSocket::~BotsIOSocket()
+{
+#if KBE_PLATFORM != PLATFORM_WIN32
+	if(fd_ >= 0)
+		::close(fd_);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+int BotsIOSocket::handleInputNotification(int fd)
+{
+	// IOִ߳
+	char buffer[65536];
+
+	while(true)
+	{
+		int len = (int)::recv(fd_, buffer, sizeof(buffer), 0);
+
+		if(len > 0)
+		{
+			recvBuffer_.append(buffer, len);
+
+			if(recvBuffer_.size() >= BotsIOTask::MAX_BUFFERED_BYTES)
+			{
+				// ʣںУ TCP÷
+				paused_ = true;
+				pTask_->pPoller()->deregisterForRead(fd_);
+				break;
+			}
+
+			continue;
+		}
+
+#if KBE_PLATFORM != PLATFORM_WIN32
+		if(len < 0 && errno == EINTR)
+			continue;
+
+		if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+#endif
+
+		// Զ˹رջ߳ ߳
+		error_ = true;
+		pTask_->pPoller()->deregisterForRead(fd_);
+		break;
+	}
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+BotsIOTask::BotsIOTask(uint32 index):
+index_(index),
+pPoller_(Network::EventPoller::create()),
+sockets_(),
+pendingAdds_(),
+pendingRemoves_(),
+numSockets_(0),
+stopped_(false)
+{
+}
+
+//-------------------------------------------------------------------------------------
+BotsIOTask::~BotsIOTask()
+{
+	std::vector<BotsIOSocket*>::iterator iter = sockets_.begin();
+	for(; iter != sockets_.end(); ++iter)
+		closeSocket((*iter));
+
+	iter = pendingAdds_.begin();
+	for(; iter != pendingAdds_.end(); ++iter)
+		delete (*iter);
+
+	// ѾƳӿܻsockets_У Ѿͷ
+	sockets_.clear();
+	pendingAdds_.clear();
+	pendingRemoves_.clear();
+
+	SAFE_RELEASE(pPoller_);
+}
+
+//-------------------------------------------------------------------------------------
+BotsIOSocket* BotsIOTask::addSocket(ClientObject* pClient, int fd)
+{
+#if KBE_PLATFORM == PLATFORM_WIN32
+	return NULL;
+#else
+	int iofd = ::dup(fd);
+	if(iofd < 0)
+	{
+		ERROR_MSG(fmt::format("BotsIOTask::addSocket: dup({}) error({})!\n", fd, kbe_strerror()));
+		return NULL;
+	}
+
+	BotsIOSocket* pSocket = new BotsIOSocket(this, pClient, iofd);
+	pendingAdds_.push_back(pSocket);
+	++numSockets_;
+	return pSocket;
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void BotsIOTask::removeSocket(BotsIOSocket* pSocket)
+{
+	// IO߳̿ڶȡӣ עpresentMainThreadн
+	pSocket->pClient_ = NULL;
+	pendingRemoves_.push_back(pSocket);
+
+	KBE_ASSERT(numSockets_ > 0);
+	--numSockets_;
+}
+
+//-------------------------------------------------------------------------------------
+void BotsIOTask::closeSocket(BotsIOSocket* pSocket)
+{
+	if(!pSocket->error_ && !pSocket->paused_)
+		pPoller_->deregisterForRead(pSocket->fd_);
+
+	delete pSocket;
+}
+
+//-------------------------------------------------------------------------------------
+bool BotsIOTask::process()
+{
+	// һʱ䣬 ֤߳һtick֮ǰȥ
+	uint64 startTime = timestamp();
+	uint64 budget = stampsPerSecond() * 8 / (10 * g_kbeSrvConfig.gameUpdateHertz());
+
+	while(true)
+	{
+		uint64 elapsed = timestamp() - startTime;
+		if(elapsed >= budget)
+			break;
+
+		pPoller_->processPendingEvents(double(budget - elapsed) / stampsPerSecondD());
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState BotsIOTask::presentMainThread()
+{
+	// ȴƳ ƳδֱӶ
+	std::vector<BotsIOSocket*>::iterator iter = pendingRemoves_.begin();
+	for(; iter != pendingRemoves_.end(); ++iter)
+	{
+		BotsIOSocket* pSocket = (*iter);
+
+		std::vector<BotsIOSocket*>::iterator findIter = std::find(sockets_.begin(), sockets_.end(), pSocket);
+		if(findIter != sockets_.end())
+		{
+			sockets_.erase(findIter);
+			closeSocket(pSocket);
+			continue;
+		}
+
+		findIter = std::find(pendingAdds_.begin(), pendingAdds_.end(), pSocket);
+		if(findIter != pendingAdds_.end())
+			pendingAdds_.erase(findIter);
+
+		delete pSocket;
+	}
+
+	pendingRemoves_.clear();
+
+	if(stopped_)
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+
+	// յݽ߳̽ ϢClientObject::gameTickд
+	iter = sockets_.begin();
+	for(; iter != sockets_.end(); ++iter)
+	{
+		BotsIOSocket* pSocket = (*iter);
+
+		if(pSocket->recvBuffer_.size() > 0)
+		{
+			if(pSocket->pClient_)
+				pSocket->pClient_->onIORecv(pSocket->recvBuffer_.data(), pSocket->recvBuffer_.size());
+
+			pSocket->recvBuffer_.clear();
+		}
+
+		if(pSocket->error_)
+		{
+			// бֱClientObjectʱƳ
+			if(pSocket->pClient_)
+				pSocket->pClient_->onIOError();
+
+			continue;
+		}
+
+		if(pSocket->paused_)
+		{
+			pSocket->paused_ = false;
+			pPoller_->registerForRead(pSocket->fd_, pSocket);
+		}
+	}
+
+	iter = pendingAdds_.begin();
+	for(; iter != pendingAdds_.end(); ++iter)
+	{
+		BotsIOSocket* pSocket = (*iter);
+
+		if(!pPoller_->registerForRead(pSocket->fd_, pSocket))
+			pSocket->error_ = true;
+
+		sockets_.push_back(pSocket);
+	}
+
+	pendingAdds_.clear();
+	return thread::TPTask::TPTASK_STATE_CONTINUE_CHILDTHREAD;
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -0,0 +1,115 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_BOTS_IO_TASK_H
+#define KBE_BOTS_IO_TASK_H
+
+#include "common/common.h"
+#include "helper/debug_helper.h"
+#include "thread/threadtask.h"
+#include "network/interfaces.h"
+
+namespace KBEngine {
+
+namespace Network
+{
+	class EventPoller;
+}
+
+class ClientObject;
+class BotsIOTask;
+
+/*
+	IO̶߳ȡһ
+	IOֻ߳յֽڴ ϢȻ߳н
+	ʹdupľ ̹߳رӺŲע֮ǰ
+*/
+class BotsIOSocket : public Network::InputNotificationHandler
+{
+public:
+	BotsIOSocket(BotsIOTask* pTask, ClientObject* pClient, int fd);
+	virtual ~BotsIOSocket();
+
+	virtual int handleInputNotification(int fd);
+
+	ClientObject* pClient() const { return pClient_; }
+	int fd() const { return fd_; }
+
+protected:
+	friend class BotsIOTask;
+
+	BotsIOTask* pTask_;
+	ClientObject* pClient_;
+	int fd_;
+
+	std::string recvBuffer_;		// IO߳յδ̵߳
+	bool error_;					// ӶϿ
+	bool paused_;					// ߳ ͣȡ
+};
+
+/*
+	˵ȡ߳
+	ÿԼpollerһӣ ̳߳жȡһtickҵʱص̣߳
+	presentMainThreadаյݽClientObject ȻٴͶݵ̳߳
+	ӵɾֻpresentMainThreadЧ ʱIO߳ûУ ˲Ҫ
+*/
+class BotsIOTask : public thread::TPTask
+{
+public:
+	BotsIOTask(uint32 index);
+	virtual ~BotsIOTask();
+
+	virtual bool process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	/** ̵߳ã һλص߳ʱעᵽpoller ʧܷNULL */
+	BotsIOSocket* addSocket(ClientObject* pClient, int fd);
+
+	/** ̵߳ã úʹpSocket δ̵߳ݱ */
+	void removeSocket(BotsIOSocket* pSocket);
+
+	/** ̵߳ã һλص߳ʱ */
+	void stop() { stopped_ = true; }
+
+	uint32 numSockets() const { return numSockets_; }
+	uint32 index() const { return index_; }
+
+	Network::EventPoller* pPoller() const { return pPoller_; }
+
+	/** ÿ໺ֽ ͣȡֱ߳ȡ */
+	static const size_t MAX_BUFFERED_BYTES = 1024 * 1024;
+
+protected:
+	void closeSocket(BotsIOSocket* pSocket);
+
+	uint32 index_;
+	Network::EventPoller* pPoller_;
+
+	std::vector<BotsIOSocket*> sockets_;
+	std::vector<BotsIOSocket*> pendingAdds_;
+	std::vector<BotsIOSocket*> pendingRemoves_;
+
+	uint32 numSockets_;
+	bool stopped_;
+};
+
+}
+
+#endif // KBE_BOTS_IO_TASK_H
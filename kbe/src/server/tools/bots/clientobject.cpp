@@ -19,7 +19,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "bots.h"
 #include "clientobject.h"
+#include "bots_io_task.h"
 #include "network/common.h"
+#include "network/error_reporter.h"
 #include "network/message_handler.h"
 #include "network/tcp_packet.h"
 #include "network/bundle.h"
@@ -58,7 +60,15 @@ error_(C_ERROR_NONE),
 state_(C_STATE_INIT),
 pBlowfishFilter_(0),
 pTCPPacketSenderEx_(NULL),
-pTCPPacketReceiverEx_(NULL)
+pTCPPacketReceiverEx_(NULL),
+loginStartTime_(0),
+enterWorldStartTime_(0),
+loginQueueStartTime_(0),
+pIOTask_(NULL),
+pIOSocket_(NULL),
+pScenario_(NULL),
+scenarioCreated_(false),
+lastScenarioTickTime_(0)
 {
 	name_ = name;
 	typeClient_ = CLIENT_TYPE_BOTS;
@@ -82,8 +92,8 @@ void ClientObject::finalise(void)
 //-------------------------------------------------------------------------------------		
 void ClientObject::reset(void)
 {
-	if(pTCPPacketReceiverEx_)
-		Bots::getSingleton().networkInterface().dispatcher().deregisterReadFileDescriptor(*pTCPPacketReceiverEx_->pEndPoint());
+	destroyScenario();
+	deregisterReceiver();
 
 	if(pServerChannel_ && pServerChannel_->pEndPoint())
 	{
@@ -106,8 +116,7 @@ void ClientObject::reset(void)
 
 void ClientObject::clearStates(void)
 {
-	if (pTCPPacketReceiverEx_)
-		Bots::getSingleton().networkInterface().dispatcher().deregisterReadFileDescriptor(*pTCPPacketReceiverEx_->pEndPoint());
+	deregisterReceiver();
 
 	pServerChannel_->stopSend();
 	pServerChannel_->pPacketSender(NULL);
@@ -162,6 +171,8 @@ bool ClientObject::initCreate()
 	Network::Address addr(infos.login_ip, infos.login_port);
 	pEndpoint->addr(addr);
 
+	loginStartTime_ = timestamp();
+
 	pServerChannel_->pEndPoint(pEndpoint);
 	pEndpoint->setnonblocking(true);
 	pEndpoint->setnodelay(true);
@@ -170,7 +181,7 @@ bool ClientObject::initCreate()
 
 	pTCPPacketSenderEx_ = new Network::TCPPacketSenderEx(*pEndpoint, this->networkInterface_, this);
 	pTCPPacketReceiverEx_ = new Network::TCPPacketReceiverEx(*pEndpoint, this->networkInterface_, this);
-	Bots::getSingleton().networkInterface().dispatcher().registerReadFileDescriptor((*pEndpoint), pTCPPacketReceiverEx_);
+	registerReceiver(pEndpoint);
 	
 	//ע
 	//Bots::getSingleton().networkInterface().dispatcher().registerWriteFileDescriptor((*pEndpoint), pTCPPacketSenderEx_);
@@ -234,7 +245,7 @@ bool ClientObject::initLoginBaseapp()
 
 	pTCPPacketSenderEx_ = new Network::TCPPacketSenderEx(*pEndpoint, this->networkInterface_, this);
 	pTCPPacketReceiverEx_ = new Network::TCPPacketReceiverEx(*pEndpoint, this->networkInterface_, this);
-	Bots::getSingleton().networkInterface().dispatcher().registerReadFileDescriptor((*pEndpoint), pTCPPacketReceiverEx_);
+	registerReceiver(pEndpoint);
 
 	//ע
 	//Bots::getSingleton().networkInterface().dispatcher().registerWriteFileDescriptor((*pEndpoint), pTCPPacketSenderEx_);
@@ -285,6 +296,7 @@ void ClientObject::gameTick()
 			connectedBaseapp_ = false;
 			canReset_ = true;
 			state_ = C_STATE_INIT;
+			destroyScenario();
 			
 			DEBUG_MSG(fmt::format("ClientObject({})::tickSend: serverCloased! name({})!\n", 
 			this->appID(), this->name()));
@@ -339,6 +351,7 @@ void ClientObject::gameTick()
 
 			break;
 		case C_STATE_PLAY:
+			tickScenario();
 			break;	
 		case C_STATE_DESTROYED:
 			return;
@@ -409,6 +422,15 @@ void ClientObject::onLoginSuccessfully(Network::Channel * pChannel, MemoryStream
 	INFO_MSG(fmt::format("ClientObject::onLoginSuccessfully: {} addr={}:{}!\n", 
 		name_, ip_, port_));
 
+	if(loginStartTime_ > 0)
+		Bots::getSingleton().recordLatency("login", timestamp() - loginStartTime_);
+
+	if(loginQueueStartTime_ > 0)
+	{
+		Bots::getSingleton().recordLatency("loginQueue", timestamp() - loginQueueStartTime_);
+		loginQueueStartTime_ = 0;
+	}
+
 	state_ = C_STATE_LOGIN_BASEAPP_CREATE;
 }
 
@@ -425,14 +447,35 @@ void ClientObject::onLoginFailed(Network::Channel * pChannel, MemoryStream& s)
 
 	// error_ = C_ERROR_LOGIN_FAILED;
 
+	loginQueueStartTime_ = 0;
+
 	// Ե¼
 	state_ = C_STATE_LOGIN;
 }
 
+//-------------------------------------------------------------------------------------	
+void ClientObject::onLoginQueuePosition(Network::Channel * pChannel, uint32 position, uint32 waitSeconds)
+{
+	if(loginQueueStartTime_ == 0)
+		loginQueueStartTime_ = timestamp();
+
+	DEBUG_MSG(fmt::format("ClientObject::onLoginQueuePosition: {} position={}, waitSeconds={}!\n", 
+		name_, position, waitSeconds));
+}
+
 //-------------------------------------------------------------------------------------	
 void ClientObject::onLoginBaseappSuccessfully(Network::Channel * pChannel, MemoryStream& s)
 {
 	ClientObjectBase::onLoginBaseappSuccessfully(pChannel, s);
+
+	uint64 now = timestamp();
+	if(loginStartTime_ > 0)
+	{
+		Bots::getSingleton().recordLatency("loginBaseapp", now - loginStartTime_);
+		loginStartTime_ = 0;
+	}
+
+	enterWorldStartTime_ = now;
 }
 
 //-------------------------------------------------------------------------------------	
@@ -447,5 +490,168 @@ void ClientObject::onLogin(Network::Bundle* pBundle)
 {
 }
 
+//-------------------------------------------------------------------------------------
+void ClientObject::onEntityEnterWorld(Network::Channel * pChannel, MemoryStream& s)
+{
+	ClientObjectBase::onEntityEnterWorld(pChannel, s);
+
+	if(enterWorldStartTime_ > 0)
+	{
+		client::Entity* pEntity = pPlayer();
+		if(pEntity && pEntity->inWorld())
+		{
+			Bots::getSingleton().recordLatency("enterWorld", timestamp() - enterWorldStartTime_);
+			enterWorldStartTime_ = 0;
+		}
+	}
+
+	client::Entity* pEntity = pPlayer();
+	if(pEntity && pEntity->inWorld())
+		createScenario();
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::registerReceiver(Network::EndPoint* pEndpoint)
+{
+	pIOTask_ = Bots::getSingleton().findIOTask();
+	if(pIOTask_)
+	{
+		pIOSocket_ = pIOTask_->addSocket(this, (int)(*pEndpoint));
+		if(pIOSocket_)
+			return;
+
+		pIOTask_ = NULL;
+	}
+
+	Bots::getSingleton().networkInterface().dispatcher().registerReadFileDescriptor((*pEndpoint), pTCPPacketReceiverEx_);
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::deregisterReceiver()
+{
+	if(pIOSocket_)
+	{
+		pIOTask_->removeSocket(pIOSocket_);
+		pIOSocket_ = NULL;
+		pIOTask_ = NULL;
+		return;
+	}
+
+	if(pTCPPacketReceiverEx_)
+		Bots::getSingleton().networkInterface().dispatcher().deregisterReadFileDescriptor(*pTCPPacketReceiverEx_->pEndPoint());
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::onIORecv(const char* datas, size_t size)
+{
+	if(!pTCPPacketReceiverEx_ || pServerChannel_->condemn() > 0)
+		return;
+
+	// ʱİСз
+	while(size > 0)
+	{
+		size_t len = KBE_MIN(size, (size_t)PACKET_MAX_SIZE_TCP);
+
+		Network::TCPPacket* pPacket = Network::TCPPacket::createPoolObject(OBJECTPOOL_POINT);
+		pPacket->append(datas, len);
+
+		Network::Reason ret = pTCPPacketReceiverEx_->processPacket(pServerChannel_, pPacket);
+		if(ret != Network::REASON_SUCCESS)
+		{
+			pTCPPacketReceiverEx_->dispatcher().errorReporter().reportException(ret, 
+				pServerChannel_->pEndPoint()->addr());
+		}
+
+		datas += len;
+		size -= len;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::onIOError()
+{
+	destroy();
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::createScenario()
+{
+	if(scenarioCreated_)
+		return;
+
+	scenarioCreated_ = true;
+
+	PyObject* pyEntryScript = Bots::getSingleton().getEntryScript().get();
+	if(pyEntryScript == NULL || !PyObject_HasAttrString(pyEntryScript, "onCreateBotScenario"))
+		return;
+
+	PyObject* pyResult = PyObject_CallMethod(pyEntryScript, 
+		const_cast<char*>("onCreateBotScenario"), const_cast<char*>("O"), static_cast<PyObject*>(this));
+
+	if(pyResult == NULL)
+	{
+		SCRIPT_ERROR_CHECK();
+		return;
+	}
+
+	// Noneʾ˲г
+	if(pyResult == Py_None)
+	{
+		Py_DECREF(pyResult);
+		return;
+	}
+
+	pScenario_ = pyResult;
+	lastScenarioTickTime_ = timestamp();
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::tickScenario()
+{
+	if(pScenario_ == NULL)
+		return;
+
+	uint64 now = timestamp();
+	float interval = g_kbeSrvConfig.getBots().bots_scenario_tickInterval;
+
+	if(interval > 0.f && now - lastScenarioTickTime_ < uint64(interval * stampsPerSecondD()))
+		return;
+
+	lastScenarioTickTime_ = now;
+
+	PyObject* pyResult = PyObject_CallMethod(pScenario_, 
+		const_cast<char*>("onTick"), const_cast<char*>("O"), static_cast<PyObject*>(this));
+
+	if(pyResult != NULL)
+		Py_DECREF(pyResult);
+	else
+		SCRIPT_ERROR_CHECK();
+}
+
+//-------------------------------------------------------------------------------------
+void ClientObject::destroyScenario()
+{
+	scenarioCreated_ = false;
+
+	if(pScenario_ == NULL)
+		return;
+
+	PyObject* pScenario = pScenario_;
+	pScenario_ = NULL;
+
+	if(PyObject_HasAttrString(pScenario, "onDestroy"))
+	{
+		PyObject* pyResult = PyObject_CallMethod(pScenario, 
+			const_cast<char*>("onDestroy"), const_cast<char*>("O"), static_cast<PyObject*>(this));
+
+		if(pyResult != NULL)
+			Py_DECREF(pyResult);
+		else
+			SCRIPT_ERROR_CHECK();
+	}
+
+	Py_DECREF(pScenario);
+}
+
 //-------------------------------------------------------------------------------------
 }
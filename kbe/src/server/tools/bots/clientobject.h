@@ -30,6 +30,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine { 
 
+class BotsIOTask;
+class BotsIOSocket;
+
 /*
 */
 
@@ -116,15 +119,54 @@ public:
 
 	virtual void onLoginBaseappFailed(Network::Channel * pChannel, SERVER_ERROR_CODE failedcode);
 
+	/** ӿ
+		¼Ŷ
+	*/
+	virtual void onLoginQueuePosition(Network::Channel* pChannel, uint32 position, uint32 waitSeconds);
+
 	virtual void onLogin(Network::Bundle* pBundle);
 
+	virtual void onEntityEnterWorld(Network::Channel * pChannel, MemoryStream& s);
+
+	/** 
+		IO̶߳ȡʱ ߳յӳ֪ͨ
+	*/
+	void onIORecv(const char* datas, size_t size);
+	void onIOError();
+
+	/** 
+		ű ҽڽűonCreateBotScenario(bot)
+		֮ÿscenario/tickIntervalһonTick(bot)
+	*/
+	void createScenario();
+	void tickScenario();
+	void destroyScenario();
+
 protected:
+	void registerReceiver(Network::EndPoint* pEndpoint);
+	void deregisterReceiver();
+
 	C_ERROR error_;
 	C_STATE state_;
 	Network::BlowfishFilter* pBlowfishFilter_;
 
 	Network::TCPPacketSenderEx* pTCPPacketSenderEx_;
 	Network::TCPPacketReceiverEx* pTCPPacketReceiverEx_;
+
+	// ͳƵ¼ӳ
+	uint64 loginStartTime_;
+	uint64 enterWorldStartTime_;
+
+	// һյŶ֪ͨʱ䣬ͳŶʱ
+	uint64 loginQueueStartTime_;
+
+	// bots/ioThreadsʱIO̶߳ȡ
+	BotsIOTask* pIOTask_;
+	BotsIOSocket* pIOSocket_;
+
+	PyObject* pScenario_;
+	bool scenarioCreated_;
+	uint64 lastScenarioTickTime_;
 };
 
 
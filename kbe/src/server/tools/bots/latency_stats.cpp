@@ -0,0 +1,102 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "latency_stats.h"
+
+namespace KBEngine { 
+
+//-------------------------------------------------------------------------------------
+LatencyStats::LatencyStats(const std::string& name):
+name_(name),
+count_(0),
+sum_(0),
+max_(0)
+{
+	memset(histogram_, 0, sizeof(histogram_));
+}
+
+//-------------------------------------------------------------------------------------
+LatencyStats::~LatencyStats()
+{
+}
+
+//-------------------------------------------------------------------------------------
+void LatencyStats::add(uint64 stamps)
+{
+	addMicroseconds(uint64(double(stamps) * 1000000.0 / stampsPerSecondD()));
+}
+
+//-------------------------------------------------------------------------------------
+void LatencyStats::addMicroseconds(uint64 us)
+{
+	int index = 0;
+	uint64 v = us;
+	while (v > 1 && index < HISTOGRAM_SIZE - 1)
+	{
+		v >>= 1;
+		++index;
+	}
+
+	++histogram_[index];
+	++count_;
+	sum_ += us;
+
+	if (us > max_)
+		max_ = us;
+}
+
+//-------------------------------------------------------------------------------------
+double LatencyStats::percentile(float p) const
+{
+	if (count_ == 0)
+		return 0.0;
+
+	uint64 target = uint64(double(count_) * p);
+	uint64 sum = 0;
+	int i = 0;
+
+	for (; i < HISTOGRAM_SIZE - 1; ++i)
+	{
+		sum += histogram_[i];
+		if (sum > target)
+			break;
+	}
+
+	// Ͱ޲ᳬʵʹ۲쵽ֵ
+	uint64 upper = uint64(1) << (i + 1);
+	return double(KBE_MIN(upper, max_)) / 1000.0;
+}
+
+//-------------------------------------------------------------------------------------
+std::string LatencyStats::summary() const
+{
+	return fmt::format("{}: count={}, avg={:.3f}ms, p50={:.3f}ms, p99={:.3f}ms, max={:.3f}ms",
+		name_, count_, avgTime(), percentile(0.5f), percentile(0.99f), maxTime());
+}
+
+//-------------------------------------------------------------------------------------
+std::string LatencyStats::toJson() const
+{
+	return fmt::format("\"{}\":{{\"count\":{},\"avg\":{:.3f},\"p50\":{:.3f},\"p99\":{:.3f},\"max\":{:.3f}}}",
+		name_, count_, avgTime(), percentile(0.5f), percentile(0.99f), maxTime());
+}
+
+//-------------------------------------------------------------------------------------
+}
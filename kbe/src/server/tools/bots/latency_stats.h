@@ -0,0 +1,69 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_BOTS_LATENCY_STATS_H
+#define KBE_BOTS_LATENCY_STATS_H
+
+#include "common/common.h"
+#include "common/timestamp.h"
+#include "helper/debug_helper.h"
+
+namespace KBEngine { 
+
+/*
+	ͻ˹۲쵽ӳͳ
+	ӳ(΢)log2Ͱ ѹʱõp50/p99/max
+*/
+class LatencyStats
+{
+public:
+	enum { HISTOGRAM_SIZE = 48 };
+
+	LatencyStats(const std::string& name);
+	~LatencyStats();
+
+	void add(uint64 stamps);
+	void addMicroseconds(uint64 us);
+
+	/** 
+		ذٷλͰӳ()
+	*/
+	double percentile(float p) const;
+
+	double maxTime() const { return double(max_) / 1000.0; }
+	double avgTime() const { return count_ > 0 ? double(sum_) / double(count_) / 1000.0 : 0.0; }
+	uint64 count() const { return count_; }
+
+	const std::string& name() const { return name_; }
+
+	std::string summary() const;
+	std::string toJson() const;
+
+private:
+	std::string name_;
+	uint32 histogram_[HISTOGRAM_SIZE];
+	uint64 count_;
+	uint64 sum_;
+	uint64 max_;
+};
+
+}
+
+#endif // KBE_BOTS_LATENCY_STATS_H
@@ -212,6 +212,13 @@ bool ClientSDK::create(const std::string& path)
 	if (!copyPluginsSourceToPath(getpath))
 		return false;
 
+	// ģеĿͻ˲Ŀǰְֻ֧˳ıID
+	if (g_kbeSrvConfig.getCellApp().aliasEntityID && g_kbeSrvConfig.getCellApp().aliasEntityIDSlots)
+	{
+		WARNING_MSG(fmt::format("ClientSDK::create(): cellapp/aliasEntityIDSlots is not supported by the {} plugins, "
+			"please disable it or the client will not be able to resolve entity aliases!\n", name()));
+	}
+
 	if (!writeServerErrorDescrsModule())
 		return false;
 
@@ -125,6 +125,7 @@ void KBCMD::handleMainTick()
 bool KBCMD::initializeBegin()
 {
 	EntityDef::entityAliasID(ServerConfig::getSingleton().getCellApp().aliasEntityID);
+	EntityDef::entityAliasIDSlots(ServerConfig::getSingleton().getCellApp().aliasEntityIDSlots);
 	EntityDef::entitydefAliasID(ServerConfig::getSingleton().getCellApp().entitydefAliasID);
 	return true;
 }
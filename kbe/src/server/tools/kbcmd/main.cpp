@@ -23,6 +23,8 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "client_sdk.h"
 #include "server_assets.h"
 #include "entitydef/entitydef.h"
+#include "entitydef/entitydef_cache.h"
+#include "navigation/navigation_mesh_handle.h"
 #include "pyscript/py_compression.h"
 #include "pyscript/py_platform.h"
 
@@ -415,6 +417,110 @@ int process_newassets(int argc, char* argv[], const std::string assetsType)
 	return ret;
 }
 
+int process_make_entitydef_cache(int argc, char* argv[])
+{
+	Resmgr::getSingleton().initialize();
+	setEvns();
+	loadConfig();
+
+	DebugHelper::initialize(g_componentType);
+
+	INFO_MSG("-----------------------------------------------------------------------------------------\n\n\n");
+
+	Resmgr::getSingleton().print();
+
+	Network::EventDispatcher dispatcher;
+	DebugHelper::getSingleton().pDispatcher(&dispatcher);
+
+	Network::g_SOMAXCONN = g_kbeSrvConfig.tcp_SOMAXCONN(g_componentType);
+
+	Network::NetworkInterface networkInterface(&dispatcher);
+
+	DebugHelper::getSingleton().pNetworkInterface(&networkInterface);
+
+	KBCMD app(dispatcher, networkInterface, g_componentType, g_componentID);
+
+	START_MSG(COMPONENT_NAME_EX(g_componentType), g_componentID);
+
+	if (!app.initialize())
+	{
+		ERROR_MSG("app::initialize(): initialization failed!\n");
+
+		app.finalise();
+
+		// ־δͬɣ ͬɲŽ
+		DebugHelper::getSingleton().finalise();
+		return -1;
+	}
+
+	// ¼ģʽ¼صdefļᱻд뻺棬سɹɻļ
+	EntityDefCache::recording(true);
+
+	std::vector<PyTypeObject*> scriptBaseTypes;
+	bool ret = EntityDef::initialize(scriptBaseTypes, g_componentType);
+
+	EntityDefCache::recording(false);
+
+	if (!ret)
+	{
+		ERROR_MSG("app::initialize(): EntityDef initialization failed!\n");
+	}
+
+	app.finalise();
+	INFO_MSG(fmt::format("{}({}) has shut down. EntityDefCache={}\n", COMPONENT_NAME_EX(g_componentType), g_componentID, ret));
+
+	// ־δͬɣ ͬɲŽ
+	DebugHelper::getSingleton().finalise();
+	return ret ? 0 : -1;
+}
+
+int process_make_navmesh_mapped(int argc, char* argv[], const std::string& path)
+{
+	Resmgr::getSingleton().initialize();
+	setEvns();
+	loadConfig();
+
+	DebugHelper::initialize(g_componentType);
+
+	INFO_MSG("-----------------------------------------------------------------------------------------\n\n\n");
+
+	Resmgr::getSingleton().print();
+
+	// ĬתԴĿ¼spacesµnavmesh Ҳͨ--navmeshmapped=ָĿ¼
+	std::string spacesPath = path;
+	if (spacesPath.size() > 0 && spacesPath[0] == '=')
+		spacesPath.erase(0, 1);
+
+	if (spacesPath.size() == 0)
+		spacesPath = Resmgr::getSingleton().matchPath("spaces");
+
+	wchar_t* wpath = strutil::char2wchar(spacesPath.c_str());
+	std::wstring wspath = wpath;
+	free(wpath);
+
+	std::vector<std::wstring> results;
+	Resmgr::getSingleton().listPathRes(wspath, L"navmesh", results);
+
+	int failed = 0;
+	std::vector<std::wstring>::iterator iter = results.begin();
+	for (; iter != results.end(); ++iter)
+	{
+		char* cpath = strutil::wchar2char((*iter).c_str());
+		std::string res = cpath;
+		free(cpath);
+
+		if (!NavMeshHandle::writeMappedNavmesh(res))
+			++failed;
+	}
+
+	INFO_MSG(fmt::format("{}({}) has shut down. navmesh={}, failed={}\n", COMPONENT_NAME_EX(g_componentType), g_componentID, 
+		results.size(), failed));
+
+	// ־δͬɣ ͬɲŽ
+	DebugHelper::getSingleton().finalise();
+	return failed == 0 ? 0 : -1;
+}
+
 int process_getuid(int argc, char* argv[])
 {
 	if (getUserUID() == 0)
@@ -444,6 +550,17 @@ int process_help(int argc, char* argv[])
 	printf("\tCreate a new server game asset library, contains the necessary files.\n");
 	printf("\tkbcmd.exe --newassets=python --outpath=c:/xserver_assets\n");
 
+	printf("\n--entitydefcache\n");
+	printf("\tCompile entities.xml, types.xml and all def files into a binary cache(entity_defs/entitydefs.cache).\n");
+	printf("\tProcesses load unchanged defs from the cache at startup and fall back to xml for changed ones.\n");
+	printf("\tkbcmd.exe --entitydefcache\n");
+
+	printf("\n--navmeshmapped\n");
+	printf("\tConvert every .navmesh under res/spaces(or the given path) into a .navmesh.mapped file next to it.\n");
+	printf("\tCellapps map that file copy-on-write instead of reading and copying every tile, so processes on one host share it.\n");
+	printf("\tkbcmd.exe --navmeshmapped\n");
+	printf("\tkbcmd.exe --navmeshmapped=c:/xserver_assets/res/spaces/xinshoucun\n");
+
 	printf("\n--help:\n");
 	printf("\tDisplay help information.\n");
 	return 0;
@@ -465,6 +582,8 @@ int main(int argc, char* argv[])
 	PARSE_COMMAND_ARG_DO_FUNC("--clientsdk=", process_make_client_sdk(argc, argv, cmd));
 	PARSE_COMMAND_ARG_DO_FUNC_RETURN("--getuid", process_getuid(argc, argv));
 	PARSE_COMMAND_ARG_DO_FUNC("--newassets=", process_newassets(argc, argv, cmd));
+	PARSE_COMMAND_ARG_DO_FUNC_RETURN("--entitydefcache", process_make_entitydef_cache(argc, argv));
+	PARSE_COMMAND_ARG_DO_FUNC_RETURN("--navmeshmapped", process_make_navmesh_mapped(argc, argv, cmd));
 	PARSE_COMMAND_ARG_DO_FUNC("--help", process_help(argc, argv));
 	PARSE_COMMAND_ARG_END();
 
@@ -59,6 +59,9 @@ Logger::Logger(Network::EventDispatcher& dispatcher,
 	PythonApp(dispatcher, ninterface, componentType, componentID),
 logWatchers_(),
 buffered_logs_(),
+pFreeLogItem_(NULL),
+logFormatter_(),
+logStore_(),
 timer_(),
 pTelnetServer_(NULL)
 {
@@ -78,6 +81,11 @@ bool Logger::initializeWatcher()
 	WATCH_OBJECT("stats/totalNumlogs", &totalNumlogs);
 	WATCH_OBJECT("stats/secsNumlogs", &secsNumlogs);
 	WATCH_OBJECT("stats/bufferedLogsSize", this, &Logger::bufferedLogsSize);
+	WATCH_OBJECT("stats/store/numRecords", &logStore_, &LogStore::numRecords);
+	WATCH_OBJECT("stats/store/numBytes", &logStore_, &LogStore::numBytes);
+	WATCH_OBJECT("stats/store/numBlocks", &logStore_, &LogStore::numBlocks);
+	WATCH_OBJECT("stats/store/numSegments", &logStore_, &LogStore::numSegments);
+	WATCH_OBJECT("stats/store/pendingBytes", &logStore_, &LogStore::pendingBytes);
 	return true;
 }
 
@@ -113,6 +121,7 @@ void Logger::handleTick()
 		g_secsNumlogs = 0;
 	}
 
+	logStore_.tick(threadPool_);
 	threadPool_.onMainThreadTick();
 	networkInterface().processChannels(&LoggerInterface::messageHandlers);
 }
@@ -141,6 +150,17 @@ bool Logger::initializeEnd()
 	timer_ = this->dispatcher().addTimer(1000000 / 50, this,
 							reinterpret_cast<void *>(TIMEOUT_TICK));
 
+	ENGINE_COMPONENT_INFO& info = g_kbeSrvConfig.getLogger();
+	if (info.logStore_enable)
+	{
+		if (!logStore_.initialize(info.logStore_path, info.logStore_segmentSize, 
+			info.logStore_blockSize, info.logStore_flushInterval))
+		{
+			ERROR_MSG(fmt::format("Logger::initializeEnd: logStore initialize failed, path={}!\n", 
+				info.logStore_path));
+		}
+	}
+
 	SCOPED_PROFILE(SCRIPTCALL_PROFILE);
 
 	// нű
@@ -183,6 +203,9 @@ void Logger::finalise()
 	}
 
 	buffered_logs_.clear();
+	SAFE_RELEASE(pFreeLogItem_);
+
+	logStore_.finalise();
 
 	timer_.cancel();
 	PythonApp::finalise();
@@ -243,14 +266,38 @@ void Logger::onShutdownEnd()
 	PythonApp::onShutdownEnd();
 }
 
+//-------------------------------------------------------------------------------------
+LOG_ITEM* Logger::createLogItem_()
+{
+	if (pFreeLogItem_)
+	{
+		LOG_ITEM* pLogItem = pFreeLogItem_;
+		pFreeLogItem_ = NULL;
+		pLogItem->persistent = true;
+		pLogItem->storeSeq = 0;
+		return pLogItem;
+	}
+
+	return new LOG_ITEM();
+}
+
+//-------------------------------------------------------------------------------------
+void Logger::reclaimLogItem_(LOG_ITEM* pLogItem)
+{
+	// ֻһö ÿ־ֻӻ̭һ
+	if (pFreeLogItem_ == NULL)
+		pFreeLogItem_ = pLogItem;
+	else
+		delete pLogItem;
+}
+
 //-------------------------------------------------------------------------------------
 void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
 	++g_secsNumlogs;
 	++g_totalNumlogs;
 
-	LOG_ITEM* pLogItem = new LOG_ITEM();
-	std::string str;
+	LOG_ITEM* pLogItem = createLogItem_();
 
 	s >> pLogItem->uid;
 	s >> pLogItem->logtype;
@@ -260,47 +307,21 @@ void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 	s >> pLogItem->componentGroupOrder;
 	s >> pLogItem->t;
 	s >> pLogItem->kbetime;
-	s.readBlob(str);
-
-	time_t tt = static_cast<time_t>(pLogItem->t);	
-    tm* aTm = localtime(&tt);
-    //       YYYY   year
-    //       MM     month (2 digits 01-12)
-    //       DD     day (2 digits 01-31)
-    //       HH     hour (2 digits 00-23)
-    //       MM     minutes (2 digits 00-59)
-    //       SS     seconds (2 digits 00-59)
-
-	if(aTm == NULL)
+
+	// յblobḳֵ õĶҪ
+	pLogItem->message.clear();
+	s.readBlob(pLogItem->message);
+
+	if(!logFormatter_.format(*pLogItem, pLogItem->logstr))
 	{
 		ERROR_MSG("Logger::writeLog: log error!\n");
-		delete pLogItem;
+		reclaimLogItem_(pLogItem);
 		return;
 	}
 
-	char timebuf[MAX_BUF];
-
-	pLogItem->logstream << KBELOG_TYPE_NAME_EX(pLogItem->logtype);
-	pLogItem->logstream << " ";
-	pLogItem->logstream << COMPONENT_NAME_EX_2(pLogItem->componentType);
-
-    kbe_snprintf(timebuf, MAX_BUF, "%02d", (int)pLogItem->componentGroupOrder);
-	pLogItem->logstream << timebuf;
-	pLogItem->logstream << " ";
-	pLogItem->logstream << pLogItem->uid;
-	pLogItem->logstream << " ";
-	pLogItem->logstream << pLogItem->componentID;
-	pLogItem->logstream << " ";
-
-    kbe_snprintf(timebuf, MAX_BUF, " [%-4d-%02d-%02d %02d:%02d:%02d %03d] ", aTm->tm_year+1900, aTm->tm_mon+1, 
-		aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec, pLogItem->kbetime);
-	pLogItem->logstream << timebuf;
-
-	pLogItem->logstream << "- ";
-	pLogItem->logstream << str;
-
-	// ¼־ڽűصʱʹ
-	std::string sLog = pLogItem->logstream.str();
+	// űԸддı־ݣûидʱֱʹ־⿽
+	const std::string* pLog = &pLogItem->logstr;
+	std::string scriptLog;
 
 	static bool notificationScript = getEntryScript().get() && PyObject_HasAttrString(getEntryScript().get(), "onLogWrote") > 0;
 	if (notificationScript)
@@ -308,8 +329,8 @@ void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 		PyObject* pyResult = PyObject_CallMethod(getEntryScript().get(),
 			const_cast<char*>("onLogWrote"),
 			const_cast<char*>("y#"),
-			sLog.c_str(),
-			sLog.length());
+			pLogItem->logstr.c_str(),
+			pLogItem->logstr.length());
 
 		if (pyResult != NULL)
 		{
@@ -326,11 +347,14 @@ void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 				if (size > 0)
 				{
 					if (data)
-						sLog.assign(data, size);
+					{
+						scriptLog.assign(data, size);
+						pLog = &scriptLog;
+					}
 				}
 				else
 				{
-					sLog = "";
+					pLog = &scriptLog;
 				}
 			}
 
@@ -349,12 +373,25 @@ void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 		if (!DebugHelper::getSingleton().canLog(pLogItem->logtype))
 		{
 			DebugHelper::getSingleton().changeLogger("default");
-			delete pLogItem;
+			reclaimLogItem_(pLogItem);
 			return;
 		}
 		 
-		PRINT_MSG(sLog);
+		if (g_kbeSrvConfig.getLogger().logStore_textLogs || !logStore_.isInitialized())
+			PRINT_MSG(*pLog);
+
 		DebugHelper::getSingleton().changeLogger("default");
+
+		// ı־һ£ 洢űдݣ дΪյ־洢
+		if (pLog != &pLogItem->logstr)
+		{
+			if (pLog->size() > 0)
+				pLogItem->storeSeq = logStore_.append(*pLogItem, pLog);
+		}
+		else
+		{
+			pLogItem->storeSeq = logStore_.append(*pLogItem);
+		}
 	}
 
 	LOG_WATCHERS::iterator iter = logWatchers_.begin();
@@ -369,7 +406,7 @@ void Logger::writeLog(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 	{
 		pLogItem = buffered_logs_.front();
 		buffered_logs_.pop_front();
-		delete pLogItem;
+		reclaimLogItem_(pLogItem);
 	}
 }
 
@@ -405,10 +442,50 @@ void Logger::registerLogWatcher(Network::Channel* pChannel, KBEngine::MemoryStre
 	bool first;
 	s >> first;
 
+	// ģʽ´־洢мʷ־ ־ڲѯ֮ͣ û־洢ʱȻֻܴӻ־в
+	if(pLogwatcher->state() == LogWatcher::STATE_FINDING && findLogs(*pLogwatcher, first))
+		return;
+
 	if(first)
 		sendInitLogs(*pLogwatcher);
 }
 
+//-------------------------------------------------------------------------------------
+bool Logger::findLogs(LogWatcher& logWatcher, bool sendInit)
+{
+	if(!logStore_.isInitialized())
+		return false;
+
+	LogStoreQuery query;
+	logWatcher.makeStoreQuery(query);
+	query.maxResults = g_kbeSrvConfig.getLogger().logStore_maxQueryResults;
+	query.sessionSegment = logStore_.sessionSegment();
+
+	// ǰ黹ûд룬 պɲѯдٲѯ
+	logStore_.seal();
+
+	LogQueryTask* pTask = new LogQueryTask(logWatcher.addr(), &logStore_, query);
+
+	if(sendInit)
+	{
+		// Ѿд洢־ٴӴ洢зأ ظ
+		std::deque<LOG_ITEM*>::iterator iter = buffered_logs_.begin();
+		for(; iter != buffered_logs_.end(); ++iter)
+		{
+			LOG_ITEM* pLogItem = (*iter);
+
+			if(pLogItem->storeSeq > 0 && pTask->seqLimit() == 0)
+				pTask->seqLimit(pLogItem->storeSeq);
+
+			if(logWatcher.accept(pLogItem))
+				pTask->addInitLog(pLogItem->logstr);
+		}
+	}
+
+	threadPool_.addTask(pTask);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 void Logger::deregisterLogWatcher(Network::Channel* pChannel, KBEngine::MemoryStream& s)
 {
@@ -32,6 +32,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/common.h"
 #include "network/address.h"
 #include "logwatcher.h"
+#include "logstore.h"
 
 //#define NDEBUG
 #include <map>	
@@ -50,6 +51,7 @@ struct LOG_ITEM
 	LOG_ITEM()
 	{
 		persistent = true;
+		storeSeq = 0;
 	}
 
 	int32 uid;
@@ -60,8 +62,11 @@ struct LOG_ITEM
 	COMPONENT_ORDER componentGroupOrder;
 	int64 t;
 	GAME_TIME kbetime;
-	std::stringstream logstream;
+	std::string message;
+	std::string logstr;
 	bool persistent;
+	uint64 storeSeq;										// д־洢ţ 0Ϊûд
+
 };
 
 class Logger:	public PythonApp, 
@@ -128,9 +133,23 @@ public:
 
 	void sendInitLogs(LogWatcher& logWatcher);
 
+	/** 
+		ͨ־洢ں̨߳вʷ־
+	*/
+	bool findLogs(LogWatcher& logWatcher, bool sendInit);
+
+	LogStore& logStore(){ return logStore_; }
+
+protected:
+	LOG_ITEM* createLogItem_();
+	void reclaimLogItem_(LOG_ITEM* pLogItem);
+
 protected:
 	LOG_WATCHERS logWatchers_;
 	std::deque<LOG_ITEM*> buffered_logs_;
+	LOG_ITEM* pFreeLogItem_;
+	LogFormatter logFormatter_;
+	LogStore logStore_;
 	TimerHandle	timer_;
 
 	TelnetServer* pTelnetServer_;
@@ -0,0 +1,918 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "logstore.h"
+#include "logger.h"
+#include "common/timestamp.h"
+#include "common/strutil.h"
+#include "resmgr/resmgr.h"
+#include "network/bundle.h"
+#include "network/channel.h"
+#include "network/network_interface.h"
+#include "thread/threadpool.h"
+#include "thread/threadguard.h"
+#include "helper/console_helper.h"
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+#include <direct.h>
+#include <io.h>
+#define KBE_ACCESS _access
+#define KBE_MKDIR(a) _mkdir((a))
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define KBE_ACCESS access
+#define KBE_MKDIR(a) KBE_UNIX_MKDIR((a))
+
+static int KBE_UNIX_MKDIR(const char* a)
+{
+	return mkdir((a), 0755);
+}
+#endif
+
+namespace KBEngine{
+
+//-------------------------------------------------------------------------------------
+static int creatStoreDir(const char *pDir)
+{
+	int iRet = 0;
+	char* pszDir = strdup(pDir);
+	int iLen = (int)strlen(pszDir);
+
+	// мĿ¼
+	for (int i = 0; i < iLen; i++)
+	{
+		if (pszDir[i] == '\\' || pszDir[i] == '/')
+		{
+			if (i == 0)
+				continue;
+
+			pszDir[i] = '\0';
+
+			if (KBE_ACCESS(pszDir, 0) != 0)
+			{
+				iRet = KBE_MKDIR(pszDir);
+				if (iRet != 0)
+				{
+					ERROR_MSG(fmt::format("LogStore::creatStoreDir(): KBE_MKDIR [{}] error! iRet={}\n",
+						pszDir, iRet));
+
+					free(pszDir);
+					return -1;
+				}
+			}
+
+			pszDir[i] = '/';
+		}
+	}
+
+	if (iLen > 0 && KBE_ACCESS(pszDir, 0) != 0)
+	{
+		iRet = KBE_MKDIR(pszDir);
+
+		if (iRet != 0)
+		{
+			ERROR_MSG(fmt::format("LogStore::creatStoreDir(): KBE_MKDIR [{}] error! iRet={}\n",
+				pszDir, iRet));
+		}
+	}
+
+	free(pszDir);
+	return iRet;
+}
+
+//-------------------------------------------------------------------------------------
+LogFormatter::LogFormatter():
+lastTime_(0),
+valid_(false)
+{
+	timebuf_[0] = '\0';
+}
+
+//-------------------------------------------------------------------------------------
+bool LogFormatter::format(const LOG_ITEM& item, std::string& out)
+{
+	time_t tt = static_cast<time_t>(item.t);
+
+	// ͬһڵ־Ҫظlocaltime
+	if (!valid_ || tt != lastTime_)
+	{
+		struct tm aTm;
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+		if (localtime_s(&aTm, &tt) != 0)
+			return false;
+#else
+		if (localtime_r(&tt, &aTm) == NULL)
+			return false;
+#endif
+
+		//       YYYY   year
+		//       MM     month (2 digits 01-12)
+		//       DD     day (2 digits 01-31)
+		//       HH     hour (2 digits 00-23)
+		//       MM     minutes (2 digits 00-59)
+		//       SS     seconds (2 digits 00-59)
+		kbe_snprintf(timebuf_, sizeof(timebuf_), "%-4d-%02d-%02d %02d:%02d:%02d", aTm.tm_year + 1900, aTm.tm_mon + 1,
+			aTm.tm_mday, aTm.tm_hour, aTm.tm_min, aTm.tm_sec);
+
+		lastTime_ = tt;
+		valid_ = true;
+	}
+
+	char buf[MAX_BUF];
+	int len = kbe_snprintf(buf, MAX_BUF, "%02d %d %" PRIu64 "  [%s %03u] - ", (int)item.componentGroupOrder, 
+		item.uid, (uint64)item.componentID, timebuf_, (uint32)item.kbetime);
+
+	if (len < 0)
+		return false;
+
+	if (len >= MAX_BUF)
+		len = MAX_BUF - 1;
+
+	out.clear();
+	out.reserve(item.message.size() + len + 32);
+	out += KBELOG_TYPE_NAME_EX(item.logtype);
+	out += " ";
+	out += COMPONENT_NAME_EX_2(item.componentType);
+	out.append(buf, len);
+	out += item.message;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+LogStore::LogStore():
+initialized_(false),
+path_(),
+segmentSize_(0),
+blockSize_(0),
+flushIntervalStamps_(0),
+pBlock_(NULL),
+blockIndex_(),
+blockStartStamp_(0),
+writing_(false),
+nextSeq_(1),
+sessionSegment_(0),
+numRecords_(0),
+numBytes_(0),
+numBlocks_(0),
+mutex_(),
+sealedBlocks_(),
+segments_(),
+pendingBytes_(0),
+fileMutex_(),
+pSegmentFile_(NULL),
+pIndexFile_(NULL),
+segmentSeq_(0),
+segmentBytes_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+LogStore::~LogStore()
+{
+	finalise();
+
+	SAFE_RELEASE(pBlock_);
+
+	std::vector<LogStoreBlock>::iterator iter = sealedBlocks_.begin();
+	for (; iter != sealedBlocks_.end(); ++iter)
+		delete iter->pStream;
+
+	sealedBlocks_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+std::string LogStore::segmentFile(const std::string& path, uint32 seq)
+{
+	return fmt::format("{}log_{:08d}.seg", path, seq);
+}
+
+//-------------------------------------------------------------------------------------
+std::string LogStore::indexFile(const std::string& path, uint32 seq)
+{
+	return fmt::format("{}log_{:08d}.idx", path, seq);
+}
+
+//-------------------------------------------------------------------------------------
+bool LogStore::initialize(const std::string& path, uint32 segmentSize, uint32 blockSize, float flushInterval)
+{
+	if (initialized_)
+		return true;
+
+	path_ = path;
+	strutil::kbe_replace(path_, "\\", "/");
+
+	if (path_.size() == 0)
+		path_ = "./";
+	else if (path_[path_.size() - 1] != '/')
+		path_ += "/";
+
+	// ҪMemoryStreamܳ󳤶
+	blockSize_ = std::min(std::max(blockSize, (uint32)4096), (uint32)(4 * 1024 * 1024));
+	segmentSize_ = std::max(segmentSize, blockSize_ * 4);
+	flushIntervalStamps_ = uint64(std::max(flushInterval, 0.f) * stampsPerSecond());
+
+	if (creatStoreDir(path_.c_str()) != 0)
+	{
+		ERROR_MSG(fmt::format("LogStore::initialize: create dir({}) failed!\n", path_));
+		return false;
+	}
+
+	// еķֶαֲ䣬 µ־дһµķֶ
+	uint32 maxSeq = 0;
+	std::vector<std::wstring> files;
+	wchar_t* wpath = strutil::char2wchar(path_.c_str());
+	Resmgr::getSingleton().listPathRes(wpath, L"seg", files);
+	free(wpath);
+
+	std::vector<std::wstring>::iterator iter = files.begin();
+	for (; iter != files.end(); ++iter)
+	{
+		char* cfile = strutil::wchar2char(iter->c_str());
+		std::string file = cfile;
+		free(cfile);
+
+		std::string::size_type pos = file.find_last_of("/\\");
+		if (pos != std::string::npos)
+			file = file.substr(pos + 1);
+
+		uint32 seq = 0;
+		if (sscanf(file.c_str(), "log_%u.seg", &seq) != 1 || seq == 0)
+			continue;
+
+		if (file != fmt::format("log_{:08d}.seg", seq))
+			continue;
+
+		segments_.push_back(seq);
+
+		if (seq > maxSeq)
+			maxSeq = seq;
+	}
+
+	std::sort(segments_.begin(), segments_.end());
+
+	{
+		thread::ThreadGuard tg(&fileMutex_);
+
+		if (!openSegment_(maxSeq + 1))
+			return false;
+	}
+
+	sessionSegment_ = maxSeq + 1;
+
+	initialized_ = true;
+
+	INFO_MSG(fmt::format("LogStore::initialize: path={}, segments={}, segmentSize={}, blockSize={}\n",
+		path_, segments_.size(), segmentSize_, blockSize_));
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::finalise()
+{
+	if (!initialized_)
+		return;
+
+	// ̳߳عرʱᶪδִе߳аʣĿ鶼д
+	sealBlock_();
+	flush();
+
+	{
+		thread::ThreadGuard tg(&fileMutex_);
+		closeSegment_();
+	}
+
+	initialized_ = false;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 LogStore::numSegments()
+{
+	thread::ThreadGuard tg(&mutex_);
+	return (uint32)segments_.size();
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::segments(std::vector<uint32>& out)
+{
+	thread::ThreadGuard tg(&mutex_);
+	out = segments_;
+}
+
+//-------------------------------------------------------------------------------------
+uint64 LogStore::append(const LOG_ITEM& item, const std::string* pText)
+{
+	if (!initialized_)
+		return 0;
+
+	if (pBlock_ == NULL)
+	{
+		pBlock_ = new MemoryStream(blockSize_ + MAX_BUF);
+		blockIndex_.reset();
+		blockStartStamp_ = timestamp();
+	}
+
+	size_t wpos = pBlock_->wpos();
+	uint8 flags = (pText ? LOG_STORE_RECORD_REWRITTEN : 0);
+
+	(*pBlock_) << item.uid;
+	(*pBlock_) << item.logtype;
+	(*pBlock_) << item.componentType;
+	(*pBlock_) << item.componentID;
+	(*pBlock_) << item.componentGlobalOrder;
+	(*pBlock_) << item.componentGroupOrder;
+	(*pBlock_) << item.t;
+	(*pBlock_) << item.kbetime;
+	(*pBlock_) << flags;
+	pBlock_->appendBlob(pText ? (*pText) : item.message);
+
+	if (blockIndex_.count == 0)
+		blockIndex_.firstSeq = nextSeq_;
+
+	if (blockIndex_.count == 0 || item.t < blockIndex_.minTime)
+		blockIndex_.minTime = item.t;
+
+	if (blockIndex_.count == 0 || item.t > blockIndex_.maxTime)
+		blockIndex_.maxTime = item.t;
+
+	++blockIndex_.count;
+	blockIndex_.logtypes |= item.logtype;
+
+	if (VALID_COMPONENT(item.componentType))
+		blockIndex_.components |= (1 << item.componentType);
+
+	++numRecords_;
+	numBytes_ += pBlock_->wpos() - wpos;
+
+	if (pBlock_->wpos() >= blockSize_)
+		sealBlock_();
+
+	return nextSeq_++;
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::sealBlock_()
+{
+	if (pBlock_ == NULL)
+		return;
+
+	LogStoreBlock block;
+	block.pStream = pBlock_;
+	block.index = blockIndex_;
+	block.index.size = (uint32)pBlock_->wpos();
+
+	{
+		thread::ThreadGuard tg(&mutex_);
+		sealedBlocks_.push_back(block);
+		pendingBytes_ += block.index.size;
+	}
+
+	pBlock_ = NULL;
+	blockIndex_.reset();
+	++numBlocks_;
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::tick(thread::ThreadPool& threadPool)
+{
+	if (!initialized_)
+		return;
+
+	if (pBlock_ && timestamp() - blockStartStamp_ >= flushIntervalStamps_)
+		sealBlock_();
+
+	// ͬһʱֻһд񣬱֤鰴˳д
+	if (writing_)
+		return;
+
+	{
+		thread::ThreadGuard tg(&mutex_);
+
+		if (sealedBlocks_.size() == 0)
+			return;
+	}
+
+	writing_ = true;
+	threadPool.addTask(new LogStoreWriteTask(this));
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::flush()
+{
+	thread::ThreadGuard fg(&fileMutex_);
+
+	std::vector<LogStoreBlock> blocks;
+
+	{
+		thread::ThreadGuard tg(&mutex_);
+		blocks.swap(sealedBlocks_);
+		pendingBytes_ = 0;
+	}
+
+	if (blocks.size() == 0)
+		return;
+
+	MemoryStream indexStream(blocks.size() * LOG_STORE_INDEX_ENTRY_SIZE);
+
+	std::vector<LogStoreBlock>::iterator iter = blocks.begin();
+	for (; iter != blocks.end(); ++iter)
+	{
+		LogStoreBlockIndex& index = iter->index;
+
+		if (pSegmentFile_ == NULL || 
+			(segmentBytes_ > LOG_STORE_FILE_HEADER_SIZE && segmentBytes_ + index.size > segmentSize_))
+		{
+			commitIndex_(indexStream);
+
+			if (!openSegment_(segmentSeq_ + 1))
+			{
+				ERROR_MSG(fmt::format("LogStore::flush: discard {} logs!\n", index.count));
+				delete iter->pStream;
+				continue;
+			}
+		}
+
+		if (fwrite(iter->pStream->data(), 1, index.size, pSegmentFile_) != index.size)
+		{
+			ERROR_MSG(fmt::format("LogStore::flush: write {} failed, discard {} logs!\n", 
+				segmentFile(path_, segmentSeq_), index.count));
+
+			delete iter->pStream;
+
+			// дʧܺ޷ȷ Ŀдµķֶ
+			closeSegment_();
+			continue;
+		}
+
+		index.offset = segmentBytes_;
+		segmentBytes_ += index.size;
+		delete iter->pStream;
+
+		indexStream << index.offset;
+		indexStream << index.size;
+		indexStream << index.count;
+		indexStream << index.minTime;
+		indexStream << index.maxTime;
+		indexStream << index.logtypes;
+		indexStream << index.components;
+		indexStream << index.firstSeq;
+	}
+
+	commitIndex_(indexStream);
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::commitIndex_(MemoryStream& indexStream)
+{
+	if (indexStream.length() == 0)
+		return;
+
+	if (pSegmentFile_ == NULL || pIndexFile_ == NULL)
+	{
+		indexStream.clear(false);
+		return;
+	}
+
+	// д ѯֻ߳ῴĿ
+	fflush(pSegmentFile_);
+
+	if (fwrite(indexStream.data() + indexStream.rpos(), 1, indexStream.length(), pIndexFile_) != indexStream.length())
+	{
+		ERROR_MSG(fmt::format("LogStore::commitIndex_: write {} failed!\n", 
+			indexFile(path_, segmentSeq_)));
+	}
+
+	fflush(pIndexFile_);
+	indexStream.clear(false);
+}
+
+//-------------------------------------------------------------------------------------
+bool LogStore::openSegment_(uint32 seq)
+{
+	closeSegment_();
+
+	std::string segmentPath = segmentFile(path_, seq);
+	std::string indexPath = indexFile(path_, seq);
+
+	pSegmentFile_ = fopen(segmentPath.c_str(), "wb");
+	if (pSegmentFile_ == NULL)
+	{
+		ERROR_MSG(fmt::format("LogStore::openSegment_: open {} failed!\n", segmentPath));
+		return false;
+	}
+
+	pIndexFile_ = fopen(indexPath.c_str(), "wb");
+	if (pIndexFile_ == NULL)
+	{
+		ERROR_MSG(fmt::format("LogStore::openSegment_: open {} failed!\n", indexPath));
+		fclose(pSegmentFile_);
+		pSegmentFile_ = NULL;
+		return false;
+	}
+
+	MemoryStream header;
+	header << (uint32)LOG_STORE_SEGMENT_MAGIC;
+	header << (uint32)LOG_STORE_VERSION;
+	fwrite(header.data(), 1, header.wpos(), pSegmentFile_);
+
+	header.clear(false);
+	header << (uint32)LOG_STORE_INDEX_MAGIC;
+	header << (uint32)LOG_STORE_VERSION;
+	fwrite(header.data(), 1, header.wpos(), pIndexFile_);
+
+	fflush(pSegmentFile_);
+	fflush(pIndexFile_);
+
+	segmentSeq_ = seq;
+	segmentBytes_ = LOG_STORE_FILE_HEADER_SIZE;
+
+	{
+		thread::ThreadGuard tg(&mutex_);
+		segments_.push_back(seq);
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void LogStore::closeSegment_()
+{
+	if (pSegmentFile_)
+	{
+		fclose(pSegmentFile_);
+		pSegmentFile_ = NULL;
+	}
+
+	if (pIndexFile_)
+	{
+		fclose(pIndexFile_);
+		pIndexFile_ = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool LogStore::parseTimeRange(const std::string& date, int64& beginTime, int64& endTime)
+{
+	std::vector<std::string> parts;
+	strutil::kbe_split(date, '~', parts);
+
+	if (parts.size() == 0 || parts.size() > 2)
+		return false;
+
+	for (size_t i = 0; i < parts.size(); ++i)
+	{
+		std::string part = strutil::kbe_trim(parts[i]);
+
+		int fields[6] = { 0, 1, 1, 0, 0, 0 };
+		int consumed = 0;
+		int n = sscanf(part.c_str(), "%d-%d-%d %d:%d:%d%n", &fields[0], &fields[1], &fields[2], 
+			&fields[3], &fields[4], &fields[5], &consumed);
+
+		// %nֻȫֶζƥʱŻᱻֵֶβȫʱƥĲ¼㳤
+		if (n < 6)
+		{
+			if (n == 5)
+				n = sscanf(part.c_str(), "%d-%d-%d %d:%d%n", &fields[0], &fields[1], &fields[2], &fields[3], &fields[4], &consumed);
+			else if (n == 4)
+				n = sscanf(part.c_str(), "%d-%d-%d %d%n", &fields[0], &fields[1], &fields[2], &fields[3], &consumed);
+			else if (n == 3)
+				n = sscanf(part.c_str(), "%d-%d-%d%n", &fields[0], &fields[1], &fields[2], &consumed);
+			else
+				return false;
+		}
+
+		if (n < 3 || consumed != (int)part.size())
+			return false;
+
+		struct tm aTm;
+		memset(&aTm, 0, sizeof(aTm));
+		aTm.tm_year = fields[0] - 1900;
+		aTm.tm_mon = fields[1] - 1;
+		aTm.tm_mday = fields[2];
+		aTm.tm_hour = fields[3];
+		aTm.tm_min = fields[4];
+		aTm.tm_sec = fields[5];
+		aTm.tm_isdst = -1;
+
+		time_t start = mktime(&aTm);
+		if (start == (time_t)-1)
+			return false;
+
+		if (i == 0)
+			beginTime = (int64)start;
+
+		if (i + 1 < parts.size())
+			continue;
+
+		// ʱΪһʱʾʱεĩβ
+		if (n == 3)
+			aTm.tm_mday += 1;
+		else if (n == 4)
+			aTm.tm_hour += 1;
+		else if (n == 5)
+			aTm.tm_min += 1;
+		else
+			aTm.tm_sec += 1;
+
+		aTm.tm_isdst = -1;
+		time_t end = mktime(&aTm);
+		if (end == (time_t)-1)
+			return false;
+
+		endTime = (int64)end;
+	}
+
+	return endTime > beginTime;
+}
+
+//-------------------------------------------------------------------------------------
+bool LogStore::query(const std::string& path, const std::vector<uint32>& segments, 
+	const LogStoreQuery& query, std::vector<std::string>& results, bool& truncated)
+{
+	results.clear();
+	truncated = false;
+
+	LogFormatter formatter;
+	LOG_ITEM item;
+	std::string text;
+	MemoryStream indexStream(LOG_STORE_INDEX_ENTRY_SIZE * 1024);
+	MemoryStream blockStream;
+
+	std::vector<uint32>::const_iterator iter = segments.begin();
+	for (; iter != segments.end(); ++iter)
+	{
+		std::string indexPath = indexFile(path, (*iter));
+		FILE* pIndexFile = fopen(indexPath.c_str(), "rb");
+		if (pIndexFile == NULL)
+			continue;
+
+		indexStream.clear(false);
+		indexStream.data_resize(LOG_STORE_FILE_HEADER_SIZE);
+		size_t readSize = fread(indexStream.data(), 1, LOG_STORE_FILE_HEADER_SIZE, pIndexFile);
+		indexStream.wpos((int)readSize);
+
+		uint32 magic = 0, version = 0;
+		if (readSize == LOG_STORE_FILE_HEADER_SIZE)
+			indexStream >> magic >> version;
+
+		if (magic != LOG_STORE_INDEX_MAGIC || version != LOG_STORE_VERSION)
+		{
+			if (readSize == LOG_STORE_FILE_HEADER_SIZE)
+			{
+				WARNING_MSG(fmt::format("LogStore::query: {} is not a valid index file!\n", 
+					indexPath));
+			}
+
+			fclose(pIndexFile);
+			continue;
+		}
+
+		FILE* pSegmentFile = NULL;
+		bool segmentFailed = false;
+
+		while (!segmentFailed)
+		{
+			// ȡ ĩβδдĿᱻ
+			indexStream.clear(false);
+			indexStream.data_resize(LOG_STORE_INDEX_ENTRY_SIZE * 1024);
+			readSize = fread(indexStream.data(), LOG_STORE_INDEX_ENTRY_SIZE, 1024, pIndexFile);
+			if (readSize == 0)
+				break;
+
+			indexStream.wpos((int)(readSize * LOG_STORE_INDEX_ENTRY_SIZE));
+
+			while (indexStream.length() >= LOG_STORE_INDEX_ENTRY_SIZE)
+			{
+				LogStoreBlockIndex index;
+				indexStream >> index.offset;
+				indexStream >> index.size;
+				indexStream >> index.count;
+				indexStream >> index.minTime;
+				indexStream >> index.maxTime;
+				indexStream >> index.logtypes;
+				indexStream >> index.components;
+				indexStream >> index.firstSeq;
+
+				// дļ¼ ŲСseqLimitļ¼ڻ
+				bool sessionBlock = (query.seqLimit > 0 && (*iter) >= query.sessionSegment);
+				if (sessionBlock && index.firstSeq >= query.seqLimit)
+					continue;
+
+				if (query.beginTime > 0 && index.maxTime < query.beginTime)
+					continue;
+
+				if (query.endTime > 0 && index.minTime >= query.endTime)
+					continue;
+
+				if ((index.logtypes & query.logtypes) == 0 || (index.components & query.components) == 0)
+					continue;
+
+				if (index.size == 0 || index.size > MemoryStream::MAX_SIZE)
+					continue;
+
+				if (pSegmentFile == NULL)
+				{
+					pSegmentFile = fopen(segmentFile(path, (*iter)).c_str(), "rb");
+					if (pSegmentFile == NULL)
+					{
+						segmentFailed = true;
+						break;
+					}
+				}
+
+				blockStream.clear(false);
+				blockStream.data_resize(index.size);
+
+				if (fseek(pSegmentFile, (long)index.offset, SEEK_SET) != 0 ||
+					fread(blockStream.data(), 1, index.size, pSegmentFile) != index.size)
+				{
+					ERROR_MSG(fmt::format("LogStore::query: read {} failed, offset={}, size={}!\n", 
+						segmentFile(path, (*iter)), index.offset, index.size));
+
+					segmentFailed = true;
+					break;
+				}
+
+				blockStream.wpos((int)index.size);
+				uint64 seq = index.firstSeq;
+
+				try
+				{
+					for (; blockStream.length() > 0; ++seq)
+					{
+						uint8 flags = 0;
+
+						blockStream >> item.uid;
+						blockStream >> item.logtype;
+						blockStream >> item.componentType;
+						blockStream >> item.componentID;
+						blockStream >> item.componentGlobalOrder;
+						blockStream >> item.componentGroupOrder;
+						blockStream >> item.t;
+						blockStream >> item.kbetime;
+						blockStream >> flags;
+						item.message.clear();
+						blockStream.readBlob(item.message);
+
+						if (sessionBlock && seq >= query.seqLimit)
+							break;
+
+						if (query.beginTime > 0 && item.t < query.beginTime)
+							continue;
+
+						if (query.endTime > 0 && item.t >= query.endTime)
+							continue;
+
+						if (!VALID_COMPONENT(item.componentType) || (query.components & (1 << item.componentType)) == 0)
+							continue;
+
+						if ((query.logtypes & item.logtype) == 0 || query.uid != item.uid)
+							continue;
+
+						if (query.globalOrder > 0 && query.globalOrder != item.componentGlobalOrder)
+							continue;
+
+						if (query.groupOrder > 0 && query.groupOrder != item.componentGroupOrder)
+							continue;
+
+						if (flags & LOG_STORE_RECORD_REWRITTEN)
+							text = item.message;
+						else if (!formatter.format(item, text))
+							continue;
+
+						if (query.date.size() > 0 && text.find(query.date) == std::string::npos)
+							continue;
+
+						if (query.keyStr.size() > 0 && text.find(query.keyStr) == std::string::npos)
+							continue;
+
+						results.push_back(text);
+
+						if (query.maxResults > 0 && results.size() >= query.maxResults)
+						{
+							truncated = true;
+							fclose(pIndexFile);
+							fclose(pSegmentFile);
+							return true;
+						}
+					}
+				}
+				catch (MemoryStreamException &)
+				{
+					WARNING_MSG(fmt::format("LogStore::query: {} has a damaged block, offset={}, size={}!\n", 
+						segmentFile(path, (*iter)), index.offset, index.size));
+				}
+			}
+		}
+
+		fclose(pIndexFile);
+
+		if (pSegmentFile)
+			fclose(pSegmentFile);
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool LogStoreWriteTask::process()
+{
+	pLogStore_->flush();
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState LogStoreWriteTask::presentMainThread()
+{
+	pLogStore_->onWriteTaskCompleted();
+	return thread::TPTask::TPTASK_STATE_COMPLETED;
+}
+
+//-------------------------------------------------------------------------------------
+LogQueryTask::LogQueryTask(const Network::Address& addr, LogStore* pLogStore, const LogStoreQuery& query):
+addr_(addr),
+pLogStore_(pLogStore),
+path_(pLogStore->path()),
+query_(query),
+results_(),
+initLogs_(),
+truncated_(false),
+success_(false),
+startTime_(timestamp())
+{
+}
+
+//-------------------------------------------------------------------------------------
+bool LogQueryTask::process()
+{
+	// дѷյĿ(עʱյĵǰ) ȡ÷ֶб ֤ѯԿע֮ǰ־
+	pLogStore_->flush();
+
+	std::vector<uint32> segments;
+	pLogStore_->segments(segments);
+
+	success_ = LogStore::query(path_, segments, query_, results_, truncated_);
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState LogQueryTask::presentMainThread()
+{
+	INFO_MSG(fmt::format("LogQueryTask::presentMainThread: addr={}, found {} logs{}, took {:.3f}s.\n",
+		addr_.c_str(), results_.size(), (truncated_ ? fmt::format("(truncated to {})", query_.maxResults) : ""),
+		double(timestamp() - startTime_) / stampsPerSecond()));
+
+	// ѯڼ߿Ѿע߶Ͽ
+	Logger::LOG_WATCHERS& logWatchers = Logger::getSingleton().logWatchers();
+	if ((results_.size() == 0 && initLogs_.size() == 0) || logWatchers.find(addr_) == logWatchers.end())
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+
+	Network::Channel* pChannel = Logger::getSingleton().networkInterface().findChannel(addr_);
+	if (pChannel == NULL)
+		return thread::TPTask::TPTASK_STATE_COMPLETED;
+
+	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
+	ConsoleInterface::ConsoleLogMessageHandler msgHandler;
+
+	std::vector<std::string>::iterator iter = results_.begin();
+	for (; iter != results_.end(); ++iter)
+	{
+		(*pBundle).newMessage(msgHandler);
+		(*pBundle).appendBlob((*iter));
+	}
+
+	// עʱе־ʷ־֮
+	iter = initLogs_.begin();
+	for (; iter != initLogs_.end(); ++iter)
+	{
+		(*pBundle).newMessage(msgHandler);
+		(*pBundle).appendBlob((*iter));
+	}
+
+	pChannel->send(pBundle);
+	return thread::TPTask::TPTASK_STATE_COMPLETED;
+}
+
+//-------------------------------------------------------------------------------------
+
+}
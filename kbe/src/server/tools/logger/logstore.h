@@ -0,0 +1,288 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2018 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_LOGSTORE_H
+#define KBE_LOGSTORE_H
+
+#include "common/common.h"
+#include "common/memorystream.h"
+#include "network/address.h"
+#include "thread/threadtask.h"
+#include "thread/threadmutex.h"
+
+namespace KBEngine{
+
+namespace thread{
+class ThreadPool;
+}
+
+struct LOG_ITEM;
+
+/*
+	ֶļɿɣÿ־¼ÿļһĿ
+	¼ڷֶеλԼ־ʱ䷶Χ룬ѯʱͨصĿ顣
+*/
+#define LOG_STORE_SEGMENT_MAGIC			0x53474C4B		// "KLGS"
+#define LOG_STORE_INDEX_MAGIC			0x49474C4B		// "KLGI"
+#define LOG_STORE_VERSION				1
+#define LOG_STORE_FILE_HEADER_SIZE		8
+#define LOG_STORE_INDEX_ENTRY_SIZE		48
+
+// ¼messageǽű(onLogWrote)д־ıѯʱٸʽ
+#define LOG_STORE_RECORD_REWRITTEN		0x01
+
+struct LogStoreBlockIndex
+{
+	LogStoreBlockIndex()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		offset = 0;
+		size = 0;
+		count = 0;
+		minTime = 0;
+		maxTime = 0;
+		logtypes = 0;
+		components = 0;
+		firstSeq = 0;
+	}
+
+	uint64 offset;
+	uint32 size;
+	uint32 count;
+	int64 minTime;
+	int64 maxTime;
+	uint32 logtypes;
+	uint32 components;
+	uint64 firstSeq;										// ڵһ¼ڱνе
+};
+
+struct LogStoreBlock
+{
+	MemoryStream* pStream;
+	LogStoreBlockIndex index;
+};
+
+struct LogStoreQuery
+{
+	LogStoreQuery():
+	beginTime(0),
+	endTime(0),
+	logtypes(0),
+	components(0),
+	uid(0),
+	globalOrder(0),
+	groupOrder(0),
+	keyStr(),
+	date(),
+	maxResults(0),
+	sessionSegment(0),
+	seqLimit(0)
+	{
+	}
+
+	int64 beginTime;										// Ϊ0
+	int64 endTime;											//  Ϊ0
+	uint32 logtypes;
+	uint32 components;										// COMPONENT_TYPEλ
+	int32 uid;
+	COMPONENT_ORDER globalOrder;
+	COMPONENT_ORDER groupOrder;
+	std::string keyStr;
+	std::string date;										// ޷Ϊʱ䷶Χʱıƥ
+	uint32 maxResults;
+
+	// νдķֶδsessionSegmentʼ ŲСseqLimitļ¼(Ѿͨ־) Ϊ0
+	uint32 sessionSegment;
+	uint64 seqLimit;
+};
+
+/*
+	־ʽΪlog4cxxı־һµĸʽͬһڵ־localtimeĽ
+*/
+class LogFormatter
+{
+public:
+	LogFormatter();
+
+	bool format(const LOG_ITEM& item, std::string& out);
+
+private:
+	time_t lastTime_;
+	bool valid_;
+	char timebuf_[32];
+};
+
+class LogStore
+{
+public:
+	LogStore();
+	~LogStore();
+
+	bool initialize(const std::string& path, uint32 segmentSize, uint32 blockSize, float flushInterval);
+	void finalise();
+
+	bool isInitialized() const { return initialized_; }
+	const std::string& path() const { return path_; }
+
+	/** 
+		̣߳׷һ־ǰ飬 ؼ¼
+		@pText: ΪNULLʱΪűд־ı 洢ԭʼϢ
+	*/
+	uint64 append(const LOG_ITEM& item, const std::string* pText = NULL);
+
+	/** 
+		̣߳յǰ飬 ʹѯԿ־
+	*/
+	void seal(){ sealBlock_(); }
+
+	uint64 nextSeq() const { return nextSeq_; }
+	uint32 sessionSegment() const { return sessionSegment_; }
+
+	/** 
+		̣߳д߳ʱĿ飬ûдִʱύһ̨д
+	*/
+	void tick(thread::ThreadPool& threadPool);
+
+	/** 
+		ѷյĿдֶļļɺִ̨߳Уرʱִ߳
+	*/
+	void flush();
+
+	void onWriteTaskCompleted(){ writing_ = false; }
+
+	void segments(std::vector<uint32>& out);
+
+	/** 
+		־ִ߳УֻѾдĿ
+	*/
+	static bool query(const std::string& path, const std::vector<uint32>& segments, 
+		const LogStoreQuery& query, std::vector<std::string>& results, bool& truncated);
+
+	/** 
+		"YYYY-MM-DD[ HH[:MM[:SS]]]""~"ӵʱΪʱ䷶Χ[begin, end)
+	*/
+	static bool parseTimeRange(const std::string& date, int64& beginTime, int64& endTime);
+
+	static std::string segmentFile(const std::string& path, uint32 seq);
+	static std::string indexFile(const std::string& path, uint32 seq);
+
+	uint64 numRecords() const { return numRecords_; }
+	uint64 numBytes() const { return numBytes_; }
+	uint64 numBlocks() const { return numBlocks_; }
+	uint32 numSegments();
+	uint32 pendingBytes() const { return pendingBytes_; }
+
+protected:
+	void sealBlock_();
+	void commitIndex_(MemoryStream& indexStream);
+	bool openSegment_(uint32 seq);
+	void closeSegment_();
+
+protected:
+	bool initialized_;
+	std::string path_;
+	uint32 segmentSize_;
+	uint32 blockSize_;
+	uint64 flushIntervalStamps_;
+
+	// ֻ߳з
+	MemoryStream* pBlock_;
+	LogStoreBlockIndex blockIndex_;
+	uint64 blockStartStamp_;
+	bool writing_;
+
+	uint64 nextSeq_;
+	uint32 sessionSegment_;
+
+	uint64 numRecords_;
+	uint64 numBytes_;
+	uint64 numBlocks_;
+
+	// mutex_
+	thread::ThreadMutex mutex_;
+	std::vector<LogStoreBlock> sealedBlocks_;
+	std::vector<uint32> segments_;
+	uint32 pendingBytes_;
+
+	// fileMutex_
+	thread::ThreadMutex fileMutex_;
+	FILE* pSegmentFile_;
+	FILE* pIndexFile_;
+	uint32 segmentSeq_;
+	uint64 segmentBytes_;
+};
+
+/*
+	̨д ͬһʱֻһ
+*/
+class LogStoreWriteTask : public thread::TPTask
+{
+public:
+	LogStoreWriteTask(LogStore* pLogStore):
+	pLogStore_(pLogStore)
+	{
+	}
+
+	virtual ~LogStoreWriteTask(){}
+
+	virtual bool process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+protected:
+	LogStore* pLogStore_;
+};
+
+/*
+	̨ѯ񣬽߳з͸log
+*/
+class LogQueryTask : public thread::TPTask
+{
+public:
+	LogQueryTask(const Network::Address& addr, LogStore* pLogStore, const LogStoreQuery& query);
+
+	virtual ~LogQueryTask(){}
+
+	virtual bool process();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	uint64 seqLimit() const { return query_.seqLimit; }
+	void seqLimit(uint64 seq) { query_.seqLimit = seq; }
+
+	void addInitLog(const std::string& log) { initLogs_.push_back(log); }
+
+protected:
+	Network::Address addr_;
+	LogStore* pLogStore_;
+	std::string path_;
+	LogStoreQuery query_;
+	std::vector<std::string> results_;
+	std::vector<std::string> initLogs_;
+	bool truncated_;
+	bool success_;
+	uint64 startTime_;
+};
+
+}
+
+#endif // KBE_LOGSTORE_H
@@ -21,6 +21,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "logwatcher.h"
 #include "logger.h"
+#include "logstore.h"
 #include "common/memorystream.h"
 #include "helper/console_helper.h"
 
@@ -51,6 +52,8 @@ void LogWatcher::reset()
 	filterOptions_.groupOrder = 0;
 	filterOptions_.keyStr = "";
 	filterOptions_.date = "";
+	filterOptions_.beginTime = 0;
+	filterOptions_.endTime = 0;
 
 	state_ = STATE_AUTO;
 }
@@ -95,25 +98,63 @@ bool LogWatcher::updateSetting(MemoryStream * s)
 			filterOptions_.componentBitmap[type] = 1;
 	}
 
+	if(filterOptions_.date.size() > 0 && 
+		!LogStore::parseTimeRange(filterOptions_.date, filterOptions_.beginTime, filterOptions_.endTime))
+	{
+		filterOptions_.beginTime = 0;
+		filterOptions_.endTime = 0;
+	}
+
 	return true;
 }
 
 //-------------------------------------------------------------------------------------
-void LogWatcher::onMessage(LOG_ITEM* pLogItem)
+void LogWatcher::makeStoreQuery(LogStoreQuery& query) const
+{
+	query.uid = filterOptions_.uid;
+	query.logtypes = filterOptions_.logtypes;
+	query.globalOrder = filterOptions_.globalOrder;
+	query.groupOrder = filterOptions_.groupOrder;
+	query.keyStr = filterOptions_.keyStr;
+	query.beginTime = filterOptions_.beginTime;
+	query.endTime = filterOptions_.endTime;
+
+	if(filterOptions_.endTime == 0)
+		query.date = filterOptions_.date;
+
+	query.components = 0;
+	for(uint8 i = 0; i < COMPONENT_END_TYPE; ++i)
+	{
+		if(filterOptions_.componentBitmap[i] > 0)
+			query.components |= (1 << i);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool LogWatcher::accept(const LOG_ITEM* pLogItem)
 {
 	if(!VALID_COMPONENT(pLogItem->componentType) || filterOptions_.componentBitmap[pLogItem->componentType] == 0)
-		return;
+		return false;
 
 	if(filterOptions_.uid != pLogItem->uid)
-		return;
+		return false;
 
 	if((filterOptions_.logtypes & pLogItem->logtype) <= 0)
-		return;
+		return false;
 
 	if(filterOptions_.globalOrder > 0 && filterOptions_.globalOrder != pLogItem->componentGlobalOrder)
-		return;
+		return false;
 
 	if(filterOptions_.groupOrder > 0 && filterOptions_.groupOrder != pLogItem->componentGroupOrder)
+		return false;
+
+	return validDate_(pLogItem) && containKeyworlds_(pLogItem->logstr);
+}
+
+//-------------------------------------------------------------------------------------
+void LogWatcher::onMessage(LOG_ITEM* pLogItem)
+{
+	if(!accept(pLogItem))
 		return;
 
 	Network::Channel* pChannel = Logger::getSingleton().networkInterface().findChannel(addr_);
@@ -123,23 +164,23 @@ void LogWatcher::onMessage(LOG_ITEM* pLogItem)
 		// עwatcherԽԽ࣬logWatchers_еĲͻԽ
 		return;
 
-	if(!validDate_(pLogItem->logstream.str()) || !containKeyworlds_(pLogItem->logstream.str()))
-		return;
-
 	Network::Bundle* pBundle = Network::Bundle::createPoolObject(OBJECTPOOL_POINT);
 	ConsoleInterface::ConsoleLogMessageHandler msgHandler;
 	(*pBundle).newMessage(msgHandler);
-	(*pBundle).appendBlob(pLogItem->logstream.str());
+	(*pBundle).appendBlob(pLogItem->logstr);
 	pChannel->send(pBundle);
 }
 
 //-------------------------------------------------------------------------------------
-bool LogWatcher::validDate_(const std::string& log)
+bool LogWatcher::validDate_(const LOG_ITEM* pLogItem)
 {
 	if(filterOptions_.date.size() == 0)
 		return true;
 
-	if(log.find(filterOptions_.date.c_str()) != std::string::npos)
+	if(filterOptions_.endTime > 0)
+		return pLogItem->t >= filterOptions_.beginTime && pLogItem->t < filterOptions_.endTime;
+
+	if(pLogItem->logstr.find(filterOptions_.date.c_str()) != std::string::npos)
 		return true;
 
 	return false;
@@ -36,6 +36,7 @@ namespace KBEngine
 {
 class MemoryStream;
 struct LOG_ITEM;
+struct LogStoreQuery;
 
 struct FilterOptions
 {
@@ -46,6 +47,8 @@ struct FilterOptions
 	COMPONENT_ORDER groupOrder;
 	std::string keyStr;
 	std::string date;
+	int64 beginTime;										// dateܽΪʱ䷶ΧʱЧ dateıƥ
+	int64 endTime;
 };
 
 class LogWatcher
@@ -65,13 +68,21 @@ public:
 
 	void reset();
 	void addr(const Network::Address& address) { addr_ = address; }
+	const Network::Address& addr() const { return addr_; }
 	
+	void makeStoreQuery(LogStoreQuery& query) const;
+
 	void onMessage(LOG_ITEM* pLogItem);
 
+	/** 
+		־Ƿ
+	*/
+	bool accept(const LOG_ITEM* pLogItem);
+
 	STATES state() const{ return state_; }
 
 protected:
-	bool validDate_(const std::string& log);
+	bool validDate_(const LOG_ITEM* pLogItem);
 	bool containKeyworlds_(const std::string& log);
 
 protected: